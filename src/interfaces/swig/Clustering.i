@@ -22,6 +22,11 @@
 /* Include Class Headers to make them visible from within the target language */
 %include <shogun/machine/Machine.h>
 %include <shogun/machine/DistanceMachine.h>
+
+/** Instantiate RandomMixin */
+%template(SeedableDistanceMachine) shogun::Seedable<shogun::CDistanceMachine>;
+%template(RandomMixinDistanceMachine) shogun::RandomMixin<shogun::CDistanceMachine, std::mt19937_64>;
+
 %include <shogun/clustering/KMeansBase.h> 
 %include <shogun/clustering/KMeans.h>
 %include <shogun/clustering/KMeansMiniBatch.h>
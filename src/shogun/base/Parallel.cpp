@@ -6,6 +6,7 @@
  */
 
 #include <shogun/base/Parallel.h>
+#include <shogun/base/ThreadPool.h>
 #include <shogun/lib/RefCount.h>
 #include <shogun/lib/config.h>
 #include <shogun/lib/memory.h>
@@ -78,13 +79,28 @@ void Parallel::set_num_threads(int32_t n)
 #if !defined(HAVE_PTHREAD) && !defined(HAVE_OPENMP)
 	ASSERT(n==1)
 #endif
+	std::lock_guard<std::mutex> lock(m_thread_pool_mutex);
 	num_threads=n;
 #ifdef HAVE_OPENMP
 	omp_set_num_threads(num_threads);
 #endif
+
+	// sections that still run on the old pool hold their own reference,
+	// which defers its destruction until they are done
+	if (m_thread_pool && m_thread_pool->get_num_threads()!=num_threads)
+		m_thread_pool.reset();
 }
 
 int32_t Parallel::get_num_threads() const
 {
 	return num_threads;
 }
+
+std::shared_ptr<ThreadPool> Parallel::get_thread_pool()
+{
+	std::lock_guard<std::mutex> lock(m_thread_pool_mutex);
+	if (!m_thread_pool)
+		m_thread_pool = std::make_shared<ThreadPool>(num_threads);
+
+	return m_thread_pool;
+}
@@ -12,8 +12,13 @@
 
 #include <shogun/lib/common.h>
 
+#include <memory>
+#include <mutex>
+
 namespace shogun
 {
+class ThreadPool;
+
 /** @brief Class Parallel provides helper functions for multithreading.
  *
  * For example it can be used to determine the number of CPU cores in your
@@ -47,6 +52,18 @@ public:
 	 */
 	int32_t get_num_threads() const;
 
+#ifndef SWIG // SWIG should skip this part
+	/** get the thread pool shared by all algorithms. It is created on first
+	 * use with get_num_threads() threads and recreated after the number of
+	 * threads changed. A pool that is replaced while in use lives on until
+	 * its last holder releases it, hence keep the returned pointer for the
+	 * duration of a parallel section.
+	 *
+	 * @return thread pool
+	 */
+	std::shared_ptr<ThreadPool> get_thread_pool();
+#endif // SWIG
+
 	// FIXME: Should be dropped, but needed to be wrappable by some
 	int32_t ref() { return 1; }
 	int32_t ref_count() const { return 1; }
@@ -55,6 +72,12 @@ public:
 private:
 	/** number of threads */
 	int32_t num_threads;
+
+	/** lazily created thread pool */
+	std::shared_ptr<ThreadPool> m_thread_pool;
+
+	/** protects creation of the thread pool */
+	std::mutex m_thread_pool_mutex;
 };
 }
 #endif
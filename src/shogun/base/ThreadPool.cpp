@@ -0,0 +1,221 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/base/ThreadPool.h>
+#include <shogun/lib/cpu.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+namespace
+{
+/** pool the calling thread works for */
+thread_local const ThreadPool* tl_pool = nullptr;
+/** queue of the calling thread within tl_pool */
+thread_local int32_t tl_queue = -1;
+}
+
+ThreadPool::ThreadPool(int32_t num_threads)
+    : m_pending(0), m_next_queue(0), m_stop(false)
+{
+	int32_t num_workers = num_threads > 1 ? num_threads - 1 : 0;
+
+	for (int32_t i = 0; i < num_workers; i++)
+		m_queues.emplace_back(new WorkQueue());
+
+	for (int32_t i = 0; i < num_workers; i++)
+		m_workers.emplace_back(&ThreadPool::worker_loop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_stop = true;
+	}
+	m_wakeup.notify_all();
+
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+int32_t ThreadPool::current_queue() const
+{
+	return tl_pool == this ? tl_queue : -1;
+}
+
+void ThreadPool::push_task(Task task)
+{
+	enqueue_task(std::move(task));
+	publish_tasks(1);
+}
+
+void ThreadPool::enqueue_task(Task task)
+{
+	int32_t id = current_queue();
+	if (id < 0)
+		id = m_next_queue.fetch_add(1, std::memory_order_relaxed) %
+		     m_queues.size();
+
+	std::lock_guard<std::mutex> lock(m_queues[id]->mutex);
+	m_queues[id]->tasks.push_back(std::move(task));
+}
+
+void ThreadPool::publish_tasks(int64_t num_tasks)
+{
+	{
+		// synchronise with workers that are about to fall asleep
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_pending.fetch_add(num_tasks, std::memory_order_release);
+	}
+
+	if (num_tasks > 1)
+		m_wakeup.notify_all();
+	else
+		m_wakeup.notify_one();
+}
+
+bool ThreadPool::pop_task(int32_t id, Task& task)
+{
+	if (m_pending.load(std::memory_order_acquire) <= 0)
+		return false;
+
+	const int32_t num_queues = m_queues.size();
+	for (int32_t i = 0; i < num_queues; i++)
+	{
+		WorkQueue& queue = *m_queues[(id + i) % num_queues];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			continue;
+
+		// own queue is processed LIFO, the others are stolen from FIFO
+		if (i == 0)
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+		m_pending.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	return false;
+}
+
+void ThreadPool::worker_loop(int32_t id)
+{
+	tl_pool = this;
+	tl_queue = id;
+
+	Task task;
+	while (true)
+	{
+		if (pop_task(id, task))
+		{
+			task();
+			task = nullptr;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_wakeup.wait(lock, [this]() {
+			return m_stop || m_pending.load(std::memory_order_acquire) > 0;
+		});
+
+		if (m_stop && m_pending.load(std::memory_order_acquire) <= 0)
+			break;
+	}
+}
+
+void ThreadPool::parallel_for(
+    index_t begin, index_t end,
+    const std::function<void(index_t, index_t)>& body)
+{
+	const index_t chunks_per_thread = 4;
+	index_t grain = (end - begin) / (get_num_threads() * chunks_per_thread);
+
+	parallel_for(begin, end, grain > 0 ? grain : 1, body);
+}
+
+void ThreadPool::parallel_for(
+    index_t begin, index_t end, index_t grain,
+    const std::function<void(index_t, index_t)>& body)
+{
+	if (end <= begin)
+		return;
+
+	if (grain < 1)
+		grain = 1;
+
+	const index_t num_chunks = (end - begin + grain - 1) / grain;
+	if (m_workers.empty() || num_chunks == 1)
+	{
+		body(begin, end);
+		return;
+	}
+
+	// lives on the stack as this function does not return before all
+	// chunks are done
+	std::atomic<index_t> remaining(num_chunks - 1);
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	auto run_chunk = [&](index_t chunk_begin) {
+		try
+		{
+			body(chunk_begin, std::min(chunk_begin + grain, end));
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(error_mutex);
+			if (!error)
+				error = std::current_exception();
+		}
+	};
+
+	for (index_t chunk = 1; chunk < num_chunks; chunk++)
+	{
+		const index_t chunk_begin = begin + chunk * grain;
+		enqueue_task([&run_chunk, &remaining, chunk_begin]() {
+			run_chunk(chunk_begin);
+			remaining.fetch_sub(1, std::memory_order_acq_rel);
+		});
+	}
+	publish_tasks(num_chunks - 1);
+
+	run_chunk(begin);
+
+	// help with pending tasks instead of idling
+	int32_t id = current_queue();
+	if (id < 0)
+		id = 0;
+
+	// spin shortly, then yield to workers that still run chunks
+	const int32_t max_spins = 64;
+	int32_t spins = 0;
+	Task task;
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (pop_task(id, task))
+		{
+			task();
+			task = nullptr;
+			spins = 0;
+		}
+		else if (spins++ < max_spins)
+			CpuRelax();
+		else
+			std::this_thread::yield();
+	}
+
+	if (error)
+		std::rethrow_exception(error);
+}
@@ -0,0 +1,169 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef THREAD_POOL_H__
+#define THREAD_POOL_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace shogun
+{
+/** @brief Persistent pool of worker threads with work stealing.
+ *
+ * Every worker owns a task queue. Workers pop tasks from the back of their
+ * own queue and, once it runs dry, steal from the front of the other queues.
+ * Threads that wait for a parallel_for to finish help executing pending
+ * tasks, hence nested parallel loops do not deadlock.
+ *
+ * The threads are created once and reused, which makes the pool suitable for
+ * solvers that run a small parallel section in every one of thousands of
+ * iterations, where creating and joining threads would dominate.
+ *
+ * The pool of the environment is available through
+ * env()->get_thread_pool().
+ */
+class ThreadPool
+{
+public:
+	/** constructor
+	 *
+	 * @param num_threads total number of threads executing work, including
+	 * the calling thread, i.e. num_threads-1 workers are started
+	 */
+	explicit ThreadPool(int32_t num_threads);
+
+	/** destructor, waits for all workers to finish */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/** @return number of threads executing work, including the caller */
+	int32_t get_num_threads() const
+	{
+		return (int32_t)m_workers.size() + 1;
+	}
+
+	/** run body on consecutive chunks of [begin, end) in parallel and
+	 * block until all chunks are done. The calling thread processes chunks
+	 * as well, without workers it processes the whole range in one call.
+	 * The first exception thrown by the body is rethrown.
+	 *
+	 * @param begin first index
+	 * @param end one past the last index
+	 * @param grain number of indices per chunk
+	 * @param body called with the range [chunk_begin, chunk_end)
+	 */
+	void parallel_for(
+	    index_t begin, index_t end, index_t grain,
+	    const std::function<void(index_t, index_t)>& body);
+
+	/** run body on chunks of [begin, end) in parallel, with a grain size
+	 * that yields a few chunks per thread
+	 *
+	 * @param begin first index
+	 * @param end one past the last index
+	 * @param body called with the range [chunk_begin, chunk_end)
+	 */
+	void parallel_for(
+	    index_t begin, index_t end,
+	    const std::function<void(index_t, index_t)>& body);
+
+	/** submit a single task
+	 *
+	 * @param f callable without arguments
+	 * @return future of the result of f
+	 */
+	template <class F>
+	std::future<std::invoke_result_t<F>> submit(F&& f)
+	{
+		using R = std::invoke_result_t<F>;
+		auto task =
+		    std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+		auto result = task->get_future();
+
+		if (m_workers.empty())
+			(*task)();
+		else
+			push_task([task]() { (*task)(); });
+
+		return result;
+	}
+
+private:
+	/** type of queued tasks */
+	typedef std::function<void()> Task;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** task queue of a worker */
+	struct WorkQueue
+	{
+		/** protects tasks */
+		std::mutex mutex;
+		/** queued tasks */
+		std::deque<Task> tasks;
+	};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** main loop of a worker */
+	void worker_loop(int32_t id);
+
+	/** queue a task and wake up a worker */
+	void push_task(Task task);
+
+	/** queue a task without announcing it to the workers, on the own queue
+	 * when called by a worker and round robin otherwise
+	 */
+	void enqueue_task(Task task);
+
+	/** announce queued tasks to the workers
+	 *
+	 * @param num_tasks number of tasks queued by enqueue_task
+	 */
+	void publish_tasks(int64_t num_tasks);
+
+	/** pop a task from the own queue or steal one from another queue
+	 *
+	 * @param id queue to start with
+	 * @param task the popped task
+	 * @return whether a task was found
+	 */
+	bool pop_task(int32_t id, Task& task);
+
+	/** @return queue of the calling thread, -1 if it is not a worker */
+	int32_t current_queue() const;
+
+private:
+	/** one queue per worker */
+	std::vector<std::unique_ptr<WorkQueue>> m_queues;
+	/** worker threads */
+	std::vector<std::thread> m_workers;
+	/** number of queued tasks */
+	std::atomic<int64_t> m_pending;
+	/** round robin counter for tasks from non-worker threads */
+	std::atomic<uint32_t> m_next_queue;
+	/** protects sleeping and stopping */
+	std::mutex m_sleep_mutex;
+	/** wakes up sleeping workers */
+	std::condition_variable m_wakeup;
+	/** whether the workers shall terminate */
+	bool m_stop;
+};
+}
+#endif // THREAD_POOL_H__
@@ -0,0 +1,72 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/base/ThreadPool.h"
+
+#include <thread>
+#include <vector>
+
+namespace shogun
+{
+
+static const int32_t num_threads = 4;
+
+/* mimics the work done for one entry of a small working set */
+static void work(std::vector<float64_t>& out, index_t start, index_t end)
+{
+	for (index_t i = start; i < end; i++)
+	{
+		float64_t sum = 0;
+		for (int32_t j = 0; j < 1000; j++)
+			sum += (i + j) * 1e-3;
+		out[i] = sum;
+	}
+}
+
+/* one parallel section per iteration by creating and joining threads, as
+ * the pthread based solvers used to do
+ */
+static void BM_ThreadPool_spawn_join(benchmark::State& state)
+{
+	const index_t num = state.range(0);
+	std::vector<float64_t> out(num);
+
+	for (auto _ : state)
+	{
+		std::vector<std::thread> threads;
+		const index_t step = num / num_threads;
+		for (int32_t t = 0; t < num_threads - 1; t++)
+			threads.emplace_back(
+			    work, std::ref(out), t * step, (t + 1) * step);
+		work(out, (num_threads - 1) * step, num);
+		for (auto& thread : threads)
+			thread.join();
+		benchmark::DoNotOptimize(out.data());
+	}
+}
+
+/* one parallel section per iteration submitted to a persistent pool */
+static void BM_ThreadPool_parallel_for(benchmark::State& state)
+{
+	const index_t num = state.range(0);
+	std::vector<float64_t> out(num);
+	ThreadPool pool(num_threads);
+
+	for (auto _ : state)
+	{
+		pool.parallel_for(0, num, [&](index_t start, index_t end) {
+			work(out, start, end);
+		});
+		benchmark::DoNotOptimize(out.data());
+	}
+}
+
+BENCHMARK(BM_ThreadPool_spawn_join)->Arg(10)->Arg(20)->Arg(50)->Arg(1000);
+BENCHMARK(BM_ThreadPool_parallel_for)->Arg(10)->Arg(20)->Arg(50)->Arg(1000);
+
+}
@@ -8,6 +8,7 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/base/Parameter.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/base/progress.h>
 #include <shogun/classifier/svm/LibLinear.h>
 #include <shogun/features/DotFeatures.h>
@@ -19,6 +20,7 @@
 #include <shogun/mathematics/RandomNamespace.h>
 #include <shogun/mathematics/UniformIntDistribution.h>
 
+#include <vector>
 
 using namespace shogun;
 
@@ -52,12 +54,16 @@ void CLibLinear::init()
 	set_C(1, 1);
 	set_max_iterations();
 	set_epsilon(1e-5);
+	set_parallel_coordinate_descent(false);
 
 	SG_ADD(&C1, "C1", "C Cost constant 1.", ParameterProperties::HYPER);
 	SG_ADD(&C2, "C2", "C Cost constant 2.", ParameterProperties::HYPER);
 	SG_ADD(&use_bias, "use_bias", "Indicates if bias is used.");
 	SG_ADD(&epsilon, "epsilon", "Convergence precision.");
 	SG_ADD(&max_iterations, "max_iterations", "Max number of iterations.");
+	SG_ADD(
+	    &m_parallel_coordinate_descent, "parallel_coordinate_descent",
+	    "Whether the dual coordinate descent is parallel.");
 	SG_ADD(&m_linear_term, "linear_term", "Linear Term");
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&liblinear_solver_type, "liblinear_solver_type",
@@ -165,6 +171,17 @@ bool CLibLinear::train_machine(CFeatures* data)
 
 	io::info("{} training points {} dims", prob.l, prob.n);
 
+	const int32_t num_threads =
+	    get_parallel_coordinate_descent() ? env()->get_num_threads() : 1;
+	if (get_parallel_coordinate_descent() &&
+	    solver_type != L2R_L2LOSS_SVC_DUAL &&
+	    solver_type != L2R_L1LOSS_SVC_DUAL)
+	{
+		io::warn(
+		    "Parallel coordinate descent is only supported by the dual SVM "
+		    "solvers, training sequentially");
+	}
+
 	function* fun_obj = NULL;
 	switch (solver_type)
 	{
@@ -191,12 +208,9 @@ bool CLibLinear::train_machine(CFeatures* data)
 		break;
 	}
 	case L2R_L2LOSS_SVC_DUAL:
-		solve_l2r_l1l2_svc(
-		    w, &prob, get_epsilon(), Cp, Cn, L2R_L2LOSS_SVC_DUAL);
-		break;
 	case L2R_L1LOSS_SVC_DUAL:
 		solve_l2r_l1l2_svc(
-		    w, &prob, get_epsilon(), Cp, Cn, L2R_L1LOSS_SVC_DUAL);
+		    w, &prob, get_epsilon(), Cp, Cn, solver_type, num_threads);
 		break;
 	case L1R_L2LOSS_SVC:
 	{
@@ -263,22 +277,26 @@ bool CLibLinear::train_machine(CFeatures* data)
 #define GETI(i) (y[i] + 1)
 // To support weights for instances, use GETI(i) (i)
 
+// With more than one thread the descent is parallel (PASSCoDe-Atomic,
+// Hsieh et al. 2015). The training vectors are partitioned over the
+// threads, every thread shrinks and descends on its own partition. w is
+// read without locking and the updates of the dual variables are added
+// to it atomically, such that no update is lost.
+
 void CLibLinear::solve_l2r_l1l2_svc(
     SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
-    double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st)
+    double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st, int32_t num_threads)
 {
-	int l = prob->l;
-	int w_size = prob->n;
-	int i, s, iter = 0;
-	double C, d, G;
-	double* QD = SG_MALLOC(double, l);
-	int* index = SG_MALLOC(int, l);
-	double* alpha = SG_MALLOC(double, l);
-	int32_t* y = SG_MALLOC(int32_t, l);
-	int active_size = l;
+	const int l = prob->l;
+	const int w_size = prob->n;
+	num_threads = CMath::max(CMath::min(num_threads, l), 1);
+	int iter = 0;
+	SGVector<float64_t> QD(l);
+	SGVector<int32_t> index(l);
+	SGVector<float64_t> alpha(l);
+	SGVector<int32_t> y(l);
 
 	// PG: projected gradient, for shrinking and stopping
-	double PG;
 	double PGmax_old = CMath::INFTY;
 	double PGmin_old = -CMath::INFTY;
 	double PGmax_new, PGmin_new;
@@ -305,26 +323,35 @@ void CLibLinear::solve_l2r_l1l2_svc(
 	if (prob->use_bias)
 		n--;
 
-	for (i = 0; i < w_size; i++)
+	for (int i = 0; i < w_size; i++)
 		w[i] = 0;
 
-	for (i = 0; i < l; i++)
+#pragma omp parallel for num_threads(num_threads)
+	for (int i = 0; i < l; i++)
 	{
 		alpha[i] = 0;
-		if (prob->y[i] > 0)
-		{
-			y[i] = +1;
-		}
-		else
-		{
-			y[i] = -1;
-		}
-		QD[i] = diag[GETI(i)];
-
-		QD[i] += prob->x->dot(i, prob->x, i);
+		y[i] = prob->y[i] > 0 ? +1 : -1;
+		QD[i] = diag[GETI(i)] + prob->x->dot(i, prob->x, i);
 		index[i] = i;
 	}
 
+	// thread t owns the vectors index[first[t]] to index[first[t+1]-1],
+	// the active ones are at the beginning of its range
+	SGVector<int32_t> first(num_threads + 1);
+	SGVector<int32_t> active_size(num_threads);
+	for (int32_t t = 0; t <= num_threads; t++)
+		first[t] = int64_t(l) * t / num_threads;
+	for (int32_t t = 0; t < num_threads; t++)
+		active_size[t] = first[t + 1] - first[t];
+
+	// a single thread shuffles with the machine's generator
+	std::vector<decltype(m_prng)> prngs;
+	if (num_threads > 1)
+	{
+		for (int32_t t = 0; t < num_threads; t++)
+			prngs.emplace_back(m_prng());
+	}
+
 	auto pb = SG_PROGRESS(range(10));
 	CTime start_time;
 	while (iter < get_max_iterations())
@@ -337,66 +364,98 @@ void CLibLinear::solve_l2r_l1l2_svc(
 		PGmax_new = -CMath::INFTY;
 		PGmin_new = CMath::INFTY;
 
-		random::shuffle(index, index+active_size, m_prng);
-
-		for (s = 0; s < active_size; s++)
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)         \
+    reduction(max : PGmax_new) reduction(min : PGmin_new)
+		for (int32_t t = 0; t < num_threads; t++)
 		{
-			i = index[s];
-			int32_t yi = y[i];
+			int32_t* part = index.vector + first[t];
+			int32_t& active = active_size[t];
+			if (num_threads > 1)
+				random::shuffle(part, part + active, prngs[t]);
+			else
+				random::shuffle(part, part + active, m_prng);
 
-			G = prob->x->dot(i, w.slice(0, n));
-			if (prob->use_bias)
-				G += w.vector[n];
+			for (int s = 0; s < active; s++)
+			{
+				const int i = part[s];
+				const int32_t yi = y[i];
 
-			if (linear_term.vector)
-				G = G * yi + linear_term.vector[i];
-			else
-				G = G * yi - 1;
+				double G = prob->x->dot(i, w.slice(0, n));
+				if (prob->use_bias)
+					G += w.vector[n];
 
-			C = upper_bound[GETI(i)];
-			G += alpha[i] * diag[GETI(i)];
+				if (linear_term.vector)
+					G = G * yi + linear_term.vector[i];
+				else
+					G = G * yi - 1;
 
-			PG = 0;
-			if (alpha[i] == 0)
-			{
-				if (G > PGmax_old)
+				const double C = upper_bound[GETI(i)];
+				G += alpha[i] * diag[GETI(i)];
+
+				double PG = 0;
+				if (alpha[i] == 0)
 				{
-					active_size--;
-					CMath::swap(index[s], index[active_size]);
-					s--;
-					continue;
+					if (G > PGmax_old)
+					{
+						active--;
+						CMath::swap(part[s], part[active]);
+						s--;
+						continue;
+					}
+					else if (G < 0)
+						PG = G;
 				}
-				else if (G < 0)
-					PG = G;
-			}
-			else if (alpha[i] == C)
-			{
-				if (G < PGmin_old)
+				else if (alpha[i] == C)
 				{
-					active_size--;
-					CMath::swap(index[s], index[active_size]);
-					s--;
-					continue;
+					if (G < PGmin_old)
+					{
+						active--;
+						CMath::swap(part[s], part[active]);
+						s--;
+						continue;
+					}
+					else if (G > 0)
+						PG = G;
 				}
-				else if (G > 0)
+				else
 					PG = G;
-			}
-			else
-				PG = G;
 
-			PGmax_new = CMath::max(PGmax_new, PG);
-			PGmin_new = CMath::min(PGmin_new, PG);
+				PGmax_new = CMath::max(PGmax_new, PG);
+				PGmin_new = CMath::min(PGmin_new, PG);
 
-			if (fabs(PG) > 1.0e-12)
-			{
-				double alpha_old = alpha[i];
-				alpha[i] = CMath::min(CMath::max(alpha[i] - G / QD[i], 0.0), C);
-				d = (alpha[i] - alpha_old) * yi;
+				if (fabs(PG) > 1.0e-12)
+				{
+					double alpha_old = alpha[i];
+					alpha[i] =
+					    CMath::min(CMath::max(alpha[i] - G / QD[i], 0.0), C);
+					const double d = (alpha[i] - alpha_old) * yi;
 
-				prob->x->add_to_dense_vec(d, i, w.vector, n);
+					if (num_threads == 1)
+					{
+						prob->x->add_to_dense_vec(d, i, w.vector, n);
 
-				if (prob->use_bias)
-					w.vector[n] += d;
+						if (prob->use_bias)
+							w.vector[n] += d;
+					}
+					else
+					{
+						int32_t j;
+						float64_t value;
+						void* it = prob->x->get_feature_iterator(i);
+						while (prob->x->get_next_feature(j, value, it))
+						{
+#pragma omp atomic
+							w.vector[j] += d * value;
+						}
+						prob->x->free_feature_iterator(it);
+
+						if (prob->use_bias)
+						{
+#pragma omp atomic
+							w.vector[n] += d;
+						}
+					}
+				}
 			}
 		}
 
@@ -408,11 +467,12 @@ void CLibLinear::solve_l2r_l1l2_svc(
 
 		if (gap <= eps)
 		{
-			if (active_size == l)
+			if (SGVector<int32_t>::sum(active_size) == l)
 				break;
 			else
 			{
-				active_size = l;
+				for (int32_t t = 0; t < num_threads; t++)
+					active_size[t] = first[t + 1] - first[t];
 				PGmax_old = CMath::INFTY;
 				PGmin_old = -CMath::INFTY;
 				continue;
@@ -439,9 +499,9 @@ void CLibLinear::solve_l2r_l1l2_svc(
 
 	double v = 0;
 	int nSV = 0;
-	for (i = 0; i < w_size; i++)
+	for (int i = 0; i < w_size; i++)
 		v += w.vector[i] * w.vector[i];
-	for (i = 0; i < l; i++)
+	for (int i = 0; i < l; i++)
 	{
 		v += alpha[i] * (alpha[i] * diag[GETI(i)] - 2);
 		if (alpha[i] > 0)
@@ -449,11 +509,6 @@ void CLibLinear::solve_l2r_l1l2_svc(
 	}
 	io::info("Objective value = {}", v / 2);
 	io::info("nSV = {}", nSV);
-
-	SG_FREE(QD);
-	SG_FREE(alpha);
-	SG_FREE(y);
-	SG_FREE(index);
 }
 
 // A coordinate descent algorithm for
@@ -193,6 +193,29 @@ namespace shogun
 			max_iterations = max_iter;
 		}
 
+		/** set whether the dual coordinate descent solvers
+		 * L2R_L1LOSS_SVC_DUAL and L2R_L2LOSS_SVC_DUAL update the dual
+		 * variables in parallel
+		 *
+		 * Every thread descends on its own partition of the training
+		 * vectors and adds its updates to the shared w atomically, while
+		 * the other threads read w without locking (PASSCoDe). The
+		 * solution converges to the sequential one, but depends on the
+		 * scheduling of the threads.
+		 *
+		 * @param parallel whether to solve in parallel
+		 */
+		inline void set_parallel_coordinate_descent(bool parallel)
+		{
+			m_parallel_coordinate_descent = parallel;
+		}
+
+		/** @return whether the dual coordinate descent is parallel */
+		inline bool get_parallel_coordinate_descent()
+		{
+			return m_parallel_coordinate_descent;
+		}
+
 		/** set the linear term for qp */
 		void set_linear_term(const SGVector<float64_t> linear_term);
 
@@ -233,7 +256,8 @@ namespace shogun
 		    double Cp, double Cn);
 		void solve_l2r_l1l2_svc(
 		    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
-		    double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st);
+		    double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st,
+		    int32_t num_threads = 1);
 
 		void solve_l1r_l2_svc(
 		    SGVector<float64_t>& w, liblinear_problem* prob_col, double eps,
@@ -256,6 +280,8 @@ namespace shogun
 		float64_t epsilon;
 		/** maximum number of iterations */
 		int32_t max_iterations;
+		/** whether the dual coordinate descent is parallel */
+		bool m_parallel_coordinate_descent;
 
 		/** precomputed linear term */
 		SGVector<float64_t> m_linear_term;
@@ -43,6 +43,7 @@
 #endif
 
 #include <shogun/base/Parallel.h>
+#include <shogun/base/ThreadPool.h>
 #include <shogun/labels/BinaryLabels.h>
 
 #include <stdio.h>
@@ -51,11 +52,6 @@
 #include <stdlib.h>
 #include <time.h>
 
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-
-#endif
-
 using namespace shogun;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -80,20 +76,6 @@ struct S_THREAD_PARAM_SVMLIGHT
 	CKernel* kernel ;
 };
 
-struct S_THREAD_PARAM_REACTIVATE_VANILLA
-{
-	CKernel* kernel;
-	float64_t* lin;
-	float64_t* aicache;
-	float64_t* a;
-	float64_t* a_old;
-	int32_t* changed2dnum;
-	int32_t* inactive2dnum;
-	int32_t* label;
-	int32_t start;
-	int32_t end;
-};
-
 struct S_THREAD_PARAM_KERNEL
 {
 	float64_t *Kval ;
@@ -1057,19 +1039,13 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 	float64_t *a, float64_t *lin, float64_t *c, int32_t varnum, int32_t totdoc,
 	float64_t *aicache, QP *qp)
 {
-	// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-	int32_t num_threads=env()->get_num_threads();
-#else
-	int32_t num_threads=1;
-#endif
-	if (num_threads < 2)
+	auto pool=env()->get_thread_pool();
+	if (pool->get_num_threads() < 2)
 	{
 		compute_matrices_for_optimization(docs, label, exclude_from_eq_const, eq_target,
 												   chosen, active2dnum, key, a, lin, c,
 												   varnum, totdoc, aicache, qp) ;
 	}
-#ifdef HAVE_PTHREAD
 	else
 	{
 		int32_t ki,kj,i,j;
@@ -1093,7 +1069,6 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 			qp->opt_g0[i]=lin[key[i]];
 		}
 
-		ASSERT(num_threads>1)
 		int32_t *KI=SG_MALLOC(int32_t, varnum*varnum);
 		int32_t *KJ=SG_MALLOC(int32_t, varnum*varnum);
 		int32_t Knum=0 ;
@@ -1113,28 +1088,17 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 		}
 		ASSERT(Knum<=varnum*(varnum+1)/2)
 
-		pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-		S_THREAD_PARAM_KERNEL* params = SG_MALLOC(S_THREAD_PARAM_KERNEL, num_threads-1);
-		int32_t step= Knum/num_threads;
-		//SG_DEBUG("\nkernel-step size: {}", step)
-		for (int32_t t=0; t<num_threads-1; t++)
+		pool->parallel_for(0, Knum, [&](index_t start, index_t end)
 		{
-			params[t].svmlight = this;
-			params[t].start = t*step;
-			params[t].end = (t+1)*step;
-			params[t].KI=KI ;
-			params[t].KJ=KJ ;
-			params[t].Kval=Kval ;
-			pthread_create(&threads[t], NULL, CSVMLight::compute_kernel_helper, (void*)&params[t]);
-		}
-		for (i=params[num_threads-2].end; i<Knum; i++)
-			Kval[i]=compute_kernel(KI[i],KJ[i]) ;
-
-		for (int32_t t=0; t<num_threads-1; t++)
-			pthread_join(threads[t], NULL);
-
-		SG_FREE(params);
-		SG_FREE(threads);
+			S_THREAD_PARAM_KERNEL params;
+			params.svmlight = this;
+			params.start = start;
+			params.end = end;
+			params.KI=KI ;
+			params.KJ=KJ ;
+			params.Kval=Kval ;
+			compute_kernel_helper((void*) &params);
+		});
 
 		Knum=0 ;
 		for (i=0;i<varnum;i++) {
@@ -1186,7 +1150,6 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 			io::progress_done();
 		}
 	}
-#endif
 }
 
 void CSVMLight::compute_matrices_for_optimization(
@@ -1472,54 +1435,30 @@ void CSVMLight::update_linear_component(
 
 			if (num_working>0)
 			{
-				// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-				int32_t num_threads=env()->get_num_threads();
-#else
-				int32_t num_threads=1;
-#endif
-				if (num_threads < 2)
+				auto pool=env()->get_thread_pool();
+				if (pool->get_num_threads() < 2)
 				{
 					for (jj=0;(j=active2dnum[jj])>=0;jj++) {
 						lin[j]+=kernel->compute_optimized(docs[j]);
 					}
 				}
-#ifdef HAVE_PTHREAD
 				else
 				{
 					int32_t num_elem = 0 ;
 					for (jj=0;(j=active2dnum[jj])>=0;jj++) num_elem++ ;
 
-					pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-					S_THREAD_PARAM_SVMLIGHT* params = SG_MALLOC(S_THREAD_PARAM_SVMLIGHT, num_threads-1);
-					int32_t start = 0 ;
-					int32_t step = num_elem/num_threads;
-					int32_t end = step ;
-
-					for (int32_t t=0; t<num_threads-1; t++)
+					pool->parallel_for(0, num_elem, [&](index_t start, index_t end)
 					{
-						params[t].kernel = kernel ;
-						params[t].lin = lin ;
-						params[t].docs = docs ;
-						params[t].active2dnum=active2dnum ;
-						params[t].start = start ;
-						params[t].end = end ;
-						start=end ;
-						end+=step ;
-						pthread_create(&threads[t], NULL, update_linear_component_linadd_helper, (void*)&params[t]) ;
-					}
-
-					for (jj=params[num_threads-2].end;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(docs[j]);
-					}
-					void* ret;
-					for (int32_t t=0; t<num_threads-1; t++)
-						pthread_join(threads[t], &ret) ;
-
-					SG_FREE(params);
-					SG_FREE(threads);
+						S_THREAD_PARAM_SVMLIGHT params;
+						params.kernel = kernel ;
+						params.lin = lin ;
+						params.docs = docs ;
+						params.active2dnum=active2dnum ;
+						params.start = start ;
+						params.end = end ;
+						update_linear_component_linadd_helper((void*) &params);
+					});
 				}
-#endif
 			}
 		}
 	}
@@ -1651,45 +1590,16 @@ void CSVMLight::update_linear_component_mkl_linadd(
 			kernel->add_to_normal(docs[i], (a[i]-a_old[i])*(float64_t)label[i]);
 		}
 	}
-	// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-	int32_t num_threads=env()->get_num_threads();
-#else
-	int32_t num_threads=1;
-#endif
-
-	if (num_threads < 2)
-	{
-		// determine contributions of different kernels
-		for (int32_t i=0; i<num; i++)
-			kernel->compute_by_subkernel(i,&W[i*num_kernels]);
-	}
-#ifdef HAVE_PTHREAD
-	else
+	// determine contributions of different kernels
+	env()->get_thread_pool()->parallel_for(0, num, [&](index_t start, index_t end)
 	{
-		pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-		S_THREAD_PARAM_SVMLIGHT* params = SG_MALLOC(S_THREAD_PARAM_SVMLIGHT, num_threads-1);
-		int32_t step= num/num_threads;
-
-		for (int32_t t=0; t<num_threads-1; t++)
-		{
-			params[t].kernel = kernel;
-			params[t].W = W;
-			params[t].start = t*step;
-			params[t].end = (t+1)*step;
-			pthread_create(&threads[t], NULL, CSVMLight::update_linear_component_mkl_linadd_helper, (void*)&params[t]);
-		}
-
-		for (int32_t i=params[num_threads-2].end; i<num; i++)
-			kernel->compute_by_subkernel(i,&W[i*num_kernels]);
-
-		for (int32_t t=0; t<num_threads-1; t++)
-			pthread_join(threads[t], NULL);
-
-		SG_FREE(params);
-		SG_FREE(threads);
-	}
-#endif
+		S_THREAD_PARAM_SVMLIGHT params;
+		params.kernel = kernel;
+		params.W = W;
+		params.start = start;
+		params.end = end;
+		update_linear_component_mkl_linadd_helper((void*) &params);
+	});
 
 	// restore old weights
 	kernel->set_subkernel_weights(SGVector<float64_t>(w_backup,num_weights));
@@ -2085,43 +1995,6 @@ void* CSVMLight::reactivate_inactive_examples_linadd_helper(void* p)
 	return NULL;
 }
 
-void* CSVMLight::reactivate_inactive_examples_vanilla_helper(void* p)
-{
-	S_THREAD_PARAM_REACTIVATE_VANILLA* params = (S_THREAD_PARAM_REACTIVATE_VANILLA*) p;
-	ASSERT(params)
-	ASSERT(params->kernel)
-	ASSERT(params->lin)
-	ASSERT(params->aicache)
-	ASSERT(params->a)
-	ASSERT(params->a_old)
-	ASSERT(params->changed2dnum)
-	ASSERT(params->inactive2dnum)
-	ASSERT(params->label)
-
-	CKernel* k = params->kernel;
-	float64_t* lin = params->lin;
-	float64_t* aicache = params->aicache;
-	float64_t* a= params->a;
-	float64_t* a_old = params->a_old;
-	int32_t* changed2dnum = params->changed2dnum;
-	int32_t* inactive2dnum = params->inactive2dnum;
-	int32_t* label = params->label;
-	int32_t start = params->start;
-	int32_t end = params->end;
-
-	for (int32_t ii=start;ii<end;ii++)
-	{
-		int32_t i=changed2dnum[ii];
-		int32_t j=0;
-		ASSERT(i>=0)
-
-		k->get_kernel_row(i,inactive2dnum,aicache);
-		for (int32_t jj=0;(j=inactive2dnum[jj])>=0;jj++)
-			lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
-	}
-	return NULL;
-}
-
 void CSVMLight::reactivate_inactive_examples(
 	int32_t* label, float64_t *a, SHRINK_STATE *shrink_state, float64_t *lin,
 	float64_t *c, int32_t totdoc, int32_t iteration, int32_t *inconsistent,
@@ -2154,14 +2027,7 @@ void CSVMLight::reactivate_inactive_examples(
 
 		  if (num_modified>0)
 		  {
-		  		// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-				int32_t num_threads=env()->get_num_threads();
-#else
-				int32_t num_threads=1;
-#endif
-			  ASSERT(num_threads>0)
-			  if (num_threads < 2)
+			  env()->get_thread_pool()->parallel_for(0, totdoc, [&](index_t start, index_t end)
 			  {
 				  S_THREAD_PARAM_REACTIVATE_LINADD params;
 				  params.kernel=kernel;
@@ -2169,46 +2035,10 @@ void CSVMLight::reactivate_inactive_examples(
 				  params.last_lin=shrink_state->last_lin;
 				  params.docs=docs;
 				  params.active=shrink_state->active;
-				  params.start=0;
-				  params.end=totdoc;
+				  params.start=start;
+				  params.end=end;
 				  reactivate_inactive_examples_linadd_helper((void*) &params);
-			  }
-#ifdef HAVE_PTHREAD
-			  else
-			  {
-				  pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-				  S_THREAD_PARAM_REACTIVATE_LINADD* params = SG_MALLOC(S_THREAD_PARAM_REACTIVATE_LINADD, num_threads);
-				  int32_t step= totdoc/num_threads;
-
-				  for (t=0; t<num_threads-1; t++)
-				  {
-					  params[t].kernel=kernel;
-					  params[t].lin=lin;
-					  params[t].last_lin=shrink_state->last_lin;
-					  params[t].docs=docs;
-					  params[t].active=shrink_state->active;
-					  params[t].start = t*step;
-					  params[t].end = (t+1)*step;
-					  pthread_create(&threads[t], NULL, CSVMLight::reactivate_inactive_examples_linadd_helper, (void*)&params[t]);
-				  }
-
-				  params[t].kernel=kernel;
-				  params[t].lin=lin;
-				  params[t].last_lin=shrink_state->last_lin;
-				  params[t].docs=docs;
-				  params[t].active=shrink_state->active;
-				  params[t].start = t*step;
-				  params[t].end = totdoc;
-				  reactivate_inactive_examples_linadd_helper((void*) &params[t]);
-
-				  for (t=0; t<num_threads-1; t++)
-					  pthread_join(threads[t], NULL);
-
-				  SG_FREE(threads);
-				  SG_FREE(params);
-			  }
-#endif
-
+			  });
 		  }
 	  }
 	  else
@@ -2294,85 +2124,13 @@ void CSVMLight::reactivate_inactive_examples(
 		  compute_index(changed,totdoc,changed2dnum);
 
 
-		  //TODO: PUT THIS BACK IN!!!!!!!! int32_t num_threads=env()->get_num_threads();
-		  int32_t num_threads=1;
-		  ASSERT(num_threads>0)
-
-		  if (num_threads < 2)
-		  {
-			  for (ii=0;(i=changed2dnum[ii])>=0;ii++) {
-				  kernel->get_kernel_row(i,inactive2dnum,aicache);
-				  for (jj=0;(j=inactive2dnum[jj])>=0;jj++)
-					  lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
-			  }
+		  // get_kernel_row updates the kernel cache and must not run
+		  // concurrently, hence this stays serial
+		  for (ii=0;(i=changed2dnum[ii])>=0;ii++) {
+			  kernel->get_kernel_row(i,inactive2dnum,aicache);
+			  for (jj=0;(j=inactive2dnum[jj])>=0;jj++)
+				  lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
 		  }
-#ifdef HAVE_PTHREAD
-		  else
-		  {
-			  //find number of the changed ones
-			  int32_t num_changed=0;
-			  for (ii=0;changed2dnum[ii]>=0;ii++)
-				  num_changed++;
-
-			  if (num_changed>0)
-			  {
-				  pthread_t* threads= SG_MALLOC(pthread_t, num_threads-1);
-				  S_THREAD_PARAM_REACTIVATE_VANILLA* params = SG_MALLOC(S_THREAD_PARAM_REACTIVATE_VANILLA, num_threads);
-				  int32_t step= num_changed/num_threads;
-
-				  // alloc num_threads many tmp buffers
-				  float64_t* tmp_lin=SG_MALLOC(float64_t, totdoc*num_threads);
-				  memset(tmp_lin, 0, sizeof(float64_t)*((size_t) totdoc)*num_threads);
-				  float64_t* tmp_aicache=SG_MALLOC(float64_t, totdoc*num_threads);
-				  memset(tmp_aicache, 0, sizeof(float64_t)*((size_t) totdoc)*num_threads);
-
-				  int32_t thr;
-				  for (thr=0; thr<num_threads-1; thr++)
-				  {
-					  params[thr].kernel=kernel;
-					  params[thr].lin=&tmp_lin[thr*totdoc];
-					  params[thr].aicache=&tmp_aicache[thr*totdoc];
-					  params[thr].a=a;
-					  params[thr].a_old=a_old;
-					  params[thr].changed2dnum=changed2dnum;
-					  params[thr].inactive2dnum=inactive2dnum;
-					  params[thr].label=label;
-					  params[thr].start = thr*step;
-					  params[thr].end = (thr+1)*step;
-					  pthread_create(&threads[thr], NULL, CSVMLight::reactivate_inactive_examples_vanilla_helper, (void*)&params[thr]);
-				  }
-
-				  params[thr].kernel=kernel;
-				  params[thr].lin=&tmp_lin[thr*totdoc];
-				  params[thr].aicache=&tmp_aicache[thr*totdoc];
-				  params[thr].a=a;
-				  params[thr].a_old=a_old;
-				  params[thr].changed2dnum=changed2dnum;
-				  params[thr].inactive2dnum=inactive2dnum;
-				  params[thr].label=label;
-				  params[thr].start = thr*step;
-				  params[thr].end = num_changed;
-				  reactivate_inactive_examples_vanilla_helper((void*) &params[thr]);
-
-				  for (jj=0;(j=inactive2dnum[jj])>=0;jj++)
-					  lin[j]+=tmp_lin[totdoc*thr+j];
-
-				  for (thr=0; thr<num_threads-1; thr++)
-				  {
-					  pthread_join(threads[thr], NULL);
-
-					  //add up results
-					  for (jj=0;(j=inactive2dnum[jj])>=0;jj++)
-						  lin[j]+=tmp_lin[totdoc*thr+j];
-				  }
-
-				  SG_FREE(tmp_lin);
-				  SG_FREE(tmp_aicache);
-				  SG_FREE(threads);
-				  SG_FREE(params);
-			  }
-		  }
-#endif
 	  }
 	  SG_FREE(changed);
 	  SG_FREE(changed2dnum);
@@ -622,12 +622,6 @@ protected:
 	 */
 	static void* update_linear_component_linadd_helper(void* p);
 
-	/** helper for reactivate inactive examples vanilla
-	 *
-	 * @param p p
-	 */
-	static void* reactivate_inactive_examples_vanilla_helper(void* p);
-
 	/** helper for reactivate inactive examples linadd
 	 *
 	 * @param p p
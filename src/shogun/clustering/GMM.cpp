@@ -14,6 +14,7 @@
 #include <shogun/clustering/KMeans.h>
 #include <shogun/distance/EuclideanDistance.h>
 #include <shogun/labels/MulticlassLabels.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/lib/observers/ObservedValueTemplated.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
@@ -568,10 +569,9 @@ void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov)
 		for (int32_t j=0; j<alpha.num_rows; j++)
 		{
 			alpha_sum+=alpha.matrix[j*alpha.num_cols+i];
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(j);
-			linalg::add(
-			    v, mean_sum, mean_sum, alpha.matrix[j * alpha.num_cols + i],
-			    1.0);
+			dotdata->add_to_dense_vec(
+			    alpha.matrix[j * alpha.num_cols + i], j, mean_sum.vector,
+			    num_dim);
 		}
 
 		linalg::scale(mean_sum, mean_sum, 1.0 / alpha_sum);
@@ -599,7 +599,10 @@ void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov)
 
 		for (int32_t j=0; j<alpha.num_rows; j++)
 		{
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(j);
+			// the centered vector only lives for one iteration
+			ScopedArena scope;
+			SGVector<float64_t> v(num_dim, scope.arena());
+			dotdata->add_to_dense_vec(1.0, j, v.vector, num_dim);
 
 			linalg::add(v, mean_sum, v, 1.0, -1.0);
 			switch (cov_type)
@@ -610,7 +613,8 @@ void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov)
 				    break;
 			    case DIAG:
 			    {
-				    auto temp_matrix = SGMatrix<float64_t>(v.vector, 1, v.vlen);
+				    auto temp_matrix =
+				        SGMatrix<float64_t>(v.vector, 1, v.vlen, false);
 				    auto temp_result = linalg::matrix_prod(
 				        temp_matrix, temp_matrix, true, false);
 				    cov_sum = temp_result.get_diagonal_vector().clone();
@@ -6,6 +6,7 @@
  *          Bjoern Esser, parijat
  */
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/base/progress.h>
 #include <shogun/clustering/KMeans.h>
 #include <shogun/distance/Distance.h>
@@ -40,6 +41,14 @@ CKMeans::~CKMeans()
 
 void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 {
+	if (kmeans_algorithm!=KMEANS_LLOYD)
+	{
+		if (!fixed_centers)
+			return bounded_KMeans(centers, num_centers);
+
+		io::warn("Centers are updated during the assignment, using Lloyd's algorithm");
+	}
+
 	CDenseFeatures<float64_t>* lhs =
 		distance->get_lhs()->as<CDenseFeatures<float64_t>>();
 
@@ -57,6 +66,10 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 	/* Initially set all weights for zeroth cluster, Changes in assignement step */
 	weights_set[0]=lhs_size;
 
+	/* points of every cluster, used by the update step */
+	SGVector<int32_t> cluster_members(lhs_size);
+	SGVector<int64_t> cluster_offsets(num_centers+1);
+
 	distance->precompute_lhs();
 
 	int32_t changed=1;
@@ -96,13 +109,14 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 			if (min_cluster!=cluster_assignments_i)
 			{
 				changed++;
-#pragma omp atomic
-				++weights_set[min_cluster];
-#pragma omp atomic
-				--weights_set[cluster_assignments_i];
 
+				/* the assignment is sequential when centers are updated
+				 * here, otherwise the weights are counted in the update step */
 				if(fixed_centers)
 				{
+					++weights_set[min_cluster];
+					--weights_set[cluster_assignments_i];
+
 					SGVector<float64_t>vec=lhs->get_feature_vector(i);
 					float64_t temp_min = 1.0 / weights_set[min_cluster];
 
@@ -146,28 +160,255 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 
 		/* Update Step : Calculate new means */
 		if (!fixed_centers)
-		{
-			/* mus=zeros(dim, num_centers) ; */
-			centers.zero();
+			update_centers(
+				lhs, cluster_assignments, centers, weights_set,
+				cluster_members, cluster_offsets);
+
+		observe<SGMatrix<float64_t>>(iter, "mus");
+
+		if (iter%(max_iter/10) == 0)
+			io::info("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed);
+	}
+	distance->reset_precompute();
+	distance->replace_rhs(rhs_cache);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs_cache);
+}
+
+void CKMeans::bounded_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
+{
+	require(
+	    distance->get_distance_type()==D_EUCLIDEAN &&
+	        !distance->as<CEuclideanDistance>()->get_disable_sqrt(),
+	    "The bounds of {} require an euclidean distance that is not squared",
+	    kmeans_algorithm==KMEANS_ELKAN ? "Elkan's algorithm" : "Hamerly's algorithm");
+
+	CDenseFeatures<float64_t>* lhs =
+		distance->get_lhs()->as<CDenseFeatures<float64_t>>();
+
+	int32_t lhs_size=lhs->get_num_vectors();
+	int32_t dim=lhs->get_num_features();
+	const bool elkan=kmeans_algorithm==KMEANS_ELKAN;
+
+	auto rhs_cache = distance->get_rhs();
 
+	SGVector<int32_t> cluster_assignments(lhs_size);
+	cluster_assignments.zero();
+	SGVector<int64_t> weights_set(num_centers);
+	SGVector<int32_t> cluster_members(lhs_size);
+	SGVector<int64_t> cluster_offsets(num_centers+1);
+
+	/* upper bound of the distance of a point to its center and lower bounds
+	 * of the distances to the other centers, one per center for Elkan's
+	 * algorithm and one for all of them for Hamerly's algorithm */
+	SGVector<float64_t> upper(lhs_size);
+	SGMatrix<float64_t> lower(elkan ? num_centers : 1, lhs_size);
+
+	/* distances between the centers, half the distance to the closest other
+	 * center and the distance the centers moved */
+	SGMatrix<float64_t> center_dists(num_centers, num_centers);
+	SGVector<float64_t> half_min_dists(num_centers);
+	SGVector<float64_t> drifts(num_centers);
+
+	distance->precompute_lhs();
+
+	for (auto iter : SG_PROGRESS(range(max_iter)))
+	{
+		if (iter==max_iter-1)
+			io::warn("KMeans clustering has reached maximum number of ( {} ) iterations without having converged. \
+				   	Terminating. ", iter);
+
+		int32_t changed=0;
+		auto rhs_mus = some<CDenseFeatures<float64_t>>(centers.clone());
+		distance->replace_rhs(rhs_mus);
+
+		if (iter==0)
+		{
+			/* the bounds are initialised with the distances to all centers */
+#pragma omp parallel for reduction(+:changed)
 			for (int32_t i=0; i<lhs_size; i++)
 			{
-				int32_t cluster_i=cluster_assignments[i];
+				int32_t min_cluster=0;
+				float64_t min_dist=distance->distance(i, 0);
+				float64_t second_dist=CMath::INFTY;
+				if (elkan)
+					lower(0, i)=min_dist;
+
+				for (int32_t j=1; j<num_centers; j++)
+				{
+					float64_t dist=distance->distance(i, j);
+					if (elkan)
+						lower(j, i)=dist;
+
+					if (dist<min_dist)
+					{
+						second_dist=min_dist;
+						min_dist=dist;
+						min_cluster=j;
+					}
+					else if (dist<second_dist)
+						second_dist=dist;
+				}
+
+				if (!elkan)
+					lower(0, i)=second_dist;
+				upper[i]=min_dist;
+				if (min_cluster!=0)
+					changed++;
+				cluster_assignments[i]=min_cluster;
+			}
+		}
+		else
+		{
+#pragma omp parallel for schedule(dynamic, 16)
+			for (int32_t j=0; j<num_centers; j++)
+			{
+				center_dists(j, j)=0;
+				for (int32_t l=j+1; l<num_centers; l++)
+				{
+					float64_t dist=0;
+					for (int32_t d=0; d<dim; d++)
+						dist+=CMath::sq(centers(d, j)-centers(d, l));
+					center_dists(j, l)=std::sqrt(dist);
+					center_dists(l, j)=center_dists(j, l);
+				}
+			}
 
-				auto vec = lhs->get_feature_vector(i);
-				linalg::add_col_vec(centers, cluster_i, vec, centers);
-				lhs->free_feature_vector(vec, i);
+			for (int32_t j=0; j<num_centers; j++)
+			{
+				float64_t min_dist=CMath::INFTY;
+				for (int32_t l=0; l<num_centers; l++)
+				{
+					if (l!=j)
+						min_dist=CMath::min(min_dist, center_dists(j, l));
+				}
+				half_min_dists[j]=0.5*min_dist;
 			}
 
-			for (int32_t i=0; i<num_centers; i++)
+			/* the distances to the centers are only computed when the
+			 * bounds do not rule out that the closest center changed.
+			 * Ties are broken towards the lower index like Lloyd's
+			 * algorithm does. */
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:changed)
+			for (int32_t i=0; i<lhs_size; i++)
 			{
-				if (weights_set[i]!=0)
+				const int32_t cluster_assignments_i=cluster_assignments[i];
+				int32_t min_cluster=cluster_assignments_i;
+				float64_t min_dist=upper[i];
+
+				if (elkan)
 				{
-					auto col = centers.get_column(i);
-					linalg::scale(col, col, 1.0 / weights_set[i]);
+					if (min_dist<half_min_dists[min_cluster])
+						continue;
+
+					bool tight=false;
+					for (int32_t j=0; j<num_centers; j++)
+					{
+						if (j==min_cluster || min_dist<lower(j, i) ||
+							min_dist<0.5*center_dists(min_cluster, j))
+							continue;
+
+						if (!tight)
+						{
+							min_dist=distance->distance(i, min_cluster);
+							lower(min_cluster, i)=min_dist;
+							tight=true;
+							if (min_dist<lower(j, i) ||
+								min_dist<0.5*center_dists(min_cluster, j))
+								continue;
+						}
+
+						float64_t dist=distance->distance(i, j);
+						lower(j, i)=dist;
+						if (dist<min_dist || (dist==min_dist && j<min_cluster))
+						{
+							min_dist=dist;
+							min_cluster=j;
+						}
+					}
+				}
+				else
+				{
+					float64_t bound=CMath::max(
+						half_min_dists[min_cluster], lower(0, i));
+					if (min_dist<bound)
+						continue;
+
+					min_dist=distance->distance(i, min_cluster);
+					if (min_dist>=bound)
+					{
+						min_cluster=0;
+						min_dist=distance->distance(i, 0);
+						float64_t second_dist=CMath::INFTY;
+						for (int32_t j=1; j<num_centers; j++)
+						{
+							float64_t dist=distance->distance(i, j);
+							if (dist<min_dist)
+							{
+								second_dist=min_dist;
+								min_dist=dist;
+								min_cluster=j;
+							}
+							else if (dist<second_dist)
+								second_dist=dist;
+						}
+						lower(0, i)=second_dist;
+					}
+				}
+
+				upper[i]=min_dist;
+				if (min_cluster!=cluster_assignments_i)
+				{
+					changed++;
+					cluster_assignments[i]=min_cluster;
 				}
 			}
 		}
+		if(changed==0)
+			break;
+
+		/* Update Step : Calculate new means and move the bounds by the
+		 * distances the centers moved */
+		SGMatrix<float64_t> old_centers=centers.clone();
+		update_centers(
+			lhs, cluster_assignments, centers, weights_set,
+			cluster_members, cluster_offsets);
+
+		int32_t max_drift_cluster=0;
+		for (int32_t j=0; j<num_centers; j++)
+		{
+			float64_t dist=0;
+			for (int32_t d=0; d<dim; d++)
+				dist+=CMath::sq(centers(d, j)-old_centers(d, j));
+			drifts[j]=std::sqrt(dist);
+			if (drifts[j]>drifts[max_drift_cluster])
+				max_drift_cluster=j;
+		}
+
+		float64_t max_drift=drifts[max_drift_cluster];
+		float64_t second_drift=0;
+		for (int32_t j=0; j<num_centers; j++)
+		{
+			if (j!=max_drift_cluster)
+				second_drift=CMath::max(second_drift, drifts[j]);
+		}
+
+#pragma omp parallel for
+		for (int32_t i=0; i<lhs_size; i++)
+		{
+			const int32_t cluster_i=cluster_assignments[i];
+			upper[i]+=drifts[cluster_i];
+			if (elkan)
+			{
+				for (int32_t j=0; j<num_centers; j++)
+					lower(j, i)=CMath::max(lower(j, i)-drifts[j], 0.0);
+			}
+			else
+			{
+				lower(0, i)-=
+					cluster_i==max_drift_cluster ? second_drift : max_drift;
+			}
+		}
 
 		observe<SGMatrix<float64_t>>(iter, "mus");
 
@@ -180,6 +421,60 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 	SG_UNREF(rhs_cache);
 }
 
+void CKMeans::update_centers(
+	CDenseFeatures<float64_t>* lhs, SGVector<int32_t> cluster_assignments,
+	SGMatrix<float64_t> centers, SGVector<int64_t> weights_set,
+	SGVector<int32_t> cluster_members, SGVector<int64_t> cluster_offsets)
+{
+	const int32_t lhs_size=cluster_assignments.vlen;
+	const int32_t dim=centers.num_rows;
+	const int32_t num_centers=centers.num_cols;
+
+	/* the points are sorted by cluster keeping their order, hence every
+	 * center sums up its points in the same order as a serial loop over all
+	 * points does, whatever the number of threads */
+	weights_set.zero();
+	for (int32_t i=0; i<lhs_size; i++)
+		weights_set[cluster_assignments[i]]++;
+
+	/* cluster_offsets[j+1] starts at the first point of cluster j and ends
+	 * up after its last point */
+	cluster_offsets[0]=0;
+	cluster_offsets[1]=0;
+	for (int32_t j=1; j<num_centers; j++)
+		cluster_offsets[j+1]=cluster_offsets[j]+weights_set[j-1];
+	for (int32_t i=0; i<lhs_size; i++)
+		cluster_members[cluster_offsets[cluster_assignments[i]+1]++]=i;
+
+#pragma omp parallel for schedule(dynamic, 16)
+	for (int32_t j=0; j<num_centers; j++)
+	{
+		for (int32_t d=0; d<dim; d++)
+			centers(d, j)=0;
+
+		for (int64_t m=cluster_offsets[j]; m<cluster_offsets[j+1]; m++)
+		{
+			const int32_t i=cluster_members[m];
+			int32_t vlen;
+			bool free_vec;
+			float64_t* vec=lhs->get_feature_vector(i, vlen, free_vec);
+
+			for (int32_t d=0; d<dim; d++)
+				centers(d, j)+=vec[d];
+
+			lhs->free_feature_vector(vec, i, free_vec);
+		}
+
+		/* empty clusters are left at the origin */
+		if (weights_set[j]!=0)
+		{
+			const float64_t scale=1.0/weights_set[j];
+			for (int32_t d=0; d<dim; d++)
+				centers(d, j)*=scale;
+		}
+	}
+}
+
 bool CKMeans::train_machine(CFeatures* data)
 {
 	initialize_training(data);
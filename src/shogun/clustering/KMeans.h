@@ -82,6 +82,25 @@ class CKMeans : public CKMeansBase
 		/** Lloyd's KMeans training method
 		 */
 		void Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** KMeans training method that skips distance computations with
+		 * the triangle inequality bounds of Elkan's or Hamerly's algorithm
+		 */
+		void bounded_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** set the centers to the means of their points
+		 *
+		 * @param lhs points
+		 * @param cluster_assignments clusters of the points
+		 * @param centers centers
+		 * @param weights_set number of points of the clusters
+		 * @param cluster_members buffer of one index per point
+		 * @param cluster_offsets buffer of one offset per center and one more
+		 */
+		void update_centers(
+			CDenseFeatures<float64_t>* lhs, SGVector<int32_t> cluster_assignments,
+			SGMatrix<float64_t> centers, SGVector<int64_t> weights_set,
+			SGVector<int32_t> cluster_members, SGVector<int64_t> cluster_offsets);
 };
 }
 #endif
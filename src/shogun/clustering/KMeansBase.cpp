@@ -48,12 +48,19 @@ CKMeansBase::~CKMeansBase()
 
 void CKMeansBase::set_initial_centers(SGMatrix<float64_t> centers)
 {
-	CDenseFeatures<float64_t>* lhs=distance->get_lhs()->as<CDenseFeatures<float64_t>>();
-	dimensions=lhs->get_num_features();
 	require(centers.num_cols == k,
 			"Expected {} initial cluster centers, got {}", k, centers.num_cols);
-	require(centers.num_rows == dimensions,
-			"Expected {} dimensionional cluster centers, got {}", dimensions, centers.num_rows);
+
+	/* features are not known before training with streaming features */
+	CFeatures* lhs=distance->get_lhs();
+	if (lhs)
+	{
+		dimensions=lhs->as<CDenseFeatures<float64_t>>()->get_num_features();
+		require(centers.num_rows == dimensions,
+				"Expected {} dimensionional cluster centers, got {}", dimensions, centers.num_rows);
+	}
+	else
+		dimensions=centers.num_rows;
 	mus_initial = centers;
 	SG_UNREF(lhs);
 }
@@ -203,6 +210,16 @@ SGMatrix<float64_t> CKMeansBase::get_cluster_centers() const
 	return mus;
 }
 
+void CKMeansBase::set_algorithm(EKMeansAlgorithm algorithm)
+{
+	kmeans_algorithm=algorithm;
+}
+
+EKMeansAlgorithm CKMeansBase::get_algorithm() const
+{
+	return kmeans_algorithm;
+}
+
 SGMatrix<float64_t> CKMeansBase::kmeanspp()
 {
 	int32_t lhs_size;
@@ -306,6 +323,7 @@ void CKMeansBase::init()
 	dimensions = 0;
 	fixed_centers = false;
 	use_kmeanspp = false;
+	kmeans_algorithm = KMEANS_LLOYD;
 	SG_ADD(
 	    &max_iter, "max_iter", "Maximum number of iterations",
 	    ParameterProperties::HYPER);
@@ -320,6 +338,10 @@ void CKMeansBase::init()
 	    &use_kmeanspp, "kmeanspp", "Whether use kmeans++",
 	    ParameterProperties::HYPER);
 	SG_ADD(&mus, "mus", "Cluster centers");
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&kmeans_algorithm, "algorithm",
+	    "Algorithm of the iterations", ParameterProperties::HYPER,
+	    SG_OPTIONS(KMEANS_LLOYD, KMEANS_ELKAN, KMEANS_HAMERLY));
 
 	watch_method("cluster_centers", &CKMeansBase::get_cluster_centers);
 }
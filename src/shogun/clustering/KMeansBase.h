@@ -21,6 +21,24 @@ namespace shogun
 {
 class CDistanceMachine;
 
+/** algorithm that assigns the points to the clusters in the iterations of
+ * CKMeans, all of them yield the same clustering
+ */
+enum EKMeansAlgorithm
+{
+	/** Lloyd's algorithm computes the distances to all centers */
+	KMEANS_LLOYD = 0,
+	/** Elkan's algorithm keeps a lower bound of the distance of every point
+	 * to every center, which skips most distance computations but needs
+	 * memory for num_vectors*k bounds
+	 */
+	KMEANS_ELKAN = 1,
+	/** Hamerly's algorithm keeps a single lower bound per point, which is
+	 * less effective than Elkan's bounds for large k but needs little memory
+	 */
+	KMEANS_HAMERLY = 2
+};
+
 /**
   Base Class for different KMeans clustering implementations.
   */
@@ -85,6 +103,18 @@ class CKMeansBase : public RandomMixin<CDistanceMachine>
 		 */
 		virtual void set_initial_centers(SGMatrix<float64_t> centers);
 
+		/** set the algorithm of the iterations
+		 *
+		 * the triangle inequality bounds of KMEANS_ELKAN and KMEANS_HAMERLY
+		 * require an euclidean distance that is not squared
+		 *
+		 * @param algorithm algorithm
+		 */
+		void set_algorithm(EKMeansAlgorithm algorithm);
+
+		/** @return algorithm of the iterations */
+		EKMeansAlgorithm get_algorithm() const;
+
 		virtual bool train_require_labels() const
 		{
 			return false;
@@ -138,6 +168,9 @@ class CKMeansBase : public RandomMixin<CDistanceMachine>
 		/** Cluster centers */
 		SGMatrix<float64_t> mus;
 
+		/** Algorithm of the iterations */
+		EKMeansAlgorithm kmeans_algorithm;
+
 };
 }
 #endif
@@ -4,11 +4,14 @@
  * Authors: Saurabh Mahindre, Michele Mazzoni, Heiko Strathmann, Viktor Gal
  */
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/base/progress.h>
 #include <shogun/clustering/KMeansMiniBatch.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
 #include <shogun/lib/observers/ObservedValueTemplated.h>
 #include <shogun/mathematics/RandomNamespace.h>
 #include <shogun/mathematics/UniformIntDistribution.h>
@@ -19,6 +22,7 @@
 #endif
 
 using namespace shogun;
+using namespace Eigen;
 
 namespace shogun
 {
@@ -52,53 +56,200 @@ void CKMeansMiniBatch::minibatch_KMeans()
 
 	CDenseFeatures<float64_t>* lhs=
 		distance->get_lhs()->as<CDenseFeatures<float64_t>>();
-	auto rhs_mus=some<CDenseFeatures<float64_t>>(mus);
-	CFeatures* rhs_cache=distance->replace_rhs(rhs_mus);
 	int32_t XSize=lhs->get_num_vectors();
 	int32_t dims=lhs->get_num_features();
 
+	/* other distances than the Euclidean one are computed by the distance */
+	const bool euclidean=distance->get_distance_type()==D_EUCLIDEAN;
+	auto rhs_mus=some<CDenseFeatures<float64_t>>(mus);
+	CFeatures* rhs_cache=euclidean ? NULL : distance->replace_rhs(rhs_mus);
+
 	SGVector<float64_t> v=SGVector<float64_t>(k);
 	v.zero();
+	SGMatrix<float64_t> batch(dims, batch_size);
+	SGVector<int32_t> ncent=SGVector<int32_t>(batch_size);
 
 	for (auto i : SG_PROGRESS(range(max_iter)))
 	{
 		SGVector<int32_t> M=mbchoose_rand(batch_size,XSize);
-		SGVector<int32_t> ncent=SGVector<int32_t>(batch_size);
 		for (int32_t j=0; j<batch_size; j++)
 		{
-			SGVector<float64_t> dists=SGVector<float64_t>(k);
-			for (int32_t p=0; p<k; p++)
-				dists[p]=distance->distance(M[j],p);
+			SGVector<float64_t> x=lhs->get_feature_vector(M[j]);
+			sg_memcpy(
+			    batch.get_column_vector(j), x.vector,
+			    sizeof(float64_t) * dims);
+			lhs->free_feature_vector(x, M[j]);
+		}
+
+		if (euclidean)
+			assign_batch(batch, batch_size, ncent);
+		else
+		{
+#pragma omp parallel for num_threads(env()->get_num_threads())
+			for (int32_t j=0; j<batch_size; j++)
+			{
+				int32_t imin=0;
+				float64_t min=distance->distance(M[j],0);
+				for (int32_t p=1; p<k; p++)
+				{
+					float64_t dist=distance->distance(M[j],p);
+					if (dist<min)
+					{
+						imin=p;
+						min=dist;
+					}
+				}
+				ncent[j]=imin;
+			}
+		}
+
+		update_centers(batch, batch_size, ncent, v);
+		observe<SGMatrix<float64_t>>(i, "mus");
+	}
+	SG_UNREF(lhs);
+	if (!euclidean)
+		distance->replace_rhs(rhs_cache);
+}
+
+namespace
+{
+	/* copy the next examples of a stream into the columns of a batch, which
+	 * is allocated when the first example is read, and return their number */
+	index_t read_batch(
+	    CStreamingDenseFeatures<float64_t>* features,
+	    SGMatrix<float64_t>& batch, index_t batch_size)
+	{
+		index_t num_read=0;
+		while (num_read<batch_size && features->get_next_example())
+		{
+			SGVector<float64_t> x=features->get_vector();
+			if (!batch.matrix)
+				batch=SGMatrix<float64_t>(x.vlen, batch_size);
+			require(
+			    x.vlen == batch.num_rows,
+			    "Expected {} dimensional vectors in the stream, got {}",
+			    batch.num_rows, x.vlen);
+
+			sg_memcpy(
+			    batch.get_column_vector(num_read), x.vector,
+			    sizeof(float64_t) * x.vlen);
+			features->release_example();
+			num_read++;
+		}
+		return num_read;
+	}
+}
+
+void CKMeansMiniBatch::streaming_minibatch_KMeans(
+    CStreamingDenseFeatures<float64_t>* features)
+{
+	require(batch_size>0,
+		"batch size not set to positive value. Current batch size {} ", batch_size);
+	require(
+		max_iter > 0, "number of iterations not set to positive value. Current "
+		              "iterations {} ",
+		max_iter);
+	require(distance, "Distance is not provided");
+	require(
+	    distance->get_distance_type() == D_EUCLIDEAN,
+	    "Training with streaming features requires an Euclidean distance");
+
+	features->start_parser();
 
+	/* the centers are initialized with the first batch */
+	SGMatrix<float64_t> first_batch;
+	index_t num_read=read_batch(features, first_batch, batch_size);
+	require(num_read > 0, "The stream is empty");
+	require(
+	    mus_initial.matrix || use_kmeanspp || num_read >= k,
+	    "The first batch ({} vectors) must contain at least as many vectors "
+	    "as clusters ({})",
+	    num_read, k);
+	require(
+	    !mus_initial.matrix || mus_initial.num_rows == first_batch.num_rows,
+	    "Expected {} dimensional initial cluster centers, got {}",
+	    first_batch.num_rows, mus_initial.num_rows);
+
+	SGMatrix<float64_t> initial_batch(first_batch.num_rows, num_read);
+	sg_memcpy(
+	    initial_batch.matrix, first_batch.matrix,
+	    sizeof(float64_t) * initial_batch.num_rows * num_read);
+	initialize_training(some<CDenseFeatures<float64_t>>(initial_batch));
+
+	SGVector<float64_t> v=SGVector<float64_t>(k);
+	v.zero();
+	SGVector<int32_t> ncent=SGVector<int32_t>(batch_size);
+	SGMatrix<float64_t> batch=first_batch;
+
+	for (int32_t i=0; i<max_iter && num_read>0; i++)
+	{
+		assign_batch(batch, num_read, ncent);
+		update_centers(batch, num_read, ncent, v);
+		observe<SGMatrix<float64_t>>(i, "mus");
+
+		if (i+1<max_iter)
+			num_read=read_batch(features, batch, batch_size);
+	}
+
+	features->end_parser();
+}
+
+void CKMeansMiniBatch::assign_batch(
+    SGMatrix<float64_t> batch, index_t num_vectors,
+    SGVector<int32_t> assignments) const
+{
+	const index_t dims=batch.num_rows;
+	Map<MatrixXd> centers(mus.matrix, dims, k);
+	VectorXd centers_sq_norms=centers.colwise().squaredNorm().transpose();
+
+	/* ||x||^2-2x'c+||c||^2 is minimized by the nearest center, the squared
+	 * norms of the vectors do not change it and are left out of the tiles */
+	const index_t block_size=256;
+	const index_t num_blocks=(num_vectors+block_size-1)/block_size;
+
+#pragma omp parallel for num_threads(env()->get_num_threads())
+	for (index_t b=0; b<num_blocks; b++)
+	{
+		const index_t first=b*block_size;
+		const index_t len=CMath::min(block_size, num_vectors-first);
+		Map<MatrixXd> x(batch.get_column_vector(first), dims, len);
+
+		MatrixXd tile=centers.transpose()*x;
+		for (index_t j=0; j<len; j++)
+		{
 			int32_t imin=0;
-			float64_t min=dists[0];
+			float64_t min=centers_sq_norms[0]-2*tile(0, j);
 			for (int32_t p=1; p<k; p++)
 			{
-				if (dists[p]<min)
+				float64_t dist=centers_sq_norms[p]-2*tile(p, j);
+				if (dist<min)
 				{
 					imin=p;
-					min=dists[p];
+					min=dist;
 				}
 			}
-			ncent[j]=imin;
+			assignments[first+j]=imin;
 		}
-		for (int32_t j=0; j<batch_size; j++)
+	}
+}
+
+void CKMeansMiniBatch::update_centers(
+    SGMatrix<float64_t> batch, index_t num_vectors,
+    SGVector<int32_t> assignments, SGVector<float64_t> counts)
+{
+	const index_t dims=batch.num_rows;
+	for (index_t j=0; j<num_vectors; j++)
+	{
+		int32_t near=assignments[j];
+		float64_t* c_alive=mus.get_column_vector(near);
+		float64_t* x=batch.get_column_vector(j);
+		counts[near]+=1.0;
+		float64_t eta=1.0/counts[near];
+		for (index_t c=0; c<dims; c++)
 		{
-			int32_t near=ncent[j];
-			SGVector<float64_t> c_alive=rhs_mus->get_feature_vector(near);
-			SGVector<float64_t> x=lhs->get_feature_vector(M[j]);
-			v[near]+=1.0;
-			float64_t eta=1.0/v[near];
-			for (int32_t c=0; c<dims; c++)
-			{
-				c_alive[c]=(1.0-eta)*c_alive[c]+eta*x[c];
-			}
+			c_alive[c]=(1.0-eta)*c_alive[c]+eta*x[c];
 		}
-		mus = rhs_mus->get_feature_matrix();
-		observe<SGMatrix<float64_t>>(i, "mus");
 	}
-	SG_UNREF(lhs);
-	distance->replace_rhs(rhs_cache);
 }
 
 SGVector<int32_t> CKMeansMiniBatch::mbchoose_rand(int32_t b, int32_t num)
@@ -131,8 +282,20 @@ void CKMeansMiniBatch::init_mb_params()
 
 bool CKMeansMiniBatch::train_machine(CFeatures* data)
 {
-	initialize_training(data);
-	minibatch_KMeans();
+	if (data && data->get_feature_class() == C_STREAMING_DENSE)
+	{
+		require(
+		    data->get_feature_type() == F_DREAL,
+		    "Expected streaming features of type REAL ({}), got {}", F_DREAL,
+		    data->get_feature_type());
+		streaming_minibatch_KMeans(
+		    data->as<CStreamingDenseFeatures<float64_t>>());
+	}
+	else
+	{
+		initialize_training(data);
+		minibatch_KMeans();
+	}
 	compute_cluster_variances();
 	return true;
 }
@@ -18,8 +18,18 @@
 namespace shogun
 {
 class CKMeansBase;
-	
-/** Class for the mini batch KMeans */
+template <class T> class CStreamingDenseFeatures;
+
+/** @brief Class for the mini batch KMeans
+ *
+ * Every iteration assigns a batch of vectors to their nearest centers and
+ * moves the centers towards them. With an Euclidean distance, the distances
+ * of a batch are computed as blocked matrix products in parallel.
+ *
+ * Training with CStreamingDenseFeatures reads the batches from the stream,
+ * so that data that does not fit in memory can be clustered. Up to max_iter
+ * batches are read, the centers are initialized with the first one.
+ */
 class CKMeansMiniBatch : public CKMeansBase
 {
 	public:
@@ -65,6 +75,37 @@ class CKMeansMiniBatch : public CKMeansBase
 		 */
 		void minibatch_KMeans();
 
+		/** mini-batch KMeans training method that reads the batches from a
+		 * stream, requires an Euclidean distance
+		 *
+		 * @param features stream of the training data
+		 */
+		void streaming_minibatch_KMeans(
+		    CStreamingDenseFeatures<float64_t>* features);
+
+		/** assign vectors to their nearest centers by computing the squared
+		 * Euclidean distances as matrix products
+		 *
+		 * @param batch vectors in the columns
+		 * @param num_vectors number of columns of batch that are assigned
+		 * @param assignments indices of the nearest centers
+		 */
+		void assign_batch(
+		    SGMatrix<float64_t> batch, index_t num_vectors,
+		    SGVector<int32_t> assignments) const;
+
+		/** move the centers towards the vectors that are assigned to them
+		 *
+		 * @param batch vectors in the columns
+		 * @param num_vectors number of columns of batch
+		 * @param assignments indices of the nearest centers
+		 * @param counts number of vectors that were assigned to the centers
+		 * so far
+		 */
+		void update_centers(
+		    SGMatrix<float64_t> batch, index_t num_vectors,
+		    SGVector<int32_t> assignments, SGVector<float64_t> counts);
+
 	private:
 
 		void init_mb_params();
@@ -12,9 +12,174 @@
 #include <shogun/features/Alphabet.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/base/Parameter.h>
+#include <shogun/lib/cpu.h>
+
+#ifdef SG_CPU_DISPATCH
+#include <immintrin.h>
+#endif
 
 using namespace shogun;
 
+namespace
+{
+/** layout of the k-mers that are extracted from packed strings */
+struct KmerShape
+{
+	KmerShape(int32_t p_order, int32_t bits, int32_t gap, bool rev)
+	    : order(p_order), max_val(bits), window_bits(p_order * bits),
+	      low_bits((p_order - gap) / 2 * bits), gap_bits(gap * bits),
+	      kmer_bits((p_order - gap) * bits), reversed(rev)
+	{
+	}
+
+	/** @return k-mer of a window, whose last symbol is in the lowest bits */
+	uint64_t kmer(uint64_t window) const
+	{
+		// the symbols of the gap are dropped
+		if (gap_bits)
+			window = (window & ((uint64_t(1) << low_bits) - 1)) |
+			         ((window >> (low_bits + gap_bits)) << low_bits);
+		if (reversed)
+			window = reverse(window) >> (64 - kmer_bits);
+		return window;
+	}
+
+	/** @return word with the order of the symbols reversed */
+	uint64_t reverse(uint64_t x) const
+	{
+		const uint64_t masks[] = {0x0000FFFF0000FFFFULL, 0x00FF00FF00FF00FFULL,
+		                          0x0F0F0F0F0F0F0F0FULL, 0x3333333333333333ULL,
+		                          0x5555555555555555ULL};
+		x = (x >> 32) | (x << 32);
+		for (int32_t i = 0, bits = 16; bits >= max_val; i++, bits /= 2)
+			x = ((x >> bits) & masks[i]) | ((x & masks[i]) << bits);
+		return x;
+	}
+
+	/** window size in symbols */
+	int32_t order;
+	/** bits of a symbol */
+	int32_t max_val;
+	/** bits of a window */
+	int32_t window_bits;
+	/** bits of the window below the gap */
+	int32_t low_bits;
+	/** bits of the gap */
+	int32_t gap_bits;
+	/** bits of a k-mer */
+	int32_t kmer_bits;
+	/** whether the k-mer is reversed */
+	bool reversed;
+};
+
+/** @return num_bits bits of a packed string starting at bit */
+inline uint64_t read_window(const uint64_t* words, int64_t bit, int32_t num_bits)
+{
+	auto shift = bit & 63;
+	words += bit >> 6;
+	auto x = words[0] << shift;
+	if (shift)
+		x |= words[1] >> (64 - shift);
+	return x >> (64 - num_bits);
+}
+
+template <class ST>
+void packed_kmers_generic(
+    const uint64_t* words, int32_t begin, int32_t end, const KmerShape& shape,
+    ST* obs)
+{
+	for (int32_t i = begin; i < end; i++)
+		obs[i - begin] = (ST)shape.kmer(read_window(
+		    words, int64_t(i - shape.order + 1) * shape.max_val,
+		    shape.window_bits));
+}
+
+#ifdef SG_CPU_DISPATCH
+template <class ST>
+__attribute__((target("avx2"))) void packed_kmers_avx2(
+    const uint64_t* words, int32_t begin, int32_t end, const KmerShape& shape,
+    ST* obs)
+{
+	const auto b = shape.max_val;
+	const __m256i lane_bits = _mm256_setr_epi64x(0, b, 2 * b, 3 * b);
+	const __m256i low_mask =
+	    _mm256_set1_epi64x((uint64_t(1) << shape.low_bits) - 1);
+	const __m128i window_shift = _mm_cvtsi32_si128(64 - shape.window_bits);
+	const __m128i high_shift =
+	    _mm_cvtsi32_si128(shape.low_bits + shape.gap_bits);
+	const __m128i low_shift = _mm_cvtsi32_si128(shape.low_bits);
+	const __m128i kmer_shift = _mm_cvtsi32_si128(64 - shape.kmer_bits);
+	const __m256i c63 = _mm256_set1_epi64x(63);
+	const __m256i c64 = _mm256_set1_epi64x(64);
+	const auto base = (const long long*)words;
+
+	int32_t i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		// every lane reads the two words its window lies in
+		auto bit = _mm256_add_epi64(
+		    _mm256_set1_epi64x(int64_t(i - shape.order + 1) * b), lane_bits);
+		auto index = _mm256_srli_epi64(bit, 6);
+		auto shift = _mm256_and_si256(bit, c63);
+		auto hi = _mm256_i64gather_epi64(base, index, 8);
+		auto lo = _mm256_i64gather_epi64(base + 1, index, 8);
+		// a shift by 64 bits yields zero
+		auto x = _mm256_or_si256(
+		    _mm256_sllv_epi64(hi, shift),
+		    _mm256_srlv_epi64(lo, _mm256_sub_epi64(c64, shift)));
+		x = _mm256_srl_epi64(x, window_shift);
+
+		if (shape.gap_bits)
+			x = _mm256_or_si256(
+			    _mm256_and_si256(x, low_mask),
+			    _mm256_sll_epi64(_mm256_srl_epi64(x, high_shift), low_shift));
+
+		if (shape.reversed)
+		{
+			x = _mm256_or_si256(
+			    _mm256_srli_epi64(x, 32), _mm256_slli_epi64(x, 32));
+#define SWAP_SYMBOLS(bits, mask)                                               \
+	if (b <= bits)                                                             \
+	{                                                                          \
+		auto m = _mm256_set1_epi64x(mask);                                     \
+		x = _mm256_or_si256(                                                   \
+		    _mm256_and_si256(_mm256_srli_epi64(x, bits), m),                   \
+		    _mm256_slli_epi64(_mm256_and_si256(x, m), bits));                  \
+	}
+			SWAP_SYMBOLS(16, 0x0000FFFF0000FFFFLL)
+			SWAP_SYMBOLS(8, 0x00FF00FF00FF00FFLL)
+			SWAP_SYMBOLS(4, 0x0F0F0F0F0F0F0F0FLL)
+			SWAP_SYMBOLS(2, 0x3333333333333333LL)
+			SWAP_SYMBOLS(1, 0x5555555555555555LL)
+#undef SWAP_SYMBOLS
+			x = _mm256_srl_epi64(x, kmer_shift);
+		}
+
+		alignas(32) uint64_t kmers[4];
+		_mm256_store_si256((__m256i*)kmers, x);
+		for (int32_t j = 0; j < 4; j++)
+			obs[i - begin + j] = (ST)kmers[j];
+	}
+
+	packed_kmers_generic(words, i, end, shape, obs + i - begin);
+}
+#endif // SG_CPU_DISPATCH
+
+template <class ST>
+using packed_kmers_t =
+    void (*)(const uint64_t*, int32_t, int32_t, const KmerShape&, ST*);
+
+template <class ST>
+packed_kmers_t<ST> select_packed_kmers()
+{
+#ifdef SG_CPU_DISPATCH
+	if (CpuHasAVX2())
+		return packed_kmers_avx2<ST>;
+#endif
+	return packed_kmers_generic<ST>;
+}
+} // namespace
+
 //define numbers for the bases
 const uint8_t CAlphabet::B_A=0;
 const uint8_t CAlphabet::B_C=1;
@@ -954,6 +1119,64 @@ void CAlphabet::translate_from_single_order_reversed(ST* obs, int32_t sequence_l
 	}
 }
 
+int32_t CAlphabet::get_num_packed_bits() const
+{
+	if (num_bits==1 || num_bits==2 || num_bits==4)
+		return num_bits;
+	return 0;
+}
+
+int64_t CAlphabet::get_num_packed_words(int32_t len) const
+{
+	ASSERT(get_num_packed_bits()>0)
+	return (int64_t(len)*num_bits+63)/64;
+}
+
+void CAlphabet::pack_string(const uint8_t* str, int32_t len, uint64_t* words) const
+{
+	const int32_t bits=get_num_packed_bits();
+	ASSERT(bits>0)
+	const uint64_t mask=(uint64_t(1) << bits)-1;
+
+	memset(words, 0, get_num_packed_words(len)*sizeof(uint64_t));
+	for (int64_t i=0; i<len; i++)
+	{
+		int64_t bit=i*bits;
+		words[bit >> 6]|=(maptable_to_bin[str[i]] & mask) << (64-bits-(bit & 63));
+	}
+}
+
+void CAlphabet::unpack_string(const uint64_t* words, int32_t len, uint8_t* str) const
+{
+	const int32_t bits=get_num_packed_bits();
+	ASSERT(bits>0)
+	const uint64_t mask=(uint64_t(1) << bits)-1;
+
+	for (int64_t i=0; i<len; i++)
+	{
+		int64_t bit=i*bits;
+		str[i]=maptable_to_char[(words[bit >> 6] >> (64-bits-(bit & 63))) & mask];
+	}
+}
+
+template <class ST>
+void CAlphabet::translate_from_packed(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, ST* obs)
+{
+	ASSERT(gap>=0 && gap<p_order && start>=0)
+	ASSERT(max_val>0 && !(max_val & (max_val-1)) && p_order*max_val<=64)
+
+	static const packed_kmers_t<ST> kernel=select_packed_kmers<ST>();
+	KmerShape shape(p_order, max_val, gap, rev);
+
+	// windows that begin before the sequence are padded with zeros
+	int32_t i=start;
+	for (; i<sequence_length && i<p_order-1; i++)
+		obs[i-start]=(ST) shape.kmer(read_window(words, 0, (i+1)*max_val));
+
+	if (i<sequence_length)
+		kernel(words, i, sequence_length, shape, obs+i-start);
+}
+
 template<> void CAlphabet::translate_from_single_order(float32_t* obs, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap)
 {
 }
@@ -1024,4 +1247,18 @@ template void CAlphabet::translate_from_single_order_reversed<uint64_t>(uint64_t
 template void CAlphabet::translate_from_single_order_reversed<float32_t>(float32_t* obs, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap);
 template void CAlphabet::translate_from_single_order_reversed<float64_t>(float64_t* obs, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap);
 template void CAlphabet::translate_from_single_order_reversed<floatmax_t>(floatmax_t* obs, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap);
+
+template void CAlphabet::translate_from_packed<bool>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, bool* obs);
+template void CAlphabet::translate_from_packed<char>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, char* obs);
+template void CAlphabet::translate_from_packed<int8_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, int8_t* obs);
+template void CAlphabet::translate_from_packed<uint8_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, uint8_t* obs);
+template void CAlphabet::translate_from_packed<int16_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, int16_t* obs);
+template void CAlphabet::translate_from_packed<uint16_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, uint16_t* obs);
+template void CAlphabet::translate_from_packed<int32_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, int32_t* obs);
+template void CAlphabet::translate_from_packed<uint32_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, uint32_t* obs);
+template void CAlphabet::translate_from_packed<int64_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, int64_t* obs);
+template void CAlphabet::translate_from_packed<uint64_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, uint64_t* obs);
+template void CAlphabet::translate_from_packed<float32_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, float32_t* obs);
+template void CAlphabet::translate_from_packed<float64_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, float64_t* obs);
+template void CAlphabet::translate_from_packed<floatmax_t>(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, floatmax_t* obs);
 }
@@ -302,6 +302,60 @@ class CAlphabet : public CSGObject
 		template <class ST>
 		static void translate_from_single_order_reversed(ST* obs, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap);
 
+		/** get number of bits of a symbol in packed strings
+		 *
+		 * strings of alphabets with 1, 2 or 4 bit symbols, e.g. DNA, can be
+		 * packed into 64 bit words
+		 *
+		 * @return number of bits or 0 if strings can not be packed
+		 */
+		int32_t get_num_packed_bits() const;
+
+		/** get number of words of a packed string
+		 *
+		 * @param len length of the string
+		 * @return number of words
+		 */
+		int64_t get_num_packed_words(int32_t len) const;
+
+		/** pack a string, the first symbol is stored in the most significant
+		 * bits of the first word
+		 *
+		 * characters that are not in the alphabet are not representable and
+		 * are packed as an arbitrary symbol
+		 *
+		 * @param str string
+		 * @param len length of the string
+		 * @param words get_num_packed_words(len) words, which are overwritten
+		 */
+		void pack_string(const uint8_t* str, int32_t len, uint64_t* words) const;
+
+		/** unpack a string that was packed with pack_string()
+		 *
+		 * @param words packed string
+		 * @param len length of the string
+		 * @param str string of size len that the characters are written to
+		 */
+		void unpack_string(const uint64_t* words, int32_t len, uint8_t* str) const;
+
+		/** translate from a packed string, the result equals
+		 * translate_from_single_order() or
+		 * translate_from_single_order_reversed() of the unpacked string
+		 *
+		 * the word following the packed string is read and must exist
+		 *
+		 * @param words string packed with max_val bits per symbol
+		 * @param sequence_length length of sequence
+		 * @param start start
+		 * @param p_order order, at most 64 bits
+		 * @param max_val maximum value
+		 * @param gap gap
+		 * @param rev reverse
+		 * @param obs sequence_length-start elements the result is written to
+		 */
+		template <class ST>
+		static void translate_from_packed(const uint64_t* words, int32_t sequence_length, int32_t start, int32_t p_order, int32_t max_val, int32_t gap, bool rev, ST* obs);
+
 		virtual CSGObject* clone(ParameterProperties pp = ParameterProperties::ALL) const override;
 
 	private:
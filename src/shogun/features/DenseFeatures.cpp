@@ -11,6 +11,7 @@
 #include <shogun/base/some.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
+#include <shogun/io/MappedDataset.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/base/Parameter.h>
 #include <shogun/mathematics/Math.h>
@@ -46,12 +47,15 @@ template<class ST> CDenseFeatures<ST>::CDenseFeatures(const CDenseFeatures & ori
 	set_feature_matrix(orig.feature_matrix);
 	initialize_cache();
 
+	m_subset_caching = orig.m_subset_caching;
+
 	if (orig.m_subset_stack != NULL)
 	{
 		SG_UNREF(m_subset_stack);
 		m_subset_stack=new CSubsetStack(*orig.m_subset_stack);
 		SG_REF(m_subset_stack);
 	}
+	update_subset_matrix();
 }
 
 template<class ST> CDenseFeatures<ST>::CDenseFeatures(SGMatrix<ST> matrix) :
@@ -116,6 +120,7 @@ template<class ST> void CDenseFeatures<ST>::free_feature_matrix()
 {
 	m_subset_stack->remove_all_subsets();
 	feature_matrix=SGMatrix<ST>();
+	m_subset_matrix=SGMatrix<ST>();
 	num_vectors = 0;
 	num_features = 0;
 }
@@ -130,7 +135,11 @@ template<class ST> ST* CDenseFeatures<ST>::get_feature_vector(int32_t num, int32
 	ST* feat = NULL;
 	dofree = false;
 
-	if (feature_matrix.matrix)
+	if (m_subset_matrix.matrix)
+	{
+		feat = &m_subset_matrix.matrix[num * int64_t(num_features)];
+	}
+	else if (feature_matrix.matrix)
 	{
 		feat = &feature_matrix.matrix[real_num * int64_t(num_features)];
 	}
@@ -190,6 +199,9 @@ template<class ST> SGVector<ST> CDenseFeatures<ST>::get_feature_vector(int32_t n
 	int32_t vlen;
 	bool do_free;
 	ST* vector= get_feature_vector(num, vlen, do_free);
+	if (!do_free && !m_subset_matrix.matrix && feature_matrix.memory_owner)
+		return SGVector<ST>(vector, vlen, feature_matrix.memory_owner);
+
 	return SGVector<ST>(vector, vlen, do_free);
 }
 
@@ -274,11 +286,71 @@ SGMatrix<ST> CDenseFeatures<ST>::get_feature_matrix() const
 	if (!m_subset_stack->has_subsets())
 		return feature_matrix;
 
+	/* callers may modify the matrix in place, which must neither reach the
+	 * feature matrix nor the cached copy */
+	if (m_subset_matrix.matrix)
+		return m_subset_matrix.clone();
+
+	SGMatrix<ST> target(num_features, get_num_vectors());
+	copy_feature_matrix(target);
+	return target;
+}
+
+template <class ST>
+SGMatrix<ST> CDenseFeatures<ST>::get_feature_matrix_view() const
+{
+	if (!m_subset_stack->has_subsets())
+		return feature_matrix;
+
+	if (m_subset_matrix.matrix)
+		return m_subset_matrix;
+
+	if (m_subset_stack->is_contiguous() && feature_matrix.matrix)
+	{
+		/* the block keeps the matrix and a mapped file alive */
+		auto matrix=feature_matrix;
+		std::shared_ptr<void> owner(
+			new SGMatrix<ST>(matrix),
+			[](void* m) { delete (SGMatrix<ST>*)m; });
+
+		auto first=m_subset_stack->subset_idx_conversion(0);
+		return SGMatrix<ST>(
+			matrix.matrix+first*int64_t(num_features), num_features,
+			get_num_vectors(), owner);
+	}
+
 	SGMatrix<ST> target(num_features, get_num_vectors());
 	copy_feature_matrix(target);
 	return target;
 }
 
+template <class ST>
+void CDenseFeatures<ST>::set_subset_caching(bool caching)
+{
+	m_subset_caching=caching;
+	update_subset_matrix();
+}
+
+template <class ST>
+void CDenseFeatures<ST>::subset_changed_post()
+{
+	CDotFeatures::subset_changed_post();
+	update_subset_matrix();
+}
+
+template <class ST>
+void CDenseFeatures<ST>::update_subset_matrix()
+{
+	m_subset_matrix=SGMatrix<ST>();
+	if (!m_subset_caching || !m_subset_stack->has_subsets() ||
+		m_subset_stack->is_contiguous() || !feature_matrix.matrix)
+		return;
+
+	SGMatrix<ST> target(num_features, get_num_vectors());
+	copy_feature_matrix(target);
+	m_subset_matrix=target;
+}
+
 template <class ST>
 void CDenseFeatures<ST>::copy_feature_matrix(SGMatrix<ST> target, index_t column_offset) const
 {
@@ -296,11 +368,12 @@ void CDenseFeatures<ST>::copy_feature_matrix(SGMatrix<ST> target, index_t column
 			"Number of cols of given matrix ({}) should be at least {}!",
 			target.num_cols, num_cols);
 
-	if (!m_subset_stack->has_subsets())
+	if (!m_subset_stack->has_subsets() || m_subset_matrix.matrix)
 	{
-		auto src=feature_matrix.matrix;
+		/* the cached copy is read like get_feature_vector() does */
+		auto src=m_subset_matrix.matrix ? m_subset_matrix : feature_matrix;
 		auto dest=target.matrix+int64_t(num_features)*column_offset;
-		sg_memcpy(dest, src, feature_matrix.size()*sizeof(ST));
+		sg_memcpy(dest, src.matrix, src.size()*sizeof(ST));
 	}
 	else
 	{
@@ -323,6 +396,16 @@ template<class ST> void CDenseFeatures<ST>::set_feature_matrix(SGMatrix<ST> matr
 	num_vectors = matrix.num_cols;
 }
 
+template <class ST>
+void CDenseFeatures<ST>::set_feature_matrix_from_file(const char* fname)
+{
+	/* the matrix and every vector taken from it keep the file mapped */
+	auto dataset = std::make_shared<MappedDataset>(fname);
+	auto matrix = dataset->get_dense_matrix<ST>();
+	set_feature_matrix(SGMatrix<ST>(
+		matrix.matrix, matrix.num_rows, matrix.num_cols, dataset));
+}
+
 template <class ST>
 ST* CDenseFeatures<ST>::get_feature_matrix(
 	int32_t& num_feat, int32_t& num_vec) const
@@ -575,7 +658,9 @@ CFeatures* CDenseFeatures<ST>::shallow_subset_copy()
 
 	SG_DEBUG("Using underlying feature matrix with {} dimensions and {} feature vectors!", num_features, num_vectors);
 	SGMatrix<ST> shallow_copy_matrix(feature_matrix);
-	shallow_copy_features=new CDenseFeatures<ST>(shallow_copy_matrix);
+	auto shallow_copy=new CDenseFeatures<ST>(shallow_copy_matrix);
+	shallow_copy->m_subset_caching=m_subset_caching;
+	shallow_copy_features=shallow_copy;
 	SG_REF(shallow_copy_features);
 	if (m_subset_stack->has_subsets())
 		shallow_copy_features->add_subset(m_subset_stack->get_last_subset()->get_subset_idx());
@@ -598,6 +683,7 @@ template<class ST> void CDenseFeatures<ST>::init()
 
 	feature_matrix = SGMatrix<ST>();
 	feature_cache = NULL;
+	m_subset_caching = false;
 
 	set_generic<ST>();
 
@@ -761,7 +847,7 @@ template <typename ST>
 SGVector<ST> CDenseFeatures<ST>::sum() const
 {
 	// TODO optimize non batch mode, but get_feature_vector is non const :(
-	SGVector<ST> result = linalg::rowwise_sum(get_feature_matrix());
+	SGVector<ST> result = linalg::rowwise_sum(get_feature_matrix_view());
 	return result;
 }
 
@@ -781,7 +867,7 @@ SGVector<float64_t > CDenseFeatures<ST>::std(bool colwise) const
 {
 	ASSERT_FLOATING_POINT
 
-	auto mat = get_feature_matrix();
+	auto mat = get_feature_matrix_view();
 	return linalg::std_deviation(mat, colwise);
 }
 
@@ -789,7 +875,7 @@ template <typename ST>
 SGMatrix<ST> CDenseFeatures<ST>::cov() const
 {
 	// TODO optimize non batch mode, but get_feature_vector is non const :(
-	auto mat = get_feature_matrix();
+	auto mat = get_feature_matrix_view();
 	return linalg::matrix_prod(mat, mat, false, true);
 }
 
@@ -797,7 +883,7 @@ template <typename ST>
 SGMatrix<ST> CDenseFeatures<ST>::gram() const
 {
 	// TODO optimize non batch mode, but get_feature_vector is non const :(
-	auto mat = get_feature_matrix();
+	auto mat = get_feature_matrix_view();
 	return linalg::matrix_prod(mat, mat, true, false);
 }
 
@@ -810,7 +896,7 @@ SGVector<ST> CDenseFeatures<ST>::dot(const SGVector<ST>& other) const
 		                                   "({}).",
 		get_num_features(), other.size());
 	// TODO optimize non batch mode, but get_feature_vector is non const :(
-	return linalg::matrix_prod(get_feature_matrix(), other, false);
+	return linalg::matrix_prod(get_feature_matrix_view(), other, false);
 }
 
 template class CDenseFeatures<bool>;
@@ -59,6 +59,11 @@ class CDotFeatures;
  * If done, all calls that work with features are translated to the subset.
  * See comments to find out whether it is supported for that method.
  * See also CFeatures class documentation
+ *
+ * Read only operations like sum() and cov() use a subset of consecutive
+ * indices as a block of the feature matrix without copying. Other subsets
+ * may be copied into a compact matrix once per subset change, see
+ * set_subset_caching().
  */
 template<class ST> class CDenseFeatures: public CDotFeatures
 {
@@ -186,12 +191,44 @@ public:
 	/** Getter the feature matrix
 	 *
 	 * in-place without subset
-	 * a copy with subset
+	 * a copy with subset, taken from the cached copy with subset caching
 	 *
 	 * @return matrix feature matrix
 	 */
 	SGMatrix<ST> get_feature_matrix() const;
 
+	/** Whether to copy the feature vectors of a subset into a compact
+	 * matrix whenever the subset changes. Feature vectors and the feature
+	 * matrix are then read from the copy, which saves the index
+	 * indirection and repeated copies of the subset, e.g. when a machine
+	 * is trained on a fold of cross-validation. Subsets of consecutive
+	 * indices are never copied. Duplicates and views inherit the setting.
+	 *
+	 * The copy is taken when the subset changes. Changes to the returned
+	 * vectors do not reach the feature matrix, and later changes to the
+	 * feature matrix are only seen after the next subset change or call
+	 * of this method.
+	 *
+	 * @param caching whether to cache the subset
+	 */
+	void set_subset_caching(bool caching);
+
+	/** @return whether subsets are cached */
+	bool get_subset_caching() const { return m_subset_caching; }
+
+	/** set feature matrix from a dense file written by
+	 * MappedDataset::save(). The file is memory mapped and the matrix points
+	 * into it without copying, hence it may be larger than the available
+	 * memory. The mapping is copy on write, in-place changes never reach
+	 * the file. The file stays mapped as long as the features or any matrix
+	 * or vector taken from them use it.
+	 *
+	 * any subset is removed
+	 *
+	 * @param fname mapped dataset file
+	 */
+	void set_feature_matrix_from_file(const char* fname);
+
 	/** get the pointer to the feature matrix
 	 * num_feat,num_vectors are returned by reference
 	 *
@@ -529,9 +566,26 @@ protected:
 	 */
 	void set_feature_matrix(SGMatrix<ST> matrix);
 
+	/** updates the cached copy of the subset */
+	virtual void subset_changed_post();
+
+	/** read only access to the feature vectors of the subset
+	 *
+	 * the feature matrix without subset
+	 * a block of the matrix with a subset of consecutive indices
+	 * the cached copy with subset caching
+	 * a copy with other subsets
+	 *
+	 * @return matrix that must not be modified
+	 */
+	SGMatrix<ST> get_feature_matrix_view() const;
+
 private:
 	void init();
 
+	/** copies the feature vectors of the subset if subsets are cached */
+	void update_subset_matrix();
+
 protected:
 	/*
 	 * Helper method which copies the working feature matrix into the pre-allocated
@@ -556,6 +610,13 @@ protected:
 
 	/** feature cache */
 	CCache<ST>* feature_cache;
+
+
+	/** whether subsets are cached */
+	bool m_subset_caching;
+
+	/** compact copy of the feature vectors of the subset, if cached */
+	SGMatrix<ST> m_subset_matrix;
 };
 }
 #endif // _DENSEFEATURES__H__
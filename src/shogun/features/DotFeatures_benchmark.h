@@ -12,9 +12,8 @@ BENCHMARK_DEFINE_F(FIXTURE, NAME)(benchmark::State& state)	\
 {															\
 	for (auto _ : state)									\
 	{														\
-		index_t dim = f->get_dim_feature_space();			\
 		for (index_t i = 0; i < f->get_num_vectors(); ++i)	\
-			f->dense_dot(i, w.vector, dim);					\
+			benchmark::DoNotOptimize(f->dot(i, w));			\
 	}														\
 }															\
 BENCHMARK_REGISTER_F(FIXTURE, NAME)
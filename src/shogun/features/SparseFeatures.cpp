@@ -1,8 +1,10 @@
 #include <shogun/lib/common.h>
 #include <shogun/lib/memory.h>
+#include <shogun/lib/SparseKernels.h>
 #include <shogun/features/SparseFeatures.h>
 #include <shogun/preprocessor/SparsePreprocessor.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/io/MappedDataset.h>
 #include <shogun/io/SGIO.h>
 
 #include <string.h>
@@ -37,7 +39,7 @@ template<class ST> CSparseFeatures<ST>::CSparseFeatures(SGMatrix<ST> dense)
 
 template<class ST> CSparseFeatures<ST>::CSparseFeatures(const CSparseFeatures & orig)
 : CDotFeatures(orig), sparse_feature_matrix(orig.sparse_feature_matrix),
-	feature_cache(orig.feature_cache)
+	feature_cache(orig.feature_cache), m_mapped_dataset(orig.m_mapped_dataset)
 {
 	init();
 
@@ -218,6 +220,56 @@ void CSparseFeatures<complex128_t>::add_to_dense_vec(float64_t alpha,
 	not_implemented(SOURCE_LOCATION);;
 }
 
+template <class ST>
+SGMatrix<float64_t>
+CSparseFeatures<ST>::dense_product(const SGMatrix<float64_t>& weights) const
+{
+	require(
+		weights.num_cols >= get_num_features(),
+		"dense_product(weights={}x{}): weights should have a column for each "
+		"of the {} features",
+		weights.num_rows, weights.num_cols, get_num_features());
+
+	int32_t num_outputs = weights.num_rows;
+	int32_t num_vectors = get_num_vectors();
+	SGMatrix<float64_t> result(num_outputs, num_vectors);
+
+#pragma omp parallel for
+	for (int32_t i = 0; i < num_vectors; i++)
+	{
+		SGSparseVector<ST> sv = get_sparse_feature_vector(i);
+		float64_t* out = result.get_column_vector(i);
+		if constexpr (std::is_same<ST, float64_t>::value)
+		{
+			sparse::dense_product(
+				sv.features, sv.num_feat_entries, weights.matrix, num_outputs,
+				weights.num_cols, out);
+		}
+		else
+		{
+			std::fill_n(out, num_outputs, 0.0);
+			for (int32_t j = 0; j < sv.num_feat_entries; j++)
+			{
+				auto column =
+					weights.get_column_vector(sv.features[j].feat_index);
+				for (int32_t k = 0; k < num_outputs; k++)
+					out[k] += column[k] * sv.features[j].entry;
+			}
+		}
+		free_sparse_feature_vector(i);
+	}
+
+	return result;
+}
+
+template <>
+SGMatrix<float64_t> CSparseFeatures<complex128_t>::dense_product(
+	const SGMatrix<float64_t>& weights) const
+{
+	not_implemented(SOURCE_LOCATION);
+	return SGMatrix<float64_t>();
+}
+
 template<class ST> void CSparseFeatures<ST>::free_sparse_feature_vector(int32_t num) const
 {
 	if (feature_cache)
@@ -248,6 +300,7 @@ template<class ST> void CSparseFeatures<ST>::set_sparse_feature_matrix(SGSparseM
 		error("Not allowed with subset");
 
 	sparse_feature_matrix=sm;
+	m_mapped_dataset.reset();
 
 	// TODO: check should be implemented in sparse matrix class
 	for (int32_t j=0; j<get_num_vectors(); j++) {
@@ -292,6 +345,20 @@ template<class ST> void CSparseFeatures<ST>::free_sparse_features()
 template<class ST> void CSparseFeatures<ST>::free_sparse_feature_matrix()
 {
 	sparse_feature_matrix=SGSparseMatrix<ST>();
+	m_mapped_dataset.reset();
+}
+
+template <class ST>
+void CSparseFeatures<ST>::set_sparse_feature_matrix_from_file(const char* fname)
+{
+	if (m_subset_stack->has_subsets())
+		error("Not allowed with subset");
+
+	auto dataset = std::make_shared<MappedDataset>(fname);
+	// the dimension check of set_sparse_feature_matrix() would read every
+	// entry, the entries are written by MappedDataset::save() instead
+	sparse_feature_matrix = dataset->get_sparse_matrix<ST>();
+	m_mapped_dataset = dataset;
 }
 
 template<class ST> void CSparseFeatures<ST>::set_full_feature_matrix(SGMatrix<ST> full)
@@ -482,8 +549,16 @@ CSparseFeatures<ST>::dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) cons
 			"vector dimension {})",
 			vec_idx1, vec2.size(), sv.get_num_dimensions());
 
-		for (int32_t i=0; i<sv.num_feat_entries; i++)
-			result+=vec2[sv.features[i].feat_index]*sv.features[i].entry;
+		if constexpr (std::is_same<ST, float64_t>::value)
+		{
+			result = sparse::dense_dot(
+				sv.features, sv.num_feat_entries, vec2.vector, vec2.vlen);
+		}
+		else
+		{
+			for (int32_t i=0; i<sv.num_feat_entries; i++)
+				result+=vec2[sv.features[i].feat_index]*sv.features[i].entry;
+		}
 	}
 
 	free_sparse_feature_vector(vec_idx1);
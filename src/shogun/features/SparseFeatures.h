@@ -24,6 +24,7 @@ namespace shogun
 
 class CFile;
 class CLibSVMFile;
+class MappedDataset;
 class CFeatures;
 template <class ST> class CDenseFeatures;
 template <class T> class CCache;
@@ -166,6 +167,20 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		void add_to_dense_vec(float64_t alpha, int32_t num,
 				float64_t* vec, int32_t dim, bool abs_val=false) const;
 
+		/** compute the products of several dense weight vectors with all
+		 * feature vectors, i.e. the sparse-dense matrix product W*X that
+		 * scores a batch of vectors with several linear models. The
+		 * vectors are processed in parallel.
+		 *
+		 * possible with subset
+		 *
+		 * @param weights num_outputs x num_features matrix, row k holds
+		 * the weights of output k
+		 * @return num_outputs x num_vectors matrix of products
+		 */
+		SGMatrix<float64_t>
+		dense_product(const SGMatrix<float64_t>& weights) const;
+
 		/** free sparse feature vector
 		 *
 		 * possible with subset
@@ -224,6 +239,19 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
         void set_sparse_feature_matrix(SGSparseMatrix<ST> sm);
 
+		/** set sparse feature matrix from a sparse file written by
+		 * MappedDataset::save(). The file is memory mapped and the sparse
+		 * vectors point into it without copying, hence the entries may be
+		 * larger than the available memory. The mapping is copy on write,
+		 * in-place changes never reach the file. The file stays mapped as
+		 * long as the features use it.
+		 *
+		 * not possible with subset
+		 *
+		 * @param fname mapped dataset file
+		 */
+		void set_sparse_feature_matrix_from_file(const char* fname);
+
 		/** gets a copy of a full feature matrix
 		 *
 		 * possible with subset
@@ -482,6 +510,9 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 
 		/** feature cache */
 		CCache< SGSparseVectorEntry<ST> >* feature_cache;
+
+		/** mapped file the sparse vectors point into, if any */
+		std::shared_ptr<MappedDataset> m_mapped_dataset;
 };
 }
 #endif /* _SPARSEFEATURES__H__ */
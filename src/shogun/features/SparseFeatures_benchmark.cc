@@ -0,0 +1,131 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/features/SparseFeatures.h"
+#include "shogun/lib/SGMatrix.h"
+#include "shogun/lib/SGSparseMatrix.h"
+#include "shogun/lib/SGVector.h"
+
+#include <algorithm>
+#include <random>
+
+namespace shogun
+{
+
+class SparseFeaturesFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		std::mt19937_64 prng(17);
+		std::uniform_int_distribution<index_t> index(0, st.range(0) - 1);
+		std::normal_distribution<float64_t> dist;
+
+		SGSparseMatrix<float64_t> matrix(st.range(0), num_vectors);
+		for (index_t i = 0; i < num_vectors; i++)
+		{
+			SGSparseVector<float64_t> v(num_entries);
+			for (index_t j = 0; j < num_entries; j++)
+			{
+				v.features[j].feat_index = index(prng);
+				v.features[j].entry = dist(prng);
+			}
+			v.sort_features();
+			matrix[i] = v;
+		}
+		f = new CSparseFeatures<float64_t>(matrix);
+		SG_REF(f);
+
+		w = SGVector<float64_t>(st.range(0));
+		for (auto& x : w)
+			x = dist(prng);
+		weights = SGMatrix<float64_t>(num_outputs, st.range(0));
+		for (auto& x : weights)
+			x = dist(prng);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(f);
+	}
+
+	static constexpr index_t num_vectors = 10000;
+	static constexpr index_t num_entries = 200;
+	static constexpr index_t num_outputs = 32;
+	CSparseFeatures<float64_t>* f;
+	SGVector<float64_t> w;
+	SGMatrix<float64_t> weights;
+};
+
+BENCHMARK_DEFINE_F(SparseFeaturesFixture, dot)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		float64_t sum = 0;
+		for (index_t i = 0; i < num_vectors; i++)
+			sum += f->dot(i, w);
+		benchmark::DoNotOptimize(sum);
+	}
+	st.SetItemsProcessed(st.iterations() * num_vectors * num_entries);
+}
+
+BENCHMARK_DEFINE_F(SparseFeaturesFixture, dense_dot_range)
+(benchmark::State& st)
+{
+	SGVector<float64_t> output(num_vectors);
+	for (auto _ : st)
+	{
+		f->dense_dot_range(
+		    output.vector, 0, num_vectors, nullptr, w.vector, w.vlen, 0);
+		benchmark::DoNotOptimize(output.vector);
+	}
+	st.SetItemsProcessed(st.iterations() * num_vectors * num_entries);
+}
+
+BENCHMARK_DEFINE_F(SparseFeaturesFixture, dense_product)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto result = f->dense_product(weights);
+		benchmark::DoNotOptimize(result.matrix);
+	}
+	st.SetItemsProcessed(
+	    st.iterations() * num_vectors * num_entries * num_outputs);
+}
+
+BENCHMARK_DEFINE_F(SparseFeaturesFixture, dense_product_by_dot)
+(benchmark::State& st)
+{
+	// the same product with one dot product per output and vector
+	for (auto _ : st)
+	{
+		SGMatrix<float64_t> result(num_outputs, num_vectors);
+		SGVector<float64_t> row(weights.num_cols);
+		for (index_t k = 0; k < num_outputs; k++)
+		{
+			for (index_t j = 0; j < weights.num_cols; j++)
+				row[j] = weights(k, j);
+			for (index_t i = 0; i < num_vectors; i++)
+				result(k, i) = f->dot(i, row);
+		}
+		benchmark::DoNotOptimize(result.matrix);
+	}
+	st.SetItemsProcessed(
+	    st.iterations() * num_vectors * num_entries * num_outputs);
+}
+
+#define ADD_SPARSE_ARGS(WHAT)                                                  \
+	WHAT->RangeMultiplier(16)->Range(1 << 12, 1 << 20)->Unit(                  \
+	    benchmark::kMillisecond);
+
+ADD_SPARSE_ARGS(BENCHMARK_REGISTER_F(SparseFeaturesFixture, dot))
+ADD_SPARSE_ARGS(BENCHMARK_REGISTER_F(SparseFeaturesFixture, dense_dot_range))
+ADD_SPARSE_ARGS(BENCHMARK_REGISTER_F(SparseFeaturesFixture, dense_product))
+ADD_SPARSE_ARGS(
+    BENCHMARK_REGISTER_F(SparseFeaturesFixture, dense_product_by_dot))
+}
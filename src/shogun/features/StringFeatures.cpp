@@ -90,7 +90,7 @@ template<class ST> void CStringFeatures<ST>::cleanup()
 
 	if (single_string.vector)
 		single_string = SGVector<ST>();
-	else
+	else if (!is_packed())
 		cleanup_feature_vectors(0, get_num_vectors()-1);
 
 	/*
@@ -105,6 +105,10 @@ template<class ST> void CStringFeatures<ST>::cleanup()
 
 	features.clear();
 	symbol_mask_table = SGVector<ST>();
+	m_packed_symbols = SGVector<uint64_t>();
+	m_packed_offsets = SGVector<int64_t>();
+	m_packed_lengths = SGVector<int32_t>();
+	m_packed_kmers = false;
 
 	/* start with a fresh alphabet, but instead of emptying the histogram
 	 * create a new object (to leave the alphabet object alone if it is used
@@ -119,6 +123,7 @@ template<class ST> void CStringFeatures<ST>::cleanup()
 template<class ST> void CStringFeatures<ST>::cleanup_feature_vector(int32_t num)
 {
 	ASSERT(num<get_num_vectors())
+	require(!is_packed(), "Strings are packed, call unpack() first");
 
 	int32_t real_num=m_subset_stack->subset_idx_conversion(num);
 	features[real_num] = SGVector<ST>();
@@ -126,6 +131,7 @@ template<class ST> void CStringFeatures<ST>::cleanup_feature_vector(int32_t num)
 
 template<class ST> void CStringFeatures<ST>::cleanup_feature_vectors(int32_t start, int32_t stop)
 {
+	require(!is_packed(), "Strings are packed, call unpack() first");
 	if(get_num_vectors())
 	{
 		ASSERT(stop<get_num_vectors())
@@ -175,6 +181,7 @@ template<class ST> void CStringFeatures<ST>::set_feature_vector(SGVector<ST> vec
 {
 	if (m_subset_stack->has_subsets())
 		error("A subset is set, cannot set feature vector");
+	require(!is_packed(), "Strings are packed, cannot set feature vector");
 
 	if (num>=get_num_vectors())
 	{
@@ -205,7 +212,7 @@ template<class ST> ST* CStringFeatures<ST>::get_feature_vector(int32_t num, int3
 
 	int32_t real_num=m_subset_stack->subset_idx_conversion(num);
 
-	if (!preprocess_on_get)
+	if (!preprocess_on_get && !is_packed())
 	{
 		dofree=false;
 		len=features[real_num].vlen;
@@ -336,15 +343,20 @@ template<class ST> int32_t CStringFeatures<ST>::get_max_vector_length() const
 
 	for (int32_t i=0; i<num_str; i++)
 	{
-		max_string_length=CMath::max(max_string_length,
-			features[m_subset_stack->subset_idx_conversion(i)].vlen);
+		int32_t real_num=m_subset_stack->subset_idx_conversion(i);
+		int32_t len=is_packed() ? get_packed_vector_length(real_num) :
+			features[real_num].vlen;
+		max_string_length=CMath::max(max_string_length, len);
 	}
 	return max_string_length;
 }
 
 template<class ST> int32_t CStringFeatures<ST>::get_num_vectors() const
 {
-	return m_subset_stack->has_subsets() ? m_subset_stack->get_size() : features.size();
+	if (m_subset_stack->has_subsets())
+		return m_subset_stack->get_size();
+
+	return is_packed() ? m_packed_lengths.vlen : features.size();
 }
 
 template<class ST> floatmax_t CStringFeatures<ST>::get_num_symbols() { return num_symbols; }
@@ -820,6 +832,9 @@ template<class ST> bool CStringFeatures<ST>::append_features(CStringFeatures<ST>
 
 	if (m_subset_stack->has_subsets())
 		error("Cannot call set_features() with subset.");
+	require(
+		!is_packed() && !sf->is_packed(),
+		"Cannot append packed strings, call unpack() first");
 
 	std::vector<SGVector<ST>> new_features;
 	new_features.reserve(sf->get_num_vectors());
@@ -838,6 +853,7 @@ template<class ST> bool CStringFeatures<ST>::append_features(const std::vector<S
 {
 	if (m_subset_stack->has_subsets())
 		error("Cannot call set_features() with subset.");
+	require(!is_packed(), "Cannot append to packed strings, call unpack() first");
 
 	if (features.empty())
 		return set_features(p_features);
@@ -883,6 +899,7 @@ template<class ST> const std::vector<SGVector<ST>>& CStringFeatures<ST>::get_str
 {
 	if (m_subset_stack->has_subsets())
 		error("get features() is not possible on subset");
+	require(!is_packed(), "Strings are packed, call unpack() first");
 
 	return features;
 }
@@ -1016,6 +1033,7 @@ template<class ST> bool CStringFeatures<ST>::save_compressed(char* dest, E_COMPR
 
 	if (m_subset_stack->has_subsets())
 		error("save_compressed() is not possible on subset");
+	require(!is_packed(), "save_compressed() is not possible on packed strings");
 
 	FILE* file=NULL;
 
@@ -1076,6 +1094,7 @@ template<class ST> int32_t CStringFeatures<ST>::obtain_by_sliding_window(int32_t
 {
 	if (m_subset_stack->has_subsets())
 		not_implemented(SOURCE_LOCATION);
+	require(!is_packed(), "Strings are packed, call unpack() first");
 
 	int32_t num_vectors = get_num_vectors();
 	int32_t max_string_length = get_max_vector_length();
@@ -1114,6 +1133,7 @@ template<class ST> int32_t CStringFeatures<ST>::obtain_by_position_list(int32_t
 {
 	if (m_subset_stack->has_subsets())
 		not_implemented(SOURCE_LOCATION);
+	require(!is_packed(), "Strings are packed, call unpack() first");
 
 	int32_t num_vectors = get_num_vectors();
 	int32_t max_string_length = get_max_vector_length();
@@ -1196,6 +1216,7 @@ template<class ST> void CStringFeatures<ST>::embed_features(int32_t p_order)
 {
 	if (m_subset_stack->has_subsets())
 		not_implemented(SOURCE_LOCATION);
+	require(!is_packed(), "Strings are packed, call unpack() first");
 
 	ASSERT(alphabet->get_num_symbols_in_histogram() > 0)
 
@@ -1313,6 +1334,7 @@ template<class ST> ST* CStringFeatures<ST>::get_zero_terminated_string_copy(SGVe
 template<class ST> void CStringFeatures<ST>::set_feature_vector(int32_t num, ST* string, int32_t len)
 {
 	ASSERT(num<get_num_vectors())
+	require(!is_packed(), "Strings are packed, cannot set feature vector");
 
 	int32_t real_num=m_subset_stack->subset_idx_conversion(num);
 
@@ -1468,6 +1490,34 @@ CStringFeatures<SSKFeature>* obtain_sssk_double_from_char(int **S, int *len, int
 template<class ST> CFeatures* CStringFeatures<ST>::copy_subset(
 		SGVector<index_t> indices) const
 {
+	if (is_packed())
+	{
+		/* the copy shares the packed strings */
+		SGVector<int64_t> offsets(indices.vlen);
+		SGVector<int32_t> lengths(indices.vlen);
+		for (index_t i=0; i<indices.vlen; ++i)
+		{
+			index_t real_idx=m_subset_stack->subset_idx_conversion(indices.vector[i]);
+			offsets[i]=m_packed_offsets[real_idx];
+			lengths[i]=m_packed_lengths[real_idx];
+		}
+
+		CStringFeatures* result=new CStringFeatures(alphabet);
+		result->order=order;
+		result->num_symbols=num_symbols;
+		result->original_num_symbols=original_num_symbols;
+		result->symbol_mask_table=symbol_mask_table;
+		result->m_packed_kmers=m_packed_kmers;
+		result->m_packed_start=m_packed_start;
+		result->m_packed_gap=m_packed_gap;
+		result->m_packed_reversed=m_packed_reversed;
+		result->set_packed(m_packed_symbols, offsets, lengths, m_packed_bits);
+
+		SG_REF(result);
+
+		return result;
+	}
+
 	/* string list to create new CStringFeatures from */
 	std::vector<SGVector<ST>> list_copy(indices.vlen);
 
@@ -1505,6 +1555,8 @@ template<class ST> ST* CStringFeatures<ST>::compute_feature_vector(int32_t num,
 	ASSERT(num<get_num_vectors())
 
 	int32_t real_num=m_subset_stack->subset_idx_conversion(num);
+	if (is_packed())
+		return compute_packed_vector(real_num, len);
 
 	len=features[real_num].vlen;
 	if (len<=0)
@@ -1515,6 +1567,195 @@ template<class ST> ST* CStringFeatures<ST>::compute_feature_vector(int32_t num,
 	return target;
 }
 
+template<class ST> int32_t CStringFeatures<ST>::get_packed_vector_length(int32_t real_num) const
+{
+	int32_t len=m_packed_lengths[real_num];
+	if (m_packed_kmers)
+		len=CMath::max(len-m_packed_start-m_packed_gap, 0);
+
+	return len;
+}
+
+template<class ST> ST* CStringFeatures<ST>::compute_packed_vector(int32_t real_num, int32_t& len) const
+{
+	len=get_packed_vector_length(real_num);
+	if (len<=0)
+		return NULL;
+
+	ST* target=SG_MALLOC(ST, len);
+	const uint64_t* words=m_packed_symbols.vector+m_packed_offsets[real_num];
+	if (m_packed_kmers)
+	{
+		CAlphabet::translate_from_packed(words, m_packed_lengths[real_num],
+				m_packed_start+m_packed_gap, order+m_packed_gap, m_packed_bits,
+				m_packed_gap, m_packed_reversed, target);
+	}
+	else if constexpr (sizeof(ST)==1)
+		alphabet->unpack_string(words, len, (uint8_t*) target);
+
+	return target;
+}
+
+template<class ST> bool CStringFeatures<ST>::is_packed() const
+{
+	return m_packed_symbols.vlen>0;
+}
+
+template<class ST> void CStringFeatures<ST>::set_packed(SGVector<uint64_t> symbols,
+		SGVector<int64_t> offsets, SGVector<int32_t> lengths, int32_t bits)
+{
+	m_packed_symbols=symbols;
+	m_packed_offsets=offsets;
+	m_packed_lengths=lengths;
+	m_packed_bits=bits;
+
+	/* the string list stays empty, so only the packed strings are
+	 * serialized, compared and cloned */
+	features.clear();
+}
+
+template<class ST> void CStringFeatures<ST>::pack()
+{
+	require(
+		get_feature_type()==F_CHAR || get_feature_type()==F_BYTE,
+		"Only strings of characters can be packed");
+	require(!single_string.vector, "Strings of a sliding window can not be packed");
+	if (is_packed())
+		return;
+
+	int32_t bits=alphabet->get_num_packed_bits();
+	require(bits>0, "Strings of alphabet {} can not be packed",
+			CAlphabet::get_alphabet_name(alphabet->get_alphabet()));
+
+	int32_t num_strings=features.size();
+	SGVector<int64_t> offsets(num_strings);
+	SGVector<int32_t> lengths(num_strings);
+	int64_t num_words=0;
+	for (int32_t i=0; i<num_strings; i++)
+	{
+		offsets[i]=num_words;
+		lengths[i]=features[i].vlen;
+		num_words+=alphabet->get_num_packed_words(lengths[i]);
+	}
+
+	SGVector<uint64_t> symbols(num_words+1);
+	symbols[num_words]=0;
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int32_t i=0; i<num_strings; i++)
+	{
+		alphabet->pack_string((const uint8_t*) features[i].vector, lengths[i],
+				symbols.vector+offsets[i]);
+	}
+
+	m_packed_kmers=false;
+	set_packed(symbols, offsets, lengths, bits);
+}
+
+template<class ST> void CStringFeatures<ST>::unpack()
+{
+	if (!is_packed())
+		return;
+
+	std::vector<SGVector<ST>> unpacked;
+	unpacked.reserve(m_packed_lengths.vlen);
+	for (index_t i=0; i<m_packed_lengths.vlen; i++)
+	{
+		int32_t len=0;
+		ST* vec=compute_packed_vector(i, len);
+		unpacked.emplace_back(vec, len);
+	}
+
+	features=std::move(unpacked);
+	m_packed_symbols=SGVector<uint64_t>();
+	m_packed_offsets=SGVector<int64_t>();
+	m_packed_lengths=SGVector<int32_t>();
+	m_packed_kmers=false;
+}
+
+template<class ST> bool CStringFeatures<ST>::obtain_from_packed_char(CStringFeatures<char>* sf,
+		int32_t start, int32_t p_order, int32_t gap, bool rev)
+{
+	remove_all_subsets();
+	ASSERT(sf)
+	require(start>=0 && p_order>0 && gap>=0,
+			"Invalid start ({}), order ({}) or gap ({})", start, p_order, gap);
+
+	CAlphabet* alpha=sf->get_alphabet();
+	int32_t bits=alpha->get_num_packed_bits();
+	EAlphabet alpha_type=alpha->get_alphabet();
+	original_num_symbols=alpha->get_num_symbols();
+	SG_UNREF(alpha);
+
+	require(bits>0, "Strings of alphabet {} can not be packed",
+			CAlphabet::get_alphabet_name(alpha_type));
+	require((p_order+gap)*bits<=64,
+			"Order {} with gap {} exceeds 64 bits", p_order, gap);
+
+	this->order=p_order;
+	cleanup();
+
+	if (p_order>1)
+		num_symbols=CMath::powl((floatmax_t) 2, (floatmax_t) bits*p_order);
+	else
+		num_symbols=original_num_symbols;
+
+	if ( ((floatmax_t) num_symbols) > CMath::powl(((floatmax_t) 2),((floatmax_t) sizeof(ST)*8)) )
+	{
+		error("{} bit k-mers do not fit into the datatype", bits*p_order);
+		return false;
+	}
+
+	int32_t num_vectors=sf->get_num_vectors();
+	ASSERT(num_vectors>0)
+	SGVector<int64_t> offsets(num_vectors);
+	SGVector<int32_t> lengths(num_vectors);
+	SGVector<uint64_t> symbols;
+
+	if (sf->is_packed())
+	{
+		/* share the packed strings */
+		for (int32_t i=0; i<num_vectors; i++)
+		{
+			int32_t real_i=sf->m_subset_stack->subset_idx_conversion(i);
+			offsets[i]=sf->m_packed_offsets[real_i];
+			lengths[i]=sf->m_packed_lengths[real_i];
+		}
+		symbols=sf->m_packed_symbols;
+	}
+	else
+	{
+		int64_t num_words=0;
+		for (int32_t i=0; i<num_vectors; i++)
+		{
+			offsets[i]=num_words;
+			lengths[i]=sf->get_vector_length(i);
+			num_words+=sf->alphabet->get_num_packed_words(lengths[i]);
+		}
+
+		symbols=SGVector<uint64_t>(num_words+1);
+		symbols[num_words]=0;
+		for (int32_t i=0; i<num_vectors; i++)
+		{
+			int32_t len=-1;
+			bool vfree;
+			char* c=sf->get_feature_vector(i, len, vfree);
+			sf->alphabet->pack_string((const uint8_t*) c, len, symbols.vector+offsets[i]);
+			sf->free_feature_vector(c, i, vfree);
+		}
+	}
+
+	m_packed_kmers=true;
+	m_packed_start=start;
+	m_packed_gap=gap;
+	m_packed_reversed=rev;
+	set_packed(symbols, offsets, lengths, bits);
+
+	compute_symbol_mask_table(bits);
+
+	return true;
+}
+
 template<class ST> void CStringFeatures<ST>::init()
 {
 	set_generic<ST>();
@@ -1528,6 +1769,11 @@ template<class ST> void CStringFeatures<ST>::init()
 	symbol_mask_table=SGVector<ST>();
 	num_symbols=0.0;
 	original_num_symbols=0;
+	m_packed_bits=0;
+	m_packed_kmers=false;
+	m_packed_start=0;
+	m_packed_gap=0;
+	m_packed_reversed=false;
 
 	SG_ADD(&alphabet, "alphabet", "Alphabet used.");
 
@@ -1548,6 +1794,22 @@ template<class ST> void CStringFeatures<ST>::init()
 	SG_ADD(
 		&symbol_mask_table, "mask_table",
 		"Symbol mask table - using in higher order mapping");
+	SG_ADD(&m_packed_symbols, "packed_symbols", "Symbols of packed strings.");
+	SG_ADD(
+		&m_packed_offsets, "packed_offsets",
+		"First word of every packed string.");
+	SG_ADD(
+		&m_packed_lengths, "packed_lengths",
+		"Number of symbols of every packed string.");
+	SG_ADD(&m_packed_bits, "packed_bits", "Bits of a packed symbol.");
+	SG_ADD(
+		&m_packed_kmers, "packed_kmers",
+		"Whether k-mers are extracted from the packed strings.");
+	SG_ADD(&m_packed_start, "packed_start", "Start of packed k-mers.");
+	SG_ADD(&m_packed_gap, "packed_gap", "Gap of packed k-mers.");
+	SG_ADD(
+		&m_packed_reversed, "packed_reversed",
+		"Whether packed k-mers are reversed.");
 
 	watch_param("string_list", &features);
 	watch_method("num_vectors", &CStringFeatures::get_num_vectors);
@@ -1806,6 +2068,7 @@ template<> void CStringFeatures<sg_type>::save(CFile* writer)		\
 	if (m_subset_stack->has_subsets())															\
 		error("save() is not possible on subset");						\
 	SG_SET_LOCALE_C;													\
+	require(!is_packed(), "save() is not possible on packed strings");	\
 	ASSERT(writer)															\
 	writer->f_write(features.data(), get_num_vectors());				\
 	SG_RESET_LOCALE;													\
@@ -1851,12 +2114,13 @@ bool CStringFeatures<ST>::obtain_from_char_features(CStringFeatures<CT>* sf, int
 		int32_t len=-1;
 		bool vfree;
 		CT* c=sf->get_feature_vector(i, len, vfree);
-		ASSERT(!vfree) // won't work when preprocessors are attached
+		ASSERT(!vfree || sf->is_packed()) // won't work when preprocessors are attached
 
 		features.emplace_back(len);
 
 		for (int32_t j=0; j<len; j++)
 			features.back()[j]=(ST) alpha->remap_to_bin(c[j]);
+		sf->free_feature_vector(c, i, vfree);
 	}
 
 	original_num_symbols=alpha->get_num_symbols();
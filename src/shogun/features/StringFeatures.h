@@ -60,6 +60,10 @@ struct SSKTripleFeature
  * as some algorithms depend on this.
  *
  * Also note that string features cannot currently be computed on-the-fly.
+ * The exception are packed strings: strings of alphabets with 1, 2 or 4 bit
+ * symbols, e.g. DNA, can be stored packed (see pack() and
+ * obtain_from_packed_char()), in which case the strings or their k-mers are
+ * unpacked whenever a feature vector is requested.
  *
  * (Partly) subset access is supported for this feature type.
  * Simple use the (inherited) add_subset(), remove_subset() functions.
@@ -533,6 +537,41 @@ template <class ST> class CStringFeatures : public CFeatures
 			bool obtain_from_char_features(CStringFeatures<CT>* sf, int32_t start,
 					int32_t p_order, int32_t gap, bool rev);
 
+		/** obtain string features from char features like obtain_from_char(),
+		 * but keep the symbols packed and extract the k-mers of a string
+		 * whenever its feature vector is requested
+		 *
+		 * the packed symbols of sf are shared if sf is packed, otherwise
+		 * the strings of sf are packed. Attached preprocessors are applied
+		 * to the extracted k-mers.
+		 *
+		 * any subset is removed before, subset of parameter sf is possible
+		 *
+		 * @param sf string features of an alphabet that can be packed
+		 * @param start start
+		 * @param p_order order
+		 * @param gap gap
+		 * @param rev reverse
+		 * @return if obtaining was successful
+		 */
+		bool obtain_from_packed_char(CStringFeatures<char>* sf, int32_t start,
+				int32_t p_order, int32_t gap, bool rev);
+
+		/** pack the strings with CAlphabet::get_num_packed_bits() bits per
+		 * symbol, they are unpacked whenever a feature vector is requested
+		 *
+		 * only possible for strings of characters of an alphabet that can be
+		 * packed. Packed strings can not be modified and attached
+		 * preprocessors are applied to the unpacked strings.
+		 */
+		void pack();
+
+		/** unpack packed strings, or store the k-mers of packed strings */
+		void unpack();
+
+		/** @return whether the strings are packed */
+		bool is_packed() const;
+
 		/** check if length of each vector in this feature object equals the
 		 * given length. if existant, only subset is checked
 		 *
@@ -639,11 +678,39 @@ template <class ST> class CStringFeatures : public CFeatures
 	private:
 		void init();
 
+		/** unpack a packed string or extract its k-mers
+		 *
+		 * @param real_num index of the string ignoring subsets
+		 * @param len length of vector
+		 * @return feature vector
+		 */
+		ST* compute_packed_vector(int32_t real_num, int32_t& len) const;
+
+		/** length of an unpacked string or of its number of k-mers
+		 *
+		 * @param real_num index of the string ignoring subsets
+		 * @return length of the feature vector
+		 */
+		int32_t get_packed_vector_length(int32_t real_num) const;
+
+		/** set the packed strings and clear the string list
+		 *
+		 * @param symbols packed symbols
+		 * @param offsets first word of every string
+		 * @param lengths number of symbols of every string
+		 * @param bits number of bits of a symbol
+		 */
+		void set_packed(SGVector<uint64_t> symbols, SGVector<int64_t> offsets,
+				SGVector<int32_t> lengths, int32_t bits);
+
+		template <class> friend class CStringFeatures;
+
 	protected:
 		/** alphabet */
 		CAlphabet* alphabet;
 
-		/** this contains the array of features */
+		/** this contains the array of features, empty while the strings
+		 * are packed */
 		std::vector<SGVector<ST>> features;
 
 		/** true when single string / created by sliding window */
@@ -666,6 +733,30 @@ template <class ST> class CStringFeatures : public CFeatures
 
 		/** feature cache */
 		CCache<ST>* feature_cache;
+
+		/** symbols of packed strings, followed by one unused word */
+		SGVector<uint64_t> m_packed_symbols;
+
+		/** first word of every packed string */
+		SGVector<int64_t> m_packed_offsets;
+
+		/** number of symbols of every packed string */
+		SGVector<int32_t> m_packed_lengths;
+
+		/** number of bits of a packed symbol */
+		int32_t m_packed_bits;
+
+		/** whether the k-mers of the packed strings are the features */
+		bool m_packed_kmers;
+
+		/** start of the k-mers of packed strings */
+		int32_t m_packed_start;
+
+		/** gap of the k-mers of packed strings */
+		int32_t m_packed_gap;
+
+		/** whether the k-mers of packed strings are reversed */
+		bool m_packed_reversed;
 };
 }
 #endif // _CSTRINGFEATURES__H__
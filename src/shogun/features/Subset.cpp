@@ -19,6 +19,7 @@ CSubset::CSubset(const SGVector<index_t>& subset_idx)
 	init();
 
 	m_subset_idx = subset_idx.clone();
+	update_stride();
 }
 
 CSubset::~CSubset()
@@ -28,4 +29,29 @@ CSubset::~CSubset()
 void CSubset::init()
 {
 	SG_ADD(&m_subset_idx, "subset", "Vector of subset indices");
+	m_stride = 0;
+}
+
+void CSubset::load_serializable_post() noexcept(false)
+{
+	CSGObject::load_serializable_post();
+	update_stride();
+}
+
+void CSubset::update_stride()
+{
+	m_stride = 0;
+	if (!m_subset_idx.vlen)
+		return;
+
+	index_t stride = m_subset_idx.vlen>1 ? m_subset_idx[1]-m_subset_idx[0] : 1;
+	if (stride<=0)
+		return;
+
+	for (index_t i=2; i<m_subset_idx.vlen; ++i)
+	{
+		if (m_subset_idx[i]-m_subset_idx[i-1]!=stride)
+			return;
+	}
+	m_stride = stride;
 }
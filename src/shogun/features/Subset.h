@@ -44,11 +44,27 @@ public:
 	/** get subset indices */
 	SGVector<index_t> get_subset_idx() const { return m_subset_idx; }
 
+	/** @return distance of consecutive indices if all indices increase by
+	 * the same positive amount, 0 otherwise */
+	index_t get_stride() const { return m_stride; }
+
+	/** @return whether the indices are a range of consecutive indices */
+	bool is_contiguous() const { return m_stride==1; }
+
+	/** updates the stride after loading */
+	virtual void load_serializable_post() noexcept(false);
+
 private:
 	void init();
 
+	/** computes the stride of the indices */
+	void update_stride();
+
 private:
 	SGVector<index_t> m_subset_idx;
+
+	/** stride of the indices, 0 if they are not equally spaced */
+	index_t m_stride;
 };
 
 }
@@ -103,7 +103,20 @@ public:
 	 */
 	inline index_t subset_idx_conversion(index_t idx) const
 	{
-		return m_active_subset ? m_active_subset->m_subset_idx.vector[idx] : idx;
+		if (!m_active_subset)
+			return idx;
+
+		/* equally spaced indices are computed instead of looked up */
+		auto stride=m_active_subset->m_stride;
+		return stride ? m_active_subset->m_subset_idx.vector[0]+idx*stride :
+			m_active_subset->m_subset_idx.vector[idx];
+	}
+
+	/** @return true iff a subset was added and its indices are a range of
+	 * consecutive indices, which then is a block of the data */
+	inline bool is_contiguous() const
+	{
+		return m_active_subset && m_active_subset->is_contiguous();
 	}
 
 private:
@@ -9,7 +9,9 @@
 #include <shogun/lib/Hash.h>
 #include <shogun/mathematics/Math.h>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace shogun
 {
@@ -30,6 +32,9 @@ CHashedDocDotFeatures::CHashedDocDotFeatures(const CHashedDocDotFeatures& orig)
 {
 	init(orig.num_bits, orig.doc_collection, orig.tokenizer, orig.should_normalize,
 			orig.ngrams, orig.tokens_to_skip);
+	m_offsets = orig.m_offsets;
+	m_indices = orig.m_indices;
+	m_values = orig.m_values;
 }
 
 CHashedDocDotFeatures::CHashedDocDotFeatures(CFile* loader)
@@ -98,50 +103,54 @@ float64_t CHashedDocDotFeatures::dot(int32_t vec_idx1, CDotFeatures* df, int32_t
 	return result;
 }
 
-float64_t CHashedDocDotFeatures::dot(
-	int32_t vec_idx1, const SGVector<float64_t>& vec2) const
+template <class F>
+void CHashedDocDotFeatures::hash_document(const SGVector<char>& doc,
+	CTokenizer* tzer, F&& visit) const
 {
-	ASSERT(vec2.size() == std::pow(2,num_bits))
+	/** the tokens are collected first to hash them in batches */
+	std::vector<int32_t> starts;
+	std::vector<int32_t> lengths;
+	tzer->set_text(doc);
+	index_t start = 0;
+	while (tzer->has_next())
+	{
+		index_t end = tzer->next_token_idx(start);
+		starts.push_back(start);
+		lengths.push_back(end-start);
+	}
 
-	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
+	const int32_t seed = 0xdeadbeaf;
+	const index_t num_tokens = starts.size();
+	std::vector<uint32_t> token_hashes(num_tokens);
+	CHash::MurmurHash3((const uint8_t*) doc.vector, starts.data(),
+		lengths.data(), num_tokens, seed, token_hashes.data());
 
 	/** this vector will maintain the current n+k active tokens
 	 * in a circular manner */
 	SGVector<uint32_t> hashes(ngrams+tokens_to_skip);
 	index_t hashes_start = 0;
 	index_t hashes_end = 0;
-	int32_t len = hashes.vlen - 1;
+	index_t len = hashes.vlen - 1;
 
 	/** the combinations generated from the current active tokens will be
 	 * stored here to avoid creating new objects */
 	SGVector<index_t> hashed_indices((ngrams-1)*(tokens_to_skip+1) + 1);
 
-	float64_t result = 0;
-	CTokenizer* local_tzer = tokenizer->get_copy();
-
 	/** Reading n+k-1 tokens */
-	const int32_t seed = 0xdeadbeaf;
-	local_tzer->set_text(sv);
-	index_t start = 0;
-	while (hashes_end<ngrams-1+tokens_to_skip && local_tzer->has_next())
-	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end++] = token_hash;
-	}
+	index_t token = 0;
+	while (hashes_end<ngrams-1+tokens_to_skip && token<num_tokens)
+		hashes[hashes_end++] = token_hashes[token++];
 
-	/** Reading token and storing indices to hashed_indices */
-	while (local_tzer->has_next())
+	/** Reading token and visiting the indices of hashed_indices */
+	for (; token<num_tokens; token++)
 	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end] = token_hash;
+		hashes[hashes_end] = token_hashes[token];
 
 		CHashedDocConverter::generate_ngram_hashes(hashes, hashes_start, len, hashed_indices,
 				num_bits, ngrams, tokens_to_skip);
 
 		for (index_t i=0; i<hashed_indices.vlen; i++)
-			result += vec2[hashed_indices[i]];
+			visit(hashed_indices[i]);
 
 		hashes_start++;
 		hashes_end++;
@@ -160,16 +169,41 @@ float64_t CHashedDocDotFeatures::dot(
 					len, hashed_indices, num_bits, ngrams, tokens_to_skip);
 
 			for (index_t i=0; i<max_idx; i++)
-				result += vec2[hashed_indices[i]];
+				visit(hashed_indices[i]);
 
 			hashes_start++;
 			if (hashes_start==hashes.vlen)
 				hashes_start = 0;
 		}
 	}
+}
+
+float64_t CHashedDocDotFeatures::normalization(index_t doc_size) const
+{
+	return should_normalize ? std::sqrt((float64_t)doc_size) : 1.0;
+}
+
+float64_t CHashedDocDotFeatures::dot(
+	int32_t vec_idx1, const SGVector<float64_t>& vec2) const
+{
+	ASSERT(vec2.size() == std::pow(2,num_bits))
+
+	float64_t result = 0;
+	if (is_materialized())
+	{
+		for (int64_t i=m_offsets[vec_idx1]; i<m_offsets[vec_idx1+1]; i++)
+			result += m_values[i] * vec2[m_indices[i]];
+		return result;
+	}
+
+	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
+	CTokenizer* local_tzer = tokenizer->get_copy();
+	hash_document(sv, local_tzer, [&](index_t idx) { result += vec2[idx]; });
+	result /= normalization(sv.size());
+
 	doc_collection->free_feature_vector(sv, vec_idx1);
 	SG_UNREF(local_tzer);
-	return should_normalize ? result / std::sqrt((float64_t)sv.size()) : result;
+	return result;
 }
 
 void CHashedDocDotFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1,
@@ -180,73 +214,88 @@ void CHashedDocDotFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1,
 	if (abs_val)
 		alpha = CMath::abs(alpha);
 
+	if (is_materialized())
+	{
+		for (int64_t i=m_offsets[vec_idx1]; i<m_offsets[vec_idx1+1]; i++)
+			vec2[m_indices[i]] += alpha * m_values[i];
+		return;
+	}
+
 	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
-	const float64_t value =
-		should_normalize ? alpha / std::sqrt((float64_t)sv.size()) : alpha;
+	const float64_t value = alpha / normalization(sv.size());
 
-	/** this vector will maintain the current n+k active tokens
-	 * in a circular manner */
-	SGVector<uint32_t> hashes(ngrams+tokens_to_skip);
-	index_t hashes_start = 0;
-	index_t hashes_end = 0;
-	index_t len = hashes.vlen - 1;
+	CTokenizer* local_tzer = tokenizer->get_copy();
+	hash_document(sv, local_tzer, [&](index_t idx) { vec2[idx] += value; });
 
-	/** the combinations generated from the current active tokens will be
-	 * stored here to avoid creating new objects */
-	SGVector<index_t> hashed_indices((ngrams-1)*(tokens_to_skip+1) + 1);
+	doc_collection->free_feature_vector(sv, vec_idx1);
+	SG_UNREF(local_tzer);
+}
 
-	CTokenizer* local_tzer = tokenizer->get_copy();
+void CHashedDocDotFeatures::materialize()
+{
+	require(doc_collection, "No document collection set");
 
-	/** Reading n+k-1 tokens */
-	const int32_t seed = 0xdeadbeaf;
-	local_tzer->set_text(sv);
-	index_t start = 0;
-	while (hashes_end<ngrams-1+tokens_to_skip && local_tzer->has_next())
-	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end++] = token_hash;
-	}
+	const index_t num_docs = doc_collection->get_num_vectors();
+	std::vector<std::vector<index_t>> doc_indices(num_docs);
+	std::vector<std::vector<float64_t>> doc_values(num_docs);
 
-	while (local_tzer->has_next())
+	#pragma omp parallel
 	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end] = token_hash;
-
-		CHashedDocConverter::generate_ngram_hashes(hashes, hashes_start, len, hashed_indices,
-				num_bits, ngrams, tokens_to_skip);
+		CTokenizer* local_tzer = tokenizer->get_copy();
+		std::vector<index_t> hashed;
 
-		for (index_t i=0; i<hashed_indices.vlen; i++)
-			vec2[hashed_indices[i]] += value;
+		#pragma omp for schedule(dynamic, 64)
+		for (index_t vec_idx=0; vec_idx<num_docs; vec_idx++)
+		{
+			SGVector<char> sv = doc_collection->get_feature_vector(vec_idx);
+			hashed.clear();
+			hash_document(sv, local_tzer,
+				[&](index_t idx) { hashed.push_back(idx); });
+
+			/** every index is stored once with its number of occurrences */
+			std::sort(hashed.begin(), hashed.end());
+			const float64_t norm = normalization(sv.size());
+			auto& indices = doc_indices[vec_idx];
+			auto& values = doc_values[vec_idx];
+			for (size_t i=0; i<hashed.size(); )
+			{
+				size_t j = i;
+				while (j<hashed.size() && hashed[j]==hashed[i])
+					j++;
+				indices.push_back(hashed[i]);
+				values.push_back((j-i) / norm);
+				i = j;
+			}
+			doc_collection->free_feature_vector(sv, vec_idx);
+		}
 
-		hashes_start++;
-		hashes_end++;
-		if (hashes_end==hashes.vlen)
-			hashes_end = 0;
-		if (hashes_start==hashes.vlen)
-			hashes_start = 0;
+		SG_UNREF(local_tzer);
 	}
 
-	if (ngrams>1)
-	{
-		while (hashes_start!=hashes_end)
-		{
-			len--;
-			index_t max_idx = CHashedDocConverter::generate_ngram_hashes(hashes,
-					hashes_start, len, hashed_indices, num_bits, ngrams, tokens_to_skip);
+	SGVector<int64_t> offsets(num_docs+1);
+	offsets[0] = 0;
+	for (index_t vec_idx=0; vec_idx<num_docs; vec_idx++)
+		offsets[vec_idx+1] = offsets[vec_idx] + doc_indices[vec_idx].size();
 
-			for (index_t i=0; i<max_idx; i++)
-				vec2[hashed_indices[i]] += value;
-
-			hashes_start++;
-			if (hashes_start==hashes.vlen)
-				hashes_start = 0;
-		}
+	SGVector<index_t> indices(offsets[num_docs]);
+	SGVector<float64_t> values(offsets[num_docs]);
+	#pragma omp parallel for
+	for (index_t vec_idx=0; vec_idx<num_docs; vec_idx++)
+	{
+		std::copy(doc_indices[vec_idx].begin(), doc_indices[vec_idx].end(),
+			indices.vector + offsets[vec_idx]);
+		std::copy(doc_values[vec_idx].begin(), doc_values[vec_idx].end(),
+			values.vector + offsets[vec_idx]);
 	}
 
-	doc_collection->free_feature_vector(sv, vec_idx1);
-	SG_UNREF(local_tzer);
+	m_offsets = offsets;
+	m_indices = indices;
+	m_values = values;
+}
+
+bool CHashedDocDotFeatures::is_materialized() const
+{
+	return m_offsets.vlen > 0;
 }
 
 uint32_t CHashedDocDotFeatures::calculate_token_hash(char* token,
@@ -260,10 +309,16 @@ void CHashedDocDotFeatures::set_doc_collection(CStringFeatures<char>* docs)
 {
 	SG_UNREF(doc_collection);
 	doc_collection = docs;
+	m_offsets = SGVector<int64_t>();
+	m_indices = SGVector<index_t>();
+	m_values = SGVector<float64_t>();
 }
 
 int32_t CHashedDocDotFeatures::get_nnz_features_for_vector(int32_t num) const
 {
+	if (is_materialized())
+		return m_offsets[num+1] - m_offsets[num];
+
 	SGVector<char> sv = doc_collection->get_feature_vector(num);
 	int32_t num_nnz_features = sv.size();
 	doc_collection->free_feature_vector(sv, num);
@@ -144,6 +144,21 @@ public:
 	 */
 	void set_doc_collection(CStringFeatures<char>* docs);
 
+	/** hash all documents once and store the hashed vectors in compressed
+	 * sparse row format. The documents are tokenized and hashed in
+	 * parallel. Afterwards dot() with a dense vector and
+	 * add_to_dense_vec() read the stored vectors instead of tokenizing
+	 * the documents again, which pays off when the features are passed
+	 * over several times, e.g. in the epochs of a linear machine.
+	 *
+	 * The stored vectors refer to the documents at the time of the call,
+	 * setting another document collection drops them.
+	 */
+	void materialize();
+
+	/** @return whether the hashed vectors are stored */
+	bool is_materialized() const;
+
 	virtual const char* get_name() const;
 
 	/** duplicate feature object
@@ -185,6 +200,20 @@ private:
 	void init(int32_t hash_bits, CStringFeatures<char>* docs, CTokenizer* tzer,
 		bool normalize, int32_t n_grams, int32_t skips);
 
+	/** tokenize a document, hash its tokens and call visit with the index
+	 * of every hashed token and combination of tokens
+	 *
+	 * @param doc the document
+	 * @param tzer tokenizer that is used by the calling thread only
+	 * @param visit function that is called with every index
+	 */
+	template <class F>
+	void hash_document(const SGVector<char>& doc, CTokenizer* tzer,
+		F&& visit) const;
+
+	/** @return divisor of the vector of a document of given size */
+	float64_t normalization(index_t doc_size) const;
+
 protected:
 	/** the document collection*/
 	CStringFeatures<char>* doc_collection;
@@ -203,6 +232,14 @@ protected:
 
 	/** tokens to skip when combining tokens */
 	int32_t tokens_to_skip;
+
+	/** start of every stored vector in m_indices, with an end entry,
+	 * empty if the vectors are not stored */
+	SGVector<int64_t> m_offsets;
+	/** sorted unique indices of the stored vectors */
+	SGVector<index_t> m_indices;
+	/** normalized number of occurrences of the stored indices */
+	SGVector<float64_t> m_values;
 };
 }
 
@@ -23,8 +23,9 @@ public:
 	void SetUp(const ::benchmark::State& st)
 	{
 		std::random_device rd;
-		std::mt19937_64 prng(rd);
+		std::mt19937_64 prng(rd());
 		UniformIntDistribution<char> uniform_int_dist('A', 'Z');
+		string_list.clear();
 		string_list.reserve(num_strings);
 		for (index_t i=0; i<num_strings; i++)
 		{
@@ -35,6 +36,8 @@ public:
 		auto string_feats = new CStringFeatures<char>(string_list, RAWBYTE);
 		auto tzer = new CNGramTokenizer(3);
 		f = std::make_shared<CHashedDocDotFeatures>(st.range(0), string_feats, tzer);
+		if (st.range(1))
+			f->materialize();
 
 		w = SGVector<float64_t>(f->get_dim_feature_space());
 		w.range_fill(17.0);
@@ -50,10 +53,40 @@ public:
 	SGVector<float64_t> w;
 };
 
+/** number of hash bits, whether the features are materialized */
+static void hasheddoc_args(benchmark::internal::Benchmark* b)
+{
+	for (auto bits : {8, 10, 12, 16, 20})
+		for (auto materialized : {0, 1})
+			b->Args({bits, materialized});
+}
+
 #define ADD_HASHEDDOC_ARGS(WHAT)	\
-	WHAT->Arg(8)->Arg(10)->Arg(12)->Arg(16)->Arg(20)->Unit(benchmark::kMillisecond)
+	WHAT->Apply(hasheddoc_args)->Unit(benchmark::kMillisecond)
+
+/** one epoch of stochastic gradient descent like a linear machine does */
+BENCHMARK_DEFINE_F(HDFixture, HashedDocDotFeatures_Epoch)(benchmark::State& state)
+{
+	index_t dim = f->get_dim_feature_space();
+	for (auto _ : state)
+	{
+		for (index_t i = 0; i < f->get_num_vectors(); ++i)
+		{
+			float64_t residual = f->dot(i, w) - 1.0;
+			f->add_to_dense_vec(-1e-6 * residual, i, w.vector, dim);
+		}
+	}
+}
 
+BENCHMARK_DEFINE_F(HDFixture, HashedDocDotFeatures_Materialize)(benchmark::State& state)
+{
+	for (auto _ : state)
+		f->materialize();
+}
 
 ADD_HASHEDDOC_ARGS(DOTFEATURES_BENCHMARK_DENSEDOT(HDFixture, HashedDocDotFeatures_DenseDot));
 ADD_HASHEDDOC_ARGS(DOTFEATURES_BENCHMARK_ADDDENSE(HDFixture, HashedDocDotFeatures_AddDense));
+ADD_HASHEDDOC_ARGS(BENCHMARK_REGISTER_F(HDFixture, HashedDocDotFeatures_Epoch));
+BENCHMARK_REGISTER_F(HDFixture, HashedDocDotFeatures_Materialize)
+	->Args({8, 0})->Args({20, 0})->Unit(benchmark::kMillisecond);
 }
@@ -61,7 +61,13 @@ template<class T> CStreamingDenseFeatures<T>::~CStreamingDenseFeatures()
 
 template<class T> void CStreamingDenseFeatures<T>::reset_stream()
 {
-	if (seekable)
+	if (seekable && batch_parser)
+	{
+		end_parser();
+		((CStreamingFileFromDenseFeatures<T>*)working_file)->reset_stream();
+		start_parser();
+	}
+	else if (seekable)
 	{
 		((CStreamingFileFromDenseFeatures<T>*)working_file)->reset_stream();
 		if (parser.is_running())
@@ -184,6 +190,7 @@ void CStreamingDenseFeatures<T>::init()
 	/* needed to prevent double free memory errors */
 	current_vector.vector=NULL;
 	current_vector.vlen=-1;
+	current_batch_index=0;
 
 	set_generic<T>();
 }
@@ -203,13 +210,32 @@ void CStreamingDenseFeatures<T>::init(CStreamingFile* file, bool is_labelled,
 template<class T>
 void CStreamingDenseFeatures<T>::start_parser()
 {
-	if (!parser.is_running())
+	if (m_batch_size>0)
+	{
+		if (batch_parser && batch_parser->is_running())
+			return;
+
+		batch_parser.reset(new BatchInputParser<T>(working_file, has_labels,
+				false, m_batch_size, m_num_batch_threads));
+		current_batch.reset();
+		current_batch_index=0;
+		batch_parser->start();
+	}
+	else if (!parser.is_running())
 		parser.start_parser();
 }
 
 template<class T>
 void CStreamingDenseFeatures<T>::end_parser()
 {
+	if (batch_parser)
+	{
+		/* the current vector points into the batch */
+		current_vector.vector=NULL;
+		current_vector.vlen=-1;
+		current_batch.reset();
+		batch_parser.reset();
+	}
 	parser.end_parser();
 }
 
@@ -217,6 +243,26 @@ template<class T>
 bool CStreamingDenseFeatures<T>::get_next_example()
 {
 	SG_DEBUG("entering");
+	if (batch_parser)
+	{
+		if (!current_batch || current_batch_index>=current_batch->num_vectors)
+		{
+			current_batch=batch_parser->next_batch();
+			current_batch_index=0;
+			if (!current_batch)
+				return false;
+		}
+
+		/* the batch owns the memory, like the parser's ring otherwise */
+		current_vector.vector=
+				current_batch->matrix.get_column_vector(current_batch_index);
+		current_vector.vlen=current_batch->matrix.num_rows;
+		if (has_labels)
+			current_label=current_batch->labels[current_batch_index];
+		current_batch_index++;
+		return true;
+	}
+
 	bool ret_value;
 	ret_value=(bool)parser.get_next_example(current_vector.vector,
 			current_vector.vlen, current_label);
@@ -242,7 +288,9 @@ float64_t CStreamingDenseFeatures<T>::get_label()
 template<class T>
 void CStreamingDenseFeatures<T>::release_example()
 {
-	parser.finalize_example();
+	/* examples of a batch are released with the batch */
+	if (!batch_parser)
+		parser.finalize_example();
 }
 
 template<class T>
@@ -358,6 +406,26 @@ CFeatures* CStreamingDenseFeatures<T>::get_streamed_features(
 	return result;
 }
 
+template<class T>
+CDotFeatures* CStreamingDenseFeatures<T>::get_next_batch(
+		SGVector<float64_t>& labels)
+{
+	require(batch_parser, "Batches are not enabled, call set_batch_size() "
+			"before start_parser()");
+
+	/* the remaining examples of the current batch are skipped */
+	current_batch=batch_parser->next_batch();
+	current_batch_index=0;
+	current_vector.vector=NULL;
+	current_vector.vlen=-1;
+	if (!current_batch)
+		return NULL;
+
+	current_batch_index=current_batch->num_vectors;
+	labels=current_batch->labels;
+	return new CDenseFeatures<T>(current_batch->matrix);
+}
+
 template class CStreamingDenseFeatures<bool> ;
 template class CStreamingDenseFeatures<char> ;
 template class CStreamingDenseFeatures<int8_t> ;
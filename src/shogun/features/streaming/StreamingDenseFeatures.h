@@ -14,6 +14,9 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/DataType.h>
 #include <shogun/io/streaming/InputParser.h>
+#include <shogun/io/streaming/BatchInputParser.h>
+
+#include <memory>
 
 namespace shogun
 {
@@ -266,6 +269,15 @@ public:
 	 */
 	virtual CFeatures* get_streamed_features(index_t num_elements);
 
+	/** Return the next mini-batch of the stream as CDenseFeatures, the
+	 * matrix of which is filled by the parser threads without copying.
+	 *
+	 * @param labels returns the labels of the batch if the stream is labelled
+	 * @return features of the batch (not SG_REF'ed), NULL at the end of the
+	 * stream
+	 */
+	virtual CDotFeatures* get_next_batch(SGVector<float64_t>& labels);
+
 private:
 	/**
 	 * Initializes members to null values.
@@ -295,6 +307,15 @@ protected:
 
 	/// The current example's label.
 	float64_t current_label;
+
+	/// Parser of mini-batches, if batches are enabled
+	std::unique_ptr<BatchInputParser<T>> batch_parser;
+
+	/// The batch of the current example
+	std::unique_ptr<StreamingBatch<T>> current_batch;
+
+	/// Index of the next example in the current batch
+	index_t current_batch_index;
 };
 }
 #endif // _STREAMINGDENSEFEATURES__H__
@@ -10,6 +10,8 @@ using namespace shogun;
 CStreamingDotFeatures::CStreamingDotFeatures() : CStreamingFeatures()
 {
 	set_property(FP_STREAMING_DOT);
+	m_batch_size=0;
+	m_num_batch_threads=1;
 }
 
 CStreamingDotFeatures::CStreamingDotFeatures(CDotFeatures* dot_features,
@@ -91,3 +93,24 @@ void CStreamingDotFeatures::free_feature_iterator(void* iterator)
 	not_implemented(SOURCE_LOCATION);
 	return;
 }
+
+void CStreamingDotFeatures::set_batch_size(index_t batch_size, int32_t num_threads)
+{
+	require(batch_size>=0, "Batch size ({}) must not be negative", batch_size);
+	require(num_threads>0, "Number of parser threads ({}) must be positive",
+			num_threads);
+
+	m_batch_size=batch_size;
+	m_num_batch_threads=num_threads;
+}
+
+index_t CStreamingDotFeatures::get_batch_size() const
+{
+	return m_batch_size;
+}
+
+CDotFeatures* CStreamingDotFeatures::get_next_batch(SGVector<float64_t>& labels)
+{
+	not_implemented(SOURCE_LOCATION);
+	return NULL;
+}
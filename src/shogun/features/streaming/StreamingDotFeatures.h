@@ -12,6 +12,7 @@
 #include <shogun/features/streaming/StreamingFeatures.h>
 #include <shogun/features/FeatureTypes.h>
 #include <shogun/lib/SGSparseVector.h>
+#include <shogun/lib/SGVector.h>
 
 namespace shogun
 {
@@ -184,6 +185,35 @@ public:
 	 */
 	virtual void free_feature_iterator(void* iterator);
 
+	/** Parse the stream in mini-batches on background threads instead of
+	 * handing over every example through the parser's ring. The examples
+	 * of a batch are still returned one by one by get_next_example(), but
+	 * the parser is only waited for once per batch. Has to be called before
+	 * start_parser().
+	 *
+	 * @param batch_size number of examples per batch, 0 disables batches
+	 * @param num_threads number of parser threads for text files
+	 */
+	void set_batch_size(index_t batch_size, int32_t num_threads=1);
+
+	/** @return number of examples per batch, 0 if batches are disabled */
+	index_t get_batch_size() const;
+
+	/** Return the next mini-batch of the stream, see set_batch_size().
+	 * The examples of the batch are not returned by get_next_example().
+	 *
+	 * @param labels returns the labels of the batch if the stream is labelled
+	 * @return features of the batch (not SG_REF'ed), NULL at the end of the
+	 * stream
+	 */
+	virtual CDotFeatures* get_next_batch(SGVector<float64_t>& labels);
+
+protected:
+	/// Number of examples per batch, 0 if batches are disabled
+	index_t m_batch_size;
+
+	/// Number of parser threads of batches
+	int32_t m_num_batch_threads;
 };
 }
 #endif // _STREAMING_DOTFEATURES__H__
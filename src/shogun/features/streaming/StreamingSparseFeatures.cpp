@@ -6,6 +6,7 @@
  */
 
 #include <shogun/features/streaming/StreamingSparseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/mathematics/Math.h>
 
 namespace shogun
@@ -262,6 +263,7 @@ void CStreamingSparseFeatures<T>::init()
 	working_file=NULL;
 	current_vec_index=0;
 	current_num_features=-1;
+	current_batch_index=0;
 
 	set_generic<T>();
 }
@@ -282,19 +284,63 @@ void CStreamingSparseFeatures<T>::init(CStreamingFile* file,
 template <class T>
 void CStreamingSparseFeatures<T>::start_parser()
 {
-	if (!parser.is_running())
+	if (m_batch_size > 0)
+	{
+		if (batch_parser && batch_parser->is_running())
+			return;
+
+		batch_parser.reset(new BatchInputParser<T>(working_file, has_labels,
+				true, m_batch_size, m_num_batch_threads));
+		current_batch.reset();
+		current_batch_index = 0;
+		batch_parser->start();
+	}
+	else if (!parser.is_running())
 		parser.start_parser();
 }
 
 template <class T>
 void CStreamingSparseFeatures<T>::end_parser()
 {
+	if (batch_parser)
+	{
+		// the current vector points into the batch
+		current_sgvector = SGSparseVector<T>();
+		current_batch.reset();
+		batch_parser.reset();
+	}
 	parser.end_parser();
 }
 
 template <class T>
 bool CStreamingSparseFeatures<T>::get_next_example()
 {
+	if (batch_parser)
+	{
+		if (!current_batch || current_batch_index >= current_batch->num_vectors)
+		{
+			current_batch = batch_parser->next_batch();
+			current_batch_index = 0;
+			if (!current_batch)
+				return false;
+
+			current_num_features = CMath::max(current_num_features,
+					current_batch->num_features);
+		}
+
+		// ref_count disabled, because the batch owns the memory
+		auto begin = current_batch->offsets[current_batch_index];
+		auto end = current_batch->offsets[current_batch_index + 1];
+		current_sgvector = SGSparseVector<T>(
+				current_batch->entries.data() + begin, end - begin, false);
+		if (has_labels)
+			current_label = current_batch->labels[current_batch_index];
+
+		current_batch_index++;
+		current_vec_index++;
+		return true;
+	}
+
 	int32_t current_length = 0;
 	SGSparseVectorEntry<T>* current_vector = NULL;
 
@@ -334,7 +380,9 @@ float64_t CStreamingSparseFeatures<T>::get_label()
 template <class T>
 void CStreamingSparseFeatures<T>::release_example()
 {
-	parser.finalize_example();
+	// examples of a batch are released with the batch
+	if (!batch_parser)
+		parser.finalize_example();
 }
 
 template <class T>
@@ -368,6 +416,38 @@ EFeatureClass CStreamingSparseFeatures<T>::get_feature_class() const
 	return C_STREAMING_SPARSE;
 }
 
+template <class T>
+CDotFeatures* CStreamingSparseFeatures<T>::get_next_batch(
+		SGVector<float64_t>& labels)
+{
+	require(batch_parser, "Batches are not enabled, call set_batch_size() "
+			"before start_parser()");
+
+	// the remaining examples of the current batch are skipped
+	current_sgvector = SGSparseVector<T>();
+	current_batch = batch_parser->next_batch();
+	current_batch_index = 0;
+	if (!current_batch)
+		return NULL;
+
+	current_batch_index = current_batch->num_vectors;
+	current_num_features = CMath::max(current_num_features,
+			current_batch->num_features);
+
+	SGSparseMatrix<T> matrix(current_num_features, current_batch->num_vectors);
+	for (index_t i = 0; i < current_batch->num_vectors; i++)
+	{
+		auto begin = current_batch->offsets[i];
+		auto len = current_batch->offsets[i + 1] - begin;
+		matrix[i] = SGSparseVector<T>(len);
+		sg_memcpy(matrix[i].features, current_batch->entries.data() + begin,
+				len * sizeof(SGSparseVectorEntry<T>));
+	}
+
+	labels = current_batch->labels;
+	return new CSparseFeatures<T>(matrix);
+}
+
 template class CStreamingSparseFeatures<bool>;
 template class CStreamingSparseFeatures<char>;
 template class CStreamingSparseFeatures<int8_t>;
@@ -12,9 +12,12 @@
 #include <shogun/lib/common.h>
 #include <shogun/features/streaming/StreamingDotFeatures.h>
 #include <shogun/io/streaming/InputParser.h>
+#include <shogun/io/streaming/BatchInputParser.h>
 #include <shogun/lib/SGSparseVector.h>
 #include <shogun/features/FeatureTypes.h>
 
+#include <memory>
+
 namespace shogun
 {
 class CStreamingFile;
@@ -319,6 +322,14 @@ public:
 	 */
 	virtual int32_t get_num_vectors() const;
 
+	/** Return the next mini-batch of the stream as CSparseFeatures.
+	 *
+	 * @param labels returns the labels of the batch if the stream is labelled
+	 * @return features of the batch (not SG_REF'ed), NULL at the end of the
+	 * stream
+	 */
+	virtual CDotFeatures* get_next_batch(SGVector<float64_t>& labels);
+
 private:
 	/**
 	 * Initializes members to null values.
@@ -350,6 +361,15 @@ protected:
 
 	/// Number of features in current vector (as seen so far upto the current vector)
 	int32_t current_num_features;
+
+	/// Parser of mini-batches, if batches are enabled
+	std::unique_ptr<BatchInputParser<T>> batch_parser;
+
+	/// The batch of the current example
+	std::unique_ptr<StreamingBatch<T>> current_batch;
+
+	/// Index of the next example in the current batch
+	index_t current_batch_index;
 };
 
 }
@@ -10,6 +10,7 @@
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/io/LineReader.h>
+#include <shogun/io/ParallelTextParser.h>
 #include <shogun/io/Parser.h>
 #include <shogun/lib/DelimiterTokenizer.h>
 
@@ -180,48 +181,11 @@ GET_VECTOR(read_ulong, uint64_t)
 #define GET_MATRIX(read_func, sg_type) \
 void CCSVFile::get_matrix(sg_type*& matrix, int32_t& num_feat, int32_t& num_vec) \
 { \
-	int32_t num_lines=0; \
-	int32_t num_tokens=-1; \
-	int32_t current_line_idx=0; \
-	SGVector<char> line; \
+	m_line_reader->reset(); \
 	\
-	skip_lines(m_num_to_skip); \
-	num_lines=get_stats(num_tokens); \
-	\
-	SG_SET_LOCALE_C; \
-	\
-	matrix=SG_MALLOC(sg_type, num_lines*num_tokens); \
-	skip_lines(m_num_to_skip); \
-	while (m_line_reader->has_next()) \
-	{ \
-		line=m_line_reader->read_line(); \
-		m_parser->set_text(line); \
-		\
-		for (int32_t i=0; i<num_tokens; i++) \
-		{ \
-			if (!m_parser->has_next()) \
-				return; \
-			\
-			if (!is_data_transposed) \
-				matrix[i+current_line_idx*num_tokens]=m_parser->read_func(); \
-			else \
-				matrix[current_line_idx+i*num_tokens]=m_parser->read_func(); \
-		} \
-		current_line_idx++; \
-	} \
-	\
-	SG_RESET_LOCALE; \
-	\
-	if (!is_data_transposed) \
-	{ \
-		num_feat=num_tokens; \
-		num_vec=num_lines; \
-	} \
-	else \
-	{ \
-		num_feat=num_lines; \
-		num_vec=num_tokens; \
-	} \
+	ParallelTextParser parser(file, m_num_to_skip); \
+	parser.parse_dense( \
+		matrix, num_feat, num_vec, m_delimiter, is_data_transposed); \
 }
 
 GET_MATRIX(read_char, int8_t)
@@ -24,6 +24,8 @@ template <class T> class SGSparseVector;
 
 /** @brief Class CSVFile used to read data from comma-separated values (CSV)
  * files. See http://en.wikipedia.org/wiki/Comma-separated_values.
+ *
+ * Matrices are parsed in parallel by ParallelTextParser.
  */
 class CCSVFile : public CFile
 {
@@ -0,0 +1,410 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <shogun/base/some.h>
+#include <shogun/io/CompressedIOBuffer.h>
+#include <shogun/io/SGIO.h>
+
+#ifdef USE_GZIP
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+
+using namespace shogun;
+
+namespace
+{
+/** identifier at the start of the file */
+const char file_id[4] = {'S', 'G', 'C', 'B'};
+
+/** size of the identifier and the compression type */
+constexpr int64_t header_size = sizeof(file_id) + sizeof(uint8_t);
+
+/** magic bytes at the start of a gzip stream */
+const uint8_t gzip_id[2] = {0x1f, 0x8b};
+
+/** compressed bytes that are read at once from a gzip stream */
+constexpr size_t gzip_chunk_size = 1 << 18;
+
+/** read until nbytes are read or the file ends
+ *
+ * @return number of bytes read
+ */
+size_t read_fully(int fd, void* buf, size_t nbytes)
+{
+	size_t total = 0;
+	while (total < nbytes)
+	{
+		ssize_t num_read = read(fd, (char*)buf + total, nbytes - total);
+		require(num_read >= 0, "Error reading compressed file");
+		if (num_read == 0)
+			break;
+		total += num_read;
+	}
+	return total;
+}
+
+/** write nbytes */
+void write_fully(int fd, const void* buf, size_t nbytes)
+{
+	size_t total = 0;
+	while (total < nbytes)
+	{
+		ssize_t num_written =
+		    write(fd, (const char*)buf + total, nbytes - total);
+		require(num_written > 0, "Error writing compressed file");
+		total += num_written;
+	}
+}
+}
+
+CCompressedIOBuffer::CCompressedIOBuffer() : CIOBuffer()
+{
+	init_blocks(UNCOMPRESSED, 1 << 20, 1);
+}
+
+CCompressedIOBuffer::CCompressedIOBuffer(
+    E_COMPRESSION_TYPE compression, int32_t block_size, int32_t level)
+    : CIOBuffer()
+{
+	require(block_size > 0, "Block size ({}) must be positive", block_size);
+	init_blocks(compression, block_size, level);
+}
+
+CCompressedIOBuffer::~CCompressedIOBuffer()
+{
+	stop_reading();
+}
+
+void CCompressedIOBuffer::init_blocks(
+    E_COMPRESSION_TYPE compression, int32_t block_size, int32_t level)
+{
+	m_compression = compression;
+	m_block_size = block_size;
+	m_level = level;
+	m_writing = false;
+	m_gzip = false;
+	m_first_block = header_size;
+	m_position = 0;
+	m_done = false;
+	m_cancel.store(false);
+}
+
+void CCompressedIOBuffer::use_file(int fd)
+{
+	stop_reading();
+	CIOBuffer::use_file(fd);
+
+	auto position = lseek(fd, 0, SEEK_CUR);
+	char id[sizeof(file_id)];
+	auto num_read = read_fully(fd, id, sizeof(id));
+	m_writing = false;
+	m_gzip =
+	    num_read >= sizeof(gzip_id) && !memcmp(id, gzip_id, sizeof(gzip_id));
+	if (m_gzip)
+	{
+#ifdef USE_GZIP
+		// the gzip header is parsed by zlib
+		require(position >= 0, "Gzip compressed input must be seekable");
+		lseek(fd, position, SEEK_SET);
+		m_compression = GZIP;
+		m_first_block = position;
+		start_reading();
+		return;
+#else
+		error("Reading gzip compressed files requires zlib");
+#endif
+	}
+
+	uint8_t compression;
+	require(
+	    num_read == sizeof(id) && !memcmp(id, file_id, sizeof(id)),
+	    "File is neither a block compressed nor a gzip compressed file");
+	require(
+	    read_fully(fd, &compression, sizeof(compression)) ==
+	        sizeof(compression),
+	    "Failed to read compression type");
+
+	m_compression = (E_COMPRESSION_TYPE)compression;
+	m_first_block = header_size;
+	start_reading();
+}
+
+int CCompressedIOBuffer::open_file(const char* name, char flag)
+{
+	if (flag == 'r')
+	{
+		int fd = open(name, O_RDONLY | O_LARGEFILE);
+		if (fd < 0)
+			return 0;
+
+		use_file(fd);
+		return 1;
+	}
+
+	int ret = CIOBuffer::open_file(name, flag);
+	if (ret && flag == 'w')
+	{
+		require(working_file >= 0, "Error opening file '{}'", name);
+		uint8_t compression = m_compression;
+		write_fully(working_file, file_id, sizeof(file_id));
+		write_fully(working_file, &compression, sizeof(compression));
+		m_writing = true;
+		m_pending.clear();
+	}
+	return ret;
+}
+
+void CCompressedIOBuffer::reset_file()
+{
+	require(!m_writing, "Unable to reset a written file");
+
+	stop_reading();
+	lseek(working_file, m_first_block, SEEK_SET);
+	endloaded = space.begin;
+	space.end = space.begin;
+	start_reading();
+}
+
+void CCompressedIOBuffer::start_reading()
+{
+	m_blocks.reset(new SPSCQueue<Block>(blocks_ahead));
+	m_current.reset();
+	m_position = 0;
+	m_done = false;
+	m_error = nullptr;
+	m_cancel.store(false, std::memory_order_release);
+	if (m_gzip)
+		m_thread = std::thread([this]() { inflate_stream(); });
+	else
+		m_thread = std::thread([this]() { decompress_blocks(); });
+}
+
+void CCompressedIOBuffer::stop_reading()
+{
+	if (!m_thread.joinable())
+		return;
+
+	m_cancel.store(true, std::memory_order_release);
+	m_thread.join();
+	m_blocks.reset();
+	m_current.reset();
+}
+
+void CCompressedIOBuffer::decompress_blocks()
+{
+	try
+	{
+		auto compressor = some<CCompressor>(m_compression);
+		std::vector<uint8_t> compressed;
+		while (!m_cancel.load(std::memory_order_acquire))
+		{
+			uint64_t sizes[2];
+			auto num_read = read_fully(working_file, sizes, sizeof(sizes));
+			if (num_read == 0)
+				break;
+			require(num_read == sizeof(sizes), "Truncated block header");
+
+			compressed.resize(sizes[0]);
+			require(
+			    read_fully(working_file, compressed.data(), sizes[0]) ==
+			        sizes[0],
+			    "Truncated block of {} bytes", sizes[0]);
+
+			Block block(new std::vector<uint8_t>(sizes[1]));
+			uint64_t size = sizes[1];
+			compressor->decompress(
+			    compressed.data(), sizes[0], block->data(), size);
+			require(
+			    size == sizes[1],
+			    "Block decompressed to {} instead of {} bytes", size,
+			    sizes[1]);
+
+			if (!m_blocks->push(block, m_cancel))
+				return;
+		}
+	}
+	catch (...)
+	{
+		m_error = std::current_exception();
+	}
+
+	Block end;
+	m_blocks->push(end, m_cancel);
+}
+
+void CCompressedIOBuffer::inflate_stream()
+{
+#ifdef USE_GZIP
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	bool initialized = false;
+	try
+	{
+		// 32 lets zlib detect and skip the gzip header
+		require(
+		    inflateInit2(&stream, 15 + 32) == Z_OK,
+		    "Error initializing gzip decompression");
+		initialized = true;
+
+		std::vector<uint8_t> compressed(gzip_chunk_size);
+		bool end_of_file = false;
+		bool end_of_stream = false;
+		while (!m_cancel.load(std::memory_order_acquire))
+		{
+			Block block(new std::vector<uint8_t>(m_block_size));
+			stream.next_out = block->data();
+			stream.avail_out = block->size();
+
+			while (stream.avail_out > 0)
+			{
+				if (stream.avail_in == 0 && !end_of_file)
+				{
+					stream.avail_in = read_fully(
+					    working_file, compressed.data(), compressed.size());
+					stream.next_in = compressed.data();
+					end_of_file = stream.avail_in < compressed.size();
+				}
+				if (stream.avail_in == 0)
+					break;
+
+				// concatenated gzip members, as written by appending
+				// to a log, are read as one stream
+				if (end_of_stream)
+				{
+					require(
+					    inflateReset(&stream) == Z_OK,
+					    "Error resetting gzip decompression");
+					end_of_stream = false;
+				}
+
+				auto ret = inflate(&stream, Z_NO_FLUSH);
+				require(
+				    ret == Z_OK || ret == Z_STREAM_END,
+				    "Error gzip-decompressing data: {}",
+				    stream.msg ? stream.msg : "corrupt stream");
+				end_of_stream = ret == Z_STREAM_END;
+			}
+
+			block->resize(block->size() - stream.avail_out);
+			if (block->empty())
+			{
+				require(end_of_stream, "Truncated gzip stream");
+				break;
+			}
+			if (!m_blocks->push(block, m_cancel))
+			{
+				inflateEnd(&stream);
+				return;
+			}
+		}
+	}
+	catch (...)
+	{
+		m_error = std::current_exception();
+	}
+	if (initialized)
+		inflateEnd(&stream);
+#endif
+
+	Block end;
+	m_blocks->push(end, m_cancel);
+}
+
+ssize_t CCompressedIOBuffer::read_file(void* buf, size_t nbytes)
+{
+	require(m_blocks, "File is not open for reading");
+
+	while (!m_current || m_position == m_current->size())
+	{
+		if (m_done)
+			return 0;
+
+		m_position = 0;
+		m_current.reset();
+		m_blocks->pop(m_current, m_cancel);
+		if (!m_current)
+		{
+			m_done = true;
+			if (m_error)
+				std::rethrow_exception(m_error);
+			return 0;
+		}
+	}
+
+	auto num_copied = std::min(nbytes, m_current->size() - m_position);
+	sg_memcpy(buf, m_current->data() + m_position, num_copied);
+	m_position += num_copied;
+	return num_copied;
+}
+
+ssize_t CCompressedIOBuffer::write_file(const void* buf, size_t nbytes)
+{
+	require(m_writing, "File is not open for writing");
+
+	auto data = (const uint8_t*)buf;
+	m_pending.insert(m_pending.end(), data, data + nbytes);
+	if (m_pending.size() >= (size_t)m_block_size)
+	{
+		size_t num_full = m_pending.size() / m_block_size * m_block_size;
+		for (size_t i = 0; i < num_full; i += m_block_size)
+			write_block(m_pending.data() + i, m_block_size);
+		m_pending.erase(m_pending.begin(), m_pending.begin() + num_full);
+	}
+	return nbytes;
+}
+
+void CCompressedIOBuffer::write_block(const uint8_t* data, size_t size)
+{
+	auto compressor = some<CCompressor>(m_compression);
+	uint8_t* compressed = NULL;
+	uint64_t sizes[2] = {0, size};
+	compressor->compress(
+	    const_cast<uint8_t*>(data), size, compressed, sizes[0], m_level);
+
+	write_fully(working_file, sizes, sizeof(sizes));
+	write_fully(working_file, compressed, sizes[0]);
+	SG_FREE(compressed);
+}
+
+bool CCompressedIOBuffer::close_file()
+{
+	if (m_writing)
+	{
+		if (!m_pending.empty())
+			write_block(m_pending.data(), m_pending.size());
+		m_pending.clear();
+		m_writing = false;
+	}
+	stop_reading();
+
+	return CIOBuffer::close_file();
+}
+
+bool CCompressedIOBuffer::is_compressed_file(int fd)
+{
+	// pipes can not be peeked at
+	auto position = lseek(fd, 0, SEEK_CUR);
+	if (position < 0)
+		return false;
+
+	char id[sizeof(file_id)];
+	auto num_read = read_fully(fd, id, sizeof(id));
+	bool compressed =
+	    (num_read == sizeof(id) && !memcmp(id, file_id, sizeof(id))) ||
+	    (num_read >= sizeof(gzip_id) && !memcmp(id, gzip_id, sizeof(gzip_id)));
+	lseek(fd, position, SEEK_SET);
+	return compressed;
+}
@@ -0,0 +1,182 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef __COMPRESSEDIOBUFFER_H__
+#define __COMPRESSEDIOBUFFER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/io/IOBuffer.h>
+#include <shogun/lib/Compressor.h>
+#include <shogun/lib/SPSCQueue.h>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace shogun
+{
+/** @brief IOBuffer of a file that is compressed in independent blocks with
+ * one of the codecs of CCompressor, or of a gzip compressed file.
+ *
+ * The block compressed file starts with the identifier "SGCB" and the
+ * compression type as one byte, followed by blocks that consist of the
+ * compressed and the uncompressed size as uint64_t and the compressed data.
+ *
+ * Gzip files, e.g. existing compressed logs, are read when shogun is built
+ * with zlib. They are inflated as one stream, concatenated gzip members
+ * included. As the stream can not be split, the block compressed files
+ * remain the faster format.
+ *
+ * While reading, a background thread reads and decompresses the blocks, or
+ * inflates the gzip stream, a few blocks ahead of the consumer, so that
+ * decompression overlaps with parsing. CStreamingFile detects such files
+ * and reads them through this buffer, hence all streaming readers accept
+ * compressed input.
+ *
+ * While writing, data is collected until a block is full. The last block
+ * is written by close_file().
+ */
+class CCompressedIOBuffer : public CIOBuffer
+{
+public:
+	/** constructor for reading, the compression is given by the file */
+	CCompressedIOBuffer();
+
+	/** constructor
+	 *
+	 * @param compression compression of written blocks
+	 * @param block_size uncompressed size of written blocks in bytes
+	 * @param level compression level
+	 */
+	CCompressedIOBuffer(
+	    E_COMPRESSION_TYPE compression, int32_t block_size = 1 << 20,
+	    int32_t level = 1);
+
+	/** destructor, stops reading */
+	virtual ~CCompressedIOBuffer();
+
+	/** start reading a compressed file
+	 *
+	 * @param fd file descriptor positioned at the identifier or at the
+	 * start of the gzip stream
+	 */
+	virtual void use_file(int fd);
+
+	/** open a file for reading or writing
+	 *
+	 * @param name name of the file
+	 * @param flag 'r' or 'w'
+	 * @return 1 on success, 0 otherwise
+	 */
+	virtual int open_file(const char* name, char flag = 'r');
+
+	/** start reading again from the first block */
+	virtual void reset_file();
+
+	/** copy decompressed data, waiting for the background thread
+	 *
+	 * @param buf destination
+	 * @param nbytes maximum number of bytes
+	 * @return number of bytes copied, 0 at the end of the file
+	 */
+	virtual ssize_t read_file(void* buf, size_t nbytes);
+
+	/** append data, full blocks are compressed and written
+	 *
+	 * @param buf data
+	 * @param nbytes number of bytes
+	 * @return nbytes
+	 */
+	virtual ssize_t write_file(const void* buf, size_t nbytes);
+
+	/** write the last block when writing and close the file
+	 *
+	 * @return whether a file was open
+	 */
+	virtual bool close_file();
+
+	/** whether a file is a block compressed or a gzip compressed file,
+	 * without changing its position
+	 *
+	 * @param fd file descriptor positioned at the start of the file
+	 * @return whether the file starts with the identifier or the gzip magic
+	 */
+	static bool is_compressed_file(int fd);
+
+	virtual const char* get_name() const
+	{
+		return "CompressedIOBuffer";
+	}
+
+private:
+	/** initialize members */
+	void init_blocks(
+	    E_COMPRESSION_TYPE compression, int32_t block_size, int32_t level);
+
+	/** read the header and start the background thread */
+	void start_reading();
+
+	/** stop the background thread */
+	void stop_reading();
+
+	/** loop of the background thread */
+	void decompress_blocks();
+
+	/** loop of the background thread for gzip files, inflates blocks of
+	 * the block size
+	 */
+	void inflate_stream();
+
+	/** compress and write a block
+	 *
+	 * @param data uncompressed data
+	 * @param size number of bytes
+	 */
+	void write_block(const uint8_t* data, size_t size);
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	typedef std::unique_ptr<std::vector<uint8_t>> Block;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** number of blocks that are decompressed ahead */
+	static constexpr size_t blocks_ahead = 4;
+
+	/** compression of the blocks */
+	E_COMPRESSION_TYPE m_compression;
+	/** uncompressed size of written blocks */
+	int32_t m_block_size;
+	/** compression level */
+	int32_t m_level;
+	/** whether the file is written */
+	bool m_writing;
+	/** whether a gzip stream is read */
+	bool m_gzip;
+	/** data of the block that is written next */
+	std::vector<uint8_t> m_pending;
+
+	/** offset of the first block in the file */
+	int64_t m_first_block;
+	/** decompressed blocks, an empty block marks the end */
+	std::unique_ptr<SPSCQueue<Block>> m_blocks;
+	/** block that is read */
+	Block m_current;
+	/** read position in the current block */
+	size_t m_position;
+	/** whether the end of the file was read */
+	bool m_done;
+	/** background thread */
+	std::thread m_thread;
+	/** set to stop the background thread */
+	std::atomic<bool> m_cancel;
+	/** error of the background thread */
+	std::exception_ptr m_error;
+};
+}
+#endif // __COMPRESSEDIOBUFFER_H__
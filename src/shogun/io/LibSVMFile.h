@@ -328,12 +328,6 @@ private:
 
 	/** class initialization */
 	void init_with_defaults();
-
-	/** get number of lines */
-	int32_t get_num_lines();
-
-	/** is it a feature entry */
-	bool is_feat_entry(const SGVector<char> entry);
 private:
 	/** delimiter for index and data in sparse entries */
 	char m_delimiter_feat;
@@ -0,0 +1,365 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/io/MappedDataset.h>
+#include <shogun/lib/SGSparseVector.h>
+#include <shogun/lib/any.h>
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+using namespace shogun;
+
+namespace
+{
+/** identifies files written by MappedDataset::save() */
+const char mapped_magic[8] = {'S', 'G', 'M', 'A', 'P', 'D', 'S', '1'};
+
+/** elements start after the header page, which keeps them page aligned */
+const int64_t mapped_header_size = 4096;
+
+/** alignment of the sections following the first one */
+const int64_t mapped_section_alignment = 64;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/** header of a mapped dataset file */
+struct MappedHeader
+{
+	char magic[8];
+	int32_t ptype;
+	int32_t sparse;
+	int64_t num_features;
+	int64_t num_vectors;
+	int64_t num_entries;
+	int64_t element_size;
+	int64_t data_offset;
+	int64_t offsets_offset;
+	int64_t labels_offset;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+int64_t align_section(int64_t offset)
+{
+	return (offset + mapped_section_alignment - 1) / mapped_section_alignment *
+	       mapped_section_alignment;
+}
+
+/** create the file, write the header and the labels */
+CMemoryMappedFile<uint8_t>* create_file(
+    const char* fname, MappedHeader& header, int64_t size,
+    const SGVector<float64_t>& labels)
+{
+	require(
+	    labels.vlen == 0 || labels.vlen == header.num_vectors,
+	    "Number of labels ({}) should be the number of vectors ({})",
+	    labels.vlen, header.num_vectors);
+
+	header.labels_offset = labels.vlen ? align_section(size) : 0;
+	if (labels.vlen)
+		size = header.labels_offset + labels.vlen * sizeof(float64_t);
+
+	auto file = new CMemoryMappedFile<uint8_t>(fname, 'w', size);
+	SG_REF(file);
+	file->set_truncate_size(size);
+
+	memcpy(header.magic, mapped_magic, sizeof(mapped_magic));
+	memcpy(file->get_map(), &header, sizeof(MappedHeader));
+	if (labels.vlen)
+		memcpy(
+		    file->get_map() + header.labels_offset, labels.vector,
+		    labels.vlen * sizeof(float64_t));
+
+	return file;
+}
+}
+
+namespace shogun
+{
+#define PRIMITIVE_TYPE(sg_type, ptype)                                         \
+	template <>                                                                \
+	EPrimitiveType MappedDataset::primitive_type<sg_type>()                    \
+	{                                                                          \
+		return ptype;                                                          \
+	}
+
+PRIMITIVE_TYPE(bool, PT_BOOL)
+PRIMITIVE_TYPE(char, PT_CHAR)
+PRIMITIVE_TYPE(int8_t, PT_INT8)
+PRIMITIVE_TYPE(uint8_t, PT_UINT8)
+PRIMITIVE_TYPE(int16_t, PT_INT16)
+PRIMITIVE_TYPE(uint16_t, PT_UINT16)
+PRIMITIVE_TYPE(int32_t, PT_INT32)
+PRIMITIVE_TYPE(uint32_t, PT_UINT32)
+PRIMITIVE_TYPE(int64_t, PT_INT64)
+PRIMITIVE_TYPE(uint64_t, PT_UINT64)
+PRIMITIVE_TYPE(float32_t, PT_FLOAT32)
+PRIMITIVE_TYPE(float64_t, PT_FLOAT64)
+PRIMITIVE_TYPE(floatmax_t, PT_FLOATMAX)
+PRIMITIVE_TYPE(complex128_t, PT_COMPLEX128)
+#undef PRIMITIVE_TYPE
+}
+
+MappedDataset::MappedDataset(const char* fname)
+{
+	// copy on write, in-place transformations of the features only change
+	// private copies of the touched pages
+	m_file = new CMemoryMappedFile<uint8_t>(fname, 'c');
+	SG_REF(m_file);
+
+	try
+	{
+		map_sections(fname);
+	}
+	catch (...)
+	{
+		SG_UNREF(m_file);
+		throw;
+	}
+}
+
+MappedDataset::~MappedDataset()
+{
+	SG_UNREF(m_file);
+}
+
+void MappedDataset::map_sections(const char* fname)
+{
+	const int64_t file_size = m_file->get_size();
+	require(
+	    file_size >= mapped_header_size, "{} is not a mapped dataset file",
+	    fname);
+
+	MappedHeader header;
+	memcpy(&header, m_file->get_map(), sizeof(MappedHeader));
+	require(
+	    memcmp(header.magic, mapped_magic, sizeof(mapped_magic)) == 0,
+	    "{} is not a mapped dataset file", fname);
+	require(
+	    header.ptype >= PT_BOOL && header.ptype < PT_UNDEFINED &&
+	        header.ptype != PT_SGOBJECT && header.element_size > 0,
+	    "Invalid element type {} of size {} in {}", header.ptype,
+	    header.element_size, fname);
+	require(
+	    header.num_features >= 0 && header.num_vectors >= 0 &&
+	        header.num_features <= std::numeric_limits<int32_t>::max() &&
+	        header.num_vectors <= std::numeric_limits<int32_t>::max() &&
+	        header.num_entries >= 0,
+	    "Invalid mapped dataset of {} features and {} vectors in {}",
+	    header.num_features, header.num_vectors, fname);
+
+	m_ptype = (EPrimitiveType)header.ptype;
+	m_sparse = header.sparse != 0;
+	m_num_features = header.num_features;
+	m_num_vectors = header.num_vectors;
+	m_num_entries = m_sparse ? header.num_entries
+	                         : int64_t(m_num_features) * m_num_vectors;
+	m_element_size = header.element_size;
+
+	// every section has to be aligned and within the file
+	auto check_section = [&](int64_t offset, int64_t size, const char* name) {
+		require(
+		    offset >= mapped_header_size &&
+		        offset % mapped_section_alignment == 0 &&
+		        offset + size <= file_size,
+		    "Mapped dataset file {} is truncated or corrupt, {} of {} bytes "
+		    "at {} does not fit into {} bytes",
+		    fname, name, size, offset, file_size);
+	};
+
+	check_section(
+	    header.data_offset, m_num_entries * m_element_size, "elements");
+	m_data = m_file->get_map() + header.data_offset;
+
+	m_offsets = NULL;
+	if (m_sparse)
+	{
+		check_section(
+		    header.offsets_offset, (m_num_vectors + 1) * sizeof(int64_t),
+		    "offsets");
+		m_offsets =
+		    (const int64_t*)(m_file->get_map() + header.offsets_offset);
+	}
+
+	m_labels = NULL;
+	if (header.labels_offset)
+	{
+		check_section(
+		    header.labels_offset, m_num_vectors * sizeof(float64_t), "labels");
+		m_labels =
+		    (const float64_t*)(m_file->get_map() + header.labels_offset);
+	}
+}
+
+template <class ST>
+void MappedDataset::check_type(bool sparse) const
+{
+	require(
+	    m_sparse == sparse, "Mapped dataset stores a {} matrix",
+	    m_sparse ? "sparse" : "dense");
+
+	const int64_t element_size =
+	    sparse ? sizeof(SGSparseVectorEntry<ST>) : sizeof(ST);
+	require(
+	    m_ptype == primitive_type<ST>() && m_element_size == element_size,
+	    "Mapped dataset stores elements of type {} and size {}, not {}",
+	    ptype_name(m_ptype), m_element_size, demangled_type<ST>());
+}
+
+template <class ST>
+SGMatrix<ST> MappedDataset::get_dense_matrix() const
+{
+	check_type<ST>(false);
+	return SGMatrix<ST>((ST*)m_data, m_num_features, m_num_vectors, false);
+}
+
+template <class ST>
+SGSparseMatrix<ST> MappedDataset::get_sparse_matrix() const
+{
+	check_type<ST>(true);
+
+	auto entries = (SGSparseVectorEntry<ST>*)m_data;
+	SGSparseMatrix<ST> result(m_num_features, m_num_vectors);
+	for (index_t i = 0; i < m_num_vectors; ++i)
+	{
+		const int64_t begin = m_offsets[i];
+		const int64_t end = m_offsets[i + 1];
+		require(
+		    begin >= 0 && begin <= end && end <= m_num_entries,
+		    "Mapped dataset has invalid entries [{}, {}) for vector {}",
+		    begin, end, i);
+		result.sparse_matrix[i] =
+		    SGSparseVector<ST>(entries + begin, end - begin, false);
+	}
+
+	return result;
+}
+
+SGVector<float64_t> MappedDataset::get_labels() const
+{
+	require(m_labels, "Mapped dataset has no labels");
+
+	SGVector<float64_t> labels(m_num_vectors);
+	std::copy_n(m_labels, m_num_vectors, labels.vector);
+	return labels;
+}
+
+void MappedDataset::prefetch(index_t first, index_t num) const
+{
+	require(
+	    first >= 0 && num >= 0 && first + num <= m_num_vectors,
+	    "Vectors [{}, {}) exceed the {} vectors", first, first + num,
+	    m_num_vectors);
+
+	int64_t begin = int64_t(first) * m_num_features;
+	int64_t end = int64_t(first + num) * m_num_features;
+	if (m_sparse)
+	{
+		begin = m_offsets[first];
+		end = m_offsets[first + num];
+	}
+
+	m_file->prefetch(
+	    m_data - m_file->get_map() + begin * m_element_size,
+	    (end - begin) * m_element_size);
+}
+
+template <class ST>
+void MappedDataset::save(
+    const char* fname, const SGMatrix<ST>& matrix,
+    const SGVector<float64_t>& labels)
+{
+	MappedHeader header;
+	memset(&header, 0, sizeof(MappedHeader));
+	header.ptype = primitive_type<ST>();
+	header.num_features = matrix.num_rows;
+	header.num_vectors = matrix.num_cols;
+	header.num_entries = int64_t(matrix.num_rows) * matrix.num_cols;
+	header.element_size = sizeof(ST);
+	header.data_offset = mapped_header_size;
+
+	const int64_t size =
+	    header.data_offset + header.num_entries * header.element_size;
+	auto file = create_file(fname, header, size, labels);
+	if (header.num_entries)
+		memcpy(
+		    file->get_map() + header.data_offset, matrix.matrix,
+		    header.num_entries * header.element_size);
+
+	SG_UNREF(file);
+}
+
+template <class ST>
+void MappedDataset::save(
+    const char* fname, const SGSparseMatrix<ST>& matrix,
+    const SGVector<float64_t>& labels)
+{
+	MappedHeader header;
+	memset(&header, 0, sizeof(MappedHeader));
+	header.ptype = primitive_type<ST>();
+	header.sparse = 1;
+	header.num_features = matrix.num_features;
+	header.num_vectors = matrix.num_vectors;
+	header.element_size = sizeof(SGSparseVectorEntry<ST>);
+	for (index_t i = 0; i < matrix.num_vectors; ++i)
+		header.num_entries += matrix.sparse_matrix[i].num_feat_entries;
+
+	header.offsets_offset = mapped_header_size;
+	header.data_offset = align_section(
+	    header.offsets_offset + (header.num_vectors + 1) * sizeof(int64_t));
+
+	const int64_t size =
+	    header.data_offset + header.num_entries * header.element_size;
+	auto file = create_file(fname, header, size, labels);
+
+	auto offsets = (int64_t*)(file->get_map() + header.offsets_offset);
+	auto entries =
+	    (SGSparseVectorEntry<ST>*)(file->get_map() + header.data_offset);
+	offsets[0] = 0;
+	for (index_t i = 0; i < matrix.num_vectors; ++i)
+	{
+		const auto& vec = matrix.sparse_matrix[i];
+		for (index_t j = 0; j < vec.num_feat_entries; ++j)
+		{
+			// fields are copied one by one to keep the padding zero
+			entries[offsets[i] + j].feat_index = vec.features[j].feat_index;
+			entries[offsets[i] + j].entry = vec.features[j].entry;
+		}
+		offsets[i + 1] = offsets[i] + vec.num_feat_entries;
+	}
+
+	SG_UNREF(file);
+}
+
+namespace shogun
+{
+#define INSTANTIATE(sg_type)                                                   \
+	template SGMatrix<sg_type> MappedDataset::get_dense_matrix<sg_type>()      \
+	    const;                                                                 \
+	template SGSparseMatrix<sg_type>                                           \
+	MappedDataset::get_sparse_matrix<sg_type>() const;                         \
+	template void MappedDataset::save<sg_type>(                                \
+	    const char*, const SGMatrix<sg_type>&, const SGVector<float64_t>&);    \
+	template void MappedDataset::save<sg_type>(                                \
+	    const char*, const SGSparseMatrix<sg_type>&,                           \
+	    const SGVector<float64_t>&);
+
+INSTANTIATE(bool)
+INSTANTIATE(char)
+INSTANTIATE(int8_t)
+INSTANTIATE(uint8_t)
+INSTANTIATE(int16_t)
+INSTANTIATE(uint16_t)
+INSTANTIATE(int32_t)
+INSTANTIATE(uint32_t)
+INSTANTIATE(int64_t)
+INSTANTIATE(uint64_t)
+INSTANTIATE(float32_t)
+INSTANTIATE(float64_t)
+INSTANTIATE(floatmax_t)
+INSTANTIATE(complex128_t)
+#undef INSTANTIATE
+}
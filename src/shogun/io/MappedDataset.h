@@ -0,0 +1,172 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef _MAPPED_DATASET_H__
+#define _MAPPED_DATASET_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/io/MemoryMappedFile.h>
+#include <shogun/lib/DataType.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/common.h>
+
+namespace shogun
+{
+
+/** @brief Dense or sparse feature matrix with optional labels stored in a
+ * binary file that is memory mapped copy on write.
+ *
+ * The file starts with a header page that keeps the element type, the shape
+ * and the location of every section. Dense matrices are stored column by
+ * column, exactly like SGMatrix. Sparse matrices are stored in compressed
+ * sparse row form: num_vectors+1 int64_t offsets followed by all entries as
+ * SGSparseVectorEntry, hence every sparse vector points into the mapping.
+ * Labels are stored as float64_t.
+ *
+ * Matrices returned by get_dense_matrix() and get_sparse_matrix() do not copy
+ * any element, pages are read when they are first accessed and the page
+ * cache is shared by all processes mapping the same file. Modified elements
+ * are copied to private pages and never reach the file. The elements are
+ * only valid as long as the dataset exists, see
+ * CDenseFeatures::set_feature_matrix_from_file() and
+ * CSparseFeatures::set_sparse_feature_matrix_from_file() for features that
+ * keep the dataset alive.
+ */
+class MappedDataset
+{
+public:
+	/** open and map a dataset
+	 *
+	 * @param fname file written by save()
+	 */
+	explicit MappedDataset(const char* fname);
+
+	/** destructor, unmaps the file */
+	~MappedDataset();
+
+	MappedDataset(const MappedDataset&) = delete;
+	MappedDataset& operator=(const MappedDataset&) = delete;
+
+	/** write a dense matrix
+	 *
+	 * @param fname file to write
+	 * @param matrix feature matrix, one vector per column
+	 * @param labels one label per vector or empty
+	 */
+	template <class ST>
+	static void save(
+	    const char* fname, const SGMatrix<ST>& matrix,
+	    const SGVector<float64_t>& labels = SGVector<float64_t>());
+
+	/** write a sparse matrix
+	 *
+	 * @param fname file to write
+	 * @param matrix sparse feature matrix
+	 * @param labels one label per vector or empty
+	 */
+	template <class ST>
+	static void save(
+	    const char* fname, const SGSparseMatrix<ST>& matrix,
+	    const SGVector<float64_t>& labels = SGVector<float64_t>());
+
+	/** @return whether a sparse matrix is stored */
+	inline bool is_sparse() const
+	{
+		return m_sparse;
+	}
+
+	/** @return type of the stored elements */
+	inline EPrimitiveType get_primitive_type() const
+	{
+		return m_ptype;
+	}
+
+	/** @return number of features */
+	inline int32_t get_num_features() const
+	{
+		return m_num_features;
+	}
+
+	/** @return number of vectors */
+	inline int32_t get_num_vectors() const
+	{
+		return m_num_vectors;
+	}
+
+	/** @return whether labels are stored */
+	inline bool has_labels() const
+	{
+		return m_labels != NULL;
+	}
+
+	/** dense matrix pointing into the mapped file
+	 *
+	 * @return matrix without reference counting
+	 */
+	template <class ST>
+	SGMatrix<ST> get_dense_matrix() const;
+
+	/** sparse matrix whose vectors point into the mapped file. Only the
+	 * vector headers are allocated.
+	 *
+	 * @return sparse matrix
+	 */
+	template <class ST>
+	SGSparseMatrix<ST> get_sparse_matrix() const;
+
+	/** @return copy of the stored labels */
+	SGVector<float64_t> get_labels() const;
+
+	/** advise the operating system to read the elements of a range of
+	 * vectors in the background
+	 *
+	 * @param first first vector
+	 * @param num number of vectors
+	 */
+	void prefetch(index_t first, index_t num) const;
+
+private:
+	/** check the header of the mapped file and locate the sections
+	 *
+	 * @param fname name of the mapped file
+	 */
+	void map_sections(const char* fname);
+
+	/** check that ST is the stored element type */
+	template <class ST>
+	void check_type(bool sparse) const;
+
+	/** @return primitive type of ST */
+	template <class ST>
+	static EPrimitiveType primitive_type();
+
+private:
+	/** mapped file */
+	CMemoryMappedFile<uint8_t>* m_file;
+	/** dense elements or sparse entries */
+	const uint8_t* m_data;
+	/** start of every sparse vector in the entries, sparse only */
+	const int64_t* m_offsets;
+	/** labels or NULL */
+	const float64_t* m_labels;
+	/** number of dense elements or sparse entries */
+	int64_t m_num_entries;
+	/** size of an element or of a sparse entry */
+	int64_t m_element_size;
+	/** type of the stored elements */
+	EPrimitiveType m_ptype;
+	/** whether a sparse matrix is stored */
+	bool m_sparse;
+	/** number of features */
+	int32_t m_num_features;
+	/** number of vectors */
+	int32_t m_num_vectors;
+};
+}
+#endif // _MAPPED_DATASET_H__
@@ -51,7 +51,9 @@ template <class T> class CMemoryMappedFile : public CSGObject
 		 * open a memory mapped file for read or read/write mode
 		 *
 		 * @param fname name of file, zero terminated string
-		 * @param flag determines read or read write mode (can be 'r' or 'w')
+		 * @param flag determines read or read write mode (can be 'r' or 'w'),
+		 *   or 'c' for a copy on write mapping of a file opened read only,
+		 *   whose pages may be modified without changing the file
 		 * @param fsize overestimate of expected file size (in bytes)
 		 *   when opened in write  mode; Underestimating the file size will
 		 *   result in an error to occur upon writing. In case the exact file
@@ -62,7 +64,8 @@ template <class T> class CMemoryMappedFile : public CSGObject
 		CMemoryMappedFile(const char* fname, char flag='r', int64_t fsize=0)
 		: CSGObject()
 		{
-			require(flag=='w' || flag=='r', "Only 'r' and 'w' flags are allowed");
+			require(flag=='w' || flag=='r' || flag=='c',
+				"Only 'r', 'w' and 'c' flags are allowed");
 
 			last_written_byte=0;
 			rw=flag;
@@ -81,6 +84,11 @@ template <class T> class CMemoryMappedFile : public CSGObject
 				mmap_prot = PAGE_READWRITE;
 				mmap_flags = FILE_MAP_ALL_ACCESS;
 			}
+			else if (rw=='c')
+			{
+				mmap_prot = PAGE_WRITECOPY;
+				mmap_flags = FILE_MAP_COPY;
+			}
 
 			fd = CreateFile(fname, open_flags, share_mode, 0, create_disp, FILE_ATTRIBUTE_NORMAL, NULL);
 			if (rw=='w' && fsize)
@@ -113,6 +121,8 @@ template <class T> class CMemoryMappedFile : public CSGObject
 				mmap_prot=PROT_READ|PROT_WRITE;
 				mmap_flags=MAP_SHARED;
 			}
+			else if (rw=='c')
+				mmap_prot=PROT_READ|PROT_WRITE;
 
 			fd = open(fname, open_flags, S_IRWXU | S_IRWXG | S_IRWXO);
 			if (fd == -1)
@@ -267,6 +277,30 @@ template <class T> class CMemoryMappedFile : public CSGObject
 			last_written_byte=sz;
 		}
 
+		/** advise the operating system that a range of the file will be
+		 * accessed soon, such that it can be read in the background
+		 *
+		 * Has no effect on platforms without madvise.
+		 *
+		 * @param offs first byte of the range
+		 * @param len number of bytes of the range
+		 */
+		void prefetch(uint64_t offs, uint64_t len)
+		{
+#ifndef _MSC_VER
+			if (offs>=length || len==0)
+				return;
+
+			if (len > length-offs)
+				len=length-offs;
+
+			// madvise requires a page aligned address
+			uint64_t page=sysconf(_SC_PAGESIZE);
+			uint64_t begin=offs-offs%page;
+			madvise(((char*) address)+begin, offs+len-begin, MADV_WILLNEED);
+#endif
+		}
+
 		/** count the number of lines in a file
 		 *
 		 * @return number of lines
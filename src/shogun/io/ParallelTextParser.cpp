@@ -0,0 +1,515 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/base/Parallel.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/ThreadPool.h>
+#include <shogun/io/ParallelTextParser.h>
+#include <shogun/io/SGIO.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <set>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using namespace shogun;
+
+namespace
+{
+/** ranges are not split below this size */
+constexpr size_t min_range_size = 1 << 20;
+
+/** ranges per thread, for load balancing */
+constexpr size_t ranges_per_thread = 4;
+
+/** initial read size of files of unknown size */
+constexpr size_t read_block_size = 1 << 20;
+
+/** powers of ten that are exactly representable as float64_t */
+const float64_t exact_powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22};
+
+/** set of characters separating tokens */
+struct Separators
+{
+	Separators(std::initializer_list<char> chars)
+	{
+		std::fill(is_separator, is_separator + 256, false);
+		for (auto c : chars)
+			is_separator[(uint8_t)c] = true;
+	}
+
+	bool operator()(char c) const
+	{
+		return is_separator[(uint8_t)c];
+	}
+
+	bool is_separator[256];
+};
+
+/** find the next token in [pos, end), which is [begin, pos) afterwards
+ *
+ * @return whether there is a token
+ */
+bool next_token(
+    const char*& pos, const char* end, const Separators& separators,
+    const char*& begin)
+{
+	while (pos < end && separators(*pos))
+		++pos;
+
+	begin = pos;
+	while (pos < end && !separators(*pos))
+		++pos;
+
+	return begin < pos;
+}
+
+bool is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+float64_t parse_double_fallback(const char* begin, const char* end)
+{
+	std::string token(begin, end);
+	return strtod(token.c_str(), NULL);
+}
+
+/** parse a float64_t like strtod, the mantissa is accumulated as integer
+ * and scaled by an exact power of ten, which is correctly rounded if both
+ * are exactly representable
+ */
+float64_t parse_double(const char* begin, const char* end)
+{
+	if (begin == end)
+		return 0;
+
+	const char* p = begin;
+	bool negative = false;
+	if (*p == '-' || *p == '+')
+	{
+		negative = *p == '-';
+		++p;
+	}
+
+	uint64_t mantissa = 0;
+	int32_t num_digits = 0;
+	int32_t exponent = 0;
+	bool has_digits = false;
+	for (; p < end && is_digit(*p); ++p)
+	{
+		has_digits = true;
+		if (mantissa || *p != '0')
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			++num_digits;
+		}
+	}
+	if (p < end && *p == '.')
+	{
+		for (++p; p < end && is_digit(*p); ++p)
+		{
+			has_digits = true;
+			if (mantissa || *p != '0')
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				++num_digits;
+			}
+			--exponent;
+		}
+	}
+	if (has_digits && p < end && (*p == 'e' || *p == 'E'))
+	{
+		++p;
+		bool negative_exponent = false;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			negative_exponent = *p == '-';
+			++p;
+		}
+
+		int32_t value = 0;
+		bool has_exponent_digits = false;
+		for (; p < end && is_digit(*p); ++p)
+		{
+			has_exponent_digits = true;
+			if (value < 100000)
+				value = value * 10 + (*p - '0');
+		}
+		if (!has_exponent_digits)
+			return parse_double_fallback(begin, end);
+
+		exponent += negative_exponent ? -value : value;
+	}
+
+	// special values, hexadecimal numbers, trailing characters and numbers
+	// that do not fit the fast path are left to the C library
+	if (!has_digits || p != end || num_digits > 19)
+		return parse_double_fallback(begin, end);
+
+	if (mantissa == 0)
+		return negative ? -0.0 : 0.0;
+
+	if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+		return parse_double_fallback(begin, end);
+
+	float64_t value = mantissa;
+	if (exponent < 0)
+		value /= exact_powers[-exponent];
+	else
+		value *= exact_powers[exponent];
+
+	return negative ? -value : value;
+}
+}
+
+namespace shogun
+{
+template <class T>
+T ParallelTextParser::parse_value(const char* begin, const char* end)
+{
+	return (T)parse_double(begin, end);
+}
+
+template <>
+int64_t
+ParallelTextParser::parse_value<int64_t>(const char* begin, const char* end)
+{
+	const char* p = begin;
+	bool negative = p < end && *p == '-';
+	if (p < end && (*p == '-' || *p == '+'))
+		++p;
+
+	int64_t value = 0;
+	const char* digits = p;
+	for (; p < end && is_digit(*p) && p - digits < 18; ++p)
+		value = value * 10 + (*p - '0');
+
+	if (p == end && p > digits)
+		return negative ? -value : value;
+
+	std::string token(begin, end);
+	return strtoll(token.c_str(), NULL, 10);
+}
+
+template <>
+uint64_t
+ParallelTextParser::parse_value<uint64_t>(const char* begin, const char* end)
+{
+	const char* p = begin;
+	uint64_t value = 0;
+	for (; p < end && is_digit(*p) && p - begin < 19; ++p)
+		value = value * 10 + (*p - '0');
+
+	if (p == end && p > begin)
+		return value;
+
+	std::string token(begin, end);
+	return strtoull(token.c_str(), NULL, 10);
+}
+
+template <>
+floatmax_t
+ParallelTextParser::parse_value<floatmax_t>(const char* begin, const char* end)
+{
+	if (begin == end)
+		return 0;
+
+	std::string token(begin, end);
+#ifdef HAVE_STRTOLD
+	return strtold(token.c_str(), NULL);
+#else
+	return strtod(token.c_str(), NULL);
+#endif
+}
+}
+
+ParallelTextParser::ParallelTextParser(FILE* file, int32_t num_lines_to_skip)
+{
+	require(file, "No file given");
+
+	// regular files are read with a single call
+	const long start = ftell(file);
+	if (start >= 0 && fseek(file, 0, SEEK_END) == 0)
+	{
+		const long end = ftell(file);
+		if (end > start)
+			m_text.reserve(end - start + 1);
+		fseek(file, start, SEEK_SET);
+	}
+
+	size_t size = 0;
+	while (true)
+	{
+		m_text.resize(
+		    size + std::max(read_block_size, m_text.capacity() - size));
+		size += fread(m_text.data() + size, 1, m_text.size() - size, file);
+		if (size < m_text.size())
+			break;
+	}
+	m_text.resize(size);
+	require(!ferror(file), "Error reading file");
+
+	size_t begin = 0;
+	for (int32_t i = 0; i < num_lines_to_skip && begin < size;)
+	{
+		auto eol =
+		    (const char*)memchr(m_text.data() + begin, '\n', size - begin);
+		const size_t line_end = eol ? eol - m_text.data() : size;
+		if (line_end > begin)
+			++i;
+		begin = std::min(line_end + 1, size);
+	}
+
+	m_range_begin.push_back(begin);
+	split_ranges();
+}
+
+void ParallelTextParser::split_ranges()
+{
+	const size_t begin = m_range_begin[0];
+	const size_t size = m_text.size() - begin;
+	const size_t num_ranges = std::max<size_t>(
+	    1, std::min<size_t>(
+	           env()->get_thread_pool()->get_num_threads() * ranges_per_thread,
+	           size / min_range_size));
+
+	// ranges end after the first line break following an equal split
+	for (size_t range = 1; range < num_ranges; ++range)
+	{
+		size_t pos =
+		    std::max(begin + range * size / num_ranges, m_range_begin.back());
+		auto eol = (const char*)memchr(
+		    m_text.data() + pos, '\n', m_text.size() - pos);
+		pos = eol ? eol - m_text.data() + 1 : m_text.size();
+		m_range_begin.push_back(pos);
+	}
+	m_range_begin.push_back(m_text.size());
+
+	std::vector<index_t> num_lines(num_ranges, 0);
+	m_first_line.assign(num_ranges + 1, 0);
+	for_each_line([&](index_t range, index_t, const char*, const char*) {
+		++num_lines[range];
+	});
+
+	for (size_t range = 0; range < num_ranges; ++range)
+		m_first_line[range + 1] = m_first_line[range] + num_lines[range];
+}
+
+template <class F>
+void ParallelTextParser::for_each_line(F&& body) const
+{
+	env()->get_thread_pool()->parallel_for(
+	    0, m_range_begin.size() - 1, 1, [&](index_t first, index_t last) {
+		    for (index_t range = first; range < last; ++range)
+		    {
+			    const char* p = m_text.data() + m_range_begin[range];
+			    const char* end = m_text.data() + m_range_begin[range + 1];
+			    index_t line = m_first_line[range];
+			    while (p < end)
+			    {
+				    auto eol = (const char*)memchr(p, '\n', end - p);
+				    if (!eol)
+					    eol = end;
+				    if (eol > p)
+					    body(range, line++, p, eol);
+				    p = eol + 1;
+			    }
+		    }
+	    });
+}
+
+template <class T>
+void ParallelTextParser::parse_dense(
+    T*& matrix, int32_t& num_feat, int32_t& num_vec, char delimiter,
+    bool transposed) const
+{
+	const Separators separators = {delimiter, ' ', '\r'};
+	const index_t num_lines = get_num_lines();
+
+	// the first line gives the number of values
+	index_t num_tokens = 0;
+	const char* p = m_text.data() + m_range_begin.front();
+	const char* end = m_text.data() + m_text.size();
+	while (p < end && *p == '\n')
+		++p;
+	auto eol = (const char*)memchr(p, '\n', end - p);
+	if (!eol)
+		eol = end;
+	const char* token;
+	while (next_token(p, eol, separators, token))
+		++num_tokens;
+	require(
+	    num_lines == 0 || num_tokens > 0, "First line does not contain values");
+
+	matrix = SG_MALLOC(T, int64_t(num_lines) * num_tokens);
+	SG_SET_LOCALE_C;
+	try
+	{
+		for_each_line([&](index_t, index_t line, const char* pos,
+		                  const char* line_end) {
+			const char* value;
+			for (index_t i = 0; i < num_tokens; ++i)
+			{
+				require(
+				    next_token(pos, line_end, separators, value),
+				    "Line {} has {} values instead of {}", line + 1, i,
+				    num_tokens);
+
+				if (transposed)
+					matrix[line + int64_t(i) * num_lines] =
+					    parse_value<T>(value, pos);
+				else
+					matrix[i + int64_t(line) * num_tokens] =
+					    parse_value<T>(value, pos);
+			}
+		});
+	}
+	catch (...)
+	{
+		SG_RESET_LOCALE;
+		SG_FREE(matrix);
+		matrix = NULL;
+		throw;
+	}
+	SG_RESET_LOCALE;
+
+	num_feat = transposed ? num_lines : num_tokens;
+	num_vec = transposed ? num_tokens : num_lines;
+}
+
+template <class T>
+void ParallelTextParser::parse_libsvm(
+    SGSparseVector<T>*& vectors, int32_t& num_feat, int32_t& num_vec,
+    SGVector<float64_t>*& labels, int32_t& num_classes, bool load_labels,
+    char feat_delimiter, char label_delimiter) const
+{
+	const Separators spaces = {' ', '\t', '\r'};
+	const Separators feat_separators = {feat_delimiter};
+	const Separators label_separators = {label_delimiter};
+
+	num_vec = get_num_lines();
+	vectors = SG_MALLOC(SGSparseVector<T>, num_vec);
+	labels = SG_MALLOC(SGVector<float64_t>, num_vec);
+	std::vector<int32_t> max_index(m_range_begin.size() - 1, 0);
+
+	SG_SET_LOCALE_C;
+	try
+	{
+		for_each_line([&](index_t range, index_t line, const char* pos,
+		                  const char* end) {
+			const char* token;
+			const char* part;
+
+			// the first token holds the labels unless it is a feature
+			const char* features = pos;
+			const char* labels_begin = pos;
+			const char* labels_end = pos;
+			if (load_labels && next_token(pos, end, spaces, token))
+			{
+				const char* index = token;
+				if (!(next_token(index, pos, feat_separators, part) &&
+				      next_token(index, pos, feat_separators, part)))
+				{
+					labels_begin = token;
+					labels_end = pos;
+					features = pos;
+				}
+			}
+
+			index_t num_entries = 0;
+			for (pos = features; next_token(pos, end, spaces, token);)
+				++num_entries;
+
+			SGSparseVector<T> vec(num_entries);
+			pos = features;
+			for (index_t j = 0; next_token(pos, end, spaces, token); ++j)
+			{
+				int32_t feat_index = 0;
+				T entry = 0;
+				const char* index = token;
+				if (next_token(index, pos, feat_separators, part))
+				{
+					feat_index = parse_value<int32_t>(part, index);
+					if (next_token(index, pos, feat_separators, part))
+						entry = parse_value<T>(part, index);
+				}
+
+				max_index[range] = std::max(max_index[range], feat_index);
+				vec.features[j].feat_index = feat_index - 1;
+				vec.features[j].entry = entry;
+			}
+			vectors[line] = vec;
+
+			if (load_labels)
+			{
+				index_t num_labels = 0;
+				for (pos = labels_begin;
+				     next_token(pos, labels_end, label_separators, part);)
+					++num_labels;
+
+				SGVector<float64_t> label(num_labels);
+				pos = labels_begin;
+				for (index_t j = 0;
+				     next_token(pos, labels_end, label_separators, part); ++j)
+					label[j] = parse_value<float64_t>(part, pos);
+				labels[line] = label;
+			}
+		});
+	}
+	catch (...)
+	{
+		SG_RESET_LOCALE;
+		SG_FREE(vectors);
+		SG_FREE(labels);
+		vectors = NULL;
+		labels = NULL;
+		throw;
+	}
+	SG_RESET_LOCALE;
+
+	num_feat = *std::max_element(max_index.begin(), max_index.end());
+
+	std::set<float64_t> classes;
+	if (load_labels)
+	{
+		for (index_t i = 0; i < num_vec; ++i)
+			classes.insert(labels[i].begin(), labels[i].end());
+	}
+	num_classes = classes.size();
+}
+
+namespace shogun
+{
+#define INSTANTIATE(sg_type)                                                   \
+	template sg_type ParallelTextParser::parse_value<sg_type>(                 \
+	    const char*, const char*);                                             \
+	template void ParallelTextParser::parse_dense<sg_type>(                    \
+	    sg_type*&, int32_t&, int32_t&, char, bool) const;                      \
+	template void ParallelTextParser::parse_libsvm<sg_type>(                   \
+	    SGSparseVector<sg_type>*&, int32_t&, int32_t&, SGVector<float64_t>*&,  \
+	    int32_t&, bool, char, char) const;
+
+INSTANTIATE(bool)
+INSTANTIATE(char)
+INSTANTIATE(int8_t)
+INSTANTIATE(uint8_t)
+INSTANTIATE(int16_t)
+INSTANTIATE(uint16_t)
+INSTANTIATE(int32_t)
+INSTANTIATE(uint32_t)
+INSTANTIATE(int64_t)
+INSTANTIATE(uint64_t)
+INSTANTIATE(float32_t)
+INSTANTIATE(float64_t)
+INSTANTIATE(floatmax_t)
+#undef INSTANTIATE
+}
@@ -0,0 +1,117 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef _PARALLEL_TEXT_PARSER_H__
+#define _PARALLEL_TEXT_PARSER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/SGSparseVector.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+#include <vector>
+
+namespace shogun
+{
+
+/** @brief Parser of line based text files that splits the text into line
+ * aligned ranges and parses the ranges in parallel on the thread pool.
+ *
+ * The remainder of the file is read at once. The ranges are scanned twice:
+ * the first pass counts the lines of every range, which gives the index of
+ * the first line of every range, the second pass parses every line directly
+ * into its place of the result, hence the result is allocated only once.
+ *
+ * Numbers are parsed without the C library for the common case of at most
+ * 19 significant digits and small exponents, which is exact and does not
+ * depend on the locale, other numbers fall back to strtod. Empty lines are
+ * skipped like CLineReader does.
+ */
+class ParallelTextParser
+{
+public:
+	/** read the rest of a file
+	 *
+	 * @param file file to read, positioned at the first line
+	 * @param num_lines_to_skip number of leading lines to skip
+	 */
+	ParallelTextParser(FILE* file, int32_t num_lines_to_skip = 0);
+
+	ParallelTextParser(const ParallelTextParser&) = delete;
+	ParallelTextParser& operator=(const ParallelTextParser&) = delete;
+
+	/** @return number of non-empty lines */
+	index_t get_num_lines() const
+	{
+		return m_first_line.back();
+	}
+
+	/** parse delimiter separated values. The number of values is given by
+	 * the first line, further values of a line are ignored.
+	 *
+	 * @param matrix allocated matrix
+	 * @param num_feat number of rows
+	 * @param num_vec number of columns
+	 * @param delimiter separator of values, spaces are separators as well
+	 * @param transposed whether a line is a row instead of a column
+	 */
+	template <class T>
+	void parse_dense(
+	    T*& matrix, int32_t& num_feat, int32_t& num_vec, char delimiter,
+	    bool transposed) const;
+
+	/** parse sparse vectors in LibSVM format, optionally preceded by comma
+	 * separated labels
+	 *
+	 * @param vectors allocated sparse vectors
+	 * @param num_feat largest feature index
+	 * @param num_vec number of vectors
+	 * @param labels allocated labels of every vector
+	 * @param num_classes number of distinct labels
+	 * @param load_labels whether the lines start with labels
+	 * @param feat_delimiter separator of feature index and value
+	 * @param label_delimiter separator of labels
+	 */
+	template <class T>
+	void parse_libsvm(
+	    SGSparseVector<T>*& vectors, int32_t& num_feat, int32_t& num_vec,
+	    SGVector<float64_t>*& labels, int32_t& num_classes, bool load_labels,
+	    char feat_delimiter = ':', char label_delimiter = ',') const;
+
+	/** parse a number like strtod and convert it to T, integers of 64 bits
+	 * are parsed like strtoll
+	 *
+	 * @param begin first character
+	 * @param end one past the last character
+	 * @return value, 0 for an empty token
+	 */
+	template <class T>
+	static T parse_value(const char* begin, const char* end);
+
+private:
+	/** split the text into line aligned ranges and count their lines */
+	void split_ranges();
+
+	/** call body(range, line, begin, end) for every non-empty line, ranges
+	 * in parallel
+	 */
+	template <class F>
+	void for_each_line(F&& body) const;
+
+private:
+	/** text of the file */
+	std::vector<char> m_text;
+	/** start of every range in m_text, with an additional end entry */
+	std::vector<size_t> m_range_begin;
+	/** index of the first line of every range, with the number of lines as
+	 * last entry
+	 */
+	std::vector<index_t> m_first_line;
+};
+}
+#endif // _PARALLEL_TEXT_PARSER_H__
@@ -0,0 +1,120 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/base/ShogunEnv.h"
+#include "shogun/io/CSVFile.h"
+#include "shogun/io/LibSVMFile.h"
+#include "shogun/lib/SGSparseVector.h"
+#include "shogun/lib/SGVector.h"
+
+#include <cstdio>
+#include <random>
+#include <unistd.h>
+
+namespace shogun
+{
+
+class ParallelTextParserFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		std::mt19937_64 prng(17);
+		std::normal_distribution<float64_t> dist;
+		std::uniform_real_distribution<float64_t> uniform;
+
+		FILE* csv = fopen(csv_name, "w");
+		FILE* libsvm = fopen(libsvm_name, "w");
+		for (index_t i = 0; i < st.range(0); i++)
+		{
+			fprintf(libsvm, "%d", i % 2 ? 1 : -1);
+			for (index_t j = 0; j < dim; j++)
+			{
+				auto value = dist(prng);
+				fprintf(csv, j ? ",%.17g" : "%.17g", value);
+				if (uniform(prng) < 0.1)
+					fprintf(libsvm, " %d:%.17g", j + 1, value);
+			}
+			fprintf(csv, "\n");
+			fprintf(libsvm, "\n");
+		}
+		fclose(csv);
+		fclose(libsvm);
+
+		num_threads = env()->get_num_threads();
+		env()->set_num_threads(st.range(1));
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		env()->set_num_threads(num_threads);
+		unlink(csv_name);
+		unlink(libsvm_name);
+	}
+
+	int64_t file_size(const char* fname)
+	{
+		FILE* f = fopen(fname, "r");
+		fseek(f, 0, SEEK_END);
+		int64_t size = ftell(f);
+		fclose(f);
+		return size;
+	}
+
+	static constexpr index_t dim = 100;
+	static constexpr const char* csv_name = "ParallelTextParser_benchmark.csv";
+	static constexpr const char* libsvm_name =
+	    "ParallelTextParser_benchmark.libsvm";
+	int32_t num_threads;
+};
+
+BENCHMARK_DEFINE_F(ParallelTextParserFixture, csv_dense)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto file = new CCSVFile(csv_name, 'r');
+		float64_t* matrix = NULL;
+		int32_t num_feat = 0;
+		int32_t num_vec = 0;
+		file->get_matrix(matrix, num_feat, num_vec);
+		benchmark::DoNotOptimize(matrix);
+		SG_FREE(matrix);
+		SG_UNREF(file);
+	}
+	st.SetBytesProcessed(st.iterations() * file_size(csv_name));
+}
+
+BENCHMARK_DEFINE_F(ParallelTextParserFixture, libsvm_labeled_sparse)
+(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto file = new CLibSVMFile(libsvm_name, 'r');
+		SGSparseVector<float64_t>* vectors = NULL;
+		float64_t* labels = NULL;
+		int32_t num_feat = 0;
+		int32_t num_vec = 0;
+		file->get_sparse_matrix(vectors, num_feat, num_vec, labels, true);
+		benchmark::DoNotOptimize(vectors);
+		SG_FREE(vectors);
+		SG_FREE(labels);
+		SG_UNREF(file);
+	}
+	st.SetBytesProcessed(st.iterations() * file_size(libsvm_name));
+}
+
+/* number of lines and number of threads */
+BENCHMARK_REGISTER_F(ParallelTextParserFixture, csv_dense)
+    ->Args({100000, 1})
+    ->Args({100000, 4})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(ParallelTextParserFixture, libsvm_labeled_sparse)
+    ->Args({100000, 1})
+    ->Args({100000, 4})
+    ->Unit(benchmark::kMillisecond);
+}
@@ -5,7 +5,10 @@
 
 #include <shogun/io/serialization/BitseryDeserializer.h>
 #include <shogun/io/serialization/BitseryVisitor.h>
+#include <shogun/io/MemoryMappedFile.h>
 #include <shogun/io/ShogunErrc.h>
+#include <shogun/io/stream/ByteArrayInputStream.h>
+#include <shogun/lib/Compressor.h>
 #include <shogun/util/converters.h>
 #include <shogun/base/class_list.h>
 #include <shogun/util/system.h>
@@ -13,17 +16,102 @@
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/string.h>
 
+#include <exception>
+#include <vector>
+
 using namespace bitsery;
 using namespace shogun;
 using namespace shogun::io;
 using namespace std;
 
+/** reads vectors and matrices that were written as raw blocks */
+struct ArrayBlockReader
+{
+	/** read exactly size bytes of the stream */
+	void read(void* buffer, uint64_t size)
+	{
+		auto dst = static_cast<char*>(buffer);
+		while (size > 0)
+		{
+			auto num_read = std::min(size, detail::kArrayBlockChunkSize);
+			auto ec = m_stream->read(&m_buffer, num_read);
+			if (ec && !io::is_out_of_range(ec))
+				throw io::to_system_error(ec);
+			require(
+				m_buffer.size() == num_read, "Truncated array block");
+			copy_n(m_buffer.begin(), num_read, dst);
+			dst += num_read;
+			size -= num_read;
+		}
+	}
+
+	Some<CInputStream> m_stream;
+	/** mapped file or empty */
+	std::shared_ptr<void> m_mapping;
+	/** start of the mapped file, which is read by m_stream */
+	const char* m_mapped_data;
+	/** whether the stream has array blocks */
+	bool m_enabled;
+	string m_buffer;
+};
+
 template<class S>
 class BitseryReaderVisitor: public detail::BitseryVisitor<S, BitseryReaderVisitor<S>>
 {
 public:
-	BitseryReaderVisitor(S& s):
-		detail::BitseryVisitor<S,BitseryReaderVisitor<S>>(s) {}
+	BitseryReaderVisitor(S& s, ArrayBlockReader* blocks):
+		detail::BitseryVisitor<S,BitseryReaderVisitor<S>>(s),
+		m_reader(s), m_blocks(blocks) {}
+
+	void enable_array_blocks()
+	{
+		require(!utils::is_big_endian(),
+			"Array blocks can only be read on little endian hosts");
+		m_blocks->m_enabled = true;
+	}
+
+	bool on_array(ArrayBlock* block) override
+	{
+		if (!m_blocks->m_enabled)
+			return false;
+
+		uint64_t num_bytes;
+		uint8_t compression;
+		m_reader.value8b(num_bytes);
+		m_reader.value1b(compression);
+		require(num_bytes == block->length * block->element_size,
+			"Array block of {} bytes does not match {} elements",
+			num_bytes, block->length);
+
+		if (compression != UNCOMPRESSED)
+		{
+			read_compressed(
+				block, num_bytes, static_cast<E_COMPRESSION_TYPE>(compression));
+			return true;
+		}
+
+		uint8_t padding;
+		m_reader.value1b(padding);
+		auto& stream = m_blocks->m_stream;
+		if (padding)
+			stream->skip(padding);
+
+		auto offset = stream->tell();
+		if (m_blocks->m_mapping && block->share &&
+			offset % detail::kArrayBlockAlignment == 0 &&
+			num_bytes >= detail::kLargeArrayBlockSize)
+		{
+			auto ec = stream->skip(num_bytes);
+			if (ec)
+				throw io::to_system_error(ec);
+			block->share(
+				const_cast<char*>(m_blocks->m_mapped_data) + offset,
+				m_blocks->m_mapping);
+		}
+		else
+			m_blocks->read(block->data(), num_bytes);
+		return true;
+	}
 
 	void on_complex(S& s, complex128_t* v)
 	{
@@ -60,6 +148,61 @@ public:
 	}
 
 private:
+	/** read the chunk sizes and the chunks, which are decompressed in
+	 * parallel */
+	void read_compressed(
+		ArrayBlock* block, uint64_t num_bytes, E_COMPRESSION_TYPE compression)
+	{
+		uint64_t num_chunks;
+		m_reader.value8b(num_chunks);
+		require(num_chunks == (num_bytes + detail::kArrayBlockChunkSize - 1) /
+			detail::kArrayBlockChunkSize,
+			"Array block of {} bytes has {} chunks", num_bytes, num_chunks);
+
+		std::vector<uint64_t> offsets(num_chunks + 1, 0);
+		for (uint64_t i = 0; i < num_chunks; ++i)
+		{
+			uint64_t size;
+			m_reader.value8b(size);
+			offsets[i + 1] = offsets[i] + size;
+		}
+		std::vector<uint8_t> compressed(offsets[num_chunks]);
+		m_blocks->read(compressed.data(), compressed.size());
+
+		auto data = static_cast<uint8_t*>(block->data());
+		std::vector<std::exception_ptr> errors(num_chunks);
+		// lzo is not thread safe
+		#pragma omp parallel for if (compression != LZO)
+		for (int64_t i = 0; i < (int64_t)num_chunks; ++i)
+		{
+			try
+			{
+				auto offset = i * detail::kArrayBlockChunkSize;
+				uint64_t size =
+					std::min(detail::kArrayBlockChunkSize, num_bytes - offset);
+				uint64_t expected = size;
+				auto compressor = some<CCompressor>(compression);
+				compressor->decompress(
+					compressed.data() + offsets[i], offsets[i + 1] - offsets[i],
+					data + offset, size);
+				require(size == expected, "Corrupt array block chunk");
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		}
+
+		for (auto& e: errors)
+		{
+			if (e)
+				std::rethrow_exception(e);
+		}
+	}
+
+	S& m_reader;
+	ArrayBlockReader* m_blocks;
+
 	SG_DELETE_COPY_AND_ASSIGN(BitseryReaderVisitor);
 };
 
@@ -104,6 +247,11 @@ CSGObject* object_reader(Reader& reader, BitseryReaderVisitor<Reader>* visitor,
 {
 	size_t obj_magic;
 	reader.value8b(obj_magic);
+	if (obj_magic == detail::kArrayBlocksMagic)
+	{
+		visitor->enable_array_blocks();
+		reader.value8b(obj_magic);
+	}
 	if (obj_magic == detail::kNullObjectMagic)
 		return nullptr;
 
@@ -165,15 +313,42 @@ CBitseryDeserializer::~CBitseryDeserializer()
 Some<CSGObject> CBitseryDeserializer::read_object()
 {
 	InputStreamAdapter adapter { stream() };
+	ArrayBlockReader blocks { stream(), m_mapping, m_mapped_data, false };
 	BitseryDeserializer deser {std::move(adapter)};
-	BitseryReaderVisitor<BitseryDeserializer> reader_visitor(deser);
+	BitseryReaderVisitor<BitseryDeserializer> reader_visitor(
+		deser, addressof(blocks));
 	return wrap<CSGObject>(object_reader(deser, addressof(reader_visitor)));
 }
 
 void CBitseryDeserializer::read(CSGObject* _this)
 {
 	InputStreamAdapter adapter { stream() };
+	ArrayBlockReader blocks { stream(), m_mapping, m_mapped_data, false };
 	BitseryDeserializer deser {std::move(adapter)};
-	BitseryReaderVisitor<BitseryDeserializer> reader_visitor(deser);
+	BitseryReaderVisitor<BitseryDeserializer> reader_visitor(
+		deser, addressof(blocks));
 	object_reader(deser, addressof(reader_visitor), _this);
 }
+
+void CBitseryDeserializer::attach(Some<CInputStream> stream)
+{
+	m_mapping.reset();
+	m_mapped_data = nullptr;
+	CDeserializer::attach(stream);
+}
+
+void CBitseryDeserializer::attach_mapped(const std::string& path)
+{
+	// copy on write, the loaded vectors and matrices may be modified in place
+	auto file = new CMemoryMappedFile<char>(path.c_str(), 'c');
+	SG_REF(file);
+	std::shared_ptr<void> mapping(file, [](CMemoryMappedFile<char>* f) {
+		SG_UNREF(f);
+	});
+
+	auto stream =
+		some<CByteArrayInputStream>(file->get_map(), file->get_size());
+	CDeserializer::attach(stream);
+	m_mapping = mapping;
+	m_mapped_data = file->get_map();
+}
@@ -7,6 +7,9 @@
 
 #include <shogun/io/serialization/Deserializer.h>
 
+#include <memory>
+#include <string>
+
 namespace shogun
 {
 	namespace io
@@ -18,11 +21,29 @@ namespace shogun
 			~CBitseryDeserializer() override;
 			Some<CSGObject> read_object() override;
 			void read(CSGObject* _this) override;
+			void attach(Some<CInputStream> stream) override;
+
+			/** Read from a memory mapped file. Aligned uncompressed
+			 * array blocks, see CBitserySerializer::set_array_blocks(),
+			 * are not copied: the vectors and matrices point into a copy
+			 * on write mapping, which is unmapped when the last of them
+			 * is destroyed. Modifying them does not change the file, and
+			 * resizing them copies the data out of the mapping.
+			 *
+			 * @param path file written by CBitserySerializer
+			 */
+			void attach_mapped(const std::string& path);
 
 			const char* get_name() const override
 			{
 				return "BitseryDeserializer";
 			}
+
+		private:
+			/** mapped file of attach_mapped() */
+			std::shared_ptr<void> m_mapping;
+			/** start of the mapped file */
+			const char* m_mapped_data = nullptr;
 		};
 	}
 }
@@ -12,17 +12,90 @@
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/string.h>
 
+#include <exception>
+#include <vector>
+
 using namespace bitsery;
 using namespace shogun;
 using namespace shogun::io;
 using namespace std;
 
+struct OutputStreamAdapter
+{
+	typedef void TValue;
+
+	void write(const TValue* buffer, size_t bytes)
+	{
+		auto ec = m_stream->write(buffer, bytes);
+		if(ec)
+			throw io::to_system_error(ec);
+		*m_written_bytes += bytes;
+	}
+
+	void flush()
+	{
+		m_stream->flush();
+	}
+
+	size_t writtenBytesCount() const
+	{
+		return *m_written_bytes;
+	}
+
+	Some<COutputStream> m_stream;
+	/** shared by all adapters of a stream */
+	size_t* m_written_bytes;
+};
+
+/** writes vectors and matrices as raw blocks, behind the bitsery values */
+struct ArrayBlockWriter
+{
+	OutputStreamAdapter m_raw;
+	E_COMPRESSION_TYPE m_compression;
+	int32_t m_level;
+};
+
 template<class Writer>
 class BitseryWriterVisitor : public detail::BitseryVisitor<Writer, BitseryWriterVisitor<Writer>>
 {
 public:
-	BitseryWriterVisitor(Writer& w):
-		detail::BitseryVisitor<Writer,BitseryWriterVisitor<Writer>>(w) {}
+	BitseryWriterVisitor(Writer& w, ArrayBlockWriter* blocks = nullptr):
+		detail::BitseryVisitor<Writer,BitseryWriterVisitor<Writer>>(w),
+		m_writer(w), m_blocks(blocks) {}
+
+	bool on_array(ArrayBlock* block) override
+	{
+		if (!m_blocks)
+			return false;
+
+		auto data = static_cast<const uint8_t*>(block->data());
+		uint64_t num_bytes = block->length * block->element_size;
+		bool large = num_bytes >= detail::kLargeArrayBlockSize;
+		auto compression = large ? m_blocks->m_compression : UNCOMPRESSED;
+		m_writer.value8b(num_bytes);
+		m_writer.value1b(static_cast<uint8_t>(compression));
+
+		if (compression != UNCOMPRESSED)
+		{
+			write_compressed(data, num_bytes, compression);
+			return true;
+		}
+
+		// pad, so that the data starts at an aligned offset
+		uint8_t padding = 0;
+		if (large)
+		{
+			auto offset = m_blocks->m_raw.writtenBytesCount() + 1;
+			padding = (detail::kArrayBlockAlignment -
+				offset % detail::kArrayBlockAlignment) %
+				detail::kArrayBlockAlignment;
+		}
+		m_writer.value1b(padding);
+		const uint8_t zeros[detail::kArrayBlockAlignment] = {};
+		m_blocks->m_raw.write(zeros, padding);
+		m_blocks->m_raw.write(data, num_bytes);
+		return true;
+	}
 
 	void on_complex(Writer& writer, complex128_t* v)
 	{
@@ -69,32 +142,61 @@ public:
 			writer.value8b(detail::kNullObjectMagic);
 		}
 	}
-};
-
-struct OutputStreamAdapter
-{
-	typedef void TValue;
 
-	void write(const TValue* buffer, size_t bytes)
+private:
+	/** write the chunk sizes followed by the chunks, which are compressed
+	 * in parallel */
+	void write_compressed(
+		const uint8_t* data, uint64_t num_bytes,
+		E_COMPRESSION_TYPE compression)
 	{
-		auto ec = m_stream->write(buffer, bytes);
-		if(ec)
-			throw io::to_system_error(ec);
-		written_bytes += bytes;
-	}
+		int64_t num_chunks = (num_bytes + detail::kArrayBlockChunkSize - 1) /
+			detail::kArrayBlockChunkSize;
+		std::vector<uint8_t*> chunks(num_chunks, nullptr);
+		std::vector<uint64_t> sizes(num_chunks, 0);
+		std::vector<std::exception_ptr> errors(num_chunks);
 
-	void flush()
-	{
-		m_stream->flush();
-	}
+		// lzo is not thread safe
+		#pragma omp parallel for if (compression != LZO)
+		for (int64_t i = 0; i < num_chunks; ++i)
+		{
+			try
+			{
+				auto offset = i * detail::kArrayBlockChunkSize;
+				auto compressor = some<CCompressor>(compression);
+				compressor->compress(
+					const_cast<uint8_t*>(data) + offset,
+					std::min(detail::kArrayBlockChunkSize, num_bytes - offset),
+					chunks[i], sizes[i], m_blocks->m_level);
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		}
 
-	size_t writtenBytesCount() const
-	{
-		return written_bytes;
+		for (auto& e: errors)
+		{
+			if (e)
+			{
+				for (auto chunk: chunks)
+					SG_FREE(chunk);
+				std::rethrow_exception(e);
+			}
+		}
+
+		m_writer.value8b(static_cast<uint64_t>(num_chunks));
+		for (auto size: sizes)
+			m_writer.value8b(size);
+		for (int64_t i = 0; i < num_chunks; ++i)
+		{
+			m_blocks->m_raw.write(chunks[i], sizes[i]);
+			SG_FREE(chunks[i]);
+		}
 	}
 
-	Some<COutputStream> m_stream;
-	size_t written_bytes = 0;
+	Writer& m_writer;
+	ArrayBlockWriter* m_blocks;
 };
 
 // cannot use context because of circular dependency :(
@@ -136,8 +238,21 @@ CBitserySerializer::~CBitserySerializer()
 
 void CBitserySerializer::write(Some<CSGObject> object) noexcept(false)
 {
-	OutputStreamAdapter adapter { stream() };
+	size_t written_bytes = 0;
+	OutputStreamAdapter adapter { stream(), addressof(written_bytes) };
+	ArrayBlockWriter blocks { adapter, m_compression, m_level };
  	BitserySerializer serializer {std::move(adapter)};
- 	BitseryWriterVisitor<BitserySerializer> writer_visitor(serializer);
+ 	BitseryWriterVisitor<BitserySerializer> writer_visitor(
+		serializer, m_array_blocks ? addressof(blocks) : nullptr);
+	if (m_array_blocks)
+		serializer.value8b(detail::kArrayBlocksMagic);
  	write_object(serializer, addressof(writer_visitor), object);
 }
+
+void CBitserySerializer::set_array_blocks(
+	bool enable, E_COMPRESSION_TYPE compression, int32_t level)
+{
+	m_array_blocks = enable && !utils::is_big_endian();
+	m_compression = compression;
+	m_level = level;
+}
@@ -6,6 +6,7 @@
 #define __BITSERY_SERIALIZER_H__
 
 #include <shogun/io/serialization/Serializer.h>
+#include <shogun/lib/Compressor.h>
 
 namespace shogun
 {
@@ -18,10 +19,36 @@ namespace shogun
 			~CBitserySerializer() override;
 			virtual void write(Some<CSGObject> object) noexcept(false);
 
+			/** Write vectors and matrices of primitive types as raw
+			 * blocks instead of element by element. Large uncompressed
+			 * blocks are aligned in the stream, so that
+			 * CBitseryDeserializer::attach_mapped() maps them instead of
+			 * copying. Compressed blocks are split into chunks, which are
+			 * compressed in parallel.
+			 *
+			 * Streams with array blocks are only written on little
+			 * endian hosts, elsewhere this option is ignored.
+			 *
+			 * @param enable whether to write array blocks
+			 * @param compression compression of large blocks
+			 * @param level compression level
+			 */
+			void set_array_blocks(
+				bool enable, E_COMPRESSION_TYPE compression = UNCOMPRESSED,
+				int32_t level = 1);
+
 			virtual const char* get_name() const
 			{
 				return "BitserySerializer";
 			}
+
+		private:
+			/** whether array blocks are written */
+			bool m_array_blocks = false;
+			/** compression of large array blocks */
+			E_COMPRESSION_TYPE m_compression = UNCOMPRESSED;
+			/** compression level */
+			int32_t m_level = 1;
 		};
 	}
 }
@@ -15,6 +15,14 @@ namespace shogun
 		namespace detail
 		{
 			static const size_t kNullObjectMagic = std::numeric_limits<size_t>::max();
+			/** written before the root object of streams with array blocks */
+			static const size_t kArrayBlocksMagic = kNullObjectMagic - 1;
+			/** alignment of large uncompressed array blocks in the stream */
+			static const uint64_t kArrayBlockAlignment = 64;
+			/** smaller array blocks are neither aligned nor compressed */
+			static const uint64_t kLargeArrayBlockSize = 4096;
+			/** uncompressed size of the chunks of compressed array blocks */
+			static const uint64_t kArrayBlockChunkSize = 4 << 20;
 
 			template <class S, class T>
 			class BitseryVisitor : public AnyVisitor
@@ -0,0 +1,459 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/io/ParallelTextParser.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/io/streaming/BatchInputParser.h>
+#include <shogun/io/streaming/StreamingAsciiFile.h>
+
+#include <algorithm>
+#include <string.h>
+#include <string>
+
+using namespace shogun;
+
+namespace
+{
+/** find the next token of [pos, end) that is separated by blanks or the
+ * delimiter, which is [begin, pos) afterwards
+ *
+ * @return whether there is a token
+ */
+bool next_token(
+    const char*& pos, const char* end, char delimiter, const char*& begin)
+{
+	auto is_separator = [delimiter](char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == delimiter;
+	};
+
+	while (pos < end && is_separator(*pos))
+		++pos;
+
+	begin = pos;
+	while (pos < end && !is_separator(*pos))
+		++pos;
+
+	return begin < pos;
+}
+
+/** @return end of the line that starts at begin */
+const char* line_end(const char* begin, const char* end)
+{
+	auto eol = (const char*)memchr(begin, '\n', end - begin);
+	return eol ? eol : end;
+}
+}
+
+namespace shogun
+{
+template <class T>
+BatchInputParser<T>::BatchInputParser(
+    CStreamingFile* file, bool is_labelled, bool is_sparse,
+    index_t batch_size, int32_t num_threads)
+    : m_file(file), m_ascii_file(dynamic_cast<CStreamingAsciiFile*>(file)),
+      m_is_labelled(is_labelled), m_is_sparse(is_sparse),
+      m_batch_size(batch_size), m_num_threads(num_threads), m_cancel(false),
+      m_next_worker(0), m_done(false)
+{
+	require(file, "Stream to read from is required");
+	require(batch_size > 0, "Batch size ({}) must be positive", batch_size);
+	require(
+	    num_threads > 0, "Number of parser threads ({}) must be positive",
+	    num_threads);
+}
+
+template <class T>
+BatchInputParser<T>::~BatchInputParser()
+{
+	stop();
+}
+
+template <class T>
+void BatchInputParser<T>::start()
+{
+	require(!is_running(), "Batch parser is already running");
+
+	m_cancel.store(false, std::memory_order_release);
+	m_reader_error = nullptr;
+	m_next_worker = 0;
+	m_done = false;
+
+	m_workers.clear();
+	auto num_workers = m_ascii_file ? m_num_threads : 1;
+	for (int32_t i = 0; i < num_workers; ++i)
+		m_workers.emplace_back(new Worker());
+
+	if (m_ascii_file)
+	{
+		SG_SET_LOCALE_C;
+		for (auto& worker : m_workers)
+		{
+			auto w = worker.get();
+			worker->thread = std::thread([this, w]() { parse_text(*w); });
+		}
+		m_reader = std::thread([this]() { read_text(); });
+	}
+	else if (m_is_sparse)
+		m_reader = std::thread(
+		    [this]() { read_vectors<SGSparseVectorEntry<T>>(); });
+	else
+		m_reader = std::thread([this]() { read_vectors<T>(); });
+}
+
+template <class T>
+void BatchInputParser<T>::stop()
+{
+	if (!is_running())
+		return;
+
+	m_cancel.store(true, std::memory_order_release);
+	m_reader.join();
+	for (auto& worker : m_workers)
+	{
+		if (worker->thread.joinable())
+			worker->thread.join();
+	}
+	m_workers.clear();
+
+	if (m_ascii_file)
+		SG_RESET_LOCALE;
+}
+
+template <class T>
+std::unique_ptr<StreamingBatch<T>> BatchInputParser<T>::next_batch()
+{
+	require(is_running(), "Batch parser is not running");
+
+	std::unique_ptr<StreamingBatch<T>> batch;
+	if (m_done)
+		return batch;
+
+	auto& worker = *m_workers[m_next_worker];
+	m_next_worker = (m_next_worker + 1) % m_workers.size();
+	worker.batches.pop(batch, m_cancel);
+
+	// an empty batch marks the end of the stream or an error
+	if (!batch)
+	{
+		m_done = true;
+		rethrow_error();
+	}
+	return batch;
+}
+
+template <class T>
+void BatchInputParser<T>::rethrow_error()
+{
+	if (m_reader_error)
+		std::rethrow_exception(m_reader_error);
+
+	for (auto& worker : m_workers)
+	{
+		if (worker->error)
+			std::rethrow_exception(worker->error);
+	}
+}
+
+template <class T>
+void BatchInputParser<T>::read_text()
+{
+	size_t i = 0;
+	try
+	{
+		while (!m_cancel.load(std::memory_order_acquire))
+		{
+			std::unique_ptr<TextBlock> block(new TextBlock());
+			block->num_lines =
+			    m_ascii_file->read_lines(block->text, m_batch_size);
+			if (block->num_lines == 0)
+				break;
+
+			if (!m_workers[i]->blocks.push(block, m_cancel))
+				return;
+			i = (i + 1) % m_workers.size();
+		}
+	}
+	catch (...)
+	{
+		m_reader_error = std::current_exception();
+	}
+
+	// every worker forwards the end of the stream as an empty batch
+	for (auto& worker : m_workers)
+	{
+		std::unique_ptr<TextBlock> end;
+		worker->blocks.push(end, m_cancel);
+	}
+}
+
+template <class T>
+void BatchInputParser<T>::parse_text(Worker& worker)
+{
+	std::unique_ptr<TextBlock> block;
+	while (worker.blocks.pop(block, m_cancel))
+	{
+		std::unique_ptr<StreamingBatch<T>> batch;
+		if (block)
+		{
+			try
+			{
+				batch =
+				    m_is_sparse ? parse_sparse(*block) : parse_dense(*block);
+			}
+			catch (...)
+			{
+				worker.error = std::current_exception();
+			}
+		}
+
+		// the end of the stream or an error is forwarded as empty batch
+		if (!worker.batches.push(batch, m_cancel) || !batch)
+			return;
+	}
+}
+
+template <class T>
+std::unique_ptr<StreamingBatch<T>>
+BatchInputParser<T>::parse_dense(const TextBlock& block) const
+{
+	const char delimiter = m_ascii_file->get_delimiter();
+	const char* pos = block.text.data();
+	const char* end = pos + block.text.size();
+
+	// the first line gives the number of values
+	index_t num_values = m_is_labelled ? -1 : 0;
+	const char* eol = line_end(pos, end);
+	const char* token;
+	for (const char* p = pos; next_token(p, eol, delimiter, token);)
+		++num_values;
+	require(
+	    num_values > 0, "First line of the batch does not contain values");
+
+	auto batch = new_batch(block.num_lines);
+	batch->matrix = SGMatrix<T>(num_values, block.num_lines);
+	for (index_t i = 0; i < block.num_lines; ++i)
+	{
+		eol = line_end(pos, end);
+		if (m_is_labelled)
+		{
+			require(
+			    next_token(pos, eol, delimiter, token), "No label found!");
+			batch->labels[i] =
+			    ParallelTextParser::parse_value<float64_t>(token, pos);
+		}
+
+		T* column = batch->matrix.get_column_vector(i);
+		index_t j = 0;
+		for (; next_token(pos, eol, delimiter, token); ++j)
+		{
+			require(
+			    j < num_values, "Vector has more than {} values", num_values);
+			column[j] = ParallelTextParser::parse_value<T>(token, pos);
+		}
+		require(
+		    j == num_values, "Vector has {} values instead of {}", j,
+		    num_values);
+
+		pos = eol + 1;
+	}
+	batch->num_vectors = block.num_lines;
+
+	return batch;
+}
+
+template <class T>
+std::unique_ptr<StreamingBatch<T>>
+BatchInputParser<T>::parse_sparse(const TextBlock& block) const
+{
+	const char* pos = block.text.data();
+	const char* end = pos + block.text.size();
+
+	auto batch = new_batch(block.num_lines);
+	batch->entries.reserve(std::count(pos, end, ':'));
+	for (index_t i = 0; i < block.num_lines; ++i)
+	{
+		const char* eol = line_end(pos, end);
+		const char* token;
+		if (m_is_labelled)
+		{
+			require(
+			    next_token(pos, eol, ' ', token) &&
+			        !memchr(token, ':', pos - token),
+			    "No label found!");
+			batch->labels[i] =
+			    ParallelTextParser::parse_value<float64_t>(token, pos);
+		}
+
+		while (next_token(pos, eol, ' ', token))
+		{
+			auto colon = (const char*)memchr(token, ':', pos - token);
+			require(
+			    colon, "Sparse entry {} is not of the form index:value",
+			    std::string(token, pos));
+
+			SGSparseVectorEntry<T> entry;
+			entry.feat_index =
+			    ParallelTextParser::parse_value<int32_t>(token, colon) - 1;
+			entry.entry = ParallelTextParser::parse_value<T>(colon + 1, pos);
+			require(
+			    entry.feat_index >= 0, "Feature index ({}) must be positive",
+			    entry.feat_index + 1);
+
+			batch->num_features =
+			    std::max(batch->num_features, entry.feat_index + 1);
+			batch->entries.push_back(entry);
+		}
+		batch->offsets.push_back(batch->entries.size());
+
+		pos = eol + 1;
+	}
+	batch->num_vectors = block.num_lines;
+
+	return batch;
+}
+
+template <class T>
+template <class V>
+void BatchInputParser<T>::read_vectors()
+{
+	auto& batches = m_workers.front()->batches;
+	try
+	{
+		bool stream_end = false;
+		while (!stream_end)
+		{
+			auto batch = new_batch(m_batch_size);
+			while (batch->num_vectors < m_batch_size)
+			{
+				V* vector = NULL;
+				int32_t len = 0;
+				float64_t label = 0;
+				if (!read_vector(vector, len, label))
+				{
+					stream_end = true;
+					break;
+				}
+
+				append(*batch, vector, len);
+				if (m_is_labelled)
+					batch->labels[batch->num_vectors] = label;
+				batch->num_vectors++;
+			}
+
+			if (batch->num_vectors == 0)
+				break;
+
+			shrink(*batch);
+			if (!batches.push(batch, m_cancel))
+				return;
+		}
+	}
+	catch (...)
+	{
+		m_reader_error = std::current_exception();
+	}
+
+	std::unique_ptr<StreamingBatch<T>> end;
+	batches.push(end, m_cancel);
+}
+
+template <class T>
+bool BatchInputParser<T>::read_vector(
+    T*& vector, int32_t& len, float64_t& label)
+{
+	if (m_is_labelled)
+		m_file->get_vector_and_label(vector, len, label);
+	else
+		m_file->get_vector(vector, len);
+
+	return len >= 0;
+}
+
+template <class T>
+bool BatchInputParser<T>::read_vector(
+    SGSparseVectorEntry<T>*& vector, int32_t& len, float64_t& label)
+{
+	if (m_is_labelled)
+		m_file->get_sparse_vector_and_label(vector, len, label);
+	else
+		m_file->get_sparse_vector(vector, len);
+
+	return len >= 0;
+}
+
+template <class T>
+void BatchInputParser<T>::append(
+    StreamingBatch<T>& batch, const T* vector, int32_t len) const
+{
+	if (batch.num_vectors == 0)
+		batch.matrix = SGMatrix<T>(len, m_batch_size);
+
+	require(
+	    len == batch.matrix.num_rows,
+	    "Vector has {} values instead of {}", len, batch.matrix.num_rows);
+	std::copy_n(vector, len, batch.matrix.get_column_vector(batch.num_vectors));
+}
+
+template <class T>
+void BatchInputParser<T>::append(
+    StreamingBatch<T>& batch, const SGSparseVectorEntry<T>* vector,
+    int32_t len) const
+{
+	for (int32_t i = 0; i < len; ++i)
+	{
+		batch.num_features =
+		    std::max(batch.num_features, vector[i].feat_index + 1);
+		batch.entries.push_back(vector[i]);
+	}
+	batch.offsets.push_back(batch.entries.size());
+}
+
+template <class T>
+std::unique_ptr<StreamingBatch<T>>
+BatchInputParser<T>::new_batch(index_t num_vectors) const
+{
+	std::unique_ptr<StreamingBatch<T>> batch(new StreamingBatch<T>());
+	if (m_is_sparse)
+	{
+		batch->offsets.reserve(num_vectors + 1);
+		batch->offsets.push_back(0);
+	}
+	if (m_is_labelled)
+		batch->labels = SGVector<float64_t>(num_vectors);
+
+	return batch;
+}
+
+template <class T>
+void BatchInputParser<T>::shrink(StreamingBatch<T>& batch) const
+{
+	if (m_is_labelled)
+		batch.labels.resize_vector(batch.num_vectors);
+
+	if (!m_is_sparse && batch.num_vectors < batch.matrix.num_cols)
+	{
+		SGMatrix<T> matrix(batch.matrix.num_rows, batch.num_vectors);
+		std::copy_n(
+		    batch.matrix.matrix,
+		    int64_t(matrix.num_rows) * matrix.num_cols, matrix.matrix);
+		batch.matrix = matrix;
+	}
+}
+
+template class BatchInputParser<bool>;
+template class BatchInputParser<char>;
+template class BatchInputParser<int8_t>;
+template class BatchInputParser<uint8_t>;
+template class BatchInputParser<int16_t>;
+template class BatchInputParser<uint16_t>;
+template class BatchInputParser<int32_t>;
+template class BatchInputParser<uint32_t>;
+template class BatchInputParser<int64_t>;
+template class BatchInputParser<uint64_t>;
+template class BatchInputParser<float32_t>;
+template class BatchInputParser<float64_t>;
+template class BatchInputParser<floatmax_t>;
+}
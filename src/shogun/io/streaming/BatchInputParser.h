@@ -0,0 +1,209 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+#ifndef __BATCHINPUTPARSER_H__
+#define __BATCHINPUTPARSER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseVector.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SPSCQueue.h>
+#include <shogun/lib/common.h>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace shogun
+{
+class CStreamingFile;
+class CStreamingAsciiFile;
+
+/** @brief Mini-batch of consecutive examples of a stream.
+ *
+ * Dense vectors are the columns of one matrix, sparse vectors are stored
+ * in compressed sparse row format, i.e. the entries of all vectors are
+ * contiguous.
+ */
+template <class T>
+struct StreamingBatch
+{
+	/** number of vectors */
+	index_t num_vectors = 0;
+	/** dense vectors as columns */
+	SGMatrix<T> matrix;
+	/** start of every sparse vector in entries, with an end entry */
+	std::vector<index_t> offsets;
+	/** entries of all sparse vectors */
+	std::vector<SGSparseVectorEntry<T>> entries;
+	/** largest feature index plus one of the sparse vectors */
+	int32_t num_features = 0;
+	/** labels, empty for unlabelled streams */
+	SGVector<float64_t> labels;
+};
+
+/** @brief Parser that reads a stream in mini-batches on background threads.
+ *
+ * Unlike CInputParser, which hands over every example through a ring that
+ * is guarded by a mutex, examples are handed over in batches. The batches
+ * are passed through lock-free single producer single consumer queues, so
+ * the consumer only synchronises once per batch.
+ *
+ * Text of a CStreamingAsciiFile is read by one reader thread in blocks of
+ * batch size lines, which are parsed by several parser threads. Each parser
+ * thread has its own input and output queue and the blocks are dealt out
+ * round robin, hence the batches are returned in the order of the stream.
+ * Other streams, like CStreamingFileFromFeatures, are read with their vector
+ * access functions by the reader thread, which then fills the batches
+ * itself. Such streams own the vectors they return.
+ */
+template <class T>
+class BatchInputParser
+{
+public:
+	/** constructor
+	 *
+	 * @param file stream to read from, which must outlive the parser
+	 * @param is_labelled whether the examples are labelled
+	 * @param is_sparse whether to parse sparse vectors
+	 * @param batch_size number of examples per batch
+	 * @param num_threads number of parser threads for text streams
+	 */
+	BatchInputParser(
+	    CStreamingFile* file, bool is_labelled, bool is_sparse,
+	    index_t batch_size, int32_t num_threads = 1);
+
+	BatchInputParser(const BatchInputParser&) = delete;
+	BatchInputParser& operator=(const BatchInputParser&) = delete;
+
+	/** destructor, stops the threads */
+	~BatchInputParser();
+
+	/** start reading the stream from its current position */
+	void start();
+
+	/** stop reading, batches that were not returned yet are dropped */
+	void stop();
+
+	/** @return whether the threads are running */
+	bool is_running() const
+	{
+		return m_reader.joinable();
+	}
+
+	/** @return number of examples per batch */
+	index_t get_batch_size() const
+	{
+		return m_batch_size;
+	}
+
+	/** return the next batch, waiting for it to be parsed. Errors while
+	 * reading or parsing are rethrown here.
+	 *
+	 * @return next batch, empty at the end of the stream
+	 */
+	std::unique_ptr<StreamingBatch<T>> next_batch();
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** lines of a text stream */
+	struct TextBlock
+	{
+		std::vector<char> text;
+		index_t num_lines;
+	};
+
+	/** queues of a parser thread */
+	struct Worker
+	{
+		Worker() : blocks(queue_capacity), batches(queue_capacity)
+		{
+		}
+
+		SPSCQueue<std::unique_ptr<TextBlock>> blocks;
+		SPSCQueue<std::unique_ptr<StreamingBatch<T>>> batches;
+		std::thread thread;
+		std::exception_ptr error;
+	};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** read text blocks and deal them out to the parser threads */
+	void read_text();
+
+	/** read batches with the vector access functions of the stream */
+	template <class V>
+	void read_vectors();
+
+	/** parse the text blocks of a worker */
+	void parse_text(Worker& worker);
+
+	/** parse a block of dense vectors */
+	std::unique_ptr<StreamingBatch<T>>
+	parse_dense(const TextBlock& block) const;
+
+	/** parse a block of sparse vectors */
+	std::unique_ptr<StreamingBatch<T>>
+	parse_sparse(const TextBlock& block) const;
+
+	/** read a dense vector, or return false at the end of the stream */
+	bool read_vector(T*& vector, int32_t& len, float64_t& label);
+
+	/** read a sparse vector, or return false at the end of the stream */
+	bool read_vector(
+	    SGSparseVectorEntry<T>*& vector, int32_t& len, float64_t& label);
+
+	/** append a dense vector to a batch */
+	void append(StreamingBatch<T>& batch, const T* vector, int32_t len) const;
+
+	/** append a sparse vector to a batch */
+	void append(
+	    StreamingBatch<T>& batch, const SGSparseVectorEntry<T>* vector,
+	    int32_t len) const;
+
+	/** @return empty batch for up to num_vectors vectors */
+	std::unique_ptr<StreamingBatch<T>> new_batch(index_t num_vectors) const;
+
+	/** shrink the storage of a batch to its number of vectors */
+	void shrink(StreamingBatch<T>& batch) const;
+
+	/** rethrow the first error of the threads */
+	void rethrow_error();
+
+private:
+	/** number of batches that are queued per thread */
+	static constexpr size_t queue_capacity = 4;
+
+	/** stream */
+	CStreamingFile* m_file;
+	/** the stream if it is a text stream */
+	CStreamingAsciiFile* m_ascii_file;
+	/** whether the examples are labelled */
+	bool m_is_labelled;
+	/** whether to parse sparse vectors */
+	bool m_is_sparse;
+	/** number of examples per batch */
+	index_t m_batch_size;
+	/** number of parser threads for text streams */
+	int32_t m_num_threads;
+
+	/** parser threads, a single queue of batches for other streams */
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	/** reader thread */
+	std::thread m_reader;
+	/** error of the reader thread */
+	std::exception_ptr m_reader_error;
+	/** set to stop the threads */
+	std::atomic<bool> m_cancel;
+	/** index of the worker of the next batch */
+	size_t m_next_worker;
+	/** whether the end of the stream was returned */
+	bool m_done;
+};
+}
+#endif // __BATCHINPUTPARSER_H__
@@ -624,6 +624,22 @@ void CStreamingAsciiFile::set_delimiter(char delimiter)
 {
 	m_delimiter = delimiter;
 }
+
+index_t CStreamingAsciiFile::read_lines(std::vector<char>& text, index_t num_lines)
+{
+	index_t i=0;
+	for (; i<num_lines; i++)
+	{
+		char* line=NULL;
+		ssize_t num_chars=buf->read_line(line);
+		if (num_chars<=0)
+			break;
+
+		text.insert(text.end(), line, line+num_chars);
+		text.push_back('\n');
+	}
+	return i;
+}
 void CStreamingAsciiFile::tokenize(char delim, substring s, v_array<substring>& ret)
 {
 	ret.erase();
@@ -12,6 +12,8 @@
 #include <shogun/io/streaming/StreamingFile.h>
 #include <shogun/lib/v_array.h>
 
+#include <vector>
+
 namespace shogun
 {
 
@@ -52,6 +54,23 @@ public:
 	 */
 	void set_delimiter(char delimiter);
 
+	/** @return delimiting character */
+	char get_delimiter() const
+	{
+		return m_delimiter;
+	}
+
+#ifndef SWIG // SWIG should skip this
+	/** read lines at once, to parse them elsewhere. Like the vector access
+	 * functions, reading stops at the first empty line.
+	 *
+	 * @param text the lines are appended, each terminated by a newline
+	 * @param num_lines maximum number of lines to read
+	 * @return number of lines read, 0 at the end of the stream
+	 */
+	index_t read_lines(std::vector<char>& text, index_t num_lines);
+#endif // #ifndef SWIG // SWIG should skip this
+
 #ifndef SWIG // SWIG should skip this
 	/**
 	 * Utility function to convert a string to a boolean value
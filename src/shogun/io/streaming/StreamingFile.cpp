@@ -7,6 +7,7 @@
 
 #include <shogun/lib/memory.h>
 #include <shogun/io/streaming/StreamingFile.h>
+#include <shogun/io/CompressedIOBuffer.h>
 #include <fcntl.h>
 #ifdef _WIN32
 #include <io.h>
@@ -213,7 +214,13 @@ CStreamingFile::CStreamingFile(const char* fname, char rw) : CSGObject()
 		if (file < 0)
 			error("Error opening file '{}'", filename);
 
-		buf = new CIOBuffer(file);
+		if (rw == 'r' && CCompressedIOBuffer::is_compressed_file(file))
+		{
+			buf = new CCompressedIOBuffer();
+			buf->use_file(file);
+		}
+		else
+			buf = new CIOBuffer(file);
 		SG_REF(buf);
 	}
 	else
@@ -25,6 +25,7 @@ void CCustomKernel::init()
 	SG_REF(m_col_subset_stack)
 	m_is_symmetric=false;
 	m_free_km=true;
+	m_tiled=NULL;
 
 	SG_ADD((CSGObject**)&m_row_subset_stack, "row_subset_stack",
 			"Subset stack of rows");
@@ -35,6 +36,9 @@ void CCustomKernel::init()
 	SG_ADD(&m_is_symmetric, "is_symmetric", "Whether kernel matrix is symmetric");
 	SG_ADD(&kmatrix, "kmatrix", "Kernel matrix.");
 	SG_ADD(&upper_diagonal, "upper_diagonal", "Upper diagonal");
+	watch_param(
+		"tiled_file", &m_tiled_file,
+		AnyParameterProperties("File of the tiled kernel matrix"));
 }
 
 CCustomKernel::CCustomKernel()
@@ -55,13 +59,17 @@ CCustomKernel::CCustomKernel(CKernel* k)
 	{
 		CCustomKernel* casted=(CCustomKernel*)k;
 		m_is_symmetric=casted->m_is_symmetric;
-		set_full_kernel_matrix_from_full(casted->get_float32_kernel_matrix());
+		if (casted->is_tiled())
+			set_tiled_kernel_matrix_from_file(casted->m_tiled_file.c_str());
+		else
+			set_full_kernel_matrix_from_full(casted->get_float32_kernel_matrix());
 		m_free_km=false;
 	}
 	else
 	{
 		m_is_symmetric=k->get_lhs_equals_rhs();
-		set_full_kernel_matrix_from_full(k->get_kernel_matrix());
+		// computed in the precision of k and stored in float32_t right away
+		set_full_kernel_matrix_from_full(k->get_kernel_matrix<float32_t>());
 	}
 }
 
@@ -147,19 +155,87 @@ bool CCustomKernel::init(CFeatures* l, CFeatures* r)
 
 	SG_DEBUG("num_vec_lhs: {} vs num_rows {}", l->get_num_vectors(), kmatrix.num_rows)
 	SG_DEBUG("num_vec_rhs: {} vs num_cols {}", r->get_num_vectors(), kmatrix.num_cols)
-	ASSERT(l->get_num_vectors()==kmatrix.num_rows)
-	ASSERT(r->get_num_vectors()==kmatrix.num_cols)
+	if (m_tiled)
+	{
+		ASSERT(l->get_num_vectors()==m_tiled->get_num_rows())
+		ASSERT(r->get_num_vectors()==m_tiled->get_num_cols())
+	}
+	else
+	{
+		ASSERT(l->get_num_vectors()==kmatrix.num_rows)
+		ASSERT(r->get_num_vectors()==kmatrix.num_cols)
+	}
 	return init_normalizer();
 }
 
+bool CCustomKernel::set_tiled_kernel_matrix_from_file(const char* fname)
+{
+	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	{
+		error("{}::set_tiled_kernel_matrix_from_file "
+				"not possible with subset. Remove first", get_name());
+	}
+
+	cleanup_custom();
+	m_tiled_file=fname;
+	map_tiled_kernel_matrix();
+	m_is_symmetric=m_tiled->is_upper_triangle();
+	SG_DEBUG("using tiled custom kernel of size {}x{}",
+			m_tiled->get_num_rows(), m_tiled->get_num_cols())
+
+	dummy_init(m_tiled->get_num_rows(), m_tiled->get_num_cols());
+	return true;
+}
+
+void CCustomKernel::map_tiled_kernel_matrix()
+{
+	delete m_tiled;
+	m_tiled=NULL;
+
+	if (!m_tiled_file.empty())
+		m_tiled=new TiledKernelMatrix(m_tiled_file.c_str());
+}
+
+CSGObject* CCustomKernel::clone(ParameterProperties pp) const
+{
+	// the mapping itself is not a parameter, only the file it comes from
+	CCustomKernel* kernel_clone=(CCustomKernel*) CKernel::clone(pp);
+	kernel_clone->map_tiled_kernel_matrix();
+	return kernel_clone;
+}
+
+void CCustomKernel::load_serializable_post() noexcept(false)
+{
+	CKernel::load_serializable_post();
+	map_tiled_kernel_matrix();
+}
+
+void CCustomKernel::prefetch_rows(const int32_t* rows, int32_t num_rows)
+{
+	if (!m_tiled)
+		return;
+
+	int32_t num_vec=get_num_vec_lhs();
+	for (int32_t i=0; i<num_rows; i++)
+	{
+		int32_t idx=rows[i];
+		if (idx>=num_vec)
+			idx=2*num_vec-1-idx;
+
+		m_tiled->prefetch_row(m_row_subset_stack->subset_idx_conversion(idx));
+	}
+}
+
 float64_t CCustomKernel::sum_symmetric_block(index_t block_begin,
 		index_t block_size, bool no_diag)
 {
 	SG_DEBUG("Entering");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_tiled || m_row_subset_stack->has_subsets() ||
+			m_col_subset_stack->has_subsets())
 	{
-		io::info("Row/col subsets initialized! Falling back to "
+		io::info("Row/col subsets initialized or kernel matrix is tiled! "
+				"Falling back to "
 				"CKernel::sum_symmetric_block (slower)!");
 		return CKernel::sum_symmetric_block(block_begin, block_size, no_diag);
 	}
@@ -185,9 +261,11 @@ float64_t CCustomKernel::sum_block(index_t block_begin_row,
 {
 	SG_DEBUG("Entering");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_tiled || m_row_subset_stack->has_subsets() ||
+			m_col_subset_stack->has_subsets())
 	{
-		io::info("Row/col subsets initialized! Falling back to "
+		io::info("Row/col subsets initialized or kernel matrix is tiled! "
+				"Falling back to "
 				"CKernel::sum_block (slower)!");
 		return CKernel::sum_block(block_begin_row, block_begin_col,
 				block_size_row, block_size_col, no_diag);
@@ -224,9 +302,11 @@ SGVector<float64_t> CCustomKernel::row_wise_sum_symmetric_block(index_t
 {
 	SG_DEBUG("Entering");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_tiled || m_row_subset_stack->has_subsets() ||
+			m_col_subset_stack->has_subsets())
 	{
-		io::info("Row/col subsets initialized! Falling back to "
+		io::info("Row/col subsets initialized or kernel matrix is tiled! "
+				"Falling back to "
 				"CKernel::row_wise_sum_symmetric_block (slower)!");
 		return CKernel::row_wise_sum_symmetric_block(block_begin, block_size,
 				no_diag);
@@ -259,9 +339,11 @@ SGMatrix<float64_t> CCustomKernel::row_wise_sum_squared_sum_symmetric_block(
 {
 	SG_DEBUG("Entering");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_tiled || m_row_subset_stack->has_subsets() ||
+			m_col_subset_stack->has_subsets())
 	{
-		io::info("Row/col subsets initialized! Falling back to "
+		io::info("Row/col subsets initialized or kernel matrix is tiled! "
+				"Falling back to "
 				"CKernel::row_wise_sum_squared_sum_symmetric_block (slower)!");
 		return CKernel::row_wise_sum_squared_sum_symmetric_block(block_begin,
 				block_size, no_diag);
@@ -305,9 +387,11 @@ SGVector<float64_t> CCustomKernel::row_col_wise_sum_block(index_t
 {
 	SG_DEBUG("Entering");
 
-	if (m_row_subset_stack->has_subsets() || m_col_subset_stack->has_subsets())
+	if (m_tiled || m_row_subset_stack->has_subsets() ||
+			m_col_subset_stack->has_subsets())
 	{
-		io::info("Row/col subsets initialized! Falling back to "
+		io::info("Row/col subsets initialized or kernel matrix is tiled! "
+				"Falling back to "
 				"CKernel::row_col_wise_sum_block (slower)!");
 		return CKernel::row_col_wise_sum_block(block_begin_row, block_begin_col,
 				block_size_row, block_size_col, no_diag);
@@ -366,6 +450,10 @@ void CCustomKernel::cleanup_custom()
 	kmatrix=SGMatrix<float32_t>();
 	upper_diagonal=false;
 
+	delete m_tiled;
+	m_tiled=NULL;
+	m_tiled_file.clear();
+
 	SG_DEBUG("Leaving")
 }
 
@@ -404,7 +492,7 @@ void CCustomKernel::row_subset_changed_post()
 	if (m_row_subset_stack->has_subsets())
 		num_lhs=m_row_subset_stack->get_size();
 	else
-		num_lhs=kmatrix.num_rows;
+		num_lhs=m_tiled ? m_tiled->get_num_rows() : kmatrix.num_rows;
 }
 
 void CCustomKernel::add_col_subset(SGVector<index_t> subset)
@@ -436,5 +524,5 @@ void CCustomKernel::col_subset_changed_post()
 	if (m_col_subset_stack->has_subsets())
 		num_rhs=m_col_subset_stack->get_size();
 	else
-		num_rhs=kmatrix.num_cols;
+		num_rhs=m_tiled ? m_tiled->get_num_cols() : kmatrix.num_cols;
 }
@@ -13,8 +13,11 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/lib/common.h>
 #include <shogun/kernel/Kernel.h>
+#include <shogun/kernel/TiledKernelMatrix.h>
 #include <shogun/features/Features.h>
 
+#include <string>
+
 namespace shogun
 {
 /** @brief The Custom Kernel allows for custom user provided kernel matrices.
@@ -27,6 +30,11 @@ namespace shogun
  * The custom kernel supports subsets each on the rows and the columns. See
  * documentation in CFeatures, CLabels how this works. The interface is similar.
  *
+ * Kernel matrices that do not fit into memory can be read from a memory
+ * mapped file in the tiled format of TiledKernelMatrix, see
+ * set_tiled_kernel_matrix_from_file(). The rows of the working set of
+ * SVMLight and LibSVM are then prefetched from disk.
+ *
  *
  */
 class CCustomKernel: public CKernel
@@ -97,6 +105,16 @@ class CCustomKernel: public CKernel
 		/** only cleanup stuff specific to Custom kernel */
 		void cleanup_custom();
 
+		/** clone the kernel, a tiled kernel matrix is mapped again
+		 *
+		 * @param pp properties of the parameters to clone
+		 * @return clone
+		 */
+		virtual CSGObject* clone(ParameterProperties pp = ParameterProperties::ALL) const override;
+
+		/** maps the tiled kernel matrix file again after loading */
+		virtual void load_serializable_post() noexcept(false);
+
 		/** return what type of kernel we are
 		 *
 		 * @return kernel type CUSTOM
@@ -246,6 +264,32 @@ class CCustomKernel: public CKernel
 			return true;
 		}
 
+		/** set kernel matrix from a file in the tiled format written by
+		 * TiledKernelMatrix::save(). The file is memory mapped and values
+		 * are read on demand, hence the matrix may be larger than the
+		 * available memory.
+		 *
+		 * works NOT with subset
+		 *
+		 * @param fname tiled kernel matrix file
+		 * @return if setting was successful
+		 */
+		bool set_tiled_kernel_matrix_from_file(const char* fname);
+
+		/** @return whether the kernel matrix is read from a tiled file */
+		inline bool is_tiled() const
+		{
+			return m_tiled!=NULL;
+		}
+
+		/** advise the tiled kernel matrix to read the given rows in the
+		 * background, does nothing for in-memory kernel matrices
+		 *
+		 * @param rows rows that are needed next, in the order of use
+		 * @param num_rows number of rows
+		 */
+		virtual void prefetch_rows(const int32_t* rows, int32_t num_rows);
+
 		/** set full kernel matrix from full kernel matrix
 		 *
 		 * for float32
@@ -557,6 +601,9 @@ class CCustomKernel: public CKernel
 					"get_kernel_matrix() and the SGMatrix constructor!",
 					get_name(), get_name());
 
+			require(!m_tiled, "{}::get_float32_kernel_matrix(): Not possible "
+					"with a tiled kernel matrix!", get_name());
+
 			return kmatrix;
 		}
 
@@ -572,12 +619,15 @@ class CCustomKernel: public CKernel
 		 */
 		virtual float64_t compute(int32_t row, int32_t col)
 		{
-			require(kmatrix.matrix, "{}::compute({}, {}): No kenrel matrix "
-					"set!", get_name(), row, col);
-
 			index_t real_row=m_row_subset_stack->subset_idx_conversion(row);
 			index_t real_col=m_col_subset_stack->subset_idx_conversion(col);
 
+			if (m_tiled)
+				return m_tiled->get(real_row, real_col);
+
+			require(kmatrix.matrix, "{}::compute({}, {}): No kenrel matrix "
+					"set!", get_name(), row, col);
+
 			if (upper_diagonal)
 			{
 				if (real_row <= real_col)
@@ -595,6 +645,9 @@ class CCustomKernel: public CKernel
 				return kmatrix(real_row, real_col);
 		}
 
+		/** map the file m_tiled_file as tiled kernel matrix */
+		void map_tiled_kernel_matrix();
+
 	protected:
 
 		/** kernel matrix */
@@ -614,6 +667,12 @@ class CCustomKernel: public CKernel
 
 		/** indicates whether kernel matrix is to be freed in destructor */
 		bool m_free_km;
+
+		/** memory mapped kernel matrix, NULL if kmatrix is used */
+		TiledKernelMatrix* m_tiled;
+
+		/** file of the tiled kernel matrix, empty if kmatrix is used */
+		std::string m_tiled_file;
 };
 
 }
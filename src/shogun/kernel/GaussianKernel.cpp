@@ -12,6 +12,8 @@
 #include <shogun/distance/EuclideanDistance.h>
 #include <shogun/mathematics/Math.h>
 
+#include <algorithm>
+
 using namespace shogun;
 
 CGaussianKernel::CGaussianKernel() : CShiftInvariantKernel()
@@ -132,6 +134,28 @@ float64_t CGaussianKernel::distance(int32_t idx_a, int32_t idx_b) const
 	return CShiftInvariantKernel::distance(idx_a, idx_b)/get_width();
 }
 
+bool CGaussianKernel::has_dot_transform() const
+{
+	return typeid(*this)==typeid(CGaussianKernel) && !has_precomputed_distance();
+}
+
+void CGaussianKernel::transform_dot_block(
+	float64_t* block, index_t num_rows, index_t num_cols,
+	const float64_t* sq_norm_lhs, const float64_t* sq_norm_rhs) const
+{
+	const float64_t width=get_width();
+	for (index_t j=0; j<num_cols; j++)
+	{
+		float64_t* col=block+j*num_rows;
+		for (index_t i=0; i<num_rows; i++)
+		{
+			// clamp rounding errors of the expansion
+			float64_t dist=std::max(sq_norm_lhs[i]+sq_norm_rhs[j]-2*col[i], 0.0);
+			col[i]=std::exp(-dist/width);
+		}
+	}
+}
+
 void CGaussianKernel::register_params()
 {
 	set_width(1.0);
@@ -167,6 +167,24 @@ protected:
 	 */
 	virtual float64_t distance(int32_t idx_a, int32_t idx_b) const;
 
+	/** @return whether the kernel matrix can be computed from dot products,
+	 * which is not the case for subclasses or precomputed distances
+	 */
+	virtual bool has_dot_transform() const;
+
+	/** turn dot products into
+	 * \f$\exp(-(||{\bf x}||^2+||{\bf y}||^2-2{\bf x}\cdot{\bf y})/\tau)\f$
+	 *
+	 * @param block column-major num_rows x num_cols block of dot products
+	 * @param num_rows number of rows of the block
+	 * @param num_cols number of columns of the block
+	 * @param sq_norm_lhs squared norms of the lhs examples of the block
+	 * @param sq_norm_rhs squared norms of the rhs examples of the block
+	 */
+	virtual void transform_dot_block(
+		float64_t* block, index_t num_rows, index_t num_cols,
+		const float64_t* sq_norm_lhs, const float64_t* sq_norm_rhs) const;
+
 private:
 	/** register parameters and initialize with defaults */
 	void register_params();
@@ -17,15 +17,21 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/base/Parallel.h>
+#include <shogun/base/ThreadPool.h>
 
 #include <shogun/kernel/Kernel.h>
 #include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
 #include <shogun/features/Features.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/base/Parameter.h>
 
 #include <shogun/classifier/svm/SVM.h>
 
+#include <algorithm>
+#include <atomic>
 #include <string.h>
+#include <typeinfo>
 #ifndef _WIN32
 #include <unistd.h>
 #endif
@@ -170,77 +176,37 @@ void CKernel::kernel_cache_init(int32_t buffsize, bool regression_hack)
 		error("kernel has zero rows: num_lhs={} num_rhs={}",
 				get_num_vec_lhs(), get_num_vec_rhs());
 	}
-	uint64_t buffer_size=0;
-	int32_t i;
 
 	//in regression the additional constraints are made by doubling the training data
 	if (regression_hack)
 		totdoc*=2;
 
-	buffer_size=((uint64_t) buffsize)*1024*1024/sizeof(KERNELCACHE_ELEM);
-	if (buffer_size>((uint64_t) totdoc)*totdoc)
-		buffer_size=((uint64_t) totdoc)*totdoc;
+	kernel_cache.init(totdoc, buffsize, cache_num_shards, cache_shortreal);
 
-	io::info("using a kernel cache of size {} MB ({} bytes) for {} Kernel", buffer_size*sizeof(KERNELCACHE_ELEM)/1024/1024, buffer_size*sizeof(KERNELCACHE_ELEM), get_name());
-
-	//make sure it fits in the *signed* KERNELCACHE_IDX type
-	ASSERT(buffer_size < (((uint64_t) 1) << (sizeof(KERNELCACHE_IDX)*8-1)))
-
-	kernel_cache.index = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.occu = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.lru = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.invindex = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.active2totdoc = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.totdoc2active = SG_MALLOC(int32_t, totdoc);
-	kernel_cache.buffer = SG_MALLOC(KERNELCACHE_ELEM, buffer_size);
-	kernel_cache.buffsize=buffer_size;
-	kernel_cache.max_elems=(int32_t) (kernel_cache.buffsize/totdoc);
-
-	if(kernel_cache.max_elems>totdoc) {
-		kernel_cache.max_elems=totdoc;
-	}
-
-	kernel_cache.elems=0;   // initialize cache
-	for(i=0;i<totdoc;i++) {
-		kernel_cache.index[i]=-1;
-		kernel_cache.lru[i]=0;
-	}
-	for(i=0;i<totdoc;i++) {
-		kernel_cache.occu[i]=0;
-		kernel_cache.invindex[i]=-1;
-	}
-
-	kernel_cache.activenum=totdoc;;
-	for(i=0;i<totdoc;i++) {
-		kernel_cache.active2totdoc[i]=i;
-		kernel_cache.totdoc2active[i]=i;
-	}
-
-	kernel_cache.time=0;
+	io::info("using a kernel cache of {} rows in {} shard(s) ({} precision) for {} Kernel",
+		kernel_cache.get_max_elems(), kernel_cache.get_num_shards(),
+		cache_shortreal ? "single" : "double", get_name());
 }
 
 void CKernel::get_kernel_row(
 	int32_t docnum, int32_t *active2dnum, float64_t *buffer, bool full_line)
 {
 	int32_t i,j;
-	KERNELCACHE_IDX start;
 
 	int32_t num_vectors = get_num_vec_lhs();
 	if (docnum>=num_vectors)
 		docnum=2*num_vectors-1-docnum;
 
 	/* is cached? */
-	if(kernel_cache.index[docnum] != -1)
+	if(kernel_cache.touch(docnum)) /* lru */
 	{
-		kernel_cache.lru[kernel_cache.index[docnum]]=kernel_cache.time; /* lru */
-		start=((KERNELCACHE_IDX) kernel_cache.activenum)*kernel_cache.index[docnum];
-
 		if (full_line)
 		{
 			for(j=0;j<get_num_vec_lhs();j++)
 			{
-				if(kernel_cache.totdoc2active[j] >= 0)
-					buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
+				int32_t l=kernel_cache.totdoc2active(j);
+				if(l >= 0)
+					buffer[j]=kernel_cache.get(docnum, l);
 				else
 					buffer[j]=(float64_t) kernel(docnum, j);
 			}
@@ -249,8 +215,9 @@ void CKernel::get_kernel_row(
 		{
 			for(i=0;(j=active2dnum[i])>=0;i++)
 			{
-				if(kernel_cache.totdoc2active[j] >= 0)
-					buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
+				int32_t l=kernel_cache.totdoc2active(j);
+				if(l >= 0)
+					buffer[j]=kernel_cache.get(docnum, l);
 				else
 				{
 					int32_t k=j;
@@ -281,13 +248,30 @@ void CKernel::get_kernel_row(
 	}
 }
 
+// Fills the cache line of row m, re-using the transposed entries of
+// already cached rows which do not need to be computed themselves
+void CKernel::kernel_cache_fill_row(int32_t m, const uint8_t* needs_computation)
+{
+	int32_t num_vectors = get_num_vec_lhs();
+	int32_t l=kernel_cache.totdoc2active(m);
+
+	kernel_cache.fill(m, [&](int32_t j) {
+		int32_t k=kernel_cache.active2totdoc(j);
+
+		if (kernel_cache.check(k) && (l != -1) && (k != m) &&
+			!(needs_computation && needs_computation[k]))
+			return kernel_cache.get(k, l);
+
+		if (k>=num_vectors)
+			k=2*num_vectors-1-k;
+
+		return kernel(m, k);
+	});
+}
 
 // Fills cache for the row m
 void CKernel::cache_kernel_row(int32_t m)
 {
-	int32_t j,k,l;
-	KERNELCACHE_ELEM *cache;
-
 	int32_t num_vectors = get_num_vec_lhs();
 
 	if (m>=num_vectors)
@@ -295,160 +279,88 @@ void CKernel::cache_kernel_row(int32_t m)
 
 	if(!kernel_cache_check(m))   // not cached yet
 	{
-		cache = kernel_cache_clean_and_malloc(m);
-		if(cache) {
-			l=kernel_cache.totdoc2active[m];
-
-			for(j=0;j<kernel_cache.activenum;j++)  // fill cache
-			{
-				k=kernel_cache.active2totdoc[j];
-
-				if((kernel_cache.index[k] != -1) && (l != -1) && (k != m)) {
-					cache[j]=kernel_cache.buffer[((KERNELCACHE_IDX) kernel_cache.activenum)
-						*kernel_cache.index[k]+l];
-				}
-				else
-				{
-					if (k>=num_vectors)
-						k=2*num_vectors-1-k;
-
-					cache[j]=kernel(m, k);
-				}
-			}
-		}
+		if (kernel_cache.allocate(m))
+			kernel_cache_fill_row(m, NULL);
 		else
 			perror("Error: Kernel cache full! => increase cache size");
 	}
 }
 
-
-void* CKernel::cache_multiple_kernel_row_helper(void* p)
-{
-	int32_t j,k,l;
-	S_KTHREAD_PARAM* params = (S_KTHREAD_PARAM*) p;
-
-	for (int32_t i=params->start; i<params->end; i++)
-	{
-		KERNELCACHE_ELEM* cache=params->cache[i];
-		int32_t m = params->uncached_rows[i];
-		l=params->kernel_cache->totdoc2active[m];
-
-		for(j=0;j<params->kernel_cache->activenum;j++)  // fill cache
-		{
-			k=params->kernel_cache->active2totdoc[j];
-
-			if((params->kernel_cache->index[k] != -1) && (l != -1) && (!params->needs_computation[k])) {
-				cache[j]=params->kernel_cache->buffer[((KERNELCACHE_IDX) params->kernel_cache->activenum)
-					*params->kernel_cache->index[k]+l];
-			}
-			else
-				{
-					if (k>=params->num_vectors)
-						k=2*params->num_vectors-1-k;
-
-					cache[j]=params->kernel->kernel(m, k);
-				}
-		}
-
-		//now line m is cached
-		params->needs_computation[m]=0;
-	}
-	return NULL;
-}
-
 // Fills cache for the rows in key
 void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 {
+	// rows are prefetched this many rows ahead of the one that is computed
+	const int32_t prefetch_distance=4;
 	int32_t nthreads=env()->get_num_threads();
 
 	if (nthreads<2)
 	{
+		prefetch_rows(rows, CMath::min(prefetch_distance, num_rows));
 		for(int32_t i=0;i<num_rows;i++)
+		{
+			if (i+prefetch_distance<num_rows)
+				prefetch_rows(&rows[i+prefetch_distance], 1);
 			cache_kernel_row(rows[i]);
+		}
+		return;
 	}
-	else
-	{
-		// fill up kernel cache
-		int32_t* uncached_rows = SG_MALLOC(int32_t, num_rows);
-		KERNELCACHE_ELEM** cache = SG_MALLOC(KERNELCACHE_ELEM*, num_rows);
-		S_KTHREAD_PARAM params;
-		int32_t num_threads=nthreads-1;
-		int32_t num_vec=get_num_vec_lhs();
-		ASSERT(num_vec>0)
-		uint8_t* needs_computation=SG_CALLOC(uint8_t, num_vec);
-
-		int32_t step=0;
-		int32_t num=0;
-		int32_t end=0;
-
-		// allocate cachelines if necessary
-		for (int32_t i=0; i<num_rows; i++)
-		{
-			int32_t idx=rows[i];
-			if (idx>=num_vec)
-				idx=2*num_vec-1-idx;
-
-			if (kernel_cache_check(idx))
-				continue;
 
-			needs_computation[idx]=1;
-			uncached_rows[num]=idx;
-			cache[num]= kernel_cache_clean_and_malloc(idx);
+	int32_t num_vec=get_num_vec_lhs();
+	ASSERT(num_vec>0)
+	int32_t num_shards=kernel_cache.get_num_shards();
+	uint8_t* needs_computation=SG_CALLOC(uint8_t, num_vec);
+	SGVector<int32_t> uncached_rows(num_rows);
+	int32_t num=0;
 
-			if (!cache[num])
-				error("Kernel cache full! => increase cache size");
+	// collect the rows that are not cached yet
+	for (int32_t i=0; i<num_rows; i++)
+	{
+		int32_t idx=rows[i];
+		if (idx>=num_vec)
+			idx=2*num_vec-1-idx;
 
-			num++;
-		}
+		if (kernel_cache_check(idx) || needs_computation[idx])
+			continue;
 
-		if (num>0)
-		{
-			step = num/nthreads;
+		needs_computation[idx]=1;
+		uncached_rows[num++]=idx;
+	}
 
-			if (step<1)
-			{
-				num_threads=num-1;
-				step=1;
-			}
+	auto pool=env()->get_thread_pool();
 
-			#pragma omp parallel for private(params)
-			for (int32_t t=0; t<num_threads; t++)
-			{
-				params.kernel = this;
-				params.kernel_cache = &kernel_cache;
-				params.cache = cache;
-				params.uncached_rows = uncached_rows;
-				params.needs_computation = needs_computation;
-				params.num_uncached = num;
-				params.start = t*step;
-				params.end = (t+1)*step;
-				params.num_vectors = get_num_vec_lhs();
-				end=params.end;
-
-				cache_multiple_kernel_row_helper(&params);
-			}
+	// allocate cache lines, every shard is only touched by one thread
+	std::atomic<bool> cache_full(false);
+	pool->parallel_for(0, num_shards, 1, [&](index_t begin, index_t end) {
+		for (int32_t i=0; i<num; i++)
+		{
+			int32_t s=kernel_cache.get_shard(uncached_rows[i]);
+			if (s>=begin && s<end && !kernel_cache.allocate(uncached_rows[i]))
+				cache_full=true;
 		}
-		else
-			num_threads=-1;
-
-
-		S_KTHREAD_PARAM last_param;
-		last_param.kernel = this;
-		last_param.kernel_cache = &kernel_cache;
-		last_param.cache = cache;
-		last_param.uncached_rows = uncached_rows;
-		last_param.needs_computation = needs_computation;
-		last_param.start = end;
-		last_param.num_uncached = num;
-		last_param.end = num;
-		last_param.num_vectors = get_num_vec_lhs();
-
-		cache_multiple_kernel_row_helper(&last_param);
+	});
 
+	if (cache_full)
+	{
 		SG_FREE(needs_computation);
-		SG_FREE(cache);
-		SG_FREE(uncached_rows);
+		error("Kernel cache full! => increase cache size");
 	}
+
+	// fill the cache lines, no cache line is (de)allocated in here.
+	// A row may have been evicted again by a later row of its shard.
+	pool->parallel_for(0, num, 1, [&](index_t begin, index_t end) {
+		prefetch_rows(
+			&uncached_rows[begin],
+			CMath::min(prefetch_distance, (int32_t) (end-begin)));
+		for (index_t i=begin; i<end; i++)
+		{
+			if (i+prefetch_distance<end)
+				prefetch_rows(&uncached_rows[i+prefetch_distance], 1);
+			if (kernel_cache_check(uncached_rows[i]))
+				kernel_cache_fill_row(uncached_rows[i], needs_computation);
+		}
+	});
+
+	SG_FREE(needs_computation);
 }
 
 // remove numshrink columns in the cache
@@ -456,151 +368,17 @@ void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 void CKernel::kernel_cache_shrink(
 	int32_t totdoc, int32_t numshrink, int32_t *after)
 {
-	ASSERT(totdoc > 0);
-	int32_t i,j,jj,scount;     // 0 in after.
-	KERNELCACHE_IDX from=0,to=0;
-	int32_t *keep;
-
-	keep=SG_MALLOC(int32_t, totdoc);
-	for(j=0;j<totdoc;j++) {
-		keep[j]=1;
-	}
-	scount=0;
-	for(jj=0;(jj<kernel_cache.activenum) && (scount<numshrink);jj++) {
-		j=kernel_cache.active2totdoc[jj];
-		if(!after[j]) {
-			scount++;
-			keep[j]=0;
-		}
-	}
-
-	for(i=0;i<kernel_cache.max_elems;i++) {
-		for(jj=0;jj<kernel_cache.activenum;jj++) {
-			j=kernel_cache.active2totdoc[jj];
-			if(!keep[j]) {
-				from++;
-			}
-			else {
-				kernel_cache.buffer[to]=kernel_cache.buffer[from];
-				to++;
-				from++;
-			}
-		}
-	}
-
-	kernel_cache.activenum=0;
-	for(j=0;j<totdoc;j++) {
-		if((keep[j]) && (kernel_cache.totdoc2active[j] != -1)) {
-			kernel_cache.active2totdoc[kernel_cache.activenum]=j;
-			kernel_cache.totdoc2active[j]=kernel_cache.activenum;
-			kernel_cache.activenum++;
-		}
-		else {
-			kernel_cache.totdoc2active[j]=-1;
-		}
-	}
-
-	kernel_cache.max_elems= (int32_t) kernel_cache.buffsize;
-
-	if (kernel_cache.activenum>0)
-		kernel_cache.buffsize/=kernel_cache.activenum;
-
-	if(kernel_cache.max_elems>totdoc)
-		kernel_cache.max_elems=totdoc;
-
-	SG_FREE(keep);
-
+	kernel_cache.shrink(totdoc, numshrink, after);
 }
 
 void CKernel::kernel_cache_reset_lru()
 {
-	int32_t maxlru=0,k;
-
-	for(k=0;k<kernel_cache.max_elems;k++) {
-		if(maxlru < kernel_cache.lru[k])
-			maxlru=kernel_cache.lru[k];
-	}
-	for(k=0;k<kernel_cache.max_elems;k++) {
-		kernel_cache.lru[k]-=maxlru;
-	}
+	kernel_cache.reset_lru();
 }
 
 void CKernel::kernel_cache_cleanup()
 {
-	SG_FREE(kernel_cache.index);
-	SG_FREE(kernel_cache.occu);
-	SG_FREE(kernel_cache.lru);
-	SG_FREE(kernel_cache.invindex);
-	SG_FREE(kernel_cache.active2totdoc);
-	SG_FREE(kernel_cache.totdoc2active);
-	SG_FREE(kernel_cache.buffer);
-	memset(&kernel_cache, 0x0, sizeof(KERNEL_CACHE));
-}
-
-int32_t CKernel::kernel_cache_malloc()
-{
-  int32_t i;
-
-  if(kernel_cache_space_available()) {
-    for(i=0;i<kernel_cache.max_elems;i++) {
-      if(!kernel_cache.occu[i]) {
-	kernel_cache.occu[i]=1;
-	kernel_cache.elems++;
-	return(i);
-      }
-    }
-  }
-  return(-1);
-}
-
-void CKernel::kernel_cache_free(int32_t cacheidx)
-{
-	kernel_cache.occu[cacheidx]=0;
-	kernel_cache.elems--;
-}
-
-// remove least recently used cache
-// element
-int32_t CKernel::kernel_cache_free_lru()
-{
-  int32_t k,least_elem=-1,least_time;
-
-  least_time=kernel_cache.time+1;
-  for(k=0;k<kernel_cache.max_elems;k++) {
-    if(kernel_cache.invindex[k] != -1) {
-      if(kernel_cache.lru[k]<least_time) {
-	least_time=kernel_cache.lru[k];
-	least_elem=k;
-      }
-    }
-  }
-
-  if(least_elem != -1) {
-    kernel_cache_free(least_elem);
-    kernel_cache.index[kernel_cache.invindex[least_elem]]=-1;
-    kernel_cache.invindex[least_elem]=-1;
-    return(1);
-  }
-  return(0);
-}
-
-// Get a free cache entry. In case cache is full, the lru
-// element is removed.
-KERNELCACHE_ELEM* CKernel::kernel_cache_clean_and_malloc(int32_t cacheidx)
-{
-	int32_t result;
-	if((result = kernel_cache_malloc()) == -1) {
-		if(kernel_cache_free_lru()) {
-			result = kernel_cache_malloc();
-		}
-	}
-	kernel_cache.index[cacheidx]=result;
-	if(result == -1) {
-		return(0);
-	}
-	kernel_cache.invindex[result]=cacheidx;
-	kernel_cache.lru[kernel_cache.index[cacheidx]]=kernel_cache.time; // lru
-	return &kernel_cache.buffer[((KERNELCACHE_IDX) kernel_cache.activenum)*kernel_cache.index[cacheidx]];
+	kernel_cache.cleanup();
 }
 #endif //USE_SVMLIGHT
 
@@ -911,6 +689,10 @@ void CKernel::save_serializable_post() noexcept(false)
 void CKernel::register_params()
 {
 	SG_ADD(&cache_size, "cache_size", "Cache size in MB.");
+	SG_ADD(&cache_num_shards, "cache_num_shards",
+		"Number of shards of the kernel cache (0: one per thread).");
+	SG_ADD(&cache_shortreal, "cache_shortreal",
+		"Whether the kernel cache stores rows in single precision.");
 	SG_ADD(
 		&lhs, "lhs", "Feature vectors to occur on left hand side.",
 		ParameterProperties::READONLY);
@@ -937,12 +719,23 @@ void CKernel::register_params()
 	    (machine_int_t*)&opt_type, "opt_type", "Optimization type.",
 	    ParameterProperties::NONE,
 	    SG_OPTIONS(FASTBUTMEMHUNGRY, SLOWBUTMEMEFFICIENT));
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&precision, "precision",
+	    "Precision of kernel matrices.", ParameterProperties::NONE,
+	    SG_OPTIONS(KPREC_DOUBLE, KPREC_MIXED, KPREC_SINGLE));
 }
 
 
 void CKernel::init()
 {
 	cache_size=10;
+	cache_num_shards=0;
+#ifdef USE_SHORTREAL_KERNELCACHE
+	cache_shortreal=true;
+#else
+	cache_shortreal=false;
+#endif
+	precision=KPREC_DOUBLE;
 	kernel_matrix=NULL;
 	lhs=NULL;
 	rhs=NULL;
@@ -955,10 +748,6 @@ void CKernel::init()
 	properties=KP_NONE;
 	normalizer=NULL;
 
-#ifdef USE_SVMLIGHT
-	memset(&kernel_cache, 0x0, sizeof(KERNEL_CACHE));
-#endif //USE_SVMLIGHT
-
 	set_normalizer(new CIdentityKernelNormalizer());
 }
 
@@ -1320,6 +1109,9 @@ SGMatrix<T> CKernel::get_kernel_matrix()
 
 	SG_DEBUG("returning kernel matrix of size {}x{}", m, n)
 
+	if (has_dense_dot_transform())
+		return get_kernel_matrix_blocked<T>();
+
 	result=SG_MALLOC(T, total_num);
 
 	int32_t num_threads=env()->get_num_threads();
@@ -1364,8 +1156,272 @@ SGMatrix<T> CKernel::get_kernel_matrix()
 }
 
 
+namespace
+{
+/** round a matrix to float32_t, split into chunks of at most chunk_size
+ * rows, every chunk is stored contiguously
+ */
+std::vector<SGMatrix<float32_t>> round_float32(
+	const SGMatrix<float64_t>& mat, index_t chunk_size)
+{
+	std::vector<SGMatrix<float32_t>> chunks;
+	for (index_t begin=0; begin<mat.num_rows; begin+=chunk_size)
+	{
+		index_t num_rows=std::min(chunk_size, mat.num_rows-begin);
+		SGMatrix<float32_t> chunk(num_rows, mat.num_cols);
+		for (index_t j=0; j<mat.num_cols; j++)
+		{
+			for (index_t i=0; i<num_rows; i++)
+				chunk(i, j)=(float32_t) mat(begin+i, j);
+		}
+		chunks.push_back(chunk);
+	}
+	return chunks;
+}
+
+/** squared norms of the columns of the rounded matrix, products of
+ * float32_t values are exact in float64_t
+ */
+SGVector<float64_t> squared_norms_float32(
+	const std::vector<SGMatrix<float32_t>>& chunks, index_t num_cols)
+{
+	SGVector<float64_t> sq_norms(num_cols);
+	sq_norms.zero();
+	for (const auto& chunk : chunks)
+	{
+		for (index_t j=0; j<num_cols; j++)
+		{
+			for (index_t i=0; i<chunk.num_rows; i++)
+				sq_norms[j]+=(float64_t) chunk(i, j)*chunk(i, j);
+		}
+	}
+	return sq_norms;
+}
+
+/** squared norms of the columns of a matrix */
+SGVector<float64_t> squared_norms(const SGMatrix<float64_t>& mat)
+{
+	SGVector<float64_t> sq_norms(mat.num_cols);
+	for (index_t i=0; i<mat.num_cols; i++)
+	{
+		SGVector<float64_t> vec(mat.get_column_vector(i), mat.num_rows, false);
+		sq_norms[i]=linalg::dot(vec, vec);
+	}
+	return sq_norms;
+}
+}
+
+bool CKernel::has_dense_dot_transform() const
+{
+	return has_dot_transform() && lhs && rhs &&
+		lhs->get_feature_class()==C_DENSE && lhs->get_feature_type()==F_DREAL &&
+		rhs->get_feature_class()==C_DENSE && rhs->get_feature_type()==F_DREAL;
+}
+
+template <class T>
+SGMatrix<T> CKernel::get_kernel_matrix_blocked()
+{
+	// tiles of block_size x block_size kernel values stay in cache while
+	// being transformed, normalized and written
+	const index_t block_size=128;
+
+	int32_t m=get_num_vec_lhs();
+	int32_t n=get_num_vec_rhs();
+	bool symmetric=(lhs==rhs && m==n);
+	bool single=(precision==KPREC_SINGLE);
+
+	SGMatrix<float64_t> lhs_mat=((CDenseFeatures<float64_t>*) lhs)->get_feature_matrix();
+	SGMatrix<float64_t> rhs_mat=symmetric ? lhs_mat :
+		((CDenseFeatures<float64_t>*) rhs)->get_feature_matrix();
+	require(lhs_mat.num_rows==rhs_mat.num_rows,
+		"Dimension of lhs ({}) and rhs ({}) features must match",
+		lhs_mat.num_rows, rhs_mat.num_rows);
+	index_t dim=lhs_mat.num_rows;
+
+	// in single precision, the features are rounded to float32_t once and
+	// the dot products of every chunk of dim_block features are float32_t
+	// GEMMs, whose results are accumulated in float64_t. With the unit
+	// roundoff u=2^-24 of float32_t, the error of a dot product is at most
+	// about (min(dim, dim_block)+2)*u*sum_i |a_i*b_i|.
+	const index_t dim_block=128;
+	std::vector<SGMatrix<float32_t>> lhs_single, rhs_single;
+	SGVector<float64_t> sq_norm_lhs, sq_norm_rhs;
+	if (single)
+	{
+		lhs_single=round_float32(lhs_mat, dim_block);
+		rhs_single=symmetric ? lhs_single : round_float32(rhs_mat, dim_block);
+
+		// the norms of the rounded features keep distances consistent
+		sq_norm_lhs=squared_norms_float32(lhs_single, m);
+		sq_norm_rhs=symmetric ? sq_norm_lhs : squared_norms_float32(rhs_single, n);
+	}
+	else
+	{
+		sq_norm_lhs=squared_norms(lhs_mat);
+		sq_norm_rhs=symmetric ? sq_norm_lhs : squared_norms(rhs_mat);
+	}
+
+	bool normalize=typeid(*normalizer)!=typeid(CIdentityKernelNormalizer);
+
+	index_t num_row_blocks=(m+block_size-1)/block_size;
+	index_t num_col_blocks=(n+block_size-1)/block_size;
+
+	// tiles to compute, only the upper triangle if symmetric
+	std::vector<std::pair<index_t, index_t>> tiles;
+	for (index_t bj=0; bj<num_col_blocks; bj++)
+	{
+		for (index_t bi=0; bi<(symmetric ? bj+1 : num_row_blocks); bi++)
+			tiles.emplace_back(bi, bj);
+	}
+
+	SGMatrix<T> result(m, n);
+	auto pb=SG_PROGRESS(range((index_t) tiles.size()));
+	env()->get_thread_pool()->parallel_for(0, tiles.size(), 1,
+		[&](index_t begin, index_t end)
+	{
+		SGMatrix<float64_t> buffer(block_size, block_size);
+		SGMatrix<float32_t> buffer_single;
+		if (single)
+			buffer_single=SGMatrix<float32_t>(block_size, block_size);
+
+		for (index_t t=begin; t<end; t++)
+		{
+			index_t row_begin=tiles[t].first*block_size;
+			index_t col_begin=tiles[t].second*block_size;
+			index_t num_rows=std::min(block_size, (index_t) m-row_begin);
+			index_t num_cols=std::min(block_size, (index_t) n-col_begin);
+			SGMatrix<float64_t> tile(buffer.matrix, num_rows, num_cols, false);
+
+			if (single)
+			{
+				SGMatrix<float32_t> partial(buffer_single.matrix, num_rows, num_cols, false);
+				tile.zero();
+				for (size_t c=0; c<lhs_single.size(); c++)
+				{
+					index_t num_dims=lhs_single[c].num_rows;
+					SGMatrix<float32_t> a(lhs_single[c].get_column_vector(row_begin), num_dims, num_rows, false);
+					SGMatrix<float32_t> b(rhs_single[c].get_column_vector(col_begin), num_dims, num_cols, false);
+					linalg::matrix_prod(a, b, partial, true, false);
+
+					for (int64_t i=0; i<int64_t(num_rows)*num_cols; i++)
+						tile.matrix[i]+=partial.matrix[i];
+				}
+			}
+			else
+			{
+				SGMatrix<float64_t> a(lhs_mat.get_column_vector(row_begin), dim, num_rows, false);
+				SGMatrix<float64_t> b(rhs_mat.get_column_vector(col_begin), dim, num_cols, false);
+				linalg::matrix_prod(a, b, tile, true, false);
+			}
+
+			transform_dot_block(tile.matrix, num_rows, num_cols,
+				sq_norm_lhs.vector+row_begin, sq_norm_rhs.vector+col_begin);
+
+			for (index_t j=0; j<num_cols; j++)
+			{
+				for (index_t i=0; i<num_rows; i++)
+				{
+					float64_t v=tile(i, j);
+					if (normalize)
+						v=normalizer->normalize(v, row_begin+i, col_begin+j);
+
+					result(row_begin+i, col_begin+j)=v;
+					if (symmetric)
+						result(col_begin+j, row_begin+i)=v;
+				}
+			}
+			pb.print_progress();
+		}
+	});
+	pb.complete();
+
+	return result;
+}
+
+SGVector<float64_t> CKernel::compute_weighted_sums_dense(
+	SGMatrix<float64_t> packed_lhs, SGVector<int32_t> idx,
+	SGVector<float64_t> weights)
+{
+	require(has_dense_dot_transform(), "{}::compute_weighted_sums_dense(): "
+		"Kernel is not computed from dot products of dense real valued "
+		"features", get_name());
+	require(packed_lhs.num_cols==weights.vlen && idx.vlen==weights.vlen,
+		"Number of packed examples ({}), indices ({}) and weights ({}) must "
+		"match", packed_lhs.num_cols, idx.vlen, weights.vlen);
+
+	// a block_size x block_size tile of kernel values stays in cache while
+	// being transformed and reduced
+	const index_t block_size=128;
+
+	int32_t m=packed_lhs.num_cols;
+	int32_t n=get_num_vec_rhs();
+
+	SGMatrix<float64_t> rhs_mat=((CDenseFeatures<float64_t>*) rhs)->get_feature_matrix();
+	require(packed_lhs.num_rows==rhs_mat.num_rows,
+		"Dimension of packed lhs ({}) and rhs ({}) features must match",
+		packed_lhs.num_rows, rhs_mat.num_rows);
+	index_t dim=rhs_mat.num_rows;
+
+	SGVector<float64_t> sq_norm_lhs=squared_norms(packed_lhs);
+	bool normalize=typeid(*normalizer)!=typeid(CIdentityKernelNormalizer);
+
+	SGVector<float64_t> result(n);
+	index_t num_col_blocks=(n+block_size-1)/block_size;
+	auto pb=SG_PROGRESS(range(num_col_blocks));
+	env()->get_thread_pool()->parallel_for(0, num_col_blocks, 1,
+		[&](index_t begin, index_t end)
+	{
+		SGMatrix<float64_t> buffer(block_size, block_size);
+
+		for (index_t bj=begin; bj<end; bj++)
+		{
+			index_t col_begin=bj*block_size;
+			index_t num_cols=std::min(block_size, (index_t) n-col_begin);
+			SGMatrix<float64_t> b(rhs_mat.get_column_vector(col_begin), dim, num_cols, false);
+			SGVector<float64_t> sq_norm_rhs=squared_norms(b);
+
+			float64_t* out=result.vector+col_begin;
+			std::fill(out, out+num_cols, 0.0);
+
+			for (index_t row_begin=0; row_begin<m; row_begin+=block_size)
+			{
+				index_t num_rows=std::min(block_size, (index_t) m-row_begin);
+				SGMatrix<float64_t> a(packed_lhs.get_column_vector(row_begin), dim, num_rows, false);
+				SGMatrix<float64_t> tile(buffer.matrix, num_rows, num_cols, false);
+
+				linalg::matrix_prod(a, b, tile, true, false);
+				transform_dot_block(tile.matrix, num_rows, num_cols,
+					sq_norm_lhs.vector+row_begin, sq_norm_rhs.vector);
+
+				const float64_t* w=weights.vector+row_begin;
+				for (index_t j=0; j<num_cols; j++)
+				{
+					float64_t* k=tile.get_column_vector(j);
+					if (normalize)
+					{
+						for (index_t i=0; i<num_rows; i++)
+							k[i]=normalizer->normalize(k[i], idx[row_begin+i], col_begin+j);
+					}
+
+					float64_t sum=0;
+					for (index_t i=0; i<num_rows; i++)
+						sum+=w[i]*k[i];
+					out[j]+=sum;
+				}
+			}
+			pb.print_progress();
+		}
+	});
+	pb.complete();
+
+	return result;
+}
+
 template SGMatrix<float64_t> CKernel::get_kernel_matrix<float64_t>();
 template SGMatrix<float32_t> CKernel::get_kernel_matrix<float32_t>();
 
+template SGMatrix<float64_t> CKernel::get_kernel_matrix_blocked<float64_t>();
+template SGMatrix<float32_t> CKernel::get_kernel_matrix_blocked<float32_t>();
+
 template void* CKernel::get_kernel_matrix_helper<float64_t>(void* p);
 template void* CKernel::get_kernel_matrix_helper<float32_t>(void* p);
@@ -22,6 +22,7 @@
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/Features.h>
 #include <shogun/kernel/normalizer/KernelNormalizer.h>
+#include <shogun/kernel/KernelRowCache.h>
 
 namespace shogun
 {
@@ -48,6 +49,18 @@ enum EOptimizationType
 	SLOWBUTMEMEFFICIENT
 };
 
+/** precision of kernel matrices */
+enum EKernelPrecision
+{
+	/// compute and store in float64_t
+	KPREC_DOUBLE,
+	/// compute in float64_t, store in float32_t
+	KPREC_MIXED,
+	/// compute dot products of features rounded to float32_t in float32_t,
+	/// accumulate blocks of 128 features in float64_t, store in float32_t
+	KPREC_SINGLE
+};
+
 /** kernel type */
 enum EKernelType
 {
@@ -444,6 +457,35 @@ class CKernel : public CSGObject
 		 */
 		template <class T> SGMatrix<T> get_kernel_matrix();
 
+		/** whether compute_weighted_sums_dense() can be used, i.e. the
+		 * kernel is computed from dot products of dense real valued lhs and
+		 * rhs features
+		 *
+		 * @return if weighted sums can be computed tile by tile
+		 */
+		bool has_dense_dot_transform() const;
+
+		/** compute the weighted sums of kernel values
+		 * \f[
+		 *	f(x_j) = \sum_{i} w_i k(x_{\mathrm{idx}_i}, x_j)
+		 * \f]
+		 * for all rhs examples \f$x_j\f$, e.g. the outputs of a kernel
+		 * machine. Tiles of dot products between the given lhs examples and
+		 * the rhs examples are computed via GEMM, turned into kernel values
+		 * and reduced with the weights while they are in cache. Tiles of rhs
+		 * examples are processed in parallel.
+		 *
+		 * Requires has_dense_dot_transform().
+		 *
+		 * @param packed_lhs lhs examples idx, packed as columns of a matrix
+		 * @param idx lhs indices of the packed examples, used by normalizers
+		 * @param weights weight of each packed example, e.g. alpha_i*y_i
+		 * @return the weighted sums for all rhs examples
+		 */
+		SGVector<float64_t> compute_weighted_sums_dense(
+			SGMatrix<float64_t> packed_lhs, SGVector<int32_t> idx,
+			SGVector<float64_t> weights);
+
 		/** initialize kernel
 		 *  e.g. setup lhs/rhs of kernel, precompute normalization
 		 *  constants etc.
@@ -593,6 +635,67 @@ class CKernel : public CSGObject
 		 */
 		inline int32_t get_cache_size() { return cache_size; }
 
+		/** set the number of shards the kernel cache is split into
+		 *
+		 * @param num_shards number of shards, 0 means one per thread
+		 */
+		inline void set_cache_num_shards(int32_t num_shards)
+		{
+			cache_num_shards = num_shards;
+#ifdef USE_SVMLIGHT
+			cache_reset();
+#endif //USE_SVMLIGHT
+		}
+
+		/** return the number of shards of the kernel cache
+		 *
+		 * @return number of shards, 0 means one per thread
+		 */
+		inline int32_t get_cache_num_shards() { return cache_num_shards; }
+
+		/** set whether the kernel cache stores rows in single precision
+		 *
+		 * @param shortreal store rows as float32_t instead of float64_t
+		 */
+		inline void set_cache_shortreal(bool shortreal)
+		{
+			cache_shortreal = shortreal;
+#ifdef USE_SVMLIGHT
+			cache_reset();
+#endif //USE_SVMLIGHT
+		}
+
+		/** return whether the kernel cache stores rows in single precision
+		 *
+		 * @return whether rows are stored as float32_t
+		 */
+		inline bool get_cache_shortreal() { return cache_shortreal; }
+
+		/** set the precision of kernel matrices that are computed for
+		 * algorithms working on the whole matrix, e.g. KernelRidgeRegression
+		 * or KernelPCA. With KPREC_MIXED and KPREC_SINGLE those store the
+		 * matrix in float32_t, which halves the memory. With KPREC_SINGLE,
+		 * kernels of dot products of dense features also compute the
+		 * products from float32_t copies of the features.
+		 *
+		 * @param p precision
+		 */
+		inline void set_precision(EKernelPrecision p) { precision = p; }
+
+		/** @return precision of kernel matrices */
+		inline EKernelPrecision get_precision() const { return precision; }
+
+		/** hint that the kernel rows of the given examples are needed soon,
+		 * e.g. those of the working set of an SVM solver. Kernels that read
+		 * their values from slow storage may start loading them in the
+		 * background. Indices beyond the number of lhs vectors are mapped
+		 * back as in cache_multiple_kernel_rows, for regression.
+		 *
+		 * @param rows rows that are needed next, in the order of use
+		 * @param num_rows number of rows
+		 */
+		virtual void prefetch_rows(const int32_t* rows, int32_t num_rows) { }
+
 #ifdef USE_SVMLIGHT
 		/** cache reset */
 		inline void cache_reset() { resize_kernel_cache(cache_size); }
@@ -601,13 +704,13 @@ class CKernel : public CSGObject
 		 *
 		 * @return maximum elements in cache
 		 */
-		inline int32_t get_max_elems_cache() { return kernel_cache.max_elems; }
+		inline int32_t get_max_elems_cache() { return kernel_cache.get_max_elems(); }
 
 		/** get activenum cache
 		 *
 		 * @return activecnum cache
 		 */
-		inline int32_t get_activenum_cache() { return kernel_cache.activenum; }
+		inline int32_t get_activenum_cache() { return kernel_cache.get_activenum(); }
 
 		/** get kernel row
 		 *
@@ -627,6 +730,9 @@ class CKernel : public CSGObject
 		void cache_kernel_row(int32_t x);
 
 		/** cache multiple kernel rows
+		 *
+		 * Cache lines are allocated shard by shard, each shard by a single
+		 * thread, and the rows are computed in parallel afterwards.
 		 *
 		 * @param key key
 		 * @param varnum
@@ -659,7 +765,7 @@ class CKernel : public CSGObject
 		 */
 		inline void set_time(int32_t t)
 		{
-			kernel_cache.time=t;
+			kernel_cache.set_time(t);
 		}
 
 		/** update lru time of item at given index to avoid removal from cache
@@ -669,12 +775,7 @@ class CKernel : public CSGObject
 		 */
 		inline int32_t kernel_cache_touch(int32_t cacheidx)
 		{
-			if(kernel_cache.index[cacheidx] != -1)
-			{
-				kernel_cache.lru[kernel_cache.index[cacheidx]]=kernel_cache.time;
-				return(1);
-			}
-			return(0);
+			return kernel_cache.touch(cacheidx);
 		}
 
 		/** check if row at given index is cached
@@ -684,7 +785,7 @@ class CKernel : public CSGObject
 		 */
 		inline int32_t kernel_cache_check(int32_t cacheidx)
 		{
-			return(kernel_cache.index[cacheidx] >= 0);
+			return kernel_cache.check(cacheidx);
 		}
 
 		/** check if there is room for one more row in kernel cache
@@ -693,7 +794,7 @@ class CKernel : public CSGObject
 		 */
 		inline int32_t kernel_cache_space_available()
 		{
-			return(kernel_cache.elems < kernel_cache.max_elems);
+			return kernel_cache.space_available();
 		}
 
 		/** initialize kernel cache
@@ -935,6 +1036,39 @@ class CKernel : public CSGObject
 		 */
 		template <class T> static void* get_kernel_matrix_helper(void* p);
 
+		/** whether the kernel can be computed from dot products and squared
+		 * norms of dense real valued features, see transform_dot_block()
+		 *
+		 * @return false by default
+		 */
+		virtual bool has_dot_transform() const
+		{
+			return false;
+		}
+
+		/** turn a block of dot products between dense real valued examples
+		 * into (unnormalized) kernel values in place
+		 *
+		 * @param block column-major num_rows x num_cols block of dot products
+		 * @param num_rows number of rows of the block
+		 * @param num_cols number of columns of the block
+		 * @param sq_norm_lhs squared norms of the lhs examples of the block
+		 * @param sq_norm_rhs squared norms of the rhs examples of the block
+		 */
+		virtual void transform_dot_block(
+			float64_t* block, index_t num_rows, index_t num_cols,
+			const float64_t* sq_norm_lhs, const float64_t* sq_norm_rhs) const
+		{
+		}
+
+		/** compute the kernel matrix tile by tile as dot products of dense
+		 * real valued features followed by transform_dot_block(), exploiting
+		 * symmetry if lhs==rhs
+		 *
+		 * @return the kernel matrix
+		 */
+		template <class T> SGMatrix<T> get_kernel_matrix_blocked();
+
 		/** Can (optionally) be overridden to post-initialize some member
 		 *  variables which are not PARAMETER::ADD'ed.  Make sure that at
 		 *  first the overridden method BASE_CLASS::LOAD_SERIALIZABLE_POST
@@ -978,68 +1112,9 @@ class CKernel : public CSGObject
 
 
 #ifdef USE_SVMLIGHT
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-		/**@ cache kernel evalutations to improve speed */
-		struct KERNEL_CACHE {
-			/** index */
-			int32_t   *index;
-			/** inverse index */
-			int32_t   *invindex;
-			/** active2totdoc */
-			int32_t   *active2totdoc;
-			/** totdoc2active */
-			int32_t   *totdoc2active;
-			/** least recently used */
-			int32_t   *lru;
-			/** occu */
-			int32_t   *occu;
-			/** elements */
-			int32_t   elems;
-			/** max elements */
-			int32_t   max_elems;
-			/** time */
-			int32_t   time;
-			/** active num */
-			int32_t   activenum;
-
-			/** buffer */
-			KERNELCACHE_ELEM  *buffer;
-			/** buffer size */
-			KERNELCACHE_IDX   buffsize;
-		};
-
-		/** kernel thread parameters */
-		struct S_KTHREAD_PARAM
-		{
-			/** kernel */
-			CKernel* kernel;
-			/** kernel cache */
-			KERNEL_CACHE* kernel_cache;
-			/** cache */
-			KERNELCACHE_ELEM** cache;
-			/** uncached rows */
-			int32_t* uncached_rows;
-			/** number of uncached rows */
-			int32_t num_uncached;
-			/** needs computation */
-			uint8_t* needs_computation;
-			/** start */
-			int32_t start;
-			/** end */
-			int32_t end;
-			/** of vectors */
-			int32_t num_vectors;
-		};
-#endif // DOXYGEN_SHOULD_SKIP_THIS
-
 		//@{
-		static void* cache_multiple_kernel_row_helper(void* p);
-
-		/// init kernel cache of size megabytes
-		void   kernel_cache_free(int32_t cacheidx);
-		int32_t   kernel_cache_malloc();
-		int32_t   kernel_cache_free_lru();
-		KERNELCACHE_ELEM *kernel_cache_clean_and_malloc(int32_t cacheidx);
+		/// fill the cache line of an allocated row
+		void kernel_cache_fill_row(int32_t row, const uint8_t* needs_computation);
 #endif //USE_SVMLIGHT
 		//@}
 
@@ -1047,9 +1122,18 @@ class CKernel : public CSGObject
 		/// cache_size in MB
 		int32_t cache_size;
 
+		/// number of shards of the kernel cache, 0 means one per thread
+		int32_t cache_num_shards;
+
+		/// whether the kernel cache stores rows in single precision
+		bool cache_shortreal;
+
+		/// precision of kernel matrices
+		EKernelPrecision precision;
+
 #ifdef USE_SVMLIGHT
 		/// kernel cache
-		KERNEL_CACHE kernel_cache;
+		KernelRowCache kernel_cache;
 #endif //USE_SVMLIGHT
 
 		/// this *COULD* store the whole kernel matrix
@@ -0,0 +1,281 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Soeren Sonnenburg, Viktor Gal
+ */
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/kernel/KernelRowCache.h>
+#include <shogun/mathematics/Math.h>
+
+#include <string.h>
+
+using namespace shogun;
+
+KernelRowCache::KernelRowCache()
+    : m_totdoc(0), m_activenum(0), m_time(0), m_use_shortreal(false),
+      m_index(NULL), m_active2totdoc(NULL), m_totdoc2active(NULL)
+{
+}
+
+KernelRowCache::~KernelRowCache()
+{
+	cleanup();
+}
+
+void KernelRowCache::init(
+	int32_t totdoc, int64_t size, int32_t num_shards, bool use_shortreal)
+{
+	require(totdoc > 0, "Kernel cache needs at least one row ({})", totdoc);
+	cleanup();
+
+	m_totdoc = totdoc;
+	m_activenum = totdoc;
+	m_time = 0;
+	m_use_shortreal = use_shortreal;
+
+	const uint64_t elem_size =
+		use_shortreal ? sizeof(float32_t) : sizeof(float64_t);
+	uint64_t buffer_size = ((uint64_t)size) * 1024 * 1024 / elem_size;
+	if (buffer_size > ((uint64_t)totdoc) * totdoc)
+		buffer_size = ((uint64_t)totdoc) * totdoc;
+
+	// make sure it fits in the *signed* index type
+	ASSERT(buffer_size < (((uint64_t)1) << (sizeof(int64_t) * 8 - 1)))
+
+	// every shard should at least be able to hold a single row
+	if (num_shards <= 0)
+		num_shards = env()->get_num_threads();
+	num_shards = CMath::min(num_shards, totdoc);
+	num_shards = (int32_t)CMath::min(
+		(uint64_t)num_shards, CMath::max(buffer_size / totdoc, (uint64_t)1));
+
+	m_index = SG_MALLOC(int32_t, totdoc);
+	m_active2totdoc = SG_MALLOC(int32_t, totdoc);
+	m_totdoc2active = SG_MALLOC(int32_t, totdoc);
+	for (int32_t i = 0; i < totdoc; i++)
+	{
+		m_index[i] = -1;
+		m_active2totdoc[i] = i;
+		m_totdoc2active[i] = i;
+	}
+
+	m_shards.resize(num_shards);
+
+#pragma omp parallel for schedule(static, 1)
+	for (int32_t s = 0; s < num_shards; s++)
+		init_shard(s, buffer_size);
+}
+
+void KernelRowCache::init_shard(int32_t s, uint64_t buffer_size)
+{
+	const int32_t num_shards = get_num_shards();
+	Shard& shard = m_shards[s];
+
+	// the budget is split proportionally to the rows a shard can hold
+	shard.num_rows = (m_totdoc - s + num_shards - 1) / num_shards;
+	shard.buffsize = (buffer_size / m_totdoc) * shard.num_rows +
+		(buffer_size % m_totdoc) * shard.num_rows / m_totdoc;
+	shard.max_elems = (int32_t)CMath::min(
+		shard.buffsize / m_totdoc, (int64_t)shard.num_rows);
+
+	shard.lru = SG_CALLOC(int32_t, shard.num_rows);
+	shard.invindex = SG_MALLOC(int32_t, shard.num_rows);
+	shard.free_slots = SG_MALLOC(int32_t, shard.num_rows);
+	for (int32_t i = 0; i < shard.num_rows; i++)
+		shard.invindex[i] = -1;
+
+	shard.num_free = shard.max_elems;
+	for (int32_t i = 0; i < shard.max_elems; i++)
+		shard.free_slots[i] = shard.max_elems - 1 - i;
+
+	// calloc may hand out untouched zero pages, which would then be placed
+	// by whichever thread first writes a row, hence zero the slab here in
+	// the thread that initialises the shard (first touch)
+	shard.buffer32 = NULL;
+	shard.buffer64 = NULL;
+	if (m_use_shortreal)
+	{
+		shard.buffer32 = SG_MALLOC(float32_t, shard.buffsize);
+		memset(shard.buffer32, 0, sizeof(float32_t) * shard.buffsize);
+	}
+	else
+	{
+		shard.buffer64 = SG_MALLOC(float64_t, shard.buffsize);
+		memset(shard.buffer64, 0, sizeof(float64_t) * shard.buffsize);
+	}
+}
+
+void KernelRowCache::cleanup()
+{
+	for (auto& shard : m_shards)
+	{
+		SG_FREE(shard.lru);
+		SG_FREE(shard.invindex);
+		SG_FREE(shard.free_slots);
+		SG_FREE(shard.buffer32);
+		SG_FREE(shard.buffer64);
+	}
+	m_shards.clear();
+
+	SG_FREE(m_index);
+	SG_FREE(m_active2totdoc);
+	SG_FREE(m_totdoc2active);
+	m_index = NULL;
+	m_active2totdoc = NULL;
+	m_totdoc2active = NULL;
+
+	m_totdoc = 0;
+	m_activenum = 0;
+	m_time = 0;
+}
+
+int32_t KernelRowCache::get_max_elems() const
+{
+	int32_t max_elems = 0;
+	for (const auto& shard : m_shards)
+		max_elems += shard.max_elems;
+	return max_elems;
+}
+
+int32_t KernelRowCache::get_elems() const
+{
+	int32_t elems = 0;
+	for (const auto& shard : m_shards)
+		elems += shard.max_elems - shard.num_free;
+	return elems;
+}
+
+bool KernelRowCache::allocate(int32_t row)
+{
+	Shard& shard = m_shards[get_shard(row)];
+
+	if (!shard.num_free && !free_lru(shard))
+	{
+		m_index[row] = -1;
+		return false;
+	}
+
+	const int32_t slot = shard.free_slots[--shard.num_free];
+	m_index[row] = slot;
+	shard.invindex[slot] = row;
+	shard.lru[slot] = m_time;
+	return true;
+}
+
+bool KernelRowCache::free_lru(Shard& shard)
+{
+	int32_t least_elem = -1;
+	int32_t least_time = m_time + 1;
+
+	for (int32_t k = 0; k < shard.max_elems; k++)
+	{
+		if (shard.invindex[k] != -1 && shard.lru[k] < least_time)
+		{
+			least_time = shard.lru[k];
+			least_elem = k;
+		}
+	}
+
+	if (least_elem == -1)
+		return false;
+
+	m_index[shard.invindex[least_elem]] = -1;
+	shard.invindex[least_elem] = -1;
+	shard.free_slots[shard.num_free++] = least_elem;
+	return true;
+}
+
+void KernelRowCache::shrink(
+	int32_t totdoc, int32_t num_shrink, const int32_t* after)
+{
+	ASSERT(totdoc > 0);
+
+	int32_t* keep = SG_MALLOC(int32_t, totdoc);
+	for (int32_t j = 0; j < totdoc; j++)
+		keep[j] = 1;
+
+	int32_t scount = 0;
+	for (int32_t jj = 0; (jj < m_activenum) && (scount < num_shrink); jj++)
+	{
+		int32_t j = m_active2totdoc[jj];
+		if (!after[j])
+		{
+			scount++;
+			keep[j] = 0;
+		}
+	}
+
+	// shards are disjoint, so they can be compacted independently
+#pragma omp parallel for schedule(static, 1)
+	for (int32_t s = 0; s < get_num_shards(); s++)
+		compact_shard(m_shards[s], keep);
+
+	m_activenum = 0;
+	for (int32_t j = 0; j < totdoc; j++)
+	{
+		if (keep[j] && (m_totdoc2active[j] != -1))
+		{
+			m_active2totdoc[m_activenum] = j;
+			m_totdoc2active[j] = m_activenum;
+			m_activenum++;
+		}
+		else
+			m_totdoc2active[j] = -1;
+	}
+
+	// shorter rows free up space for additional slots
+	for (auto& shard : m_shards)
+	{
+		int32_t max_elems = shard.num_rows;
+		if (m_activenum > 0)
+			max_elems = (int32_t)CMath::min(
+				shard.buffsize / m_activenum, (int64_t)shard.num_rows);
+
+		for (int32_t i = shard.max_elems; i < max_elems; i++)
+			shard.free_slots[shard.num_free++] = i;
+		shard.max_elems = CMath::max(shard.max_elems, max_elems);
+	}
+
+	SG_FREE(keep);
+}
+
+void KernelRowCache::compact_shard(Shard& shard, const int32_t* keep)
+{
+	int64_t from = 0;
+	int64_t to = 0;
+
+	for (int32_t i = 0; i < shard.max_elems; i++)
+	{
+		for (int32_t jj = 0; jj < m_activenum; jj++)
+		{
+			if (keep[m_active2totdoc[jj]])
+			{
+				if (m_use_shortreal)
+					shard.buffer32[to] = shard.buffer32[from];
+				else
+					shard.buffer64[to] = shard.buffer64[from];
+				to++;
+			}
+			from++;
+		}
+	}
+}
+
+void KernelRowCache::reset_lru()
+{
+	int32_t maxlru = 0;
+
+	for (const auto& shard : m_shards)
+	{
+		for (int32_t k = 0; k < shard.max_elems; k++)
+			maxlru = CMath::max(maxlru, shard.lru[k]);
+	}
+
+	for (auto& shard : m_shards)
+	{
+		for (int32_t k = 0; k < shard.max_elems; k++)
+			shard.lru[k] -= maxlru;
+	}
+}
@@ -0,0 +1,278 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Soeren Sonnenburg, Viktor Gal
+ */
+
+#ifndef _KERNEL_ROW_CACHE_H__
+#define _KERNEL_ROW_CACHE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+
+#include <vector>
+
+namespace shogun
+{
+/** @brief Sharded LRU cache of kernel rows as used by the decomposition
+ * based SVM solvers (e.g. SVMLight).
+ *
+ * A cached row of example \f$i\f$ stores \f$k(x_i, x_j)\f$ for all examples
+ * \f$j\f$ that are currently active (not shrunk away). Rows are distributed
+ * round-robin over a number of shards, i.e. row \f$i\f$ lives in shard
+ * \f$i \bmod s\f$. Every shard owns its own slab of row slots together with
+ * its own LRU bookkeeping and free list. Hence slots of *different* shards
+ * can be allocated, evicted and compacted concurrently without any
+ * synchronisation, while lookups of cached values never take a lock.
+ *
+ * The shards are initialised in parallel and the slab of a shard is zeroed
+ * by the thread that initialises it, which with the default first-touch
+ * page placement puts it on the NUMA node of that thread.
+ *
+ * Rows can be stored in single precision, which fits twice as many rows into
+ * the same memory budget.
+ */
+class KernelRowCache
+{
+public:
+	/** default constructor */
+	KernelRowCache();
+
+	/** destructor */
+	~KernelRowCache();
+
+	/** initialise the cache
+	 *
+	 * @param totdoc number of rows (and columns) that may be cached
+	 * @param size cache size in MB
+	 * @param num_shards number of shards, 0 means one per thread
+	 * @param use_shortreal store rows as float32_t instead of float64_t
+	 */
+	void init(
+		int32_t totdoc, int64_t size, int32_t num_shards, bool use_shortreal);
+
+	/** free all memory held by the cache */
+	void cleanup();
+
+	/** @return whether the cache was initialised */
+	inline bool is_initialized() const
+	{
+		return m_totdoc > 0;
+	}
+
+	/** @return number of shards */
+	inline int32_t get_num_shards() const
+	{
+		return (int32_t)m_shards.size();
+	}
+
+	/** @param row row index
+	 * @return the shard the given row belongs to
+	 */
+	inline int32_t get_shard(int32_t row) const
+	{
+		return row % get_num_shards();
+	}
+
+	/** @return whether rows are stored in single precision */
+	inline bool is_shortreal() const
+	{
+		return m_use_shortreal;
+	}
+
+	/** @return maximum number of rows that fit into the cache */
+	int32_t get_max_elems() const;
+
+	/** @return number of currently cached rows */
+	int32_t get_elems() const;
+
+	/** @return number of active columns */
+	inline int32_t get_activenum() const
+	{
+		return m_activenum;
+	}
+
+	/** set the lru time
+	 *
+	 * @param t the time to use
+	 */
+	inline void set_time(int32_t t)
+	{
+		m_time = t;
+	}
+
+	/** check if row is cached
+	 *
+	 * @param row row index
+	 * @return if row is cached
+	 */
+	inline bool check(int32_t row) const
+	{
+		return m_index[row] >= 0;
+	}
+
+	/** update lru time of a cached row to avoid its removal
+	 *
+	 * @param row row index
+	 * @return if row is cached
+	 */
+	inline bool touch(int32_t row)
+	{
+		if (m_index[row] < 0)
+			return false;
+
+		m_shards[get_shard(row)].lru[m_index[row]] = m_time;
+		return true;
+	}
+
+	/** @return if there is room for one more row in the cache */
+	inline bool space_available() const
+	{
+		return get_elems() < get_max_elems();
+	}
+
+	/** map a document index to its active column
+	 *
+	 * @param doc document index
+	 * @return active column or -1 if the document is inactive
+	 */
+	inline int32_t totdoc2active(int32_t doc) const
+	{
+		return m_totdoc2active[doc];
+	}
+
+	/** map an active column to its document index
+	 *
+	 * @param col active column
+	 * @return document index
+	 */
+	inline int32_t active2totdoc(int32_t col) const
+	{
+		return m_active2totdoc[col];
+	}
+
+	/** get a cached value, row has to be cached
+	 *
+	 * @param row row index
+	 * @param col active column
+	 * @return cached value
+	 */
+	inline float64_t get(int32_t row, int32_t col) const
+	{
+		const Shard& shard = m_shards[get_shard(row)];
+		const int64_t offset = ((int64_t)m_activenum) * m_index[row] + col;
+
+		if (m_use_shortreal)
+			return shard.buffer32[offset];
+		return shard.buffer64[offset];
+	}
+
+	/** allocate a slot for a row, evicting the least recently used row of
+	 * the same shard if the shard is full. Allocations of rows that belong
+	 * to different shards may run concurrently.
+	 *
+	 * @param row row index
+	 * @return whether a slot could be allocated
+	 */
+	bool allocate(int32_t row);
+
+	/** fill an allocated row
+	 *
+	 * @param row row index
+	 * @param compute functor mapping an active column to its value
+	 */
+	template <class F>
+	void fill(int32_t row, F&& compute)
+	{
+		Shard& shard = m_shards[get_shard(row)];
+		const int64_t offset = ((int64_t)m_activenum) * m_index[row];
+
+		if (m_use_shortreal)
+		{
+			float32_t* line = shard.buffer32 + offset;
+			for (int32_t j = 0; j < m_activenum; j++)
+				line[j] = (float32_t)compute(j);
+		}
+		else
+		{
+			float64_t* line = shard.buffer64 + offset;
+			for (int32_t j = 0; j < m_activenum; j++)
+				line[j] = compute(j);
+		}
+	}
+
+	/** remove columns of examples that are marked as inactive. Shards are
+	 * compacted in parallel.
+	 *
+	 * @param totdoc number of documents
+	 * @param num_shrink maximum number of columns to remove
+	 * @param after marks columns to keep with non zero entries
+	 */
+	void shrink(int32_t totdoc, int32_t num_shrink, const int32_t* after);
+
+	/** shift lru times such that the most recent one is zero */
+	void reset_lru();
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** slab of row slots owned by one shard */
+	struct Shard
+	{
+		/** number of elements in the buffer */
+		int64_t buffsize;
+		/** number of slots */
+		int32_t max_elems;
+		/** number of rows the shard can ever hold */
+		int32_t num_rows;
+		/** least recently used time of each slot */
+		int32_t* lru;
+		/** row stored in each slot, -1 if free */
+		int32_t* invindex;
+		/** stack of free slots */
+		int32_t* free_slots;
+		/** number of free slots */
+		int32_t num_free;
+		/** single precision buffer */
+		float32_t* buffer32;
+		/** double precision buffer */
+		float64_t* buffer64;
+	};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** init shard of given index and zero its slab, called from the
+	 * parallel loop in init
+	 *
+	 * @param s shard index
+	 * @param buffer_size number of elements of the whole cache
+	 */
+	void init_shard(int32_t s, uint64_t buffer_size);
+
+	/** free the least recently used slot of a shard
+	 * @return whether a slot was freed
+	 */
+	bool free_lru(Shard& shard);
+
+	/** compact a shard after the active set changed */
+	void compact_shard(Shard& shard, const int32_t* keep);
+
+private:
+	/** number of rows */
+	int32_t m_totdoc;
+	/** number of active columns */
+	int32_t m_activenum;
+	/** lru time */
+	int32_t m_time;
+	/** whether rows are stored in single precision */
+	bool m_use_shortreal;
+	/** slot of each row within its shard, -1 if not cached */
+	int32_t* m_index;
+	/** document index of each active column */
+	int32_t* m_active2totdoc;
+	/** active column of each document, -1 if inactive */
+	int32_t* m_totdoc2active;
+	/** shards */
+	std::vector<Shard> m_shards;
+};
+}
+#endif // _KERNEL_ROW_CACHE_H__
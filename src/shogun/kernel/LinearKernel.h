@@ -95,6 +95,15 @@ class CLinearKernel: public CDotKernel
 		*/
 		virtual float64_t compute_optimized(int32_t idx);
 
+		/** the kernel matrix consists of plain dot products
+		 *
+		 * @return true
+		 */
+		virtual bool has_dot_transform() const
+		{
+			return true;
+		}
+
 		virtual void clear_normal()
 		{
 			normal = SGVector<float64_t>(((CDotFeatures*)lhs)->get_dim_feature_space());
@@ -66,6 +66,15 @@ float64_t CPolyKernel::compute(int32_t idx_a, int32_t idx_b)
 	return CMath::pow(result, degree);
 }
 
+void CPolyKernel::transform_dot_block(
+	float64_t* block, index_t num_rows, index_t num_cols,
+	const float64_t* sq_norm_lhs, const float64_t* sq_norm_rhs) const
+{
+	const int64_t num=int64_t(num_rows)*num_cols;
+	for (int64_t i=0; i<num; i++)
+		block[i]=CMath::pow(m_gamma*block[i]+m_c, degree);
+}
+
 void CPolyKernel::init()
 {
 	degree = 0;
@@ -95,6 +95,24 @@ class CPolyKernel: public CDotKernel
 		 */
 		virtual float64_t compute(int32_t idx_a, int32_t idx_b);
 
+		/** @return true */
+		virtual bool has_dot_transform() const
+		{
+			return true;
+		}
+
+		/** turn dot products into \f$(\gamma {\bf x}\cdot{\bf y}+c)^d\f$
+		 *
+		 * @param block column-major num_rows x num_cols block of dot products
+		 * @param num_rows number of rows of the block
+		 * @param num_cols number of columns of the block
+		 * @param sq_norm_lhs unused
+		 * @param sq_norm_rhs unused
+		 */
+		virtual void transform_dot_block(
+			float64_t* block, index_t num_rows, index_t num_cols,
+			const float64_t* sq_norm_lhs, const float64_t* sq_norm_rhs) const;
+
 	private:
 		void init();
 
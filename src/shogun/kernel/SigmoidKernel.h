@@ -87,6 +87,29 @@ class CSigmoidKernel: public CDotKernel
 			return tanh(gamma*CDotKernel::compute(idx_a,idx_b)+coef0);
 		}
 
+		/** @return true */
+		virtual bool has_dot_transform() const
+		{
+			return true;
+		}
+
+		/** turn dot products into \f$\mbox{tanh}(\gamma {\bf x}\cdot{\bf y}+c)\f$
+		 *
+		 * @param block column-major num_rows x num_cols block of dot products
+		 * @param num_rows number of rows of the block
+		 * @param num_cols number of columns of the block
+		 * @param sq_norm_lhs unused
+		 * @param sq_norm_rhs unused
+		 */
+		virtual void transform_dot_block(
+			float64_t* block, index_t num_rows, index_t num_cols,
+			const float64_t* sq_norm_lhs, const float64_t* sq_norm_rhs) const
+		{
+			const int64_t num=int64_t(num_rows)*num_cols;
+			for (int64_t i=0; i<num; i++)
+				block[i]=tanh(gamma*block[i]+coef0);
+		}
+
 	private:
 		void init();
 
@@ -0,0 +1,199 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/base/Parallel.h>
+#include <shogun/base/ThreadPool.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/kernel/Kernel.h>
+#include <shogun/kernel/TiledKernelMatrix.h>
+
+#include <string.h>
+
+using namespace shogun;
+
+namespace
+{
+/** identifies files written by TiledKernelMatrix::save() */
+const char tiled_magic[8] = {'S', 'G', 'K', 'T', 'I', 'L', 'E', '1'};
+
+/** tiles start after the header page, which keeps them page aligned */
+const int64_t tiled_header_size = 4096;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/** header of a tiled kernel matrix file */
+struct TiledHeader
+{
+	char magic[8];
+	int64_t num_rows;
+	int64_t num_cols;
+	int64_t tile_size;
+	int64_t upper_triangle;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+}
+
+int64_t TiledKernelMatrix::num_tiles(
+    int64_t num_rows, int64_t num_cols, int64_t tile_size, bool upper_triangle)
+{
+	const int64_t tile_rows = (num_rows + tile_size - 1) / tile_size;
+	const int64_t tile_cols = (num_cols + tile_size - 1) / tile_size;
+
+	if (upper_triangle)
+		return tile_rows * (tile_rows + 1) / 2;
+
+	return tile_rows * tile_cols;
+}
+
+TiledKernelMatrix::TiledKernelMatrix(const char* fname)
+{
+	m_file = new CMemoryMappedFile<uint8_t>(fname, 'r');
+	SG_REF(m_file);
+
+	try
+	{
+		map_tiles(fname);
+	}
+	catch (...)
+	{
+		SG_UNREF(m_file);
+		throw;
+	}
+}
+
+void TiledKernelMatrix::map_tiles(const char* fname)
+{
+	require(
+	    m_file->get_size() >= (uint64_t)tiled_header_size,
+	    "{} is not a tiled kernel matrix file", fname);
+
+	TiledHeader header;
+	memcpy(&header, m_file->get_map(), sizeof(TiledHeader));
+	require(
+	    memcmp(header.magic, tiled_magic, sizeof(tiled_magic)) == 0,
+	    "{} is not a tiled kernel matrix file", fname);
+	require(
+	    header.num_rows > 0 && header.num_cols > 0 && header.tile_size > 0,
+	    "Invalid tiled kernel matrix of size {}x{} with tiles of size {}",
+	    header.num_rows, header.num_cols, header.tile_size);
+
+	m_num_rows = header.num_rows;
+	m_num_cols = header.num_cols;
+	m_tile_size = header.tile_size;
+	m_num_tile_cols = (m_num_cols + m_tile_size - 1) / m_tile_size;
+	m_upper_triangle = header.upper_triangle != 0;
+
+	const int64_t size = tiled_header_size +
+	                     num_tiles(m_num_rows, m_num_cols, m_tile_size,
+	                               m_upper_triangle) *
+	                         m_tile_size * m_tile_size * sizeof(float32_t);
+	require(
+	    m_file->get_size() >= (uint64_t)size,
+	    "Tiled kernel matrix file {} is truncated, expected {} bytes but got "
+	    "{}",
+	    fname, size, m_file->get_size());
+
+	m_tiles = (const float32_t*)(m_file->get_map() + tiled_header_size);
+}
+
+TiledKernelMatrix::~TiledKernelMatrix()
+{
+	SG_UNREF(m_file);
+}
+
+void TiledKernelMatrix::save(CKernel* kernel, const char* fname, int32_t tile_size)
+{
+	require(kernel, "No kernel given");
+	require(kernel->has_features(), "Kernel is not initialised");
+	require(tile_size > 0, "Tile size has to be positive, not {}", tile_size);
+
+	const int64_t num_rows = kernel->get_num_vec_lhs();
+	const int64_t num_cols = kernel->get_num_vec_rhs();
+	const bool upper_triangle =
+	    kernel->get_lhs_equals_rhs() && num_rows == num_cols;
+
+	const int64_t tile_elems = int64_t(tile_size) * tile_size;
+	const int64_t tile_rows = (num_rows + tile_size - 1) / tile_size;
+	const int64_t tile_cols = (num_cols + tile_size - 1) / tile_size;
+	const int64_t total_tiles =
+	    num_tiles(num_rows, num_cols, tile_size, upper_triangle);
+	const int64_t size =
+	    tiled_header_size + total_tiles * tile_elems * sizeof(float32_t);
+
+	auto file = new CMemoryMappedFile<uint8_t>(fname, 'w', size);
+	SG_REF(file);
+	file->set_truncate_size(size);
+
+	TiledHeader header;
+	memset(&header, 0, sizeof(TiledHeader));
+	memcpy(header.magic, tiled_magic, sizeof(tiled_magic));
+	header.num_rows = num_rows;
+	header.num_cols = num_cols;
+	header.tile_size = tile_size;
+	header.upper_triangle = upper_triangle;
+	memcpy(file->get_map(), &header, sizeof(TiledHeader));
+
+	float32_t* tiles = (float32_t*)(file->get_map() + tiled_header_size);
+
+	// tiles are independent, every task writes its own part of the file
+	env()->get_thread_pool()->parallel_for(
+	    0, tile_rows, 1, [&](index_t begin, index_t end) {
+		    for (int64_t tr = begin; tr < end; tr++)
+		    {
+			    float32_t* tile = tiles +
+			                      (upper_triangle
+			                           ? tr * tile_cols - tr * (tr - 1) / 2
+			                           : tr * tile_cols) *
+			                          tile_elems;
+
+			    for (int64_t tc = upper_triangle ? tr : 0; tc < tile_cols;
+			         tc++, tile += tile_elems)
+			    {
+				    for (int64_t r = 0; r < tile_size; r++)
+				    {
+					    const int64_t i = tr * tile_size + r;
+					    for (int64_t c = 0; c < tile_size; c++)
+					    {
+						    const int64_t j = tc * tile_size + c;
+						    tile[r * tile_size + c] =
+						        (i < num_rows && j < num_cols)
+						            ? kernel->kernel(i, j)
+						            : 0;
+					    }
+				    }
+			    }
+		    }
+	    });
+
+	SG_UNREF(file);
+}
+
+void TiledKernelMatrix::prefetch_row(index_t row) const
+{
+	const int64_t tile_elems = int64_t(m_tile_size) * m_tile_size;
+	const int64_t tile_row = row / m_tile_size;
+	const int64_t line = int64_t(row % m_tile_size) * m_tile_size;
+	const uint64_t base = tiled_header_size;
+
+	// in the lower part a row is a column of the transposed tile, which is
+	// spread over the whole tile
+	if (m_upper_triangle)
+	{
+		for (int64_t tc = 0; tc <= tile_row; tc++)
+		{
+			m_file->prefetch(
+			    base + tile_offset(tc, tile_row) * sizeof(float32_t),
+			    tile_elems * sizeof(float32_t));
+		}
+	}
+
+	for (int64_t tc = m_upper_triangle ? tile_row + 1 : 0; tc < m_num_tile_cols;
+	     tc++)
+	{
+		m_file->prefetch(
+		    base + (tile_offset(tile_row, tc) + line) * sizeof(float32_t),
+		    m_tile_size * sizeof(float32_t));
+	}
+}
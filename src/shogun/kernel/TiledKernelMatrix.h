@@ -0,0 +1,149 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef _TILED_KERNEL_MATRIX_H__
+#define _TILED_KERNEL_MATRIX_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+#include <shogun/io/MemoryMappedFile.h>
+
+#include <utility>
+
+namespace shogun
+{
+class CKernel;
+
+/** @brief Kernel matrix stored in a tiled on-disk format that is memory
+ * mapped and read on demand, hence it may be larger than the available
+ * memory.
+ *
+ * The file starts with a header page, followed by square tiles of
+ * tile_size x tile_size float32_t values. Tiles are stored tile row after
+ * tile row and values within a tile row by row, tiles at the border are
+ * padded with zeros. Symmetric matrices only store the tiles on and above
+ * the diagonal.
+ *
+ * A kernel row touches one line in every tile of its tile row. Prefetching a
+ * row advises the operating system to read all these lines at once, instead
+ * of faulting them in one after another while the row is computed.
+ */
+class TiledKernelMatrix
+{
+public:
+	/** open and map a tiled kernel matrix
+	 *
+	 * @param fname file written by save()
+	 */
+	explicit TiledKernelMatrix(const char* fname);
+
+	/** destructor, unmaps the file */
+	~TiledKernelMatrix();
+
+	TiledKernelMatrix(const TiledKernelMatrix&) = delete;
+	TiledKernelMatrix& operator=(const TiledKernelMatrix&) = delete;
+
+	/** compute the kernel matrix of the given kernel tile by tile and write
+	 * it to a file. Only the upper tiles are written if the left and right
+	 * hand side features of the kernel are the same.
+	 *
+	 * @param kernel initialised kernel
+	 * @param fname file to write
+	 * @param tile_size number of rows and columns of a tile
+	 */
+	static void save(CKernel* kernel, const char* fname, int32_t tile_size=256);
+
+	/** @return number of rows */
+	inline int32_t get_num_rows() const
+	{
+		return m_num_rows;
+	}
+
+	/** @return number of columns */
+	inline int32_t get_num_cols() const
+	{
+		return m_num_cols;
+	}
+
+	/** @return number of rows and columns of a tile */
+	inline int32_t get_tile_size() const
+	{
+		return m_tile_size;
+	}
+
+	/** @return whether only the upper tiles of a symmetric matrix are stored */
+	inline bool is_upper_triangle() const
+	{
+		return m_upper_triangle;
+	}
+
+	/** get a kernel matrix entry
+	 *
+	 * @param row row index
+	 * @param col column index
+	 * @return entry
+	 */
+	inline float32_t get(index_t row, index_t col) const
+	{
+		if (m_upper_triangle && row > col)
+			std::swap(row, col);
+
+		const int64_t offset = tile_offset(row / m_tile_size, col / m_tile_size);
+		return m_tiles
+		    [offset + int64_t(row % m_tile_size) * m_tile_size +
+		     col % m_tile_size];
+	}
+
+	/** advise the operating system to read the tiles of a row in the
+	 * background
+	 *
+	 * @param row row index
+	 */
+	void prefetch_row(index_t row) const;
+
+private:
+	/** check the header of the mapped file and locate the tiles
+	 *
+	 * @param fname name of the mapped file
+	 */
+	void map_tiles(const char* fname);
+
+	/** @return offset of the first element of a tile within m_tiles */
+	inline int64_t tile_offset(int64_t tile_row, int64_t tile_col) const
+	{
+		const int64_t tile_elems = int64_t(m_tile_size) * m_tile_size;
+		const int64_t tile_index = m_upper_triangle
+		    ? tile_row * m_num_tile_cols - tile_row * (tile_row - 1) / 2 +
+		          tile_col - tile_row
+		    : tile_row * m_num_tile_cols + tile_col;
+
+		return tile_index * tile_elems;
+	}
+
+	/** @return total number of tiles stored for a matrix of the given size */
+	static int64_t num_tiles(
+	    int64_t num_rows, int64_t num_cols, int64_t tile_size,
+	    bool upper_triangle);
+
+private:
+	/** mapped file */
+	CMemoryMappedFile<uint8_t>* m_file;
+	/** first tile within the mapped file */
+	const float32_t* m_tiles;
+	/** number of rows */
+	int32_t m_num_rows;
+	/** number of columns */
+	int32_t m_num_cols;
+	/** number of rows and columns of a tile */
+	int32_t m_tile_size;
+	/** number of tiles in a tile row */
+	int32_t m_num_tile_cols;
+	/** whether only the upper tiles are stored */
+	bool m_upper_triangle;
+};
+}
+#endif // _TILED_KERNEL_MATRIX_H__
@@ -8,8 +8,15 @@
 #include <shogun/lib/Hash.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/external/PMurHash.h>
+#include <shogun/lib/cpu.h>
 #include <ctype.h>
 
+#include <algorithm>
+
+#ifdef SG_CPU_DISPATCH
+#include <immintrin.h>
+#endif
+
 using namespace shogun;
 
 uint32_t CHash::crc32(uint8_t *data, int32_t len)
@@ -345,6 +352,112 @@ uint32_t CHash::MurmurHash3(uint8_t* data, int32_t len, uint32_t seed)
 	return PMurHash32(seed, data, len);
 }
 
+namespace
+{
+void murmur_hash3_generic(
+	const uint8_t* data, const int32_t* starts, const int32_t* lengths,
+	int32_t num_tokens, uint32_t seed, uint32_t* hashes)
+{
+	for (int32_t i=0; i<num_tokens; i++)
+		hashes[i]=PMurHash32(seed, data+starts[i], lengths[i]);
+}
+
+#ifdef SG_CPU_DISPATCH
+__attribute__((target("avx2"))) inline __m256i rotl32(__m256i x, int r)
+{
+	return _mm256_or_si256(_mm256_slli_epi32(x, r), _mm256_srli_epi32(x, 32-r));
+}
+
+__attribute__((target("avx2"))) void murmur_hash3_avx2(
+	const uint8_t* data, const int32_t* starts, const int32_t* lengths,
+	int32_t num_tokens, uint32_t seed, uint32_t* hashes)
+{
+	const __m256i c1=_mm256_set1_epi32(0xcc9e2d51);
+	const __m256i c2=_mm256_set1_epi32(0x1b873593);
+	const __m256i zero=_mm256_setzero_si256();
+
+	int32_t i=0;
+	for (; i+8<=num_tokens; i+=8)
+	{
+		auto start=_mm256_loadu_si256((const __m256i*)(starts+i));
+		auto length=_mm256_loadu_si256((const __m256i*)(lengths+i));
+		auto num_blocks=_mm256_srli_epi32(length, 2);
+
+		int32_t max_blocks=0;
+		for (int32_t j=0; j<8; j++)
+			max_blocks=std::max(max_blocks, lengths[i+j] >> 2);
+
+		// tokens with fewer blocks keep their hash
+		auto h=_mm256_set1_epi32(seed);
+		for (int32_t b=0; b<max_blocks; b++)
+		{
+			auto active=_mm256_cmpgt_epi32(num_blocks, _mm256_set1_epi32(b));
+			auto offset=_mm256_add_epi32(start, _mm256_set1_epi32(4*b));
+			auto k=_mm256_mask_i32gather_epi32(
+				zero, (const int*)data, offset, active, 1);
+			k=_mm256_mullo_epi32(rotl32(_mm256_mullo_epi32(k, c1), 15), c2);
+
+			auto mixed=rotl32(_mm256_xor_si256(h, k), 13);
+			mixed=_mm256_add_epi32(
+				_mm256_add_epi32(mixed, _mm256_slli_epi32(mixed, 2)),
+				_mm256_set1_epi32(0xe6546b64));
+			h=_mm256_blendv_epi8(h, mixed, active);
+		}
+
+		// the tail bytes are gathered per token to stay inside the buffer
+		alignas(32) uint32_t tails[8];
+		for (int32_t j=0; j<8; j++)
+		{
+			auto tail=data+starts[i+j]+(lengths[i+j] & ~3);
+			uint32_t t=0;
+			switch (lengths[i+j] & 3)
+			{
+				case 3: t^=uint32_t(tail[2]) << 16; // fallthrough
+				case 2: t^=uint32_t(tail[1]) << 8; // fallthrough
+				case 1: t^=tail[0];
+			}
+			tails[j]=t;
+		}
+		auto k=_mm256_load_si256((const __m256i*)tails);
+		k=_mm256_mullo_epi32(rotl32(_mm256_mullo_epi32(k, c1), 15), c2);
+		h=_mm256_xor_si256(h, k);
+
+		h=_mm256_xor_si256(h, length);
+		h=_mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+		h=_mm256_mullo_epi32(h, _mm256_set1_epi32(0x85ebca6b));
+		h=_mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+		h=_mm256_mullo_epi32(h, _mm256_set1_epi32(0xc2b2ae35));
+		h=_mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+		_mm256_storeu_si256((__m256i*)(hashes+i), h);
+	}
+
+	murmur_hash3_generic(
+		data, starts+i, lengths+i, num_tokens-i, seed, hashes+i);
+}
+#endif // SG_CPU_DISPATCH
+
+typedef void (*murmur_hash3_t)(
+	const uint8_t*, const int32_t*, const int32_t*, int32_t, uint32_t,
+	uint32_t*);
+
+murmur_hash3_t select_murmur_hash3()
+{
+#ifdef SG_CPU_DISPATCH
+	if (CpuHasAVX2())
+		return murmur_hash3_avx2;
+#endif
+	return murmur_hash3_generic;
+}
+}
+
+void CHash::MurmurHash3(
+	const uint8_t* data, const int32_t* starts, const int32_t* lengths,
+	int32_t num_tokens, uint32_t seed, uint32_t* hashes)
+{
+	static const murmur_hash3_t kernel=select_murmur_hash3();
+	kernel(data, starts, lengths, num_tokens, seed, hashes);
+}
+
 void CHash::IncrementalMurmurHash3(uint32_t *ph1, uint32_t *pcarry, uint8_t* data, int32_t len)
 {
 	PMurHash32_Process(ph1, pcarry, data, len);
@@ -58,6 +58,22 @@ class CHash : public CSGObject
 		 */
 		static uint32_t MurmurHash3(uint8_t* data, int32_t len, uint32_t seed);
 
+		/** Murmur Hash3 of several tokens of one buffer, equal to
+		 * MurmurHash3() of every token. Eight tokens are hashed at once
+		 * with AVX2 if the CPU supports it.
+		 *
+		 * @param data buffer that contains the tokens
+		 * @param starts offsets of the tokens in data
+		 * @param lengths lengths of the tokens in number of bytes
+		 * @param num_tokens number of tokens
+		 * @param seed initial seed
+		 * @param hashes hash of every token
+		 */
+		static void MurmurHash3(
+			const uint8_t* data, const int32_t* starts,
+			const int32_t* lengths, int32_t num_tokens, uint32_t seed,
+			uint32_t* hashes);
+
 		/** Incremental Murmur3 Hash. Wrapper for function in PMurHash.c
 		 * FinalizeIncrementalMurmurHash3 must be called
 		 * at the end of all incremental hashing to
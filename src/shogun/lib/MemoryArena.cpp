@@ -0,0 +1,100 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/io/SGIO.h>
+#include <shogun/lib/MemoryArena.h>
+#include <shogun/lib/memory.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+MemoryArena::MemoryArena(size_t chunk_size)
+    : m_chunk_size(chunk_size), m_chunk(0), m_offset(0)
+{
+	require(chunk_size > 0, "Chunk size must be positive");
+}
+
+MemoryArena::~MemoryArena()
+{
+	for (auto& chunk : m_chunks)
+		SG_FREE(chunk.data);
+}
+
+void* MemoryArena::allocate(size_t num_bytes, size_t alignment)
+{
+	require(
+	    alignment && !(alignment & (alignment - 1)),
+	    "Alignment ({}) must be a power of two", alignment);
+
+	auto& c = counters();
+	c.arena_allocations++;
+	c.arena_bytes += num_bytes;
+
+	while (m_chunk < m_chunks.size())
+	{
+		auto& chunk = m_chunks[m_chunk];
+		auto address = (uintptr_t)chunk.data + m_offset;
+		auto padding = (alignment - address % alignment) % alignment;
+		if (m_offset + padding + num_bytes <= chunk.size)
+		{
+			m_offset += padding + num_bytes;
+			return chunk.data + m_offset - num_bytes;
+		}
+
+		// a following chunk that is too small is replaced
+		if (m_chunk + 1 < m_chunks.size() &&
+		    m_chunks[m_chunk + 1].size < num_bytes + alignment)
+		{
+			SG_FREE(m_chunks[m_chunk + 1].data);
+			m_chunks.erase(m_chunks.begin() + m_chunk + 1);
+		}
+		m_chunk++;
+		m_offset = 0;
+	}
+
+	auto size = std::max(m_chunk_size, num_bytes + alignment);
+	m_chunks.push_back({SG_MALLOC(char, size), size});
+	c.arena_chunks++;
+
+	m_chunk = m_chunks.size() - 1;
+	auto data = m_chunks[m_chunk].data;
+	auto padding = (alignment - (uintptr_t)data % alignment) % alignment;
+	m_offset = padding + num_bytes;
+	return data + padding;
+}
+
+void MemoryArena::release(const Marker& marker)
+{
+	if (m_chunks.empty())
+		return;
+
+	ASSERT(
+	    marker.chunk < m_chunk ||
+	    (marker.chunk == m_chunk && marker.offset <= m_offset))
+	m_chunk = marker.chunk;
+	m_offset = marker.offset;
+}
+
+size_t MemoryArena::capacity() const
+{
+	size_t capacity = 0;
+	for (const auto& chunk : m_chunks)
+		capacity += chunk.size;
+	return capacity;
+}
+
+MemoryArena& MemoryArena::thread_arena()
+{
+	thread_local MemoryArena arena;
+	return arena;
+}
+
+AllocationCounters& MemoryArena::counters()
+{
+	thread_local AllocationCounters thread_counters;
+	return thread_counters;
+}
@@ -0,0 +1,194 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+#ifndef __MEMORYARENA_H__
+#define __MEMORYARENA_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace shogun
+{
+/** @brief Number of allocations of the data of SGVector and SGMatrix by the
+ * calling thread.
+ */
+struct AllocationCounters
+{
+	/** allocations on the heap */
+	int64_t heap_allocations = 0;
+	/** bytes allocated on the heap */
+	int64_t heap_bytes = 0;
+	/** allocations in arenas */
+	int64_t arena_allocations = 0;
+	/** bytes allocated in arenas */
+	int64_t arena_bytes = 0;
+	/** chunks that arenas allocated on the heap */
+	int64_t arena_chunks = 0;
+};
+
+/** @brief Memory arena that hands out memory from large chunks by bumping a
+ * pointer and releases it in bulk.
+ *
+ * Temporaries of hot loops, which would otherwise allocate and free the
+ * data of many vectors and matrices, are allocated with
+ * SGVector(len, arena) or SGMatrix(rows, cols, arena). Such vectors and
+ * matrices are not reference counted and must not outlive the release of
+ * their memory. Chunks are kept when memory is released, so a loop that
+ * allocates the same temporaries in every iteration only allocates chunks
+ * on the heap in its first iteration.
+ *
+ * Every thread has its own arena, see thread_arena(), which is usually used
+ * through ScopedArena. An arena must only be used by one thread.
+ */
+class MemoryArena
+{
+public:
+	/** position of an arena that allocations can be released to */
+	struct Marker
+	{
+		/** chunk */
+		size_t chunk;
+		/** offset in the chunk */
+		size_t offset;
+	};
+
+	/** constructor
+	 *
+	 * @param chunk_size minimum size of the chunks in bytes
+	 */
+	explicit MemoryArena(size_t chunk_size = 1 << 20);
+
+	MemoryArena(const MemoryArena&) = delete;
+	MemoryArena& operator=(const MemoryArena&) = delete;
+
+	/** destructor, frees all chunks */
+	~MemoryArena();
+
+	/** allocate memory, which is not initialized
+	 *
+	 * @param num_bytes number of bytes
+	 * @param alignment alignment, a power of two
+	 * @return memory
+	 */
+	void* allocate(size_t num_bytes, size_t alignment);
+
+	/** allocate an array of len elements, which is not initialized
+	 *
+	 * @param len number of elements
+	 * @return memory
+	 */
+	template <class T>
+	T* allocate(int64_t len)
+	{
+		return (T*)allocate(len * sizeof(T), alignof(T) < 64 ? 64 : alignof(T));
+	}
+
+	/** @return current position */
+	Marker mark() const
+	{
+		return {m_chunk, m_offset};
+	}
+
+	/** release all memory that was allocated after a position was marked
+	 *
+	 * @param marker position
+	 */
+	void release(const Marker& marker);
+
+	/** release all memory */
+	void clear()
+	{
+		release({0, 0});
+	}
+
+	/** @return number of bytes in chunks */
+	size_t capacity() const;
+
+	/** @return arena of the calling thread */
+	static MemoryArena& thread_arena();
+
+	/** @return allocation counters of the calling thread */
+	static AllocationCounters& counters();
+
+	/** count an allocation of the data of a vector or matrix on the heap
+	 *
+	 * @param num_bytes number of bytes
+	 */
+	static void count_heap_allocation(size_t num_bytes)
+	{
+		auto& c = counters();
+		c.heap_allocations++;
+		c.heap_bytes += num_bytes;
+	}
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	struct Chunk
+	{
+		char* data;
+		size_t size;
+	};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** minimum size of the chunks */
+	size_t m_chunk_size;
+	/** chunks, the ones after the current chunk are unused */
+	std::vector<Chunk> m_chunks;
+	/** chunk that is allocated from */
+	size_t m_chunk;
+	/** used bytes of the current chunk */
+	size_t m_offset;
+};
+
+/** @brief Scope of allocations in the arena of the calling thread, which are
+ * released when the scope ends.
+ *
+ * Scopes can be nested, e.g.
+ *
+ * @code
+ * for (auto i : range(num_iterations))
+ * {
+ *     ScopedArena scope;
+ *     SGVector<float64_t> tmp(dim, scope.arena());
+ *     ...
+ * }
+ * @endcode
+ */
+class ScopedArena
+{
+public:
+	/** constructor, marks the arena of the calling thread */
+	ScopedArena()
+	    : m_arena(MemoryArena::thread_arena()), m_marker(m_arena.mark())
+	{
+	}
+
+	ScopedArena(const ScopedArena&) = delete;
+	ScopedArena& operator=(const ScopedArena&) = delete;
+
+	/** destructor, releases the allocations of the scope */
+	~ScopedArena()
+	{
+		m_arena.release(m_marker);
+	}
+
+	/** @return arena to allocate from */
+	MemoryArena& arena()
+	{
+		return m_arena;
+	}
+
+private:
+	/** arena of the thread */
+	MemoryArena& m_arena;
+	/** position at the start of the scope */
+	MemoryArena::Marker m_marker;
+};
+}
+#endif // __MEMORYARENA_H__
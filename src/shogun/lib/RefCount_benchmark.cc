@@ -6,7 +6,9 @@
 
 #include <benchmark/benchmark.h>
 
+#include "shogun/lib/MemoryArena.h"
 #include "shogun/lib/RefCount.h"
+#include "shogun/lib/SGVector.h"
 
 namespace shogun
 {
@@ -20,4 +22,53 @@ static void BM_RefCount(benchmark::State& state)
 
 BENCHMARK(BM_RefCount);
 
+/** number of temporaries per iteration of a training loop */
+static constexpr index_t num_temporaries = 64;
+
+/** report the allocations per iteration */
+static void report_allocations(
+	benchmark::State& state, const AllocationCounters& before)
+{
+	auto& after = MemoryArena::counters();
+	auto iterations = (double)state.iterations();
+	state.counters["heap_allocs"] =
+		(after.heap_allocations - before.heap_allocations) / iterations;
+	state.counters["arena_allocs"] =
+		(after.arena_allocations - before.arena_allocations) / iterations;
+}
+
+static void BM_SGVector_HeapTemporaries(benchmark::State& state)
+{
+	auto before = MemoryArena::counters();
+	for (auto _ : state)
+	{
+		for (index_t i = 0; i < num_temporaries; ++i)
+		{
+			SGVector<float64_t> tmp(state.range(0));
+			SGVector<float64_t> copy = tmp;
+			benchmark::DoNotOptimize(copy.vector);
+		}
+	}
+	report_allocations(state, before);
+}
+
+static void BM_SGVector_ArenaTemporaries(benchmark::State& state)
+{
+	auto before = MemoryArena::counters();
+	for (auto _ : state)
+	{
+		ScopedArena scope;
+		for (index_t i = 0; i < num_temporaries; ++i)
+		{
+			SGVector<float64_t> tmp(state.range(0), scope.arena());
+			SGVector<float64_t> copy = tmp;
+			benchmark::DoNotOptimize(copy.vector);
+		}
+	}
+	report_allocations(state, before);
+}
+
+BENCHMARK(BM_SGVector_HeapTemporaries)->Range(8, 8 << 10);
+BENCHMARK(BM_SGVector_ArenaTemporaries)->Range(8, 8 << 10);
+
 }
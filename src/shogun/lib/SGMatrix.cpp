@@ -10,6 +10,7 @@
 #include <shogun/lib/config.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/io/File.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/mathematics/eigen3.h>
@@ -41,6 +42,15 @@ SGMatrix<T>::SGMatrix(T* m, index_t nrows, index_t ncols, bool ref_counting)
 	m_on_gpu.store(false, std::memory_order_release);
 }
 
+template <class T>
+SGMatrix<T>::SGMatrix(
+	T* m, index_t nrows, index_t ncols, std::shared_ptr<void> owner)
+	: SGReferencedData(false), matrix(m), num_rows(nrows), num_cols(ncols),
+	gpu_ptr(nullptr), memory_owner(std::move(owner))
+{
+	m_on_gpu.store(false, std::memory_order_release);
+}
+
 template <class T>
 SGMatrix<T>::SGMatrix(T* m, index_t nrows, index_t ncols, index_t offset)
 	: SGReferencedData(false), matrix(m+offset),
@@ -55,6 +65,16 @@ SGMatrix<T>::SGMatrix(index_t nrows, index_t ncols, bool ref_counting)
 {
 	matrix=SG_ALIGNED_MALLOC(
 		T, ((int64_t) nrows)*ncols, alignment::container_alignment);
+	MemoryArena::count_heap_allocation(sizeof(T)*((int64_t) nrows)*ncols);
+	std::fill_n(matrix, ((int64_t) nrows)*ncols, 0);
+	m_on_gpu.store(false, std::memory_order_release);
+}
+
+template <class T>
+SGMatrix<T>::SGMatrix(index_t nrows, index_t ncols, MemoryArena& arena)
+	: SGReferencedData(false), num_rows(nrows), num_cols(ncols), gpu_ptr(nullptr)
+{
+	matrix=arena.allocate<T>(((int64_t) nrows)*ncols);
 	std::fill_n(matrix, ((int64_t) nrows)*ncols, 0);
 	m_on_gpu.store(false, std::memory_order_release);
 }
@@ -67,6 +87,7 @@ SGMatrix<T>::SGMatrix(SGVector<T> vec) : SGReferencedData(vec)
 	num_rows=vec.vlen;
 	num_cols=1;
 	gpu_ptr = vec.gpu_ptr;
+	memory_owner = vec.memory_owner;
 	m_on_gpu.store(vec.on_gpu(), std::memory_order_release);
 }
 
@@ -85,6 +106,7 @@ SGMatrix<T>::SGMatrix(SGVector<T> vec, index_t nrows, index_t ncols)
 	num_rows=nrows;
 	num_cols=ncols;
 	gpu_ptr = vec.gpu_ptr;
+	memory_owner = vec.memory_owner;
 	m_on_gpu.store(vec.on_gpu(), std::memory_order_release);
 }
 
@@ -889,6 +911,7 @@ void SGMatrix<T>::copy_data(const SGReferencedData &orig)
 	matrix=((SGMatrix*)(&orig))->matrix;
 	num_rows=((SGMatrix*)(&orig))->num_rows;
 	num_cols=((SGMatrix*)(&orig))->num_cols;
+	memory_owner=((SGMatrix*)(&orig))->memory_owner;
 	m_on_gpu.store(((SGMatrix*)(&orig))->m_on_gpu.load(
 		std::memory_order_acquire), std::memory_order_release);
 }
@@ -900,16 +923,19 @@ void SGMatrix<T>::init_data()
 	num_rows=0;
 	num_cols=0;
 	gpu_ptr=nullptr;
+	memory_owner=nullptr;
 	m_on_gpu.store(false, std::memory_order_release);
 }
 
 template<class T>
 void SGMatrix<T>::free_data()
 {
-	SG_FREE(matrix);
+	if (!memory_owner)
+		SG_FREE(matrix);
 	matrix=NULL;
 	num_rows=0;
 	num_cols=0;
+	memory_owner=nullptr;
 }
 
 template<class T>
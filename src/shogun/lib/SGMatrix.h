@@ -32,6 +32,7 @@ namespace shogun
 	template<class T> class SGVector;
 	template<typename T> struct GPUMemoryBase;
 	class CFile;
+	class MemoryArena;
 
 /** @brief shogun matrix */
 template<class T> class SGMatrix : public SGReferencedData
@@ -64,6 +65,13 @@ template<class T> class SGMatrix : public SGReferencedData
 		/** Constructor to create new matrix in memory */
 		SGMatrix(index_t nrows, index_t ncols, bool ref_counting=true);
 
+#ifndef SWIG
+		/** Constructor to create new matrix in an arena. The matrix is
+		 * not reference counted and must not be used after its memory was
+		 * released by the arena. */
+		SGMatrix(index_t nrows, index_t ncols, MemoryArena& arena);
+#endif
+
 		/**
 		 * Construct SGMatrix from GPU memory.
 		 *
@@ -132,6 +140,18 @@ template<class T> class SGMatrix : public SGReferencedData
 		/** Wraps a matrix around the data of an Eigen3 matrix */
 		SGMatrix(EigenMatrixXt& mat);
 
+		/** Wraps a matrix around memory that is kept alive by an owner,
+		 * e.g. a memory mapped file. The memory is not freed by the
+		 * matrix, the owner is released when the last copy is destroyed.
+		 *
+		 * @param m memory of nrows*ncols elements
+		 * @param nrows number of rows
+		 * @param ncols number of columns
+		 * @param owner owner of the memory
+		 */
+		SGMatrix(
+			T* m, index_t nrows, index_t ncols, std::shared_ptr<void> owner);
+
 		/** Wraps an Eigen3 matrix around the data of this matrix */
 		operator EigenMatrixXtMap() const;
 
@@ -505,6 +525,10 @@ template<class T> class SGMatrix : public SGReferencedData
 		index_t num_cols;
 		/** GPU Matrix structure. Stores pointer to the data on GPU. */
 		std::shared_ptr<GPUMemoryBase<T>> gpu_ptr;
+#ifndef SWIG
+		/** owner of memory that is not allocated by the matrix */
+		std::shared_ptr<void> memory_owner;
+#endif
 };
 }
 #endif // __SGMATRIX_H__
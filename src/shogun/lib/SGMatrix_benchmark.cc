@@ -6,6 +6,7 @@
 
 #include "shogun/mathematics/Math.h"
 #include <benchmark/benchmark.h>
+#include "shogun/lib/MemoryArena.h"
 #include "shogun/lib/SGMatrix.h"
 #include "shogun/mathematics/UniformIntDistribution.h"
 
@@ -52,7 +53,51 @@ void BM_SGMatrix_inverse(benchmark::State& state)
 	}
 }
 
+/** temporaries of a training iteration, e.g. of a layer pass */
+template <class F>
+static void allocate_temporaries(index_t dim, F&& new_matrix)
+{
+	for (index_t i = 0; i < 16; ++i)
+	{
+		SGMatrix<float64_t> activations = new_matrix(dim, 32);
+		SGVector<float64_t> column = activations.get_column(0);
+		benchmark::DoNotOptimize(column.vector);
+	}
+}
+
+void BM_SGMatrix_HeapTemporaries(benchmark::State& state)
+{
+	auto before = MemoryArena::counters().heap_allocations;
+	for (auto _ : state)
+	{
+		allocate_temporaries(state.range(0), [](index_t rows, index_t cols) {
+			return SGMatrix<float64_t>(rows, cols);
+		});
+	}
+	state.counters["heap_allocs"] =
+		(MemoryArena::counters().heap_allocations - before) /
+		(double)state.iterations();
+}
+
+void BM_SGMatrix_ArenaTemporaries(benchmark::State& state)
+{
+	auto before = MemoryArena::counters().heap_allocations;
+	for (auto _ : state)
+	{
+		ScopedArena scope;
+		allocate_temporaries(
+			state.range(0), [&scope](index_t rows, index_t cols) {
+				return SGMatrix<float64_t>(rows, cols, scope.arena());
+			});
+	}
+	state.counters["heap_allocs"] =
+		(MemoryArena::counters().heap_allocations - before) /
+		(double)state.iterations();
+}
+
 BENCHMARK(BM_SGMatrix_eigenvectors)->Range(8, 2048);
 BENCHMARK(BM_SGMatrix_inverse)->Range(8, 2048);
+BENCHMARK(BM_SGMatrix_HeapTemporaries)->Range(8, 1024);
+BENCHMARK(BM_SGMatrix_ArenaTemporaries)->Range(8, 1024);
 
 }
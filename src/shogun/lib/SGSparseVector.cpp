@@ -7,6 +7,7 @@
 
 #include <shogun/lib/SGSparseVector.h>
 #include <shogun/lib/SGVector.h>
+#include <shogun/lib/SparseKernels.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/io/File.h>
 
@@ -68,6 +69,17 @@ T SGSparseVector<T>::dense_dot(T alpha, T * vec, int32_t dim, T b)
 	return result;
 }
 
+template <>
+float64_t SGSparseVector<float64_t>::dense_dot(
+	float64_t alpha, float64_t* vec, int32_t dim, float64_t b)
+{
+	ASSERT(vec)
+	if (!features)
+		return b;
+
+	return b + alpha * sparse::dense_dot(features, num_feat_entries, vec, dim);
+}
+
 template <class T>
 void SGSparseVector<T>::add_to_dense(T alpha, T * vec, int32_t dim, bool abs_val)
 {
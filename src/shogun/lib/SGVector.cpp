@@ -11,6 +11,7 @@
 #include <shogun/lib/config.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/lib/SGSparseVector.h>
 #include <shogun/lib/SGReferencedData.h>
 #include <shogun/io/File.h>
@@ -89,6 +90,16 @@ SGVector<T>::SGVector(index_t len, bool ref_counting)
 : SGReferencedData(ref_counting), vlen(len), gpu_ptr(NULL)
 {
 	vector=SG_ALIGNED_MALLOC(T, len, alignment::container_alignment);
+	MemoryArena::count_heap_allocation(sizeof(T)*len);
+	std::fill_n(vector, len, 0);
+	m_on_gpu.store(false, std::memory_order_release);
+}
+
+template<class T>
+SGVector<T>::SGVector(index_t len, MemoryArena& arena)
+: SGReferencedData(false), vlen(len), gpu_ptr(NULL)
+{
+	vector=arena.allocate<T>(len);
 	std::fill_n(vector, len, 0);
 	m_on_gpu.store(false, std::memory_order_release);
 }
@@ -96,13 +107,21 @@ SGVector<T>::SGVector(index_t len, bool ref_counting)
 template <class T>
 SGVector<T>::SGVector(SGMatrix<T> matrix)
 	: SGReferencedData(matrix), vlen(matrix.num_cols * matrix.num_rows),
-	  gpu_ptr(NULL)
+	  gpu_ptr(NULL), memory_owner(matrix.memory_owner)
 {
 	ASSERT(!matrix.on_gpu())
 	vector = matrix.data();
 	m_on_gpu.store(false, std::memory_order_release);
 }
 
+template <class T>
+SGVector<T>::SGVector(T* v, index_t len, std::shared_ptr<void> owner)
+	: SGReferencedData(false), vector(v), vlen(len), gpu_ptr(NULL),
+	  memory_owner(std::move(owner))
+{
+	m_on_gpu.store(false, std::memory_order_release);
+}
+
 template <class T>
 SGVector<T>::SGVector(GPUMemoryBase<T>* gpu_vector, index_t len)
 	: SGReferencedData(true), vector(NULL), vlen(len),
@@ -294,6 +313,17 @@ template<class T>
 void SGVector<T>::resize_vector(int32_t n)
 {
 	assert_on_cpu();
+
+	// memory of another owner, e.g. a mapped file, can not be reallocated,
+	// hence the data is copied into a vector of its own
+	if (memory_owner)
+	{
+		SGVector<T> resized(n);
+		sg_memcpy(resized.vector, vector, sizeof(T)*CMath::min(vlen, n));
+		*this=resized;
+		return;
+	}
+
 	vector=SG_REALLOC(T, vector, vlen, n);
 
 	if (n > vlen)
@@ -371,6 +401,7 @@ void SGVector<T>::copy_data(const SGReferencedData &orig)
 	gpu_ptr=std::shared_ptr<GPUMemoryBase<T>>(((SGVector*)(&orig))->gpu_ptr);
 	vector=((SGVector*)(&orig))->vector;
 	vlen=((SGVector*)(&orig))->vlen;
+	memory_owner=((SGVector*)(&orig))->memory_owner;
 	m_on_gpu.store(((SGVector*)(&orig))->m_on_gpu.load(
 		std::memory_order_acquire), std::memory_order_release);
 }
@@ -381,16 +412,19 @@ void SGVector<T>::init_data()
 	vector=NULL;
 	vlen=0;
 	gpu_ptr=NULL;
+	memory_owner=nullptr;
 	m_on_gpu.store(false, std::memory_order_release);
 }
 
 template<class T>
 void SGVector<T>::free_data()
 {
-	SG_FREE(vector);
+	if (!memory_owner)
+		SG_FREE(vector);
 	vector=NULL;
 	vlen=0;
 	gpu_ptr=NULL;
+	memory_owner=nullptr;
 }
 
 template <class T>
@@ -36,6 +36,7 @@ namespace shogun
 	template <class T> class SGSparseVector;
 	template <class T> class SGMatrix;
 	class CFile;
+	class MemoryArena;
 
 /** @brief shogun vector */
 template<class T> class SGVector : public SGReferencedData
@@ -67,6 +68,13 @@ template<class T> class SGVector : public SGReferencedData
 		/** Constructor to create new vector in memory */
 		SGVector(index_t len, bool ref_counting=true);
 
+#ifndef SWIG
+		/** Constructor to create new vector in an arena. The vector is
+		 * not reference counted and must not be used after its memory was
+		 * released by the arena. */
+		SGVector(index_t len, MemoryArena& arena);
+#endif
+
 		/** Constructor to create new vector from a SGMatrix */
 		SGVector(SGMatrix<T> matrix);
 
@@ -113,6 +121,16 @@ template<class T> class SGVector : public SGReferencedData
 		/** Construct SGVector from initializer list */
 		SGVector(std::initializer_list<T> il);
 
+		/** Wraps a vector around memory that is kept alive by an owner,
+		 * e.g. a memory mapped file. The memory is not freed by the
+		 * vector, the owner is released when the last copy is destroyed.
+		 *
+		 * @param v memory of len elements
+		 * @param len number of elements
+		 * @param owner owner of the memory
+		 */
+		SGVector(T* v, index_t len, std::shared_ptr<void> owner);
+
 		/** Wraps a matrix around the data of an Eigen3 column vector */
 		SGVector(EigenVectorXt& vec);
 
@@ -610,6 +628,10 @@ template<class T> class SGVector : public SGReferencedData
 		index_t vlen;
 		/** GPU Vector structure. Stores pointer to the data on GPU. */
 		std::shared_ptr<GPUMemoryBase<T>> gpu_ptr;
+#ifndef SWIG
+		/** owner of memory that is not allocated by the vector */
+		std::shared_ptr<void> memory_owner;
+#endif
 };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -0,0 +1,128 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+#ifndef __SPSCQUEUE_H__
+#define __SPSCQUEUE_H__
+
+#include <shogun/lib/config.h>
+#include <shogun/lib/cpu.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace shogun
+{
+/** @brief Bounded lock-free queue of one producer and one consumer thread.
+ *
+ * The producer only writes the tail and the consumer only writes the head,
+ * hence an element is handed over with one release store and no lock.
+ * Waiting for a free or a filled slot spins shortly and sleeps afterwards,
+ * so that a blocked thread does not occupy a core.
+ */
+template <class T>
+class SPSCQueue
+{
+public:
+	/** constructor
+	 *
+	 * @param capacity maximum number of queued elements
+	 */
+	explicit SPSCQueue(size_t capacity)
+	    : m_slots(capacity + 1), m_head(0), m_tail(0)
+	{
+	}
+
+	SPSCQueue(const SPSCQueue&) = delete;
+	SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+	/** append an element if there is space, called by the producer
+	 *
+	 * @param value element, moved from on success
+	 * @return whether the element was appended
+	 */
+	bool try_push(T& value)
+	{
+		auto tail = m_tail.load(std::memory_order_relaxed);
+		auto next = tail + 1 == m_slots.size() ? 0 : tail + 1;
+		if (next == m_head.load(std::memory_order_acquire))
+			return false;
+
+		m_slots[tail] = std::move(value);
+		m_tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/** remove the first element if there is one, called by the consumer
+	 *
+	 * @param value first element
+	 * @return whether there was an element
+	 */
+	bool try_pop(T& value)
+	{
+		auto head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		value = std::move(m_slots[head]);
+		m_head.store(
+		    head + 1 == m_slots.size() ? 0 : head + 1,
+		    std::memory_order_release);
+		return true;
+	}
+
+	/** append an element, waiting for space
+	 *
+	 * @param value element
+	 * @param cancel flag that stops waiting when set
+	 * @return whether the element was appended before cancel was set
+	 */
+	bool push(T& value, const std::atomic<bool>& cancel)
+	{
+		return wait([&]() { return try_push(value); }, cancel);
+	}
+
+	/** remove the first element, waiting for one
+	 *
+	 * @param value first element
+	 * @param cancel flag that stops waiting when set
+	 * @return whether there was an element before cancel was set
+	 */
+	bool pop(T& value, const std::atomic<bool>& cancel)
+	{
+		return wait([&]() { return try_pop(value); }, cancel);
+	}
+
+private:
+	template <class F>
+	static bool wait(F&& done, const std::atomic<bool>& cancel)
+	{
+		for (int32_t i = 0; !done(); ++i)
+		{
+			if (cancel.load(std::memory_order_acquire))
+				return false;
+
+			if (i < 64)
+				CpuRelax();
+			else if (i < 128)
+				std::this_thread::yield();
+			else
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+		return true;
+	}
+
+private:
+	/** ring of elements, one slot stays free to tell full from empty */
+	std::vector<T> m_slots;
+	/** index of the first element, written by the consumer */
+	alignas(64) std::atomic<size_t> m_head;
+	/** index past the last element, written by the producer */
+	alignas(64) std::atomic<size_t> m_tail;
+};
+}
+#endif // __SPSCQUEUE_H__
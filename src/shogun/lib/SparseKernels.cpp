@@ -0,0 +1,244 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/lib/SparseKernels.h>
+#include <shogun/lib/cpu.h>
+
+#include <cstddef>
+
+#ifdef SG_CPU_DISPATCH
+#include <immintrin.h>
+#endif
+
+using namespace shogun;
+
+namespace
+{
+typedef SGSparseVectorEntry<float64_t> Entry;
+
+// the kernels load the index and the entry of consecutive entries from
+// 16 byte records
+static_assert(sizeof(Entry) == 16, "unexpected sparse entry layout");
+static_assert(offsetof(Entry, entry) == 8, "unexpected sparse entry layout");
+
+/** number of outputs that dense_product() accumulates in registers */
+constexpr int32_t output_block = 16;
+
+float64_t dense_dot_scalar(
+    const Entry* entries, int32_t begin, int32_t end, const float64_t* vec,
+    int32_t dim)
+{
+	float64_t result = 0;
+	for (int32_t i = begin; i < end; i++)
+	{
+		if (entries[i].feat_index < dim)
+			result += vec[entries[i].feat_index] * entries[i].entry;
+	}
+	return result;
+}
+
+void dense_product_scalar(
+    const Entry* entries, int32_t num_entries, const float64_t* weights,
+    int32_t num_outputs, int32_t dim, int32_t begin, float64_t* out)
+{
+	for (int32_t k = begin; k < num_outputs; k++)
+		out[k] = 0;
+
+	for (int32_t i = 0; i < num_entries; i++)
+	{
+		if (entries[i].feat_index >= dim)
+			continue;
+		auto column = weights + int64_t(entries[i].feat_index) * num_outputs;
+		for (int32_t k = begin; k < num_outputs; k++)
+			out[k] += entries[i].entry * column[k];
+	}
+}
+
+#ifdef SG_CPU_DISPATCH
+__attribute__((target("avx2,fma"))) float64_t dense_dot_avx2(
+    const Entry* entries, int32_t num_entries, const float64_t* vec,
+    int32_t dim)
+{
+	const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+	const __m128i limit = _mm_set1_epi32(dim);
+	__m256d acc = _mm256_setzero_pd();
+
+	int32_t i = 0;
+	for (; i + 4 <= num_entries; i += 4)
+	{
+		// two entries per load, split into indices and values
+		auto a = _mm256_loadu_pd((const double*)(entries + i));
+		auto b = _mm256_loadu_pd((const double*)(entries + i + 2));
+		auto values = _mm256_unpackhi_pd(a, b);
+		auto index = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(
+		    _mm256_castpd_si256(_mm256_unpacklo_pd(a, b)), even));
+
+		auto mask = _mm256_castsi256_pd(
+		    _mm256_cvtepi32_epi64(_mm_cmpgt_epi32(limit, index)));
+		auto x = _mm256_mask_i32gather_pd(
+		    _mm256_setzero_pd(), vec, index, mask, 8);
+		acc = _mm256_fmadd_pd(x, values, acc);
+	}
+
+	auto sum = _mm_add_pd(
+	    _mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+	sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+	return _mm_cvtsd_f64(sum) +
+	       dense_dot_scalar(entries, i, num_entries, vec, dim);
+}
+
+__attribute__((target("avx512f"))) float64_t dense_dot_avx512(
+    const Entry* entries, int32_t num_entries, const float64_t* vec,
+    int32_t dim)
+{
+	const __m256i limit = _mm256_set1_epi32(dim);
+	__m512d acc = _mm512_setzero_pd();
+
+	int32_t i = 0;
+	for (; i + 8 <= num_entries; i += 8)
+	{
+		auto a = _mm512_loadu_pd((const double*)(entries + i));
+		auto b = _mm512_loadu_pd((const double*)(entries + i + 4));
+		auto values = _mm512_unpackhi_pd(a, b);
+		// the low half of every 64 bit lane is the index
+		auto index = _mm512_cvtepi64_epi32(
+		    _mm512_castpd_si512(_mm512_unpacklo_pd(a, b)));
+
+		__mmask8 mask = _mm256_movemask_ps(
+		    _mm256_castsi256_ps(_mm256_cmpgt_epi32(limit, index)));
+		auto x = _mm512_mask_i32gather_pd(
+		    _mm512_setzero_pd(), mask, index, vec, 8);
+		acc = _mm512_fmadd_pd(x, values, acc);
+	}
+
+	return _mm512_reduce_add_pd(acc) +
+	       dense_dot_scalar(entries, i, num_entries, vec, dim);
+}
+
+__attribute__((target("avx2,fma"))) void dense_product_avx2(
+    const Entry* entries, int32_t num_entries, const float64_t* weights,
+    int32_t num_outputs, int32_t dim, float64_t* out)
+{
+	int32_t k = 0;
+	for (; k + output_block <= num_outputs; k += output_block)
+	{
+		__m256d acc[output_block / 4];
+		for (auto& a : acc)
+			a = _mm256_setzero_pd();
+
+		for (int32_t i = 0; i < num_entries; i++)
+		{
+			if (entries[i].feat_index >= dim)
+				continue;
+			auto x = _mm256_set1_pd(entries[i].entry);
+			auto column =
+			    weights + int64_t(entries[i].feat_index) * num_outputs + k;
+			for (int32_t j = 0; j < output_block / 4; j++)
+				acc[j] = _mm256_fmadd_pd(
+				    x, _mm256_loadu_pd(column + 4 * j), acc[j]);
+		}
+
+		for (int32_t j = 0; j < output_block / 4; j++)
+			_mm256_storeu_pd(out + k + 4 * j, acc[j]);
+	}
+
+	if (k < num_outputs)
+		dense_product_scalar(
+		    entries, num_entries, weights, num_outputs, dim, k, out);
+}
+
+__attribute__((target("avx512f"))) void dense_product_avx512(
+    const Entry* entries, int32_t num_entries, const float64_t* weights,
+    int32_t num_outputs, int32_t dim, float64_t* out)
+{
+	int32_t k = 0;
+	for (; k + output_block <= num_outputs; k += output_block)
+	{
+		__m512d acc[output_block / 8];
+		for (auto& a : acc)
+			a = _mm512_setzero_pd();
+
+		for (int32_t i = 0; i < num_entries; i++)
+		{
+			if (entries[i].feat_index >= dim)
+				continue;
+			auto x = _mm512_set1_pd(entries[i].entry);
+			auto column =
+			    weights + int64_t(entries[i].feat_index) * num_outputs + k;
+			for (int32_t j = 0; j < output_block / 8; j++)
+				acc[j] = _mm512_fmadd_pd(
+				    x, _mm512_loadu_pd(column + 8 * j), acc[j]);
+		}
+
+		for (int32_t j = 0; j < output_block / 8; j++)
+			_mm512_storeu_pd(out + k + 8 * j, acc[j]);
+	}
+
+	if (k < num_outputs)
+		dense_product_scalar(
+		    entries, num_entries, weights, num_outputs, dim, k, out);
+}
+#endif // SG_CPU_DISPATCH
+
+float64_t dense_dot_generic(
+    const Entry* entries, int32_t num_entries, const float64_t* vec,
+    int32_t dim)
+{
+	return dense_dot_scalar(entries, 0, num_entries, vec, dim);
+}
+
+void dense_product_generic(
+    const Entry* entries, int32_t num_entries, const float64_t* weights,
+    int32_t num_outputs, int32_t dim, float64_t* out)
+{
+	dense_product_scalar(
+	    entries, num_entries, weights, num_outputs, dim, 0, out);
+}
+
+typedef float64_t (*dense_dot_t)(
+    const Entry*, int32_t, const float64_t*, int32_t);
+typedef void (*dense_product_t)(
+    const Entry*, int32_t, const float64_t*, int32_t, int32_t, float64_t*);
+
+dense_dot_t select_dense_dot()
+{
+#ifdef SG_CPU_DISPATCH
+	if (CpuHasAVX512F())
+		return dense_dot_avx512;
+	if (CpuHasAVX2())
+		return dense_dot_avx2;
+#endif
+	return dense_dot_generic;
+}
+
+dense_product_t select_dense_product()
+{
+#ifdef SG_CPU_DISPATCH
+	if (CpuHasAVX512F())
+		return dense_product_avx512;
+	if (CpuHasAVX2())
+		return dense_product_avx2;
+#endif
+	return dense_product_generic;
+}
+} // namespace
+
+float64_t sparse::dense_dot(
+    const SGSparseVectorEntry<float64_t>* entries, int32_t num_entries,
+    const float64_t* vec, int32_t dim)
+{
+	static const dense_dot_t kernel = select_dense_dot();
+	return kernel(entries, num_entries, vec, dim);
+}
+
+void sparse::dense_product(
+    const SGSparseVectorEntry<float64_t>* entries, int32_t num_entries,
+    const float64_t* weights, int32_t num_outputs, int32_t dim,
+    float64_t* out)
+{
+	static const dense_product_t kernel = select_dense_product();
+	kernel(entries, num_entries, weights, num_outputs, dim, out);
+}
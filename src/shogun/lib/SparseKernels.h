@@ -0,0 +1,54 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef __SPARSEKERNELS_H__
+#define __SPARSEKERNELS_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/SGSparseVector.h>
+#include <shogun/lib/common.h>
+
+namespace shogun
+{
+/** Inner loops of products with sparse vectors of float64_t entries.
+ *
+ * The kernels gather the dense elements with AVX-512 or AVX2 instructions
+ * if the CPU supports them, which is detected once at runtime, and fall
+ * back to scalar loops otherwise. Entries whose index is not below the
+ * dimension of the dense operand are ignored.
+ */
+namespace sparse
+{
+	/** dot product of a sparse and a dense vector
+	 *
+	 * @param entries entries of the sparse vector
+	 * @param num_entries number of entries
+	 * @param vec dense vector
+	 * @param dim length of the dense vector
+	 * @return dot product
+	 */
+	float64_t dense_dot(
+	    const SGSparseVectorEntry<float64_t>* entries, int32_t num_entries,
+	    const float64_t* vec, int32_t dim);
+
+	/** product of a dense matrix and a sparse vector, out=weights*x
+	 *
+	 * @param entries entries of the sparse vector x
+	 * @param num_entries number of entries
+	 * @param weights column major num_outputs x dim matrix, column j holds
+	 * the weights of feature j
+	 * @param num_outputs number of rows of weights
+	 * @param dim number of columns of weights
+	 * @param out vector of num_outputs elements, overwritten
+	 */
+	void dense_product(
+	    const SGSparseVectorEntry<float64_t>* entries, int32_t num_entries,
+	    const float64_t* weights, int32_t num_outputs, int32_t dim,
+	    float64_t* out);
+} // namespace sparse
+} // namespace shogun
+#endif // __SPARSEKERNELS_H__
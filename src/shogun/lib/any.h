@@ -13,6 +13,7 @@
 #include <cassert>
 #include <limits>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <stdexcept>
 #include <string.h>
@@ -31,6 +32,19 @@ namespace shogun {
 	namespace any_detail
 	{
 		std::string demangled_type_helper(const char *name);
+
+		/** whether vectors and matrices of T can be visited as raw
+		 * memory, i.e. T is a primitive type with a fixed layout */
+		template <class T>
+		struct is_block_element
+			: std::integral_constant<
+				bool,
+				(std::is_arithmetic<T>::value &&
+					!std::is_same<T, bool>::value &&
+					!std::is_same<T, floatmax_t>::value) ||
+					std::is_same<T, complex128_t>::value>
+		{
+		};
 	}
 
 	/** Converts compiler-dependent name of class to
@@ -162,11 +176,40 @@ namespace shogun {
 		}
 	};
 
+	/** Contiguous elements of a vector or a matrix of a primitive type,
+	 * which a visitor may visit at once instead of element by element.
+	 */
+	struct ArrayBlock
+	{
+		/** number of elements */
+		int64_t length;
+		/** size of an element in bytes */
+		size_t element_size;
+		/** elements, which are allocated first when they are read */
+		std::function<void*()> data;
+		/** let the container use memory that is kept alive by an owner
+		 * instead of its own, empty if the container can not share memory
+		 */
+		std::function<void(void*, std::shared_ptr<void>)> share;
+	};
+
 	class AnyVisitor
 	{
 	public:
 		virtual ~AnyVisitor() = default;
 
+		/** Visit all elements of a vector or a matrix at once. Called
+		 * after enter_vector() or enter_matrix() for primitive types.
+		 *
+		 * @param block elements
+		 * @return whether the elements were visited, otherwise they are
+		 * visited one by one
+		 */
+		virtual bool on_array(ArrayBlock* block)
+		{
+			return false;
+		}
+
 		virtual void on(bool*) = 0;
 		virtual void on(char*) = 0;
 		virtual void on(int8_t*) = 0;
@@ -210,6 +253,24 @@ namespace shogun {
 		{
 			auto size = _v->vlen;
 			enter_vector(std::addressof(size));
+			if constexpr (any_detail::is_block_element<T>::value)
+			{
+				ArrayBlock block{size, sizeof(T)};
+				block.data = [_v, size]() {
+					if (size != _v->vlen)
+						_v->resize_vector(size);
+					return (void*)_v->vector;
+				};
+				block.share = [_v, size](
+					void* data, std::shared_ptr<void> owner) {
+					*_v = SGVector<T>((T*)data, size, std::move(owner));
+				};
+				if (on_array(std::addressof(block)))
+				{
+					exit_vector(std::addressof(size));
+					return;
+				}
+			}
 			if (size != _v->vlen)
 				_v->resize_vector(size);
 			for (auto& _value: *_v)
@@ -258,6 +319,16 @@ namespace shogun {
 					*_v->ptr() = SG_CALLOC(T, size);
 			}
 			auto ptr = *(_v->ptr());
+			if constexpr (any_detail::is_block_element<T>::value)
+			{
+				ArrayBlock block{(int64_t)size, sizeof(T)};
+				block.data = [ptr]() { return (void*)ptr; };
+				if (on_array(std::addressof(block)))
+				{
+					exit_vector(std::addressof(size));
+					return;
+				}
+			}
 			for (S i = 0; i < size; ++i)
 				on(std::addressof(ptr[i]));
 			exit_vector(std::addressof(size));
@@ -279,6 +350,16 @@ namespace shogun {
 					*_v->ptr() = SG_MALLOC(T, length);
 			}
 			auto ptr = *(_v->ptr());
+			if constexpr (any_detail::is_block_element<T>::value)
+			{
+				ArrayBlock block{length, sizeof(T)};
+				block.data = [ptr]() { return (void*)ptr; };
+				if (on_array(std::addressof(block)))
+				{
+					exit_matrix(shape.first, shape.second);
+					return;
+				}
+			}
 			for (int64_t i = 0; i < length; ++i)
 				on(std::addressof(ptr[i]));
 			exit_matrix(shape.first, shape.second);
@@ -290,6 +371,26 @@ namespace shogun {
 			auto rows = _matrix->num_rows;
 			auto cols = _matrix->num_cols;
 			enter_matrix(std::addressof(rows), std::addressof(cols));
+			if constexpr (any_detail::is_block_element<T>::value)
+			{
+				ArrayBlock block{int64_t(rows) * cols, sizeof(T)};
+				block.data = [_matrix, rows, cols]() {
+					if ((rows != _matrix->num_rows) ||
+						(cols != _matrix->num_cols))
+						*_matrix = SGMatrix<T>(rows, cols);
+					return (void*)_matrix->matrix;
+				};
+				block.share = [_matrix, rows, cols](
+					void* data, std::shared_ptr<void> owner) {
+					*_matrix =
+						SGMatrix<T>((T*)data, rows, cols, std::move(owner));
+				};
+				if (on_array(std::addressof(block)))
+				{
+					exit_matrix(std::addressof(rows), std::addressof(cols));
+					return;
+				}
+			}
 			if ((rows != _matrix->num_rows) || (cols != _matrix->num_cols))
 				*_matrix = SGMatrix<T>(rows, cols);
 			for (auto index=0; index < cols; index++) {
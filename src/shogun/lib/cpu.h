@@ -56,4 +56,34 @@ SG_FORCED_INLINE static void CpuRelax()
 #endif
 }
 
+#if (defined(__GNUC__) || defined(__clang__)) && \
+	(defined(__i386__) || defined(__x86_64__))
+/** SIMD kernels for instruction sets beyond the compiler flags can be
+ * compiled with the target attribute and are chosen at runtime */
+#define SG_CPU_DISPATCH
+#endif
+
+/** @return whether the CPU supports AVX2 and FMA */
+static inline bool CpuHasAVX2()
+{
+#ifdef SG_CPU_DISPATCH
+	static const bool supported =
+		__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	return supported;
+#else
+	return false;
+#endif
+}
+
+/** @return whether the CPU supports AVX-512 Foundation */
+static inline bool CpuHasAVX512F()
+{
+#ifdef SG_CPU_DISPATCH
+	static const bool supported = __builtin_cpu_supports("avx512f");
+	return supported;
+#else
+	return false;
+#endif
+}
+
 #endif /* __CPU_INFO_H__ */
@@ -210,6 +210,8 @@ public:
 	virtual Qfloat *get_Q(int32_t column, int32_t len) const = 0;
 	virtual Qfloat *get_QD() const = 0;
 	virtual void swap_index(int32_t i, int32_t j) const = 0;
+	// hint that column will be needed after the one that is computed next
+	virtual void prefetch_Q(int32_t column) const {}
 	virtual ~QMatrix() {}
 
 	float64_t max_train_time;
@@ -230,6 +232,13 @@ public:
 		if(x_square) CMath::swap(x_square[i],x_square[j]);
 	}
 
+	virtual void prefetch_Q(int32_t column) const
+	{
+		// a kernel on slow storage loads the row in the background while
+		// the current one is computed
+		kernel->prefetch_rows(&x[column]->index, 1);
+	}
+
 	void compute_Q_parallel(Qfloat* data, float64_t* lab, int32_t i, int32_t start, int32_t len) const
 	{
 		if (lab) // two class
@@ -547,6 +556,7 @@ void Solver::Solve(
 
 		// update alpha[i] and alpha[j], handle bounds carefully
 
+		Q->prefetch_Q(j);
 		const Qfloat *Q_i = Q->get_Q(i,active_size);
 		const Qfloat *Q_j = Q->get_Q(j,active_size);
 
@@ -1084,6 +1094,8 @@ int32_t Solver_NU::select_working_set(
 	int32_t in = Gmaxn_idx;
 	const Qfloat *Q_ip = NULL;
 	const Qfloat *Q_in = NULL;
+	if(ip != -1 && in != -1)
+		Q->prefetch_Q(in);
 	if(ip != -1) // NULL Q_ip not accessed: Gmaxp=-INF if ip=-1
 		Q_ip = Q->get_Q(ip,active_size);
 	if(in != -1)
@@ -1785,6 +1797,11 @@ public:
 		CMath::swap(QD[i],QD[j]);
 	}
 
+	void prefetch_Q(int32_t column) const
+	{
+		LibSVMKernel::prefetch_Q(index[column]);
+	}
+
 	Qfloat *get_Q(int32_t i, int32_t len) const
 	{
 		Qfloat *data;
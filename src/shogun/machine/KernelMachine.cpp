@@ -7,7 +7,9 @@
  */
 
 #include <rxcpp/rx-lite.hpp>
+#include <shogun/base/ThreadPool.h>
 #include <shogun/base/progress.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/kernel/CustomKernel.h>
 #include <shogun/kernel/Kernel.h>
@@ -15,11 +17,6 @@
 #include <shogun/labels/RegressionLabels.h>
 #include <shogun/machine/KernelMachine.h>
 
-#ifdef HAVE_OPENMP
-#include <omp.h>
-
-#endif
-
 using namespace shogun;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -329,32 +326,26 @@ SGVector<float64_t> CKernelMachine::apply_get_outputs(CFeatures* data)
 				output[i] = get_bias() + output[i];
 
 		}
+		else if (
+		    get_num_support_vectors() > 0 &&
+		    !(kernel->has_property(KP_LINADD) &&
+		      kernel->get_is_initialized()) &&
+		    kernel->has_dense_dot_transform())
+		{
+			SG_DEBUG("Scoring dense features tile by tile")
+			SGVector<float64_t> alphas(
+			    m_alpha.vector, get_num_support_vectors(), false);
+			output = kernel->compute_weighted_sums_dense(
+			    pack_support_vectors(), m_svs, alphas);
+
+			for (int32_t i = 0; i < num_vectors; i++)
+				output[i] += get_bias();
+		}
 		else
 		{
 			auto pb = SG_PROGRESS(range(num_vectors));
-			int32_t num_threads;
-			int64_t step;
-#pragma omp parallel shared(num_threads, step)
-			{
-
-#ifdef HAVE_OPENMP
-#pragma omp single
-				{
-					num_threads = omp_get_num_threads();
-					step = num_vectors / num_threads;
-					num_threads--;
-				}
-				int32_t thread_num = omp_get_thread_num();
-#else
-				num_threads = 0;
-				step = num_vectors;
-				int32_t thread_num = 0;
-#endif
-				int32_t start = thread_num * step;
-				int32_t end = (thread_num == num_threads)
-				                  ? num_vectors
-				                  : (thread_num + 1) * step;
-
+			env()->get_thread_pool()->parallel_for(
+			    0, num_vectors, [&](index_t start, index_t end) {
 				for (int32_t vec = start; vec < end; vec++)
 				{
 					COMPUTATION_CONTROLLERS
@@ -377,7 +368,7 @@ SGVector<float64_t> CKernelMachine::apply_get_outputs(CFeatures* data)
 						output[vec] = score + get_bias();
 					}
 				}
-			}
+			    });
 			pb.complete();
 		}
 	}
@@ -388,6 +379,25 @@ SGVector<float64_t> CKernelMachine::apply_get_outputs(CFeatures* data)
 	return output;
 }
 
+SGMatrix<float64_t> CKernelMachine::pack_support_vectors()
+{
+	auto feats=(CDenseFeatures<float64_t>*) kernel->get_lhs();
+	int32_t num_sv=get_num_support_vectors();
+	int32_t dim=feats->get_num_features();
+
+	SGMatrix<float64_t> packed_svs(dim, num_sv);
+	for (int32_t i=0; i<num_sv; i++)
+	{
+		SGVector<float64_t> vec=feats->get_feature_vector(get_support_vector(i));
+		sg_memcpy(packed_svs.get_column_vector(i), vec.vector,
+				sizeof(float64_t)*dim);
+		feats->free_feature_vector(vec, get_support_vector(i));
+	}
+
+	SG_UNREF(feats);
+	return packed_svs;
+}
+
 void CKernelMachine::store_model_features()
 {
 	if (!kernel)
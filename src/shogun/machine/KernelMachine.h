@@ -243,6 +243,14 @@ class CKernelMachine : public CMachine
 		/** register parameters and do misc init */
 		void init();
 
+		/** pack the features of the support vectors into the columns of a
+		 * matrix. They are gathered on every call, as the lhs features, their
+		 * subsets and their values may change between two applies.
+		 *
+		 * @return features of the support vectors
+		 */
+		SGMatrix<float64_t> pack_support_vectors();
+
 	protected:
 		/** kernel */
 		CKernel* kernel;
@@ -0,0 +1,113 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/features/DenseFeatures.h"
+#include "shogun/kernel/GaussianKernel.h"
+#include "shogun/labels/RegressionLabels.h"
+#include "shogun/machine/KernelMachine.h"
+
+#include <memory>
+#include <random>
+
+namespace shogun
+{
+
+class KernelMachineFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		std::mt19937_64 prng(17);
+		std::normal_distribution<float64_t> dist;
+
+		const index_t num_sv = st.range(0);
+		SGMatrix<float64_t> sv_data(dim, num_sv);
+		SGMatrix<float64_t> test_data(dim, num_test);
+		for (index_t i = 0; i < dim * num_sv; i++)
+			sv_data[i] = dist(prng);
+		for (index_t i = 0; i < dim * num_test; i++)
+			test_data[i] = dist(prng);
+
+		svs = new CDenseFeatures<float64_t>(sv_data);
+		test = new CDenseFeatures<float64_t>(test_data);
+		SG_REF(svs);
+		SG_REF(test);
+
+		kernel = new CGaussianKernel(10, 2.0);
+		kernel->init(svs, svs);
+
+		SGVector<int32_t> sv_idx(num_sv);
+		SGVector<float64_t> alphas(num_sv);
+		sv_idx.range_fill();
+		for (index_t i = 0; i < num_sv; i++)
+			alphas[i] = dist(prng);
+
+		machine = std::make_shared<CKernelMachine>();
+		machine->set_kernel(kernel);
+		machine->set_support_vectors(sv_idx);
+		machine->set_alphas(alphas);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		machine.reset();
+		SG_UNREF(svs);
+		SG_UNREF(test);
+	}
+
+	static constexpr index_t dim = 16;
+	static constexpr index_t num_test = 2000;
+	CDenseFeatures<float64_t>* svs;
+	CDenseFeatures<float64_t>* test;
+	CGaussianKernel* kernel;
+	std::shared_ptr<CKernelMachine> machine;
+};
+
+/* tiled scoring of packed support vectors */
+BENCHMARK_DEFINE_F(KernelMachineFixture, apply)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto outputs = machine->apply_regression(test);
+		benchmark::DoNotOptimize(outputs->get_labels().vector);
+		SG_UNREF(outputs);
+	}
+	st.SetItemsProcessed(st.iterations() * num_test);
+}
+
+/* one kernel evaluation per support vector and test vector, as done before */
+BENCHMARK_DEFINE_F(KernelMachineFixture, apply_elementwise)
+(benchmark::State& st)
+{
+	kernel->init(svs, test);
+	SGVector<float64_t> outputs(num_test);
+	for (auto _ : st)
+	{
+		for (index_t j = 0; j < num_test; j++)
+		{
+			float64_t score = 0;
+			for (index_t i = 0; i < machine->get_num_support_vectors(); i++)
+				score += machine->get_alpha(i) * kernel->kernel(i, j);
+			outputs[j] = score;
+		}
+		benchmark::DoNotOptimize(outputs.vector);
+	}
+	st.SetItemsProcessed(st.iterations() * num_test);
+}
+
+BENCHMARK_REGISTER_F(KernelMachineFixture, apply)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(KernelMachineFixture, apply_elementwise)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+}
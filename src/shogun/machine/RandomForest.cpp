@@ -84,6 +84,7 @@ CRandomForest::CRandomForest(CFeatures* features, CLabels* labels, SGVector<floa
 
 CRandomForest::~CRandomForest()
 {
+	SG_UNREF(m_flat_trees);
 }
 
 void CRandomForest::set_machine(CMachine* machine)
@@ -139,6 +140,44 @@ int32_t CRandomForest::get_num_random_features() const
 	return dynamic_cast<CRandomCARTree*>(m_machine)->get_feature_subset_size();
 }
 
+void CRandomForest::set_num_bins(int32_t bins)
+{
+	require(m_machine,"m_machine is NULL. It is expected to be RandomCARTree");
+	dynamic_cast<CRandomCARTree*>(m_machine)->set_num_bins(bins);
+}
+
+int32_t CRandomForest::get_num_bins() const
+{
+	require(m_machine,"m_machine is NULL. It is expected to be RandomCARTree");
+	return dynamic_cast<CRandomCARTree*>(m_machine)->get_num_bins();
+}
+
+void CRandomForest::compile_trees()
+{
+	require(m_bags->get_num_elements()==m_num_bags, "Forest is not trained");
+
+	auto flat_trees=new CFlatTreeEnsemble();
+	for (index_t i=0;i<m_num_bags;i++)
+	{
+		CSGObject* element=m_bags->get_element(i);
+		flat_trees->add_tree(element->as<CCARTree>());
+		SG_UNREF(element);
+	}
+
+	SG_REF(flat_trees);
+	SG_UNREF(m_flat_trees);
+	m_flat_trees=flat_trees;
+}
+
+SGMatrix<float64_t> CRandomForest::apply_outputs_without_combination(CFeatures* data)
+{
+	require(data, "Data required for apply");
+	if (!m_flat_trees)
+		compile_trees();
+
+	return m_flat_trees->apply(data->as<CDenseFeatures<float64_t>>());
+}
+
 void CRandomForest::set_machine_parameters(CMachine* m, SGVector<index_t> idx)
 {
 	require(m,"Machine supplied is NULL");
@@ -159,7 +198,10 @@ void CRandomForest::set_machine_parameters(CMachine* m, SGVector<index_t> idx)
 	}
 
 	tree->set_weights(weights);
-	tree->set_sorted_features(m_sorted_transposed_feats, m_sorted_indices);
+	if (tree->get_num_bins()>0)
+		tree->set_binned_features(m_bins, m_bin_edges);
+	else
+		tree->set_sorted_features(m_sorted_transposed_feats, m_sorted_indices);
 	// equate the machine problem types - cloning does not do this
 	tree->set_machine_problem_type(dynamic_cast<CRandomCARTree*>(m_machine)->get_machine_problem_type());
 }
@@ -175,9 +217,19 @@ bool CRandomForest::train_machine(CFeatures* data)
 	
 	require(m_features, "Training features not set!");
 	
-	dynamic_cast<CRandomCARTree*>(m_machine)->pre_sort_features(m_features, m_sorted_transposed_feats, m_sorted_indices);
+	auto tree=dynamic_cast<CRandomCARTree*>(m_machine);
+	if (tree->get_num_bins()>0)
+		tree->pre_bin_features(m_features, m_bins, m_bin_edges);
+	else
+		tree->pre_sort_features(m_features, m_sorted_transposed_feats, m_sorted_indices);
+
+	SG_UNREF(m_flat_trees);
+	m_flat_trees=NULL;
+	if (!CBaggingMachine::train_machine())
+		return false;
 
-	return CBaggingMachine::train_machine();
+	compile_trees();
+	return true;
 }
 
 void CRandomForest::init()
@@ -185,6 +237,7 @@ void CRandomForest::init()
 	m_machine=new CRandomCARTree();
 	SG_REF(m_machine);
 	m_weights=SGVector<float64_t>();
+	m_flat_trees=NULL;
 
 	SG_ADD(&m_weights,"m_weights","weights");
 }
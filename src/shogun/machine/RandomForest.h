@@ -33,6 +33,7 @@
 
 #include <shogun/lib/config.h>
 #include <shogun/machine/BaggingMachine.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
 
 namespace shogun
 {
@@ -138,6 +139,23 @@ public:
 	 */
 	int32_t get_num_random_features() const;
 
+	/** set number of histogram bins per feature used to find the splits
+	 *
+	 * @param bins number of bins, 0 for splits on the exact values
+	 */
+	void set_num_bins(int32_t bins);
+
+	/** get number of histogram bins per feature used to find the splits
+	 *
+	 * @return number of bins, 0 for splits on the exact values
+	 */
+	int32_t get_num_bins() const;
+
+	/** compile the trained trees into contiguous node arrays used by apply.
+	 * Done by train, needed only after the trees were loaded or cloned.
+	 */
+	void compile_trees();
+
 protected:
 
 	virtual bool train_machine(CFeatures* data=NULL);
@@ -148,6 +166,13 @@ protected:
 	 */
 	virtual void set_machine_parameters(CMachine* m, SGVector<index_t> idx);
 
+	/** outputs of every tree from the compiled trees
+	 *
+	 * @param data the data to compute the output for
+	 * @return predictions
+	 */
+	virtual SGMatrix<float64_t> apply_outputs_without_combination(CFeatures* data);
+
 private:
 	/** initialize parameters */
 	void init();
@@ -161,6 +186,15 @@ private:
 
 	/** Indices of pre-sorted features */
 	SGMatrix<index_t> m_sorted_indices;
+
+	/** Bins of the features, shared by all trees */
+	SGMatrix<uint8_t> m_bins;
+
+	/** Upper bin edges of every feature */
+	SGMatrix<float64_t> m_bin_edges;
+
+	/** trees compiled for apply */
+	CFlatTreeEnsemble* m_flat_trees;
 };
 } /* namespace shogun */
 #endif /* _RANDOMFOREST_H__ */
@@ -33,6 +33,7 @@
 #include <shogun/lib/View.h>
 #include <shogun/machine/StochasticGBMachine.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/multiclass/tree/CARTree.h>
 #include <shogun/optimization/lbfgs/lbfgs.h>
 
 using namespace shogun;
@@ -66,6 +67,7 @@ CStochasticGBMachine::~CStochasticGBMachine()
 	SG_UNREF(m_loss);
 	SG_UNREF(m_weak_learners);
 	SG_UNREF(m_gamma);
+	SG_UNREF(m_flat_trees);
 }
 
 void CStochasticGBMachine::set_machine(CMachine* machine)
@@ -147,6 +149,18 @@ CRegressionLabels* CStochasticGBMachine::apply_regression(CFeatures* data)
 	require(data,"test data supplied is NULL");
 	CDenseFeatures<float64_t>* feats=data->as<CDenseFeatures<float64_t>>();
 
+	if (!m_trees_compiled)
+		compile_trees();
+
+	if (m_flat_trees)
+	{
+		SGVector<float64_t> gamma(m_num_iter);
+		for (int32_t i=0;i<m_num_iter;i++)
+			gamma[i]=m_gamma->get_element(i);
+
+		return new CRegressionLabels(m_flat_trees->apply_weighted_sum(feats, gamma, m_learning_rate));
+	}
+
 	SGVector<float64_t> retlabs(feats->get_num_vectors());
 	retlabs.fill_vector(retlabs.vector,retlabs.vlen,0);
 	for (int32_t i=0;i<m_num_iter;i++)
@@ -182,6 +196,16 @@ bool CStochasticGBMachine::train_machine(CFeatures* data)
 	// initialize weak learners array and gamma array
 	initialize_learners();
 
+	// bin the features once, every tree searches its splits on the bins
+	auto tree=dynamic_cast<CCARTree*>(m_machine);
+	if (tree && tree->get_num_bins()>0)
+		tree->pre_bin_features(feats, m_bins, m_bin_edges);
+	else
+	{
+		m_bins=SGMatrix<uint8_t>();
+		m_bin_edges=SGMatrix<float64_t>();
+	}
+
 	// cache predicted labels for intermediate models
 	CRegressionLabels* interf=new CRegressionLabels(feats->get_num_vectors());
 	SG_REF(interf);
@@ -221,9 +245,39 @@ bool CStochasticGBMachine::train_machine(CFeatures* data)
 	}
 
 	SG_UNREF(interf);
+	compile_trees();
 	return true;
 }
 
+void CStochasticGBMachine::compile_trees()
+{
+	SG_UNREF(m_flat_trees);
+	m_flat_trees=NULL;
+	m_trees_compiled=true;
+	if (m_weak_learners->get_num_elements()!=m_num_iter)
+		return;
+
+	for (int32_t i=0;i<m_num_iter;i++)
+	{
+		CSGObject* element=m_weak_learners->get_element(i);
+		bool is_tree=dynamic_cast<CCARTree*>(element)!=NULL;
+		SG_UNREF(element);
+		if (!is_tree)
+			return;
+	}
+
+	auto flat_trees=new CFlatTreeEnsemble();
+	for (int32_t i=0;i<m_num_iter;i++)
+	{
+		CSGObject* element=m_weak_learners->get_element(i);
+		flat_trees->add_tree(dynamic_cast<CCARTree*>(element));
+		SG_UNREF(element);
+	}
+
+	SG_REF(flat_trees);
+	m_flat_trees=flat_trees;
+}
+
 float64_t CStochasticGBMachine::compute_multiplier(
     CRegressionLabels* f, CRegressionLabels* hm, CLabels* labs)
 {
@@ -251,6 +305,10 @@ CMachine* CStochasticGBMachine::fit_model(CDenseFeatures<float64_t>* feats, CReg
 	else
 		error("Machine could not be cloned!");
 
+	auto tree=dynamic_cast<CCARTree*>(c);
+	if (tree && m_bins.num_rows>0)
+		tree->set_binned_features(m_bins, m_bin_edges);
+
 	// train cloned machine
 	c->set_labels(labels);
 	c->train(feats);
@@ -294,6 +352,10 @@ CStochasticGBMachine::get_subset(
 
 void CStochasticGBMachine::initialize_learners()
 {
+	SG_UNREF(m_flat_trees);
+	m_flat_trees=NULL;
+	m_trees_compiled=false;
+
 	SG_UNREF(m_weak_learners);
 	m_weak_learners=new CDynamicObjectArray();
 	SG_REF(m_weak_learners);
@@ -394,6 +456,8 @@ void CStochasticGBMachine::init()
 	m_num_iter=0;
 	m_subset_frac=0;
 	m_learning_rate=0;
+	m_flat_trees=NULL;
+	m_trees_compiled=false;
 
 	m_weak_learners=new CDynamicObjectArray();
 	SG_REF(m_weak_learners);
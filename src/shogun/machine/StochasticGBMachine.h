@@ -39,6 +39,7 @@
 #include <shogun/loss/LossFunction.h>
 #include <shogun/machine/Machine.h>
 #include <shogun/mathematics/RandomMixin.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
 
 #include <tuple>
 
@@ -143,6 +144,12 @@ public:
 	 */
 	virtual CRegressionLabels* apply_regression(CFeatures* data=NULL);
 
+	/** compile the weak learners into contiguous node arrays used by
+	 * apply_regression if they are all CARTrees. Done by train, needed only
+	 * after the learners were loaded or cloned.
+	 */
+	void compile_trees();
+
 protected:
 	/** train machine
 	 *
@@ -232,6 +239,20 @@ protected:
 
 	/** gamma - weak learner weights */
 	CDynamicArray<float64_t>* m_gamma;
+
+	/** bins of the training features if the machine is a binned CARTree */
+	SGMatrix<uint8_t> m_bins;
+
+	/** upper bin edges of the training features */
+	SGMatrix<float64_t> m_bin_edges;
+
+	/** weak learners compiled for apply if they are CARTrees */
+	CFlatTreeEnsemble* m_flat_trees;
+
+	/** whether compile_trees was called for the current weak learners,
+	 * m_flat_trees stays NULL if they could not be compiled
+	 */
+	bool m_trees_compiled;
 };
 }/* shogun */
 
@@ -0,0 +1,405 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/base/Parallel.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/ThreadPool.h>
+#include <shogun/base/progress.h>
+#include <shogun/mathematics/UniformRealDistribution.h>
+#include <shogun/multiclass/HNSWIndex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+using namespace shogun;
+
+namespace
+{
+float64_t squared_distance(const float64_t* a, const float64_t* b, index_t dim)
+{
+	float64_t result = 0;
+	for (index_t i = 0; i < dim; i++)
+	{
+		const float64_t diff = a[i] - b[i];
+		result += diff * diff;
+	}
+	return result;
+}
+}
+
+CHNSWIndex::CHNSWIndex() : RandomMixin<CSGObject>()
+{
+	init();
+}
+
+CHNSWIndex::CHNSWIndex(
+    int32_t max_links, int32_t ef_construction, int32_t ef_search)
+    : RandomMixin<CSGObject>()
+{
+	init();
+
+	require(max_links > 1, "M has to be larger than 1, not {}", max_links);
+	require(
+	    ef_construction > 0, "ef_construction has to be positive, not {}",
+	    ef_construction);
+
+	m_max_links = max_links;
+	m_ef_construction = ef_construction;
+	set_ef_search(ef_search);
+}
+
+void CHNSWIndex::init()
+{
+	m_max_links = 16;
+	m_ef_construction = 200;
+	m_ef_search = 50;
+	m_entry_point = 0;
+	m_max_level = 0;
+
+	SG_ADD(&m_max_links, "max_links", "Neighbours kept on the upper levels");
+	SG_ADD(
+	    &m_ef_construction, "ef_construction",
+	    "Candidate list size while building");
+	SG_ADD(&m_ef_search, "ef_search", "Candidate list size while querying");
+	SG_ADD(&m_entry_point, "entry_point", "Node the queries start from");
+	SG_ADD(&m_max_level, "max_level", "Top level of the graph");
+	SG_ADD(&m_levels, "levels", "Top level of every node");
+	SG_ADD(&m_offsets, "offsets", "Start of the neighbour lists of a node");
+	SG_ADD(&m_links, "links", "Neighbour lists of all nodes");
+}
+
+CHNSWIndex::~CHNSWIndex()
+{
+}
+
+void CHNSWIndex::set_ef_search(int32_t ef_search)
+{
+	require(ef_search > 0, "ef_search has to be positive, not {}", ef_search);
+	m_ef_search = ef_search;
+}
+
+void CHNSWIndex::VisitedList::clear()
+{
+	if (++tag == 0)
+	{
+		std::fill(tags.begin(), tags.end(), 0);
+		tag = 1;
+	}
+}
+
+void CHNSWIndex::build(const SGMatrix<float64_t>& data)
+{
+	const index_t num_nodes = data.num_cols;
+	require(num_nodes > 0, "No vectors to index");
+	require(data.num_rows > 0, "Vectors to index have no dimensions");
+
+	// levels are geometric with mean 1/(M-1), so the upper levels hold
+	// M times fewer nodes each
+	const float64_t level_mult = 1.0 / std::log(float64_t(m_max_links));
+	UniformRealDistribution<float64_t> uniform(0.0, 1.0);
+
+	m_levels = SGVector<int32_t>(num_nodes);
+	m_offsets = SGVector<index_t>(num_nodes + 1);
+	index_t num_links = 0;
+	for (index_t i = 0; i < num_nodes; i++)
+	{
+		m_levels[i] = std::floor(-std::log(1.0 - uniform(m_prng)) * level_mult);
+		m_offsets[i] = num_links;
+		num_links +=
+		    2 * m_max_links + 1 + m_levels[i] * (m_max_links + 1);
+	}
+	m_offsets[num_nodes] = num_links;
+
+	m_links = SGVector<index_t>(num_links);
+	m_links.zero();
+
+	m_entry_point = 0;
+	m_max_level = m_levels[0];
+
+	std::vector<std::mutex> locks(num_nodes);
+	std::mutex entry_lock;
+
+	auto pb = SG_PROGRESS(range(num_nodes));
+	env()->get_thread_pool()->parallel_for(
+	    1, num_nodes, [&](index_t begin, index_t end) {
+		    VisitedList visited(num_nodes);
+		    for (index_t i = begin; i < end; i++)
+		    {
+			    insert(data, i, visited, locks, entry_lock);
+			    pb.print_progress();
+		    }
+	    });
+	pb.complete();
+}
+
+void CHNSWIndex::insert(
+    const SGMatrix<float64_t>& data, index_t node, VisitedList& visited,
+    std::vector<std::mutex>& locks, std::mutex& entry_lock)
+{
+	const float64_t* query = data.get_column_vector(node);
+	const int32_t level = m_levels[node];
+
+	// a node that becomes the new entry point holds the lock until it is
+	// linked, so that no query starts from an unconnected node
+	std::unique_lock<std::mutex> entry_guard(entry_lock);
+	index_t entry = m_entry_point;
+	const int32_t max_level = m_max_level;
+	if (level <= max_level)
+		entry_guard.unlock();
+
+	float64_t entry_dist = squared_distance(
+	    query, data.get_column_vector(entry), data.num_rows);
+	for (int32_t l = max_level; l > level; l--)
+		search_greedy(data, query, entry, entry_dist, l, &locks);
+
+	for (int32_t l = std::min(level, max_level); l >= 0; l--)
+	{
+		auto candidates = search_layer(
+		    data, query, entry, entry_dist, m_ef_construction, l, visited,
+		    &locks);
+		entry = candidates.front().second;
+		entry_dist = candidates.front().first;
+
+		select_neighbors(data, candidates, m_max_links);
+		{
+			std::lock_guard<std::mutex> guard(locks[node]);
+			index_t* links = get_links(node, l);
+			links[0] = candidates.size();
+			for (size_t i = 0; i < candidates.size(); i++)
+				links[i + 1] = candidates[i].second;
+		}
+
+		for (const auto& c : candidates)
+			connect(data, c.second, node, c.first, l, locks);
+	}
+
+	if (level > max_level)
+	{
+		m_entry_point = node;
+		m_max_level = level;
+	}
+}
+
+void CHNSWIndex::connect(
+    const SGMatrix<float64_t>& data, index_t neighbor, index_t node,
+    float64_t dist, int32_t level, std::vector<std::mutex>& locks)
+{
+	std::lock_guard<std::mutex> guard(locks[neighbor]);
+	index_t* links = get_links(neighbor, level);
+	const int32_t capacity = get_capacity(level);
+
+	if (links[0] < capacity)
+	{
+		links[++links[0]] = node;
+		return;
+	}
+
+	const float64_t* base = data.get_column_vector(neighbor);
+	std::vector<Candidate> candidates;
+	candidates.reserve(capacity + 1);
+	candidates.emplace_back(dist, node);
+	for (index_t i = 1; i <= links[0]; i++)
+	{
+		candidates.emplace_back(
+		    squared_distance(
+		        base, data.get_column_vector(links[i]), data.num_rows),
+		    links[i]);
+	}
+
+	select_neighbors(data, candidates, capacity);
+	links[0] = candidates.size();
+	for (size_t i = 0; i < candidates.size(); i++)
+		links[i + 1] = candidates[i].second;
+}
+
+void CHNSWIndex::select_neighbors(
+    const SGMatrix<float64_t>& data, std::vector<Candidate>& candidates,
+    int32_t max_links) const
+{
+	std::sort(candidates.begin(), candidates.end());
+	if (candidates.size() <= (size_t)max_links)
+		return;
+
+	// a candidate closer to an already kept neighbour than to the base node
+	// is reachable through that neighbour
+	std::vector<Candidate> selected;
+	selected.reserve(max_links);
+	for (const auto& c : candidates)
+	{
+		if (selected.size() == (size_t)max_links)
+			break;
+
+		const float64_t* vec = data.get_column_vector(c.second);
+		bool diverse = true;
+		for (const auto& s : selected)
+		{
+			if (squared_distance(
+			        vec, data.get_column_vector(s.second), data.num_rows) <
+			    c.first)
+			{
+				diverse = false;
+				break;
+			}
+		}
+
+		if (diverse)
+			selected.push_back(c);
+	}
+
+	candidates.swap(selected);
+}
+
+void CHNSWIndex::copy_links(
+    index_t node, int32_t level, std::vector<index_t>& neighbors,
+    std::vector<std::mutex>* locks) const
+{
+	std::unique_lock<std::mutex> guard;
+	if (locks)
+		guard = std::unique_lock<std::mutex>((*locks)[node]);
+
+	const index_t* links = get_links(node, level);
+	neighbors.assign(links + 1, links + 1 + links[0]);
+}
+
+void CHNSWIndex::search_greedy(
+    const SGMatrix<float64_t>& data, const float64_t* query, index_t& entry,
+    float64_t& entry_dist, int32_t level, std::vector<std::mutex>* locks) const
+{
+	std::vector<index_t> neighbors;
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		copy_links(entry, level, neighbors, locks);
+		for (auto n : neighbors)
+		{
+			const float64_t dist = squared_distance(
+			    query, data.get_column_vector(n), data.num_rows);
+			if (dist < entry_dist)
+			{
+				entry_dist = dist;
+				entry = n;
+				changed = true;
+			}
+		}
+	}
+}
+
+std::vector<CHNSWIndex::Candidate> CHNSWIndex::search_layer(
+    const SGMatrix<float64_t>& data, const float64_t* query, index_t entry,
+    float64_t entry_dist, int32_t ef, int32_t level, VisitedList& visited,
+    std::vector<std::mutex>* locks) const
+{
+	// closest candidate to expand on top, furthest result on top
+	std::priority_queue<
+	    Candidate, std::vector<Candidate>, std::greater<Candidate>>
+	    candidates;
+	std::priority_queue<Candidate> results;
+
+	visited.clear();
+	visited.visit(entry);
+	candidates.emplace(entry_dist, entry);
+	results.emplace(entry_dist, entry);
+
+	std::vector<index_t> neighbors;
+	while (!candidates.empty())
+	{
+		const Candidate current = candidates.top();
+		if (current.first > results.top().first)
+			break;
+		candidates.pop();
+
+		copy_links(current.second, level, neighbors, locks);
+		for (auto n : neighbors)
+		{
+			if (visited.visit(n))
+				continue;
+
+			const float64_t dist = squared_distance(
+			    query, data.get_column_vector(n), data.num_rows);
+			if (results.size() < (size_t)ef || dist < results.top().first)
+			{
+				candidates.emplace(dist, n);
+				results.emplace(dist, n);
+				if (results.size() > (size_t)ef)
+					results.pop();
+			}
+		}
+	}
+
+	std::vector<Candidate> found(results.size());
+	for (auto it = found.rbegin(); it != found.rend(); ++it)
+	{
+		*it = results.top();
+		results.pop();
+	}
+	return found;
+}
+
+SGMatrix<index_t> CHNSWIndex::query_knn(
+    const SGMatrix<float64_t>& data, const SGMatrix<float64_t>& queries,
+    int32_t k) const
+{
+	const index_t num_nodes = get_num_vectors();
+	require(num_nodes > 0, "Index has not been built");
+	require(
+	    data.num_cols == num_nodes,
+	    "Index was built on {} vectors, but {} were given", num_nodes,
+	    data.num_cols);
+	require(
+	    queries.num_rows == data.num_rows,
+	    "Queries have {} dimensions, indexed vectors have {}",
+	    queries.num_rows, data.num_rows);
+	require(
+	    k > 0 && k <= num_nodes,
+	    "k ({}) has to be between 1 and the number of indexed vectors ({})",
+	    k, num_nodes);
+
+	SGMatrix<index_t> NN(k, queries.num_cols);
+	const int32_t ef = std::max(m_ef_search, k);
+
+	env()->get_thread_pool()->parallel_for(
+	    0, queries.num_cols, [&](index_t begin, index_t end) {
+		    VisitedList visited(num_nodes);
+		    std::vector<Candidate> all;
+		    for (index_t i = begin; i < end; i++)
+		    {
+			    const float64_t* query = queries.get_column_vector(i);
+			    index_t entry = m_entry_point;
+			    float64_t entry_dist = squared_distance(
+			        query, data.get_column_vector(entry), data.num_rows);
+			    for (int32_t l = m_max_level; l > 0; l--)
+				    search_greedy(data, query, entry, entry_dist, l, nullptr);
+
+			    auto found = search_layer(
+			        data, query, entry, entry_dist, ef, 0, visited, nullptr);
+
+			    // tiny graphs may not reach k nodes from the entry point
+			    if (found.size() < (size_t)k)
+			    {
+				    all.clear();
+				    for (index_t j = 0; j < num_nodes; j++)
+				    {
+					    all.emplace_back(
+					        squared_distance(
+					            query, data.get_column_vector(j),
+					            data.num_rows),
+					        j);
+				    }
+				    std::partial_sort(all.begin(), all.begin() + k, all.end());
+				    found.swap(all);
+			    }
+
+			    for (int32_t j = 0; j < k; j++)
+				    NN(j, i) = found[j].second;
+		    }
+	    });
+
+	return NN;
+}
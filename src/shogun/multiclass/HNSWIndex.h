@@ -0,0 +1,217 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef _HNSWINDEX_H__
+#define _HNSWINDEX_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/mathematics/RandomMixin.h>
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace shogun
+{
+
+/** @brief Hierarchical navigable small world graph over dense vectors
+ * for approximate nearest neighbour queries with the Euclidean distance.
+ *
+ * Every vector is a node on the levels 0 to l, where l is drawn from a
+ * geometric distribution. A query descends greedily from the single node of
+ * the top level and runs a best first search with a candidate list of size
+ * ef on level 0. Nodes keep at most 2M neighbours on level 0 and M on the
+ * other levels, chosen with the diversity heuristic of
+ *
+ * Malkov, Y. A. and Yashunin, D. A. "Efficient and robust approximate nearest
+ * neighbor search using Hierarchical Navigable Small World graphs",
+ * IEEE TPAMI, 2018.
+ *
+ * Vectors are inserted in parallel on the thread pool. The index only keeps
+ * the graph, the vectors have to be passed to every query. Larger ef_search
+ * trades throughput for recall.
+ */
+class CHNSWIndex : public RandomMixin<CSGObject>
+{
+public:
+	/** default constructor */
+	CHNSWIndex();
+
+	/** constructor
+	 *
+	 * @param max_links number of neighbours M kept on the upper levels
+	 * @param ef_construction candidate list size while building
+	 * @param ef_search candidate list size while querying
+	 */
+	CHNSWIndex(int32_t max_links, int32_t ef_construction, int32_t ef_search);
+
+	virtual ~CHNSWIndex();
+
+	/** build the graph over the columns of data
+	 *
+	 * @param data vectors to index, one per column
+	 */
+	void build(const SGMatrix<float64_t>& data);
+
+	/** approximate k nearest neighbours of every query
+	 *
+	 * @param data vectors the index was built on
+	 * @param queries query vectors, one per column
+	 * @param k number of neighbours
+	 * @return k x num_queries matrix of indices into data, closest first
+	 */
+	SGMatrix<index_t> query_knn(
+	    const SGMatrix<float64_t>& data, const SGMatrix<float64_t>& queries,
+	    int32_t k) const;
+
+	/** @return number of indexed vectors */
+	index_t get_num_vectors() const
+	{
+		return m_levels.vlen;
+	}
+
+	/** @return number of neighbours kept on the upper levels */
+	int32_t get_max_links() const
+	{
+		return m_max_links;
+	}
+
+	/** @return candidate list size while building */
+	int32_t get_ef_construction() const
+	{
+		return m_ef_construction;
+	}
+
+	/** @return candidate list size while querying */
+	int32_t get_ef_search() const
+	{
+		return m_ef_search;
+	}
+
+	/** set candidate list size while querying, does not need a rebuild
+	 *
+	 * @param ef_search candidate list size
+	 */
+	void set_ef_search(int32_t ef_search);
+
+	/** @return object name */
+	virtual const char* get_name() const
+	{
+		return "HNSWIndex";
+	}
+
+private:
+	void init();
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** distance to a node and its index */
+	typedef std::pair<float64_t, index_t> Candidate;
+
+	/** per search marks of visited nodes, cleared by bumping the tag */
+	struct VisitedList
+	{
+		explicit VisitedList(index_t num_nodes) : tags(num_nodes, 0), tag(0)
+		{
+		}
+
+		void clear();
+
+		bool visit(index_t node)
+		{
+			if (tags[node] == tag)
+				return true;
+			tags[node] = tag;
+			return false;
+		}
+
+		std::vector<uint32_t> tags;
+		uint32_t tag;
+	};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** neighbour list of a node on a level, the count followed by the ids */
+	index_t* get_links(index_t node, int32_t level) const
+	{
+		return m_links.vector + m_offsets[node] +
+		       (level ? 2 * m_max_links + 1 + (level - 1) * (m_max_links + 1)
+		              : 0);
+	}
+
+	/** @return maximal number of neighbours on a level */
+	int32_t get_capacity(int32_t level) const
+	{
+		return level ? m_max_links : 2 * m_max_links;
+	}
+
+	/** copy the neighbours of a node, locking it while the graph is built */
+	void copy_links(
+	    index_t node, int32_t level, std::vector<index_t>& neighbors,
+	    std::vector<std::mutex>* locks) const;
+
+	/** move entry to the closest node of a level by greedy descent */
+	void search_greedy(
+	    const SGMatrix<float64_t>& data, const float64_t* query,
+	    index_t& entry, float64_t& entry_dist, int32_t level,
+	    std::vector<std::mutex>* locks) const;
+
+	/** best first search on a level
+	 *
+	 * @return up to ef closest nodes found, closest first
+	 */
+	std::vector<Candidate> search_layer(
+	    const SGMatrix<float64_t>& data, const float64_t* query,
+	    index_t entry, float64_t entry_dist, int32_t ef, int32_t level,
+	    VisitedList& visited, std::vector<std::mutex>* locks) const;
+
+	/** keep at most max_links candidates that are closer to the base node
+	 * than to any candidate kept before
+	 */
+	void select_neighbors(
+	    const SGMatrix<float64_t>& data, std::vector<Candidate>& candidates,
+	    int32_t max_links) const;
+
+	/** add node to the neighbours of neighbor, pruning a full list */
+	void connect(
+	    const SGMatrix<float64_t>& data, index_t neighbor, index_t node,
+	    float64_t dist, int32_t level, std::vector<std::mutex>& locks);
+
+	/** insert a node into the graph */
+	void insert(
+	    const SGMatrix<float64_t>& data, index_t node, VisitedList& visited,
+	    std::vector<std::mutex>& locks, std::mutex& entry_lock);
+
+protected:
+	/** number of neighbours M kept on the upper levels */
+	int32_t m_max_links;
+
+	/** candidate list size while building */
+	int32_t m_ef_construction;
+
+	/** candidate list size while querying */
+	int32_t m_ef_search;
+
+	/** node the queries start from */
+	index_t m_entry_point;
+
+	/** top level of the graph */
+	int32_t m_max_level;
+
+	/** top level of every node */
+	SGVector<int32_t> m_levels;
+
+	/** start of the neighbour lists of every node in m_links */
+	SGVector<index_t> m_offsets;
+
+	/** neighbour lists of all nodes and levels */
+	SGVector<index_t> m_links;
+};
+}
+
+#endif // _HNSWINDEX_H__
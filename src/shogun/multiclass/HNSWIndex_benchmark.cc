@@ -0,0 +1,134 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/distance/EuclideanDistance.h"
+#include "shogun/features/DenseFeatures.h"
+#include "shogun/labels/MulticlassLabels.h"
+#include "shogun/multiclass/HNSWIndex.h"
+#include "shogun/multiclass/KNN.h"
+
+#include <random>
+#include <set>
+
+namespace shogun
+{
+
+class HNSWIndexFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		std::mt19937_64 prng(17);
+		std::normal_distribution<float64_t> dist;
+
+		const index_t num_vectors = st.range(0);
+		data = SGMatrix<float64_t>(dim, num_vectors);
+		queries = SGMatrix<float64_t>(dim, num_queries);
+		for (index_t i = 0; i < dim * num_vectors; i++)
+			data[i] = dist(prng);
+		for (index_t i = 0; i < dim * num_queries; i++)
+			queries[i] = dist(prng);
+
+		train = new CDenseFeatures<float64_t>(data);
+		test = new CDenseFeatures<float64_t>(queries);
+		SG_REF(train);
+		SG_REF(test);
+
+		SGVector<float64_t> lab(num_vectors);
+		lab.zero();
+		knn = new CKNN(k, new CEuclideanDistance(), new CMulticlassLabels(lab));
+		SG_REF(knn);
+		knn->train(train);
+		knn->get_distance()->init(train, test);
+		exact = knn->nearest_neighbors();
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(knn);
+		SG_UNREF(train);
+		SG_UNREF(test);
+	}
+
+	float64_t recall(const SGMatrix<index_t>& approx) const
+	{
+		index_t found = 0;
+		for (index_t i = 0; i < num_queries; i++)
+		{
+			std::set<index_t> truth(
+			    exact.get_column_vector(i), exact.get_column_vector(i) + k);
+			for (index_t j = 0; j < k; j++)
+				found += truth.count(approx(j, i));
+		}
+		return float64_t(found) / (k * num_queries);
+	}
+
+	static constexpr index_t dim = 16;
+	static constexpr index_t num_queries = 500;
+	static constexpr int32_t k = 10;
+	SGMatrix<float64_t> data;
+	SGMatrix<float64_t> queries;
+	SGMatrix<index_t> exact;
+	CDenseFeatures<float64_t>* train;
+	CDenseFeatures<float64_t>* test;
+	CKNN* knn;
+};
+
+/* queries per second and recall@10 for a candidate list size of range(1) */
+BENCHMARK_DEFINE_F(HNSWIndexFixture, query)(benchmark::State& st)
+{
+	auto index = some<CHNSWIndex>(16, 200, st.range(1));
+	index->build(data);
+
+	SGMatrix<index_t> NN;
+	for (auto _ : st)
+	{
+		NN = index->query_knn(data, queries, k);
+		benchmark::DoNotOptimize(NN.matrix);
+	}
+	st.SetItemsProcessed(st.iterations() * num_queries);
+	st.counters["recall"] = recall(NN);
+}
+
+/* exhaustive search of the brute force solver */
+BENCHMARK_DEFINE_F(HNSWIndexFixture, brute_force)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto NN = knn->nearest_neighbors();
+		benchmark::DoNotOptimize(NN.matrix);
+	}
+	st.SetItemsProcessed(st.iterations() * num_queries);
+}
+
+BENCHMARK_DEFINE_F(HNSWIndexFixture, build)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto index = some<CHNSWIndex>(16, 200, 50);
+		index->build(data);
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+BENCHMARK_REGISTER_F(HNSWIndexFixture, query)
+    ->Args({10000, 16})
+    ->Args({10000, 64})
+    ->Args({100000, 16})
+    ->Args({100000, 64})
+    ->Args({100000, 256})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(HNSWIndexFixture, brute_force)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(HNSWIndexFixture, build)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+}
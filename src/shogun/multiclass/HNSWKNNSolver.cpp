@@ -0,0 +1,75 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/lib/Signal.h>
+#include <shogun/multiclass/HNSWKNNSolver.h>
+
+using namespace shogun;
+
+CHNSWKNNSolver::CHNSWKNNSolver(const int32_t k, const float64_t q, const int32_t num_classes, const int32_t min_label, const SGVector<int32_t> train_labels, CHNSWIndex* index):
+CKNNSolver(k, q, num_classes, min_label, train_labels)
+{
+	init();
+
+	require(index, "No HNSW index given");
+	m_index=index;
+	SG_REF(m_index);
+}
+
+CHNSWKNNSolver::~CHNSWKNNSolver()
+{
+	SG_UNREF(m_index);
+}
+
+SGMatrix<index_t> CHNSWKNNSolver::nearest_neighbors(CDistance* knn_distance) const
+{
+	auto lhs = knn_distance->get_lhs()->as<CDenseFeatures<float64_t>>();
+	auto query = knn_distance->get_rhs()->as<CDenseFeatures<float64_t>>();
+
+	SGMatrix<index_t> NN = m_index->query_knn(lhs->get_feature_matrix(), query->get_feature_matrix(), m_k);
+
+	SG_UNREF(lhs);
+	SG_UNREF(query);
+	return NN;
+}
+
+CMulticlassLabels* CHNSWKNNSolver::classify_objects(CDistance* knn_distance, const int32_t num_lab, SGVector<int32_t>& train_lab, SGVector<float64_t>& classes) const
+{
+	CMulticlassLabels* output=new CMulticlassLabels(num_lab);
+	SGMatrix<index_t> NN = nearest_neighbors(knn_distance);
+
+	for (int32_t i = 0; i < num_lab && (!cancel_computation()); i++)
+	{
+		//write the labels of the k nearest neighbors from theirs indices
+		for (int32_t j=0; j<m_k; j++)
+			train_lab[j] = m_train_labels[ NN(j,i) ];
+
+		//get the index of the 'nearest' class
+		int32_t out_idx = choose_class(classes.vector, train_lab.vector);
+		//write the label of 'nearest' in the output
+		output->set_label(i, out_idx + m_min_label);
+	}
+
+	return output;
+}
+
+SGVector<int32_t> CHNSWKNNSolver::classify_objects_k(CDistance* knn_distance, const int32_t num_lab, SGVector<int32_t>& train_lab, SGVector<int32_t>& classes) const
+{
+	SGVector<int32_t> output(m_k*num_lab);
+	SGMatrix<index_t> NN = nearest_neighbors(knn_distance);
+
+	for (index_t i = 0; i < num_lab && (!cancel_computation()); i++)
+	{
+		//neighbours are already ordered by distance
+		for (index_t j=0; j<m_k; j++)
+			train_lab[j] = m_train_labels[ NN(j,i) ];
+
+		choose_class_for_multiple_k(output.vector+i, classes.vector, train_lab.vector, num_lab);
+	}
+
+	return output;
+}
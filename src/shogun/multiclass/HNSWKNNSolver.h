@@ -0,0 +1,71 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef HNSWSOLVER_H__
+#define HNSWSOLVER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+#include <shogun/distance/Distance.h>
+#include <shogun/multiclass/HNSWIndex.h>
+#include <shogun/multiclass/KNNSolver.h>
+
+namespace shogun
+{
+
+/**
+ * HNSW solver. It answers the nearest neighbour queries approximately with a
+ * hierarchical navigable small world graph built on the training vectors,
+ * see CHNSWIndex. Requires dense real valued features and the Euclidean
+ * distance.
+ */
+class CHNSWKNNSolver : public CKNNSolver
+{
+	public:
+		/** default constructor */
+		CHNSWKNNSolver() : CKNNSolver()
+		{
+			init();
+		}
+
+		/** deconstructor */
+		virtual ~CHNSWKNNSolver();
+
+		/** constructor
+		 *
+		 * @param k k
+		 * @param q m_q
+		 * @param num_classes m_num_classes
+		 * @param min_label m_min_label
+		 * @param train_labels m_train_labels
+		 * @param index graph built on the left hand side of the distance
+		 */
+		CHNSWKNNSolver(const int32_t k, const float64_t q, const int32_t num_classes, const int32_t min_label, const SGVector<int32_t> train_labels, CHNSWIndex* index);
+
+		virtual CMulticlassLabels* classify_objects(CDistance* d, const int32_t num_lab, SGVector<int32_t>& train_lab, SGVector<float64_t>& classes) const;
+
+		virtual SGVector<int32_t> classify_objects_k(CDistance* d, const int32_t num_lab, SGVector<int32_t>& train_lab, SGVector<int32_t>& classes) const;
+
+		/** @return object name */
+		const char* get_name() const { return "HNSWKNNSolver"; }
+
+	private:
+		void init()
+		{
+			m_index=NULL;
+		}
+
+		/** k nearest training vectors of every vector on the right hand side */
+		SGMatrix<index_t> nearest_neighbors(CDistance* d) const;
+
+	protected:
+		/** graph over the training vectors */
+		CHNSWIndex* m_index;
+};
+}
+
+#endif
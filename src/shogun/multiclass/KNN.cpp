@@ -8,6 +8,7 @@
 
 #include <shogun/base/Parameter.h>
 #include <shogun/base/progress.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/Labels.h>
 #include <shogun/lib/Signal.h>
 #include <shogun/lib/Time.h>
@@ -21,13 +22,13 @@
 using namespace shogun;
 
 CKNN::CKNN()
-: CDistanceMachine()
+: RandomMixin<CDistanceMachine>()
 {
 	init();
 }
 
 CKNN::CKNN(int32_t k, CDistance* d, CLabels* trainlab, KNN_SOLVER knn_solver)
-: CDistanceMachine()
+: RandomMixin<CDistanceMachine>()
 {
 	init();
 
@@ -52,6 +53,10 @@ void CKNN::init()
 	solver=NULL;
 	m_lsh_l = 0;
 	m_lsh_t = 0;
+	m_hnsw_max_links = 16;
+	m_hnsw_ef_construction = 200;
+	m_hnsw_ef_search = 50;
+	m_hnsw_index = NULL;
 
 	/* use the method classify_multiply_k to experiment with different values
 	 * of k */
@@ -62,11 +67,53 @@ void CKNN::init()
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&m_knn_solver, "knn_solver", "Algorithm to solve knn",
 	    ParameterProperties::NONE,
-	    SG_OPTIONS(KNN_BRUTE, KNN_KDTREE, KNN_COVER_TREE, KNN_LSH));
+	    SG_OPTIONS(KNN_BRUTE, KNN_KDTREE, KNN_COVER_TREE, KNN_LSH, KNN_HNSW));
+	SG_ADD(&m_hnsw_max_links, "hnsw_max_links", "Neighbours per node for HNSW");
+	SG_ADD(
+	    &m_hnsw_ef_construction, "hnsw_ef_construction",
+	    "Candidate list size while building the HNSW graph");
+	SG_ADD(
+	    &m_hnsw_ef_search, "hnsw_ef_search",
+	    "Candidate list size while querying the HNSW graph");
+	SG_ADD((CSGObject**)&m_hnsw_index, "hnsw_index", "HNSW graph");
 }
 
 CKNN::~CKNN()
 {
+	SG_UNREF(m_hnsw_index);
+}
+
+void CKNN::set_hnsw_parameters(
+    int32_t max_links, int32_t ef_construction, int32_t ef_search)
+{
+	if (m_hnsw_index && (max_links != m_hnsw_max_links ||
+	                     ef_construction != m_hnsw_ef_construction))
+	{
+		SG_UNREF(m_hnsw_index);
+		m_hnsw_index = NULL;
+	}
+
+	m_hnsw_max_links = max_links;
+	m_hnsw_ef_construction = ef_construction;
+	m_hnsw_ef_search = ef_search;
+}
+
+void CKNN::build_hnsw_index()
+{
+	require(
+	    distance->get_distance_type() == D_EUCLIDEAN,
+	    "HNSW solver requires the Euclidean distance");
+
+	auto lhs = distance->get_lhs()->as<CDenseFeatures<float64_t>>();
+
+	SG_UNREF(m_hnsw_index);
+	m_hnsw_index = new CHNSWIndex(
+	    m_hnsw_max_links, m_hnsw_ef_construction, m_hnsw_ef_search);
+	SG_REF(m_hnsw_index);
+	seed(m_hnsw_index);
+	m_hnsw_index->build(lhs->get_feature_matrix());
+
+	SG_UNREF(lhs);
 }
 
 bool CKNN::train_machine(CFeatures* data)
@@ -100,6 +147,15 @@ bool CKNN::train_machine(CFeatures* data)
 	io::info("m_num_classes: {} ({:+d} to {:+d}) num_train: {}", m_num_classes,
 			min_class, max_class, m_train_labels.vlen);
 
+	// the graph always belongs to the last training set
+	if (m_knn_solver == KNN_HNSW)
+		build_hnsw_index();
+	else
+	{
+		SG_UNREF(m_hnsw_index);
+		m_hnsw_index = NULL;
+	}
+
 	return true;
 }
 
@@ -321,5 +377,17 @@ void CKNN::init_solver(KNN_SOLVER knn_solver)
 		SG_REF(solver);
 		break;
 	}
+	case KNN_HNSW:
+	{
+		// the graph is built by train, unless the solver was switched to
+		// HNSW after training
+		if (!m_hnsw_index)
+			build_hnsw_index();
+		m_hnsw_index->set_ef_search(m_hnsw_ef_search);
+
+		solver = new CHNSWKNNSolver(m_k, m_q, m_num_classes, m_min_label, m_train_labels, m_hnsw_index);
+		SG_REF(solver);
+		break;
+	}
 	}
 }
@@ -16,6 +16,7 @@
 #include <shogun/features/Features.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/machine/DistanceMachine.h>
+#include <shogun/mathematics/RandomMixin.h>
 #include <shogun/multiclass/KNNSolver.h>
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/multiclass/BruteKNNSolver.h>
@@ -24,6 +25,7 @@
 #include <shogun/multiclass/CoverTreeKNNSolver.h>
 #endif
 #include <shogun/multiclass/LSHKNNSolver.h>
+#include <shogun/multiclass/HNSWKNNSolver.h>
 
 namespace shogun
 {
@@ -32,7 +34,8 @@ namespace shogun
 		KNN_BRUTE,
 		KNN_KDTREE,
 		KNN_COVER_TREE,
-		KNN_LSH
+		KNN_LSH,
+		KNN_HNSW
 	};
 
 class CDistanceMachine;
@@ -66,7 +69,7 @@ class CDistanceMachine;
  * multi-class-classification. And finally, in case of k=1 classification will
  * take less time with an special optimization provided.
  */
-class CKNN : public CDistanceMachine
+class CKNN : public RandomMixin<CDistanceMachine>
 {
 	public:
 		MACHINE_PROBLEM_TYPE(PT_MULTICLASS)
@@ -210,6 +213,16 @@ class CKNN : public CDistanceMachine
 			m_lsh_t = t;
 		}
 
+		/** set parameters for HNSW solver, a changed M or ef_construction
+		 * rebuilds the graph
+		 *
+		 * @param max_links number of neighbours M kept per node and level
+		 * @param ef_construction candidate list size while building
+		 * @param ef_search candidate list size while querying
+		 */
+		void set_hnsw_parameters(
+		    int32_t max_links, int32_t ef_construction, int32_t ef_search);
+
 	protected:
 		/** classify all examples with nearest neighbor (k=1)
 		 * @return classified labels
@@ -267,6 +280,11 @@ class CKNN : public CDistanceMachine
 		 */
 		void init_solver(KNN_SOLVER knn_solver);
 
+		/** build the HNSW graph on the left hand side of the distance,
+		 * seeded from the machine's random generator
+		 */
+		void build_hnsw_index();
+
 	protected:
 		/// the k parameter in KNN
 		int32_t m_k;
@@ -295,6 +313,18 @@ class CKNN : public CDistanceMachine
 
 		/* Number of probes per query for LSH */
 		int32_t m_lsh_t;
+
+		/* Number of neighbours per node and level for HNSW */
+		int32_t m_hnsw_max_links;
+
+		/* Candidate list size while building the HNSW graph */
+		int32_t m_hnsw_ef_construction;
+
+		/* Candidate list size while querying the HNSW graph */
+		int32_t m_hnsw_ef_search;
+
+		/** HNSW graph on the training vectors */
+		CHNSWIndex* m_hnsw_index;
 };
 
 }
@@ -48,6 +48,17 @@ float64_t CBallTree::min_dist(bnode_t* node,float64_t* feat, int32_t dim)
 	return CMath::max(0.0,dist-node->data.radius);
 }
 
+float64_t CBallTree::min_dist_flat(index_t node, float64_t* feat, int32_t dim)
+{
+	float64_t dist=0;
+	const float64_t* center=flat_center(node);
+	for (int32_t i=0;i<dim;i++)
+		dist+=add_dim_dist(center[i]-feat[i]);
+
+	dist=actual_dists(dist);
+	return CMath::max(0.0,dist-m_flat_nodes[node].radius);
+}
+
 float64_t CBallTree::min_dist_dual(bnode_t* nodeq, bnode_t* noder)
 {
 	float64_t dist=0;
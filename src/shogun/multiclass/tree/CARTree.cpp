@@ -28,8 +28,13 @@
  * either expressed or implied, of the Shogun Development Team.
  */
 
+#include <algorithm>
 #include <vector>
 
+#include <shogun/base/Parallel.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/ThreadPool.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/lib/View.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
@@ -43,6 +48,166 @@ using namespace shogun;
 const float64_t CCARTree::MISSING=CMath::MAX_REAL_NUMBER;
 const float64_t CCARTree::EQ_DELTA=1e-7;
 const float64_t CCARTree::MIN_SPLIT_GAIN=1e-7;
+const uint8_t CCARTree::MISSING_BIN=255;
+
+namespace
+{
+	// number of histogram slots per feature, the value bins and MISSING_BIN
+	constexpr index_t num_bin_slots=256;
+
+	// at most this many nominal categories are split by testing all subsets
+	constexpr index_t max_enumerated_categories=16;
+
+	// histograms of smaller nodes are computed in the calling thread
+	constexpr index_t parallel_histogram_size=4096;
+
+	// storage indices of the vectors of data
+	SGVector<index_t> get_storage_indices(CFeatures* data)
+	{
+		SGVector<index_t> indices;
+		CSubsetStack* subset_stack=data->get_subset_stack();
+		if (subset_stack->has_subsets())
+			indices=(subset_stack->get_last_subset())->get_subset_idx();
+		else
+		{
+			indices=SGVector<index_t>(data->get_num_vectors());
+			linalg::range_fill(indices);
+		}
+		SG_UNREF(subset_stack);
+		return indices;
+	}
+
+	// Gini or least squares gain of splitting the statistics total into left
+	// and total-left. Both reduce to wl*wr/w^2*sum_k (l_k/wl-r_k/wr)^2 where
+	// l_k and r_k are the class weights or the weighted label sums.
+	float64_t histogram_gain(const float64_t* left, const float64_t* total, index_t num_stats, bool regression)
+	{
+		float64_t wleft=0;
+		float64_t wtotal=0;
+		if (regression)
+		{
+			wleft=left[1];
+			wtotal=total[1];
+		}
+		else
+		{
+			for (index_t k=1;k<num_stats;++k)
+			{
+				wleft+=left[k];
+				wtotal+=total[k];
+			}
+		}
+
+		float64_t wright=wtotal-wleft;
+		if (wleft<=0 || wright<=0)
+			return 0;
+
+		float64_t dist=0;
+		for (index_t k=regression ? 2 : 1;k<num_stats;++k)
+		{
+			float64_t diff=left[k]/wleft-(total[k]-left[k])/wright;
+			dist+=diff*diff;
+		}
+
+		return wleft*wright*dist/(wtotal*wtotal);
+	}
+
+	// best split of one binned feature
+	struct BinnedSplit
+	{
+		float64_t gain=0;
+		std::vector<bool> left_bins;
+	};
+
+	// best split of the bins, in the given order, into a prefix going left
+	// and the rest going right
+	BinnedSplit best_prefix_split(const float64_t* stats, const std::vector<index_t>& bins,
+		const std::vector<float64_t>& total, index_t num_stats, bool regression)
+	{
+		BinnedSplit split;
+		split.left_bins.assign(num_bin_slots, false);
+		std::vector<float64_t> left(num_stats, 0);
+		size_t best=0;
+		for (size_t j=0;j+1<bins.size();++j)
+		{
+			for (index_t k=0;k<num_stats;++k)
+				left[k]+=stats[bins[j]*num_stats+k];
+
+			auto g=histogram_gain(left.data(), total.data(), num_stats, regression);
+			if (g>split.gain)
+			{
+				split.gain=g;
+				best=j+1;
+			}
+		}
+
+		for (size_t j=0;j<best;++j)
+			split.left_bins[bins[j]]=true;
+
+		return split;
+	}
+
+	// best division of the categories in bins between two children, tests
+	// all divisions of a few categories and otherwise orders the categories
+	// by their mean label or the share of the heaviest class
+	BinnedSplit best_subset_split(const float64_t* stats, std::vector<index_t> bins,
+		const std::vector<float64_t>& total, index_t num_stats, bool regression)
+	{
+		auto num_categories=(index_t)bins.size();
+		if (num_categories>max_enumerated_categories)
+		{
+			std::vector<float64_t> key(num_bin_slots, 0);
+			index_t heaviest=1;
+			for (index_t k=2;!regression && k<num_stats;++k)
+			{
+				if (total[k]>total[heaviest])
+					heaviest=k;
+			}
+			for (auto b : bins)
+			{
+				const float64_t* bin_stats=stats+b*num_stats;
+				float64_t weight=0;
+				for (index_t k=1;k<(regression ? 2 : num_stats);++k)
+					weight+=bin_stats[k];
+				if (weight>0)
+					key[b]=(regression ? bin_stats[2] : bin_stats[heaviest])/weight;
+			}
+			std::stable_sort(bins.begin(), bins.end(), [&key](index_t a, index_t b) { return key[a]<key[b]; });
+
+			return best_prefix_split(stats, bins, total, num_stats, regression);
+		}
+
+		// all 2^(c-1)-1 divisions, the last category always goes right
+		BinnedSplit split;
+		split.left_bins.assign(num_bin_slots, false);
+		std::vector<float64_t> left(num_stats);
+		int64_t best=0;
+		for (int64_t mask=1;mask<(int64_t(1)<<(num_categories-1));++mask)
+		{
+			std::fill(left.begin(), left.end(), 0);
+			for (index_t p=0;p<num_categories-1;++p)
+			{
+				if ((mask>>p)&1)
+				{
+					for (index_t k=0;k<num_stats;++k)
+						left[k]+=stats[bins[p]*num_stats+k];
+				}
+			}
+
+			auto g=histogram_gain(left.data(), total.data(), num_stats, regression);
+			if (g>split.gain)
+			{
+				split.gain=g;
+				best=mask;
+			}
+		}
+
+		for (index_t p=0;p<num_categories-1;++p)
+			split.left_bins[bins[p]]=(best>>p)&1;
+
+		return split;
+	}
+}
 
 CCARTree::CCARTree()
 : RandomMixin<CTreeMachine<CARTreeNodeData>>()
@@ -251,6 +416,15 @@ bool CCARTree::weights_set()
 	return m_weights.size() != 0;
 }
 
+void CCARTree::set_num_bins(int32_t bins)
+{
+	require(bins==0 || (bins>1 && bins<=MISSING_BIN),"Number of bins should be 0 or between 2 and {}. Supplied value is {}",MISSING_BIN,bins);
+	m_num_bins=bins;
+	m_pre_binned=false;
+	m_bins=SGMatrix<uint8_t>();
+	m_bin_edges=SGMatrix<float64_t>();
+}
+
 bool CCARTree::train_machine(CFeatures* data)
 {
 	require(data,"Data required for training");
@@ -290,6 +464,23 @@ bool CCARTree::train_machine(CFeatures* data)
 	}
 
 	auto dense_labels = m_labels->as<CDenseLabels>();
+	if (m_num_bins>0)
+	{
+		if (!m_pre_binned)
+			pre_bin_features(dense_features, m_bins, m_bin_edges);
+
+		require(m_bins.num_rows==num_features, "Binned features have {} features, data has {}",
+			m_bins.num_rows, num_features);
+
+		m_num_classes=0;
+		if (m_mode==PT_MULTICLASS)
+		{
+			auto labels_vec=dense_labels->get_labels();
+			auto range=std::minmax_element(labels_vec.begin(), labels_vec.end());
+			require(*range.first>=0, "Multiclass labels have to be non-negative");
+			m_num_classes=*range.second+1;
+		}
+	}
 	set_root(CARTtrain(dense_features,m_weights,dense_labels,0));
 
 	if (m_apply_cv_pruning)
@@ -307,6 +498,83 @@ void CCARTree::set_sorted_features(SGMatrix<float64_t>& sorted_feats, SGMatrix<i
 	m_sorted_indices=sorted_indices;
 }
 
+void CCARTree::set_binned_features(SGMatrix<uint8_t>& bins, SGMatrix<float64_t>& bin_edges)
+{
+	require(m_num_bins>0, "Number of bins has to be set before using binned features");
+	m_pre_binned=true;
+	m_bins=bins;
+	m_bin_edges=bin_edges;
+}
+
+void CCARTree::pre_bin_features(CFeatures* data, SGMatrix<uint8_t>& bins, SGMatrix<float64_t>& bin_edges)
+{
+	require(m_num_bins>0, "Number of bins has to be set before binning features");
+
+	auto mat=data->as<CDenseFeatures<float64_t>>()->get_feature_matrix();
+	auto ids=get_storage_indices(data);
+	auto num_feats=mat.num_rows;
+	require(!types_set() || m_nominal.vlen==num_feats,
+		"Length of m_nominal vector (currently {}) should be same as number of features in data (presently {}).",
+		m_nominal.vlen, num_feats);
+
+	bins=SGMatrix<uint8_t>(num_feats, ids.vlen ? *std::max_element(ids.begin(), ids.end())+1 : 0);
+	std::fill(bins.begin(), bins.end(), MISSING_BIN);
+	bin_edges=SGMatrix<float64_t>(MISSING_BIN, num_feats);
+	linalg::set_const(bin_edges, MISSING);
+
+	env()->get_thread_pool()->parallel_for(0, num_feats, [&](index_t begin, index_t end)
+	{
+		std::vector<float64_t> values;
+		values.reserve(mat.num_cols);
+		for (index_t f=begin;f<end;++f)
+		{
+			values.clear();
+			for (index_t i=0;i<mat.num_cols;++i)
+			{
+				if (mat(f,i)!=MISSING)
+					values.push_back(mat(f,i));
+			}
+			std::sort(values.begin(), values.end());
+
+			auto num_values=(index_t)values.size();
+			index_t num_distinct=0;
+			for (index_t i=0;i<num_values;++i)
+			{
+				if (i==0 || values[i]!=values[i-1])
+					++num_distinct;
+			}
+
+			float64_t* edges=bin_edges.get_column_vector(f);
+			index_t num_edges=0;
+			if ((types_set() && m_nominal[f]) || num_distinct<=m_num_bins)
+			{
+				// one bin per value, every category of a nominal feature
+				require(num_distinct<=MISSING_BIN, "Nominal feature {} has {} categories, at most {} can be binned",
+					f, num_distinct, MISSING_BIN);
+				num_edges=std::unique(values.begin(), values.end())-values.begin();
+				std::copy(values.begin(), values.begin()+num_edges, edges);
+			}
+			else
+			{
+				// quantiles of the sorted values, the last one is the max
+				for (index_t q=1;q<=m_num_bins;++q)
+				{
+					auto edge=values[(q*(int64_t)num_values-1)/m_num_bins];
+					if (num_edges==0 || edge>edges[num_edges-1])
+						edges[num_edges++]=edge;
+				}
+			}
+
+			for (index_t i=0;i<mat.num_cols;++i)
+			{
+				if (mat(f,i)==MISSING)
+					continue;
+				bins(f,ids[i])=std::lower_bound(edges, edges+num_edges, mat(f,i))-edges;
+			}
+		}
+	});
+}
+
 void CCARTree::pre_sort_features(CFeatures* data, SGMatrix<float64_t>& sorted_feats, SGMatrix<index_t>& sorted_indices)
 {
 	SGMatrix<float64_t> mat=(data)->as<CDenseFeatures<float64_t>>()->get_feature_matrix();
@@ -327,16 +595,21 @@ void CCARTree::pre_sort_features(CFeatures* data, SGMatrix<float64_t>& sorted_fe
 
 }
 
-CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::CARTtrain(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, int32_t level)
+CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::CARTtrain(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, int32_t level,
+	SGVector<float64_t> histogram)
 {
 	require(labels,"labels have to be supplied");
 	require(data,"data matrix has to be supplied");
 
 	bnode_t* node=new bnode_t();
 	auto labels_vec = labels->get_labels();
-	auto mat = data->get_feature_matrix();
-	auto num_feats=mat.num_rows;
-	auto num_vecs=mat.num_cols;
+	auto num_feats=data->get_num_features();
+	auto num_vecs=data->get_num_vectors();
+	// binned features do not need the feature values unless values are missing
+	bool binned=m_num_bins>0;
+	SGMatrix<float64_t> mat;
+	if (!binned)
+		mat=data->get_feature_matrix();
 
 	// calculate node label
 	switch(m_mode)
@@ -426,15 +699,17 @@ CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::CARTtrain(CDenseFeatures<floa
 	int32_t c_right=-1;
 	int32_t best_attribute;
 
-	SGVector<index_t> indices(num_vecs);
-	if (m_pre_sort)
+	SGVector<index_t> indices;
+	if (binned)
 	{
-		CSubsetStack* subset_stack = data->get_subset_stack();
-		if (subset_stack->has_subsets())
-			indices=(subset_stack->get_last_subset())->get_subset_idx();
-		else
-			linalg::range_fill(indices);
-		SG_UNREF(subset_stack);
+		indices=get_storage_indices(data);
+		if (histogram.vlen==0)
+			histogram=compute_histogram(indices,weights,labels_vec);
+		best_attribute=compute_best_attribute_binned(histogram,indices,weights,labels,left,right,left_final,num_missing_final,c_left,c_right);
+	}
+	else if (m_pre_sort)
+	{
+		indices=get_storage_indices(data);
 		best_attribute=compute_best_attribute(m_sorted_features,weights,labels,left,right,left_final,num_missing_final,c_left,c_right,0,indices);
 	}
 	else
@@ -454,6 +729,9 @@ CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::CARTtrain(CDenseFeatures<floa
 
 	if (num_missing_final>0)
 	{
+		if (binned)
+			mat=data->get_feature_matrix();
+
 		SGVector<bool> is_left_final(num_vecs-num_missing_final);
 		int32_t ilf=0;
 		for (int32_t i=0;i<num_vecs;++i)
@@ -487,17 +765,42 @@ CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::CARTtrain(CDenseFeatures<floa
 		}
 	}
 
+	SGVector<float64_t> histogram_left;
+	SGVector<float64_t> histogram_right;
+	if (binned && (m_max_depth<=0 || level+1<m_max_depth))
+	{
+		// scan the smaller child, the larger one is the rest of this node
+		bool left_smaller=count_left<=num_vecs-count_left;
+		const auto& subset=left_smaller ? subsetl : subsetr;
+		SGVector<index_t> child_ids(subset.vlen);
+		SGVector<float64_t> child_labels(subset.vlen);
+		for (index_t i=0;i<subset.vlen;++i)
+		{
+			child_ids[i]=indices[subset[i]];
+			child_labels[i]=labels_vec[subset[i]];
+		}
+
+		auto histogram_small=compute_histogram(child_ids,left_smaller ? weightsl : weightsr,child_labels);
+		for (index_t i=0;i<histogram.vlen;++i)
+			histogram[i]-=histogram_small[i];
+
+		histogram_left=left_smaller ? histogram_small : histogram;
+		histogram_right=left_smaller ? histogram : histogram_small;
+		histogram=SGVector<float64_t>();
+	}
+
 	// left child
 	auto feats_train = view(data, subsetl);
 	auto labels_train = view(labels, subsetl);
 	bnode_t* left_child =
-	    CARTtrain(feats_train, weightsl, labels_train, level + 1);
+	    CARTtrain(feats_train, weightsl, labels_train, level + 1, histogram_left);
+	histogram_left=SGVector<float64_t>();
 
 	// right child
 	feats_train = view(data, subsetr);
 	labels_train = view(labels, subsetr);
 	bnode_t* right_child =
-	    CARTtrain(feats_train, weightsr, labels_train, level + 1);
+	    CARTtrain(feats_train, weightsr, labels_train, level + 1, histogram_right);
 
 	// set node parameters
 	node->data.attribute_id=best_attribute;
@@ -604,9 +907,11 @@ index_t CCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, const S
 
 	for (index_t i=0;i<num_feats;++i)
 	{
-		SGVector<float64_t> feats(num_vecs);
-		SGVector<index_t> sorted_args(num_vecs);
-		SGVector<index_t> temp_count_indices(count_indices.size());
+		// temporaries of an attribute are released together
+		ScopedArena scope;
+		SGVector<float64_t> feats(num_vecs, scope.arena());
+		SGVector<index_t> sorted_args(num_vecs, scope.arena());
+		SGVector<index_t> temp_count_indices(count_indices.size(), scope.arena());
 		sg_memcpy(temp_count_indices.vector, count_indices.vector, sizeof(index_t)*count_indices.size());
 
 		if (m_pre_sort)
@@ -654,7 +959,7 @@ index_t CCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, const S
 
 		if (m_nominal[idx[i]])
 		{
-			SGVector<index_t> simple_feats(num_vecs);
+			SGVector<index_t> simple_feats(num_vecs, scope.arena());
 			linalg::set_const(simple_feats, -1);
 
 			// convert to simple values
@@ -669,7 +974,7 @@ index_t CCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, const S
 			}
 
 			// collect the unique categorical values
-			SGVector<float64_t> ufeats(c+1);
+			SGVector<float64_t> ufeats(c+1, scope.arena());
 			ufeats[0]=feats[0];
 			index_t u=0;
 			for (index_t j = 1; j < n_nm_vecs; ++j)
@@ -685,16 +990,15 @@ index_t CCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, const S
 			index_t num_cases=CMath::pow(2,c);
 			for (index_t k = 1; k < num_cases; ++k)
 			{
-				SGVector<float64_t> wleft(n_ulabels), wright(n_ulabels);
-				linalg::zero(wleft);
-				linalg::zero(wright);
+				ScopedArena case_scope;
+				SGVector<float64_t> wleft(n_ulabels, case_scope.arena());
+				SGVector<float64_t> wright(n_ulabels, case_scope.arena());
 
 				// stores which vectors are assigned to left child
-				SGVector<bool> is_left(num_vecs);
-				linalg::set_const(is_left, false);
+				SGVector<bool> is_left(num_vecs, case_scope.arena());
 
 				// stores which among the categorical values of chosen attribute are assigned left child
-				SGVector<bool> feats_left(c+1);
+				SGVector<bool> feats_left(c+1, case_scope.arena());
 
 				// fill feats_left in a unique way corresponding to the case
 				for (index_t p = 0; p < feats_left.vlen; ++p)
@@ -755,9 +1059,9 @@ index_t CCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, const S
 		else
 		{
 			// O(N)
-			SGVector<float64_t> right_wclasses=total_wclasses.clone();
-			SGVector<float64_t> left_wclasses(n_ulabels);
-			linalg::zero(left_wclasses);
+			SGVector<float64_t> right_wclasses(n_ulabels, scope.arena());
+			sg_memcpy(right_wclasses.vector, total_wclasses.vector, sizeof(float64_t)*n_ulabels);
+			SGVector<float64_t> left_wclasses(n_ulabels, scope.arena());
 
 			// O(N)
 			// find best split for non-nominal attribute - choose threshold (z)
@@ -846,6 +1150,173 @@ index_t CCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, const S
 	return best_attribute;
 }
 
+index_t CCARTree::get_num_stats() const
+{
+	// count and class weights or count, weight and weighted label sum
+	return (m_mode==PT_REGRESSION) ? 3 : 1+m_num_classes;
+}
+
+SGVector<float64_t> CCARTree::compute_histogram(const SGVector<index_t>& ids, const SGVector<float64_t>& weights,
+	const SGVector<float64_t>& labels) const
+{
+	auto num_feats=m_bins.num_rows;
+	auto num_stats=get_num_stats();
+	auto feature_size=num_bin_slots*num_stats;
+	bool regression=m_mode==PT_REGRESSION;
+
+	SGVector<float64_t> histogram(num_feats*feature_size);
+	histogram.zero();
+
+	// every chunk of features has its own part of the histogram
+	auto add_vectors=[&](index_t begin, index_t end)
+	{
+		for (index_t i=0;i<ids.vlen;++i)
+		{
+			const uint8_t* vec_bins=m_bins.get_column_vector(ids[i]);
+			for (index_t f=begin;f<end;++f)
+			{
+				float64_t* stats=histogram.vector+f*feature_size+vec_bins[f]*num_stats;
+				stats[0]+=1;
+				if (regression)
+				{
+					stats[1]+=weights[i];
+					stats[2]+=weights[i]*labels[i];
+				}
+				else
+					stats[1+(index_t)labels[i]]+=weights[i];
+			}
+		}
+	};
+
+	if (ids.vlen<parallel_histogram_size)
+		add_vectors(0, num_feats);
+	else
+		env()->get_thread_pool()->parallel_for(0, num_feats, add_vectors);
+
+	return histogram;
+}
+
+index_t CCARTree::compute_best_attribute_binned(const SGVector<float64_t>& histogram, const SGVector<index_t>& ids,
+	const SGVector<float64_t>& weights, CDenseLabels* labels, SGVector<float64_t>& left, SGVector<float64_t>& right,
+	SGVector<bool>& is_left_final, index_t &num_missing_final, index_t &count_left, index_t &count_right, index_t subset_size)
+{
+	auto labels_vec=labels->get_labels();
+	auto num_feats=m_bins.num_rows;
+	auto num_stats=get_num_stats();
+	bool regression=m_mode==PT_REGRESSION;
+
+	// if all labels same early stop
+	float64_t delta=regression ? m_label_epsilon : 0;
+	auto range=std::minmax_element(labels_vec.begin(), labels_vec.end());
+	if (*range.second-*range.first<=delta)
+		return -1;
+
+	SGVector<index_t> idx(num_feats);
+	linalg::range_fill(idx);
+	if (subset_size)
+	{
+		num_feats=subset_size;
+		random::shuffle(idx, m_prng);
+	}
+
+	std::vector<BinnedSplit> splits(num_feats);
+	env()->get_thread_pool()->parallel_for(0, num_feats, [&](index_t begin, index_t end)
+	{
+		std::vector<float64_t> total(num_stats);
+		std::vector<index_t> bins;
+		for (index_t i=begin;i<end;++i)
+		{
+			const float64_t* stats=histogram.vector+idx[i]*num_bin_slots*num_stats;
+
+			// statistics of the vectors with a known value
+			std::fill(total.begin(), total.end(), 0);
+			bins.clear();
+			for (index_t b=0;b<MISSING_BIN;++b)
+			{
+				if (stats[b*num_stats]==0)
+					continue;
+
+				bins.push_back(b);
+				for (index_t k=0;k<num_stats;++k)
+					total[k]+=stats[b*num_stats+k];
+			}
+
+			// if only one unique value - it cannot be used to split
+			if (bins.size()<2)
+				continue;
+
+			if (m_nominal[idx[i]])
+				splits[i]=best_subset_split(stats, bins, total, num_stats, regression);
+			else
+				splits[i]=best_prefix_split(stats, bins, total, num_stats, regression);
+		}
+	});
+
+	float64_t max_gain=MIN_SPLIT_GAIN;
+	index_t best=-1;
+	for (index_t i=0;i<num_feats;++i)
+	{
+		if (splits[i].gain>max_gain)
+		{
+			max_gain=splits[i].gain;
+			best=i;
+		}
+	}
+
+	if (best==-1)
+		return -1;
+
+	auto best_attribute=idx[best];
+	const auto& left_bins=splits[best].left_bins;
+	const float64_t* stats=histogram.vector+best_attribute*num_bin_slots*num_stats;
+	const float64_t* edges=m_bin_edges.get_column_vector(best_attribute);
+	if (m_nominal[best_attribute])
+	{
+		if (left.vlen<MISSING_BIN)
+			left.resize_vector(MISSING_BIN);
+		if (right.vlen<MISSING_BIN)
+			right.resize_vector(MISSING_BIN);
+
+		count_left=0;
+		count_right=0;
+		for (index_t b=0;b<MISSING_BIN;++b)
+		{
+			if (stats[b*num_stats]==0)
+				continue;
+
+			if (left_bins[b])
+				left[count_left++]=edges[b];
+			else
+				right[count_right++]=edges[b];
+		}
+	}
+	else
+	{
+		// the upper edge of the last bin going left
+		index_t last_left=0;
+		for (index_t b=0;b<MISSING_BIN;++b)
+		{
+			if (left_bins[b])
+				last_left=b;
+		}
+		left[0]=edges[last_left];
+		right[0]=edges[last_left];
+		count_left=1;
+		count_right=1;
+	}
+
+	num_missing_final=0;
+	for (index_t i=0;i<ids.vlen;++i)
+	{
+		auto b=m_bins(best_attribute,ids[i]);
+		if (b==MISSING_BIN)
+			++num_missing_final;
+		is_left_final[i]=left_bins[b];
+	}
+
+	return best_attribute;
+}
+
 SGVector<bool> CCARTree::surrogate_split(SGMatrix<float64_t> m,SGVector<float64_t> weights, SGVector<bool> nm_left, int32_t attr) const
 {
 	// return vector - left/right belongingness
@@ -1494,10 +1965,19 @@ void CCARTree::init()
 	m_label_epsilon=1e-7;
 	m_sorted_features=SGMatrix<float64_t>();
 	m_sorted_indices=SGMatrix<index_t>();
+	m_num_bins=0;
+	m_bins=SGMatrix<uint8_t>();
+	m_bin_edges=SGMatrix<float64_t>();
+	m_pre_binned=false;
+	m_num_classes=0;
 
 	SG_ADD(&m_pre_sort, "pre_sort", "presort");
 	SG_ADD(&m_sorted_features, "sorted_features", "sorted feats");
 	SG_ADD(&m_sorted_indices, "sorted_indices", "sorted indices");
+	SG_ADD(&m_num_bins, "num_bins", "number of histogram bins per feature");
+	SG_ADD(&m_pre_binned, "pre_binned", "prebinned");
+	SG_ADD(&m_bins, "bins", "binned feats");
+	SG_ADD(&m_bin_edges, "bin_edges", "upper bin edges");
 	SG_ADD(&m_nominal, "nominal", "feature types");
 	SG_ADD(&m_weights, "weights", "weights");
 	SG_ADD(
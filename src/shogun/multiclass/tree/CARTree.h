@@ -229,10 +229,45 @@ public:
 	 */
 	void set_label_epsilon(float64_t epsilon);
 
+	/** get number of histogram bins per feature
+	 *
+	 * @return number of bins, 0 if splits are searched on the exact values
+	 */
+	int32_t get_num_bins() const { return m_num_bins; }
+
+	/** set number of histogram bins per feature. With bins the feature
+	 * values are quantized once before training and every node searches its
+	 * split on per feature histograms of the label statistics instead of
+	 * sorting the feature values. A node scans only its smaller child, the
+	 * histogram of the larger one is the difference to the parent.
+	 *
+	 * @param bins number of bins between 2 and 255, 0 for exact splits
+	 */
+	void set_num_bins(int32_t bins);
+
 	void pre_sort_features(CFeatures* data, SGMatrix<float64_t>& sorted_feats, SGMatrix<index_t>& sorted_indices);
 
 	void set_sorted_features(SGMatrix<float64_t>& sorted_feats, SGMatrix<index_t>& sorted_indices);
 
+	/** quantize the features into at most get_num_bins() bins. Continuous
+	 * features get the distinct values or quantiles as bin edges, nominal
+	 * features one bin per category. Missing values go to MISSING_BIN.
+	 *
+	 * @param data training data
+	 * @param bins bin of every feature value, columns are indexed by the
+	 * storage index of the vectors
+	 * @param bin_edges upper edges of the bins, one column per feature
+	 * padded with MISSING
+	 */
+	void pre_bin_features(CFeatures* data, SGMatrix<uint8_t>& bins, SGMatrix<float64_t>& bin_edges);
+
+	/** use features quantized by pre_bin_features in train
+	 *
+	 * @param bins bin of every feature value
+	 * @param bin_edges upper edges of the bins
+	 */
+	void set_binned_features(SGMatrix<uint8_t>& bins, SGMatrix<float64_t>& bin_edges);
+
 protected:
 	/** train machine - build CART from training data
 	 * @param data training data
@@ -246,9 +281,12 @@ protected:
 	 * @param weights vector of weights of data points
 	 * @param labels labels of data points
 	 * @param level current tree depth
+	 * @param histogram label statistics of the node if the features are
+	 * binned, computed if empty
 	 * @return pointer to the root of the CART subtree
 	 */
-	virtual CBinaryTreeMachineNode<CARTreeNodeData>* CARTtrain(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, int32_t level);
+	virtual CBinaryTreeMachineNode<CARTreeNodeData>* CARTtrain(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, int32_t level,
+		SGVector<float64_t> histogram=SGVector<float64_t>());
 
 	/** modify labels for compute_best_attribute
 	 *
@@ -275,6 +313,40 @@ protected:
 		SGVector<float64_t>& left, SGVector<float64_t>& right, SGVector<bool>& is_left_final, index_t &num_missing,
 		index_t &count_left, index_t &count_right, index_t subset_size=0, const SGVector<index_t>& active_indices=SGVector<index_t>());
 
+	/** computes best attribute for CARTtrain from the histograms of binned
+	 * features
+	 *
+	 * @param histogram label statistics of every bin of every feature
+	 * @param ids storage indices of the vectors in the node
+	 * @param weights data weights
+	 * @param labels data labels
+	 * @param left stores feature values for left transition
+	 * @param right stores feature values for right transition
+	 * @param is_left_final stores which feature vectors go to the left child
+	 * @param num_missing number of missing attributes
+	 * @param count_left stores number of feature values for left transition
+	 * @param count_right stores number of feature values for right transition
+	 * @param subset_size number of randomly chosen features to search, all if 0
+	 * @return index to the best attribute
+	 */
+	virtual index_t compute_best_attribute_binned(const SGVector<float64_t>& histogram, const SGVector<index_t>& ids,
+		const SGVector<float64_t>& weights, CDenseLabels* labels, SGVector<float64_t>& left, SGVector<float64_t>& right,
+		SGVector<bool>& is_left_final, index_t &num_missing, index_t &count_left, index_t &count_right, index_t subset_size=0);
+
+	/** label statistics of every bin of every feature for the given vectors
+	 *
+	 * @param ids storage indices of the vectors
+	 * @param weights data weights
+	 * @param labels data labels
+	 * @return histogram with get_num_stats() values per bin
+	 */
+	SGVector<float64_t> compute_histogram(const SGVector<index_t>& ids, const SGVector<float64_t>& weights, const SGVector<float64_t>& labels) const;
+
+	/** @return number of label statistics kept per histogram bin: the count
+	 * and the class weights or the weighted sums of the regression labels
+	 */
+	index_t get_num_stats() const;
+
 
 	/** handles missing values through surrogate splits
 	 *
@@ -423,6 +495,9 @@ public:
 	/** equality epsilon */
 	static const float64_t EQ_DELTA;
 
+	/** bin of missing feature values */
+	static const uint8_t MISSING_BIN;
+
 protected:
 	/** Returns whether the type of various feature dimensions are specified
 	 * using is_nominal_feature
@@ -450,6 +525,21 @@ protected:
 	/** If pre sorted features are used in train */
 	bool m_pre_sort;
 
+	/** number of histogram bins per feature, 0 for exact splits */
+	int32_t m_num_bins;
+
+	/** bins of the features */
+	SGMatrix<uint8_t> m_bins;
+
+	/** upper bin edges of every feature */
+	SGMatrix<float64_t> m_bin_edges;
+
+	/** If pre binned features are used in train */
+	bool m_pre_binned;
+
+	/** number of classes counted in the histograms */
+	index_t m_num_classes;
+
 	/** flag indicating whether cross validation pruning has to be applied or not - false by default **/
 	bool m_apply_cv_pruning;
 
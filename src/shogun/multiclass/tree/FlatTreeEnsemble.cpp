@@ -0,0 +1,202 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <shogun/base/Parallel.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/ThreadPool.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+namespace
+{
+	typedef CBinaryTreeMachineNode<CARTreeNodeData> bnode_t;
+
+	// samples walked through every tree before the next block
+	constexpr index_t block_size = 64;
+
+	// number of nodes and of left categories of nominal splits of a subtree
+	void count_nodes(
+	    bnode_t* node, const SGVector<bool>& nominal, index_t& num_nodes,
+	    index_t& num_categories)
+	{
+		++num_nodes;
+		if (node->data.num_leaves == 1)
+			return;
+
+		bnode_t* left = node->left();
+		bnode_t* right = node->right();
+		if (nominal[node->data.attribute_id])
+			num_categories += left->data.transit_into_values.vlen;
+		count_nodes(left, nominal, num_nodes, num_categories);
+		count_nodes(right, nominal, num_nodes, num_categories);
+		SG_UNREF(left);
+		SG_UNREF(right);
+	}
+}
+
+CFlatTreeEnsemble::CFlatTreeEnsemble() : CSGObject()
+{
+	init();
+}
+
+CFlatTreeEnsemble::~CFlatTreeEnsemble()
+{
+}
+
+void CFlatTreeEnsemble::init()
+{
+	m_category_offsets = SGVector<index_t>(1);
+	m_category_offsets[0] = 0;
+
+	SG_ADD(&m_roots, "roots", "first node of every tree");
+	SG_ADD(&m_attributes, "attributes", "attribute tested by every node");
+	SG_ADD(&m_right, "right", "right child of every node");
+	SG_ADD(&m_values, "values", "thresholds and leaf labels");
+	SG_ADD(
+	    &m_category_offsets, "category_offsets",
+	    "start of the left categories of every node");
+	SG_ADD(&m_categories, "categories", "left categories of nominal splits");
+}
+
+void CFlatTreeEnsemble::add_tree(CCARTree* tree)
+{
+	require(tree, "Tree has to be supplied");
+	auto root = dynamic_cast<bnode_t*>(tree->get_root());
+	require(root, "Tree {} is not trained", tree->get_name());
+
+	auto nominal = tree->get_feature_types();
+	index_t num_nodes = 0;
+	index_t num_categories = 0;
+	count_nodes(root, nominal, num_nodes, num_categories);
+
+	auto first_node = m_attributes.vlen;
+	auto first_category = m_categories.vlen;
+	m_attributes.resize_vector(first_node + num_nodes);
+	m_right.resize_vector(first_node + num_nodes);
+	m_values.resize_vector(first_node + num_nodes);
+	m_category_offsets.resize_vector(first_node + num_nodes + 1);
+	m_categories.resize_vector(first_category + num_categories);
+
+	// nodes and categories are filled in from the previous ends
+	num_nodes = first_node;
+	num_categories = first_category;
+	add_node(root, nominal, num_nodes, num_categories);
+	SG_UNREF(root);
+
+	m_roots.resize_vector(m_roots.vlen + 1);
+	m_roots[m_roots.vlen - 1] = first_node;
+}
+
+index_t CFlatTreeEnsemble::add_node(
+    CBinaryTreeMachineNode<CARTreeNodeData>* node,
+    const SGVector<bool>& nominal, index_t& num_nodes,
+    index_t& num_categories)
+{
+	auto index = num_nodes++;
+	m_category_offsets[index] = num_categories;
+	m_category_offsets[index + 1] = num_categories;
+
+	if (node->data.num_leaves == 1)
+	{
+		m_attributes[index] = -1;
+		m_right[index] = -1;
+		m_values[index] = node->data.node_label;
+		return index;
+	}
+
+	bnode_t* left = node->left();
+	bnode_t* right = node->right();
+	const auto& transit = left->data.transit_into_values;
+	m_attributes[index] = node->data.attribute_id;
+	m_values[index] = transit[0];
+	if (nominal[node->data.attribute_id])
+	{
+		std::copy_n(
+		    transit.vector, transit.vlen, m_categories.vector + num_categories);
+		num_categories += transit.vlen;
+		m_category_offsets[index + 1] = num_categories;
+	}
+
+	add_node(left, nominal, num_nodes, num_categories);
+	m_right[index] = add_node(right, nominal, num_nodes, num_categories);
+	SG_UNREF(left);
+	SG_UNREF(right);
+
+	return index;
+}
+
+template <class F>
+void CFlatTreeEnsemble::apply_blocks(
+    CDenseFeatures<float64_t>* data, F&& body) const
+{
+	require(data, "Data has to be supplied");
+	require(m_roots.vlen > 0, "No trees were added");
+
+	auto mat = data->get_feature_matrix();
+	auto num_trees = m_roots.vlen;
+	env()->get_thread_pool()->parallel_for(
+	    0, (mat.num_cols + block_size - 1) / block_size, 1,
+	    [&](index_t begin, index_t end) {
+		    SGMatrix<float64_t> outputs(block_size, num_trees);
+		    for (index_t block = begin; block < end; ++block)
+		    {
+			    auto first = block * block_size;
+			    auto size = std::min(block_size, mat.num_cols - first);
+			    for (index_t t = 0; t < num_trees; ++t)
+			    {
+				    for (index_t i = 0; i < size; ++i)
+					    outputs(i, t) = predict(
+					        m_roots[t], mat.get_column_vector(first + i));
+			    }
+			    body(first, size, outputs);
+		    }
+	    });
+}
+
+SGMatrix<float64_t>
+CFlatTreeEnsemble::apply(CDenseFeatures<float64_t>* data) const
+{
+	SGMatrix<float64_t> result(data->get_num_vectors(), m_roots.vlen);
+	apply_blocks(
+	    data, [&](index_t first, index_t size,
+	              const SGMatrix<float64_t>& outputs) {
+		    for (index_t t = 0; t < result.num_cols; ++t)
+			    std::copy_n(
+			        outputs.get_column_vector(t), size,
+			        result.get_column_vector(t) + first);
+	    });
+
+	return result;
+}
+
+SGVector<float64_t> CFlatTreeEnsemble::apply_weighted_sum(
+    CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights,
+    float64_t scale) const
+{
+	require(
+	    weights.vlen == m_roots.vlen,
+	    "Number of weights ({}) should be the number of trees ({})",
+	    weights.vlen, m_roots.vlen);
+
+	SGVector<float64_t> result(data->get_num_vectors());
+	apply_blocks(
+	    data, [&](index_t first, index_t size,
+	              const SGMatrix<float64_t>& outputs) {
+		    for (index_t i = 0; i < size; ++i)
+		    {
+			    float64_t sum = 0;
+			    for (index_t t = 0; t < weights.vlen; ++t)
+				    sum += outputs(i, t) * weights[t] * scale;
+			    result[first + i] = sum;
+		    }
+	    });
+
+	return result;
+}
@@ -0,0 +1,149 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#ifndef _FLATTREEENSEMBLE_H__
+#define _FLATTREEENSEMBLE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/multiclass/tree/CARTree.h>
+
+namespace shogun
+{
+
+/** @brief Trained CART trees compiled into contiguous node arrays for
+ * prediction.
+ *
+ * The nodes of all trees are stored in pre-order, the left child of a node
+ * is the next node and only the right child is stored. Inner nodes keep the
+ * attribute and the threshold or the categories that go left, leaves keep
+ * their label. Samples are predicted in blocks, every tree walks the whole
+ * block before the next tree is loaded, and the blocks are processed in
+ * parallel on the thread pool.
+ *
+ * The outputs are the same as the ones of CCARTree::apply of every tree.
+ */
+class CFlatTreeEnsemble : public CSGObject
+{
+public:
+	/** default constructor */
+	CFlatTreeEnsemble();
+
+	virtual ~CFlatTreeEnsemble();
+
+	/** append the nodes of a trained tree
+	 *
+	 * @param tree trained tree
+	 */
+	void add_tree(CCARTree* tree);
+
+	/** @return number of trees */
+	index_t get_num_trees() const
+	{
+		return m_roots.vlen;
+	}
+
+	/** @return number of nodes of all trees */
+	index_t get_num_nodes() const
+	{
+		return m_attributes.vlen;
+	}
+
+	/** outputs of every tree
+	 *
+	 * @param data samples to predict
+	 * @return num_vectors x num_trees matrix of the tree outputs
+	 */
+	SGMatrix<float64_t> apply(CDenseFeatures<float64_t>* data) const;
+
+	/** weighted sum of the tree outputs, added up in the order of the trees
+	 *
+	 * @param data samples to predict
+	 * @param weights weight of every tree
+	 * @param scale common factor of the weights
+	 * @return weighted sum for every sample
+	 */
+	SGVector<float64_t> apply_weighted_sum(
+	    CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights,
+	    float64_t scale = 1.0) const;
+
+	/** @return object name */
+	virtual const char* get_name() const
+	{
+		return "FlatTreeEnsemble";
+	}
+
+private:
+	void init();
+
+	/** append the subtree of node in pre-order
+	 *
+	 * @param node root of the subtree
+	 * @param nominal feature types of the tree
+	 * @param num_nodes number of flattened nodes
+	 * @param num_categories number of stored categories
+	 * @return index of the flattened node
+	 */
+	index_t add_node(
+	    CBinaryTreeMachineNode<CARTreeNodeData>* node,
+	    const SGVector<bool>& nominal, index_t& num_nodes,
+	    index_t& num_categories);
+
+	/** output of the tree with the given root for a sample */
+	float64_t predict(index_t root, const float64_t* sample) const
+	{
+		index_t node = root;
+		while (m_attributes[node] >= 0)
+		{
+			float64_t value = sample[m_attributes[node]];
+			auto begin = m_category_offsets[node];
+			auto end = m_category_offsets[node + 1];
+			bool left = false;
+			if (begin == end)
+				left = value <= m_values[node];
+			else
+			{
+				for (index_t i = begin; i < end && !left; ++i)
+					left = m_categories[i] == value;
+			}
+			node = left ? node + 1 : m_right[node];
+		}
+
+		return m_values[node];
+	}
+
+	/** call body with the block and the outputs of every tree for it */
+	template <class F>
+	void apply_blocks(CDenseFeatures<float64_t>* data, F&& body) const;
+
+protected:
+	/** first node of every tree */
+	SGVector<index_t> m_roots;
+
+	/** attribute tested by every node, -1 for leaves */
+	SGVector<int32_t> m_attributes;
+
+	/** right child of every node */
+	SGVector<index_t> m_right;
+
+	/** threshold of continuous splits and label of leaves */
+	SGVector<float64_t> m_values;
+
+	/** start of the left categories of every node in m_categories, with an
+	 * additional end entry. Continuous splits and leaves have none.
+	 */
+	SGVector<index_t> m_category_offsets;
+
+	/** categories going left of all nominal splits */
+	SGVector<float64_t> m_categories;
+};
+}
+
+#endif // _FLATTREEENSEMBLE_H__
@@ -0,0 +1,114 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/ensemble/MajorityVote.h"
+#include "shogun/features/DenseFeatures.h"
+#include "shogun/labels/MulticlassLabels.h"
+#include "shogun/lib/DynamicObjectArray.h"
+#include "shogun/machine/RandomForest.h"
+
+#include <random>
+
+namespace shogun
+{
+
+class FlatTreeEnsembleFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		std::mt19937_64 prng(17);
+		std::normal_distribution<float64_t> dist;
+
+		SGMatrix<float64_t> train_data(dim, num_train);
+		SGVector<float64_t> lab(num_train);
+		for (index_t i = 0; i < num_train; i++)
+		{
+			for (index_t j = 0; j < dim; j++)
+				train_data(j, i) = dist(prng);
+			lab[i] = train_data(0, i) + train_data(1, i) > 0 ? 1 : 0;
+		}
+
+		const index_t num_test = st.range(0);
+		SGMatrix<float64_t> test_data(dim, num_test);
+		for (index_t i = 0; i < dim * num_test; i++)
+			test_data[i] = dist(prng);
+
+		train = new CDenseFeatures<float64_t>(train_data);
+		test = new CDenseFeatures<float64_t>(test_data);
+		SG_REF(train);
+		SG_REF(test);
+
+		SGVector<bool> ft(dim);
+		ft.set_const(false);
+
+		forest = new CRandomForest(train, new CMulticlassLabels(lab), num_trees);
+		SG_REF(forest);
+		forest->set_feature_types(ft);
+		forest->set_combination_rule(new CMajorityVote());
+		forest->put("seed", 17);
+		forest->train(train);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(forest);
+		SG_UNREF(train);
+		SG_UNREF(test);
+	}
+
+	static constexpr index_t dim = 16;
+	static constexpr index_t num_train = 2000;
+	static constexpr index_t num_trees = 50;
+	CDenseFeatures<float64_t>* train;
+	CDenseFeatures<float64_t>* test;
+	CRandomForest* forest;
+};
+
+/* all trees compiled into node arrays */
+BENCHMARK_DEFINE_F(FlatTreeEnsembleFixture, apply)(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		auto result = forest->apply_multiclass(test);
+		benchmark::DoNotOptimize(result->get_labels().vector);
+		SG_UNREF(result);
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+/* walking the node objects of every tree, as done before */
+BENCHMARK_DEFINE_F(FlatTreeEnsembleFixture, apply_node_objects)
+(benchmark::State& st)
+{
+	auto bags = forest->get<CDynamicObjectArray*>("bags");
+	for (auto _ : st)
+	{
+		for (index_t i = 0; i < bags->get_num_elements(); i++)
+		{
+			auto tree = bags->get_element(i)->as<CMachine>();
+			auto result = tree->apply_multiclass(test);
+			benchmark::DoNotOptimize(result->get_labels().vector);
+			SG_UNREF(result);
+			SG_UNREF(tree);
+		}
+	}
+	st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+
+BENCHMARK_REGISTER_F(FlatTreeEnsembleFixture, apply)
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(FlatTreeEnsembleFixture, apply_node_objects)
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+}
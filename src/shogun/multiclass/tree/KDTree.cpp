@@ -54,6 +54,21 @@ float64_t CKDTree::min_dist(bnode_t* node,float64_t* feat, int32_t dim)
 	return actual_dists(dist);
 }
 
+float64_t CKDTree::min_dist_flat(index_t node, float64_t* feat, int32_t dim)
+{
+	const float64_t* lower=flat_lower(node);
+	const float64_t* upper=flat_upper(node);
+	float64_t dist=0;
+	for (int32_t i=0;i<dim;i++)
+	{
+		float64_t dim_dist=(lower[i]-feat[i])+CMath::abs(feat[i]-lower[i]);
+		dim_dist+=(feat[i]-upper[i])+CMath::abs(feat[i]-upper[i]);
+		dist+=add_dim_dist(0.5*dim_dist);
+	}
+
+	return actual_dists(dist);
+}
+
 float64_t CKDTree::min_dist_dual(bnode_t* nodeq, bnode_t* noder)
 {
 	SGVector<float64_t> nodeq_lower=nodeq->data.bbox_lower;
@@ -70,6 +70,16 @@ private:
 	 */
 	float64_t min_dist(bnode_t* node,float64_t* feat, int32_t dim);
 
+	/** find minimum distance between a node of the flattened tree and a
+	 * query vector
+	 *
+	 * @param node index of the node
+	 * @param feat query vector
+	 * @param dim dimensions of query vector
+	 * @return min distance
+	 */
+	float64_t min_dist_flat(index_t node, float64_t* feat, int32_t dim);
+
 	/** find minimum distance between 2 nodes
 	 *
 	 * @param nodeq node containing active query vectors
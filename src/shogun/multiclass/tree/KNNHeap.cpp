@@ -48,6 +48,16 @@ CKNNHeap::CKNNHeap(int32_t k)
 	}
 }
 
+void CKNNHeap::clear()
+{
+	m_sorted=false;
+	for (int32_t i=0;i<m_capacity;i++)
+	{
+		m_dists[i]=CMath::MAX_REAL_NUMBER;
+		m_inds[i]=0;
+	}
+}
+
 void CKNNHeap::push(index_t index, float64_t dist)
 {
 	if (dist>m_dists[0])
@@ -63,6 +63,9 @@ public:
 	 */
 	void push(index_t index, float64_t dist);
 
+	/** empty the heap, so that it can be reused for another query */
+	void clear();
+
 	/** max distance
 	 *
 	 * @return max distance value stored in the heap
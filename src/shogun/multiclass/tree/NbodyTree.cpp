@@ -28,11 +28,20 @@
  * either expressed or implied, of the Shogun Development Team.
  */
 
+#include <shogun/base/Parallel.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/ThreadPool.h>
 #include <shogun/multiclass/tree/NbodyTree.h>
 #include <shogun/distributions/KernelDensity.h>
 
 using namespace shogun;
 
+namespace
+{
+/** subtrees with at least this many vectors are built in parallel */
+const index_t parallel_build_size=4096;
+}
+
 CNbodyTree::CNbodyTree(int32_t leaf_size, EDistanceType d)
 : CTreeMachine<NbodyTreeNodeData>()
 {
@@ -54,6 +63,10 @@ void CNbodyTree::build_tree(CDenseFeatures<float64_t>* data)
 	m_vec_id.range_fill(0);
 
 	set_root(recursive_build(0,m_data.num_cols-1));
+
+	m_flat_nodes.clear();
+	m_flat_bounds.clear();
+	flatten(dynamic_cast<bnode_t*>(m_root));
 }
 
 void CNbodyTree::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
@@ -67,20 +80,22 @@ void CNbodyTree::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
 	m_knn_indices=SGMatrix<index_t>(k,qfeats.num_cols);
 	int32_t dim=qfeats.num_rows;
 
-	for (int32_t i=0;i<qfeats.num_cols;i++)
-	{
-		CKNNHeap* heap=new CKNNHeap(k);
-		bnode_t* root=NULL;
-		if (m_root)
-			root=dynamic_cast<bnode_t*>(m_root);
-
-		float64_t mdist=min_dist(root,qfeats.matrix+i*dim,dim);
-		query_knn_single(heap,mdist,root,qfeats.matrix+i*dim,dim);
-		sg_memcpy(m_knn_dists.matrix+i*k,heap->get_dists(),k*sizeof(float64_t));
-		sg_memcpy(m_knn_indices.matrix+i*k,heap->get_indices(),k*sizeof(index_t));
+	// a deserialized tree has not been flattened yet
+	if (m_flat_nodes.empty() && m_root)
+		flatten(dynamic_cast<bnode_t*>(m_root));
 
-		delete(heap);
-	}
+	env()->get_thread_pool()->parallel_for(0, qfeats.num_cols, [&](index_t begin, index_t end)
+	{
+		CKNNHeap heap(k);
+		for (index_t i=begin;i<end;i++)
+		{
+			heap.clear();
+			float64_t mdist=min_dist_flat(0,qfeats.get_column_vector(i),dim);
+			query_knn_single(&heap,mdist,0,qfeats.get_column_vector(i),dim);
+			sg_memcpy(m_knn_dists.get_column_vector(i),heap.get_dists(),k*sizeof(float64_t));
+			sg_memcpy(m_knn_indices.get_column_vector(i),heap.get_indices(),k*sizeof(index_t));
+		}
+	});
 }
 
 SGVector<float64_t> CNbodyTree::log_kernel_density(SGMatrix<float64_t> test, EKernelType kernel, float64_t h, float64_t atol, float64_t rtol)
@@ -92,26 +107,30 @@ SGVector<float64_t> CNbodyTree::log_kernel_density(SGMatrix<float64_t> test, EKe
 	float64_t log_rtol = std::log(rtol);
 	float64_t log_kernel_norm=CKernelDensity::log_norm(kernel,h,dim);
 	SGVector<float64_t> log_density(test.num_cols);
-	for (int32_t i=0;i<test.num_cols;i++)
+	bnode_t* root=NULL;
+	if (m_root)
+		root=dynamic_cast<bnode_t*>(m_root);
+
+	// query points are independent, the tree is only read
+	env()->get_thread_pool()->parallel_for(0, test.num_cols, [&](index_t begin, index_t end)
 	{
-		bnode_t* root=NULL;
-		if (m_root)
-			root=dynamic_cast<bnode_t*>(m_root);
-
-		float64_t lower_dist=0;
-		float64_t upper_dist=0;
-		min_max_dist(test.matrix+i*dim,root,lower_dist,upper_dist,dim);
-
-		float64_t min_bound = std::log(m_data.num_cols) +
-		                      CKernelDensity::log_kernel(kernel, upper_dist, h);
-		float64_t max_bound = std::log(m_data.num_cols) +
-		                      CKernelDensity::log_kernel(kernel, lower_dist, h);
-		float64_t spread=logdiffexp(max_bound,min_bound);
-
-		get_kde_single(root,test.matrix+i*dim,kernel,h,log_atol,log_rtol,log_kernel_norm,min_bound,spread,min_bound,spread);
-		log_density[i] = logsumexp(min_bound, spread - std::log(2)) +
-		                 log_kernel_norm - std::log(m_data.num_cols);
-	}
+		for (index_t i=begin;i<end;i++)
+		{
+			float64_t lower_dist=0;
+			float64_t upper_dist=0;
+			min_max_dist(test.get_column_vector(i),root,lower_dist,upper_dist,dim);
+
+			float64_t min_bound = std::log(m_data.num_cols) +
+			                      CKernelDensity::log_kernel(kernel, upper_dist, h);
+			float64_t max_bound = std::log(m_data.num_cols) +
+			                      CKernelDensity::log_kernel(kernel, lower_dist, h);
+			float64_t spread=logdiffexp(max_bound,min_bound);
+
+			get_kde_single(root,test.get_column_vector(i),kernel,h,log_atol,log_rtol,log_kernel_norm,min_bound,spread,min_bound,spread);
+			log_density[i] = logsumexp(min_bound, spread - std::log(2)) +
+			                 log_kernel_norm - std::log(m_data.num_cols);
+		}
+	});
 
 	return log_density;
 }
@@ -166,41 +185,69 @@ SGMatrix<index_t> CNbodyTree::get_knn_indices()
 	return SGMatrix<index_t>();
 }
 
-void CNbodyTree::query_knn_single(CKNNHeap* heap, float64_t mdist, bnode_t* node, float64_t* arr, int32_t dim)
+void CNbodyTree::query_knn_single(CKNNHeap* heap, float64_t mdist, index_t node, float64_t* arr, int32_t dim)
 {
 	if (mdist>heap->get_max_dist())
 		return;
 
-	if (node->data.is_leaf)
+	const FlatNode& current=m_flat_nodes[node];
+	if (current.left<0)
 	{
-		index_t start=node->data.start_idx;
-		index_t end=node->data.end_idx;
-
-		for (int32_t i=start;i<=end;i++)
+		for (index_t i=current.start_idx;i<=current.end_idx;i++)
 			heap->push(m_vec_id[i],distance(m_vec_id[i],arr,dim));
 
 		return;
 	}
 
-	bnode_t* cleft=node->left();
-	bnode_t* cright=node->right();
-
-	float64_t min_dist_left=min_dist(cleft,arr,dim);
-	float64_t min_dist_right=min_dist(cright,arr,dim);
+	float64_t min_dist_left=min_dist_flat(current.left,arr,dim);
+	float64_t min_dist_right=min_dist_flat(current.right,arr,dim);
 
 	if (min_dist_left<=min_dist_right)
 	{
-		query_knn_single(heap,min_dist_left,cleft,arr,dim);
-		query_knn_single(heap,min_dist_right,cright,arr,dim);
+		query_knn_single(heap,min_dist_left,current.left,arr,dim);
+		query_knn_single(heap,min_dist_right,current.right,arr,dim);
 	}
 	else
 	{
-		query_knn_single(heap,min_dist_right,cright,arr,dim);
-		query_knn_single(heap,min_dist_left,cleft,arr,dim);
+		query_knn_single(heap,min_dist_right,current.right,arr,dim);
+		query_knn_single(heap,min_dist_left,current.left,arr,dim);
 	}
+}
+
+index_t CNbodyTree::flatten(bnode_t* node)
+{
+	index_t id=m_flat_nodes.size();
+	FlatNode flat;
+	flat.start_idx=node->data.start_idx;
+	flat.end_idx=node->data.end_idx;
+	flat.left=-1;
+	flat.right=-1;
+	flat.radius=node->data.radius;
+	m_flat_nodes.push_back(flat);
+
+	int32_t dim=m_data.num_rows;
+	SGVector<float64_t> center=node->data.center;
+	m_flat_bounds.insert(m_flat_bounds.end(),node->data.bbox_lower.vector,node->data.bbox_lower.vector+dim);
+	m_flat_bounds.insert(m_flat_bounds.end(),node->data.bbox_upper.vector,node->data.bbox_upper.vector+dim);
+	if (center.vlen==dim)
+		m_flat_bounds.insert(m_flat_bounds.end(),center.vector,center.vector+dim);
+	else
+		m_flat_bounds.resize(m_flat_bounds.size()+dim,0);
+
+	if (node->data.is_leaf)
+		return id;
+
+	bnode_t* cleft=node->left();
+	bnode_t* cright=node->right();
+
+	index_t left=flatten(cleft);
+	index_t right=flatten(cright);
+	m_flat_nodes[id].left=left;
+	m_flat_nodes[id].right=right;
 
 	SG_UNREF(cleft);
 	SG_UNREF(cright);
+	return id;
 }
 
 float64_t CNbodyTree::distance(index_t vec, float64_t* arr, int32_t dim)
@@ -229,8 +276,25 @@ CBinaryTreeMachineNode<NbodyTreeNodeData>* CNbodyTree::recursive_build(index_t s
 	index_t mid=(end+start)/2;
 	partition(dim,start,end,mid);
 
-	bnode_t* child_left=recursive_build(start,mid);
-	bnode_t* child_right=recursive_build(mid+1,end);
+	// the halves are disjoint parts of m_vec_id, large ones are built as
+	// separate tasks
+	bnode_t* child_left=NULL;
+	bnode_t* child_right=NULL;
+	if (end-start+1>=parallel_build_size)
+	{
+		env()->get_thread_pool()->parallel_for(0, 2, 1, [&](index_t begin, index_t)
+		{
+			if (begin==0)
+				child_left=recursive_build(start,mid);
+			else
+				child_right=recursive_build(mid+1,end);
+		});
+	}
+	else
+	{
+		child_left=recursive_build(start,mid);
+		child_right=recursive_build(mid+1,end);
+	}
 
 	node->left(child_left);
 	node->right(child_right);
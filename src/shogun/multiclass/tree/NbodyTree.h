@@ -41,6 +41,8 @@
 #include <shogun/multiclass/tree/KNNHeap.h>
 #include <shogun/features/DenseFeatures.h>
 
+#include <vector>
+
 namespace shogun
 {
 
@@ -130,6 +132,16 @@ protected:
 	 */
 	virtual float64_t min_dist(bnode_t* node,float64_t* feat, int32_t dim)=0;
 
+	/** find minimum distance between a node of the flattened tree and a
+	 * query vector
+	 *
+	 * @param node index of the node in m_flat_nodes
+	 * @param feat query vector
+	 * @param dim dimensions of query vector
+	 * @return min distance
+	 */
+	virtual float64_t min_dist_flat(index_t node, float64_t* feat, int32_t dim)=0;
+
 	/** find minimum distance between 2 nodes
 	 *
 	 * @param nodeq node containing active query vectors
@@ -203,17 +215,55 @@ protected:
 		return 0;
 	}
 
+	/** bounding box lower bounds of a node of the flattened tree
+	 *
+	 * @param node index of the node in m_flat_nodes
+	 * @return lower bounds, one per dimension
+	 */
+	inline const float64_t* flat_lower(index_t node) const
+	{
+		return m_flat_bounds.data()+int64_t(node)*3*m_data.num_rows;
+	}
+
+	/** bounding box upper bounds of a node of the flattened tree
+	 *
+	 * @param node index of the node in m_flat_nodes
+	 * @return upper bounds, one per dimension
+	 */
+	inline const float64_t* flat_upper(index_t node) const
+	{
+		return flat_lower(node)+m_data.num_rows;
+	}
+
+	/** center of a node of the flattened tree, zero if the tree does not
+	 * use centers
+	 *
+	 * @param node index of the node in m_flat_nodes
+	 * @return center, one value per dimension
+	 */
+	inline const float64_t* flat_center(index_t node) const
+	{
+		return flat_lower(node)+2*m_data.num_rows;
+	}
+
 private:
 
 	/** apply knn on each query vector
 	 *
 	 * @param heap heap to store kNN distances and indices of corresponding vectors
 	 * @param min_dist minimum distance b/ query point and the current node
-	 * @param node current node
+	 * @param node index of the current node in m_flat_nodes
 	 * @param arr current query vector
 	 * @param dim dimension of query vector
 	 */
-	void query_knn_single(CKNNHeap* heap, float64_t min_dist, bnode_t* node, float64_t* arr, int32_t dim);
+	void query_knn_single(CKNNHeap* heap, float64_t min_dist, index_t node, float64_t* arr, int32_t dim);
+
+	/** append a subtree to the flattened tree in depth-first order
+	 *
+	 * @param node root of the subtree
+	 * @return index of node in m_flat_nodes
+	 */
+	index_t flatten(bnode_t* node);
 
 	/** find kde at each query point
 	 *
@@ -316,6 +366,31 @@ protected:
 	/** vector id */
 	SGVector<index_t> m_vec_id;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** node of the flattened tree */
+	struct FlatNode
+	{
+		/** start index */
+		index_t start_idx;
+		/** end index */
+		index_t end_idx;
+		/** index of the left child, -1 for leaves */
+		index_t left;
+		/** index of the right child, -1 for leaves */
+		index_t right;
+		/** radius of point cloud in node */
+		float64_t radius;
+	};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** nodes of the tree in depth-first order, which is traversed by the
+	 * knn queries instead of the node objects
+	 */
+	std::vector<FlatNode> m_flat_nodes;
+
+	/** lower bounds, upper bounds and center of every flattened node */
+	std::vector<float64_t> m_flat_bounds;
+
 private:
 	/** leaf size */
 	int32_t m_leaf_size;
@@ -68,6 +68,23 @@ index_t CRandomCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, c
 
 }
 
+index_t CRandomCARTree::compute_best_attribute_binned(const SGVector<float64_t>& histogram, const SGVector<index_t>& ids,
+	const SGVector<float64_t>& weights, CDenseLabels* labels, SGVector<float64_t>& left, SGVector<float64_t>& right,
+	SGVector<bool>& is_left_final, index_t &num_missing_final, index_t &count_left, index_t &count_right, index_t subset_size)
+{
+	auto num_feats = m_bins.num_rows;
+
+	// if subset size is not set choose sqrt(num_feats) by default
+	if (m_randsubset_size==0)
+		m_randsubset_size = std::sqrt((float64_t)num_feats);
+	subset_size=m_randsubset_size;
+
+	require(subset_size<=num_feats, "The Feature subset size(set {}) should be less than"
+	" or equal to the total number of features({} here).",subset_size,num_feats);
+
+	return CCARTree::compute_best_attribute_binned(histogram,ids,weights,labels,left,right,is_left_final,num_missing_final,count_left,count_right,subset_size);
+}
+
 void CRandomCARTree::init()
 {
 	m_randsubset_size=0;
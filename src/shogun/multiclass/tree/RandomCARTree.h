@@ -89,6 +89,26 @@ protected:
 		SGVector<float64_t>& left, SGVector<float64_t>& right, SGVector<bool>& is_left_final, index_t &num_missing,
 		index_t &count_left, index_t &count_right, index_t subset_size=0, const SGVector<index_t>& active_indices=SGVector<index_t>());
 
+	/** computes best attribute for CARTtrain from the histograms of binned
+	 * features
+	 *
+	 * @param histogram label statistics of every bin of every feature
+	 * @param ids storage indices of the vectors in the node
+	 * @param weights data weights
+	 * @param labels data labels
+	 * @param left stores feature values for left transition
+	 * @param right stores feature values for right transition
+	 * @param is_left_final stores which feature vectors go to the left child
+	 * @param num_missing number of missing attributes
+	 * @param count_left stores number of feature values for left transition
+	 * @param count_right stores number of feature values for right transition
+	 * @param subset_size overridden by the random feature subset size
+	 * @return index to the best attribute
+	 */
+	virtual index_t compute_best_attribute_binned(const SGVector<float64_t>& histogram, const SGVector<index_t>& ids,
+		const SGVector<float64_t>& weights, CDenseLabels* labels, SGVector<float64_t>& left, SGVector<float64_t>& right,
+		SGVector<bool>& is_left_final, index_t &num_missing, index_t &count_left, index_t &count_right, index_t subset_size=0);
+
 private:
 	/** initialize parameters */
 	void init();
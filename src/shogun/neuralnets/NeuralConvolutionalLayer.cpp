@@ -31,12 +31,185 @@
  * Written (W) 2014 Khaled Nasr
  */
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/neuralnets/NeuralConvolutionalLayer.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/lib/DynamicObjectArray.h>
+#include <shogun/lib/MemoryArena.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/mathematics/NormalDistribution.h>
 
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#include <vector>
+
 using namespace shogun;
+using namespace Eigen;
+
+namespace
+{
+/** an image of one of the input layers, with the gradients that the input
+ * gradients are added to, which are NULL for input layers
+ */
+struct InputChannel
+{
+	const float64_t* images;
+	float64_t* gradients;
+	index_t stride;
+};
+
+/** positions at which the filters are applied, the convolution outputs of
+ * an autoencoder layer have the size of the inputs and are only computed at
+ * the strided positions
+ */
+struct ConvolutionShape
+{
+	int32_t input_width;
+	int32_t input_height;
+	int32_t radius_x;
+	int32_t radius_y;
+	int32_t stride_x;
+	int32_t stride_y;
+	bool autoencoder;
+
+	int32_t filter_width() const { return 2*radius_x+1; }
+	int32_t filter_height() const { return 2*radius_y+1; }
+
+	int32_t num_x() const
+	{
+		return autoencoder ? (input_width+stride_x-1)/stride_x :
+			input_width/stride_x;
+	}
+
+	int32_t num_y() const
+	{
+		return autoencoder ? (input_height+stride_y-1)/stride_y :
+			input_height/stride_y;
+	}
+
+	index_t num_positions() const { return index_t(num_x())*num_y(); }
+
+	/** number of convolution outputs of a map */
+	index_t map_size() const
+	{
+		return autoencoder ? index_t(input_width)*input_height :
+			num_positions();
+	}
+
+	/** index of the convolution output of a position in its map */
+	index_t output_index(int32_t px, int32_t py) const
+	{
+		return autoencoder ? py*stride_y + index_t(px)*stride_x*input_height :
+			py + index_t(px)*num_y();
+	}
+};
+
+/** copies the inputs that the filters see at every position of a sample to
+ * the columns of col, row c*fh*fw+wy+wx*fh of a column holds the input of
+ * channel c that is multiplied with the filter weight (wy, wx)
+ */
+template <class T>
+void im2col(const ConvolutionShape& shape,
+	const std::vector<InputChannel>& channels, index_t sample, T* col)
+{
+	const int32_t fw = shape.filter_width();
+	const int32_t fh = shape.filter_height();
+	const int32_t num_x = shape.num_x();
+	const int32_t num_y = shape.num_y();
+
+	for (int32_t px=0; px<num_x; px++)
+	{
+		const int32_t x = px*shape.stride_x;
+		for (int32_t py=0; py<num_y; py++)
+		{
+			const int32_t y = py*shape.stride_y;
+			for (const auto& channel : channels)
+			{
+				const float64_t* image = channel.images+sample*channel.stride;
+				for (int32_t wx=0; wx<fw; wx++)
+				{
+					const int32_t x1 = x+shape.radius_x-wx;
+					const bool valid_x = x1>=0 && x1<shape.input_width;
+					for (int32_t wy=0; wy<fh; wy++)
+					{
+						const int32_t y1 = y+shape.radius_y-wy;
+						*col++ = valid_x && y1>=0 && y1<shape.input_height ?
+							T(image[y1+index_t(x1)*shape.input_height]) : T(0);
+					}
+				}
+			}
+		}
+	}
+}
+
+/** adds the gradients of the columns of col to the gradients of the input
+ * images of a sample, the inverse of im2col
+ */
+template <class T>
+void col2im(const ConvolutionShape& shape,
+	const std::vector<InputChannel>& channels, index_t sample, const T* col)
+{
+	const int32_t fw = shape.filter_width();
+	const int32_t fh = shape.filter_height();
+	const int32_t num_x = shape.num_x();
+	const int32_t num_y = shape.num_y();
+
+	for (int32_t px=0; px<num_x; px++)
+	{
+		const int32_t x = px*shape.stride_x;
+		for (int32_t py=0; py<num_y; py++)
+		{
+			const int32_t y = py*shape.stride_y;
+			for (const auto& channel : channels)
+			{
+				if (!channel.gradients)
+				{
+					col += fw*fh;
+					continue;
+				}
+
+				float64_t* image = channel.gradients+sample*channel.stride;
+				for (int32_t wx=0; wx<fw; wx++)
+				{
+					const int32_t x1 = x+shape.radius_x-wx;
+					const bool valid_x = x1>=0 && x1<shape.input_width;
+					for (int32_t wy=0; wy<fh; wy++, col++)
+					{
+						const int32_t y1 = y+shape.radius_y-wy;
+						if (valid_x && y1>=0 && y1<shape.input_height)
+							image[y1+index_t(x1)*shape.input_height] += *col;
+					}
+				}
+			}
+		}
+	}
+}
+
+/** applies the activation function to a convolution output */
+inline float64_t activate(EConvMapActivationFunction function, float64_t x)
+{
+	if (function==CMAF_LOGISTIC)
+		return 1.0/(1.0+std::exp(-x));
+	else if (function==CMAF_RECTIFIED_LINEAR)
+		return CMath::max<float64_t>(0, x);
+	return x;
+}
+
+/** number of samples whose lowered inputs are multiplied at once, bounded
+ * such that the lowered inputs stay small and every thread gets a block
+ */
+index_t block_size(index_t batch_size, index_t column_size)
+{
+	const index_t max_elements = 1 << 18;
+	const index_t num_threads = env()->get_num_threads();
+	index_t size = (batch_size+num_threads-1)/num_threads;
+	size = CMath::min(size, max_elements/CMath::max<index_t>(column_size, 1));
+	return CMath::max<index_t>(size, 1);
+}
+}
 
 CNeuralConvolutionalLayer::CNeuralConvolutionalLayer() : CNeuralLayer()
 {
@@ -163,25 +336,10 @@ void CNeuralConvolutionalLayer::compute_activations(
 		SGVector<float64_t> parameters,
 		CDynamicObjectArray* layers)
 {
-	int32_t num_parameters_per_map =
-		1 + m_input_num_channels*(2*m_radius_x+1)*(2*m_radius_y+1);
-
-	for (int32_t m=0; m<m_num_maps; m++)
-	{
-		SGVector<float64_t> map_params(
-			parameters.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
-
-		CConvolutionalFeatureMap map(m_input_width, m_input_height,
-			m_radius_x, m_radius_y, m_stride_x, m_stride_y, m,
-			m_activation_function, autoencoder_position);
-
-		map.compute_activations(map_params, layers, m_input_indices,
-			m_convolution_output);
-
-		map.pool_activations(m_convolution_output,
-			m_pooling_width, m_pooling_height, m_activations, m_max_indices);
-	}
+	if (m_single_precision)
+		convolve<float32_t>(parameters, layers);
+	else
+		convolve<float64_t>(parameters, layers);
 }
 
 void CNeuralConvolutionalLayer::compute_gradients(
@@ -214,27 +372,303 @@ void CNeuralConvolutionalLayer::compute_gradients(
 				m_convolution_output_gradients(m_max_indices(i,j),j) =
 					m_activation_gradients(i,j);
 
-	int32_t num_parameters_per_map =
+	if (m_single_precision)
+		convolve_gradients<float32_t>(parameters, layers, parameter_gradients);
+	else
+		convolve_gradients<float64_t>(parameters, layers, parameter_gradients);
+}
+
+template <class T>
+void CNeuralConvolutionalLayer::convolve(SGVector<float64_t> parameters,
+		CDynamicObjectArray* layers)
+{
+	const ConvolutionShape shape = {m_input_width, m_input_height,
+		m_radius_x, m_radius_y, m_stride_x, m_stride_y,
+		autoencoder_position!=NLAP_NONE};
+
+	std::vector<InputChannel> channels;
+	for (int32_t l=0; l<m_input_indices.vlen; l++)
+	{
+		CNeuralLayer* layer =
+			(CNeuralLayer*)layers->get_element(m_input_indices[l]);
+		SGMatrix<float64_t> activations = layer->get_activations();
+		const index_t input_size = index_t(m_input_width)*m_input_height;
+		for (index_t c=0; c<layer->get_num_neurons()/input_size; c++)
+			channels.push_back({activations.matrix+c*input_size, NULL,
+				activations.num_rows});
+		SG_UNREF(layer);
+	}
+
+	const int32_t num_parameters_per_map =
 		1 + m_input_num_channels*(2*m_radius_x+1)*(2*m_radius_y+1);
+	const index_t column_size = num_parameters_per_map-1;
+
+	// the weights of a map are a row, after the bias
+	typedef Matrix<float64_t, Dynamic, Dynamic, RowMajor> RowMatrix;
+	const Matrix<T, Dynamic, Dynamic> weights =
+		Map<const RowMatrix, 0, OuterStride<> >(parameters.vector+1,
+			m_num_maps, column_size, OuterStride<>(num_parameters_per_map))
+		.template cast<T>();
+
+	const index_t num_positions = shape.num_positions();
+	const index_t map_size = shape.map_size();
+	const index_t block = block_size(m_batch_size, column_size*num_positions);
+	const index_t num_blocks = (m_batch_size+block-1)/block;
+
+	#pragma omp parallel for num_threads(env()->get_num_threads())
+	for (index_t b=0; b<num_blocks; b++)
+	{
+		const index_t first = b*block;
+		const index_t len = CMath::min(block, m_batch_size-first);
+
+		ScopedArena scope;
+		SGMatrix<T> col(column_size, num_positions*len, scope.arena());
+		SGMatrix<T> out(m_num_maps, num_positions*len, scope.arena());
+		for (index_t i=0; i<len; i++)
+			im2col(shape, channels, first+i, col.get_column_vector(i*num_positions));
+
+		Map<Matrix<T, Dynamic, Dynamic> >(out.matrix, out.num_rows, out.num_cols)
+			.noalias() = weights*Map<Matrix<T, Dynamic, Dynamic> >(
+				col.matrix, col.num_rows, col.num_cols);
+
+		for (index_t i=0; i<len; i++)
+		{
+			const index_t j = first+i;
+			for (int32_t m=0; m<m_num_maps; m++)
+			{
+				const float64_t bias = parameters[m*num_parameters_per_map];
+				float64_t* output = m_convolution_output.get_column_vector(j)+
+					m*map_size;
+
+				// the outputs that are not computed only see the bias
+				if (shape.autoencoder)
+				{
+					const float64_t value = activate(m_activation_function, bias);
+					for (index_t k=0; k<map_size; k++)
+						output[k] = value;
+				}
+
+				const T* products = out.get_column_vector(i*num_positions)+m;
+				for (int32_t px=0; px<shape.num_x(); px++)
+				{
+					for (int32_t py=0; py<shape.num_y(); py++)
+					{
+						output[shape.output_index(px, py)] = activate(
+							m_activation_function, *products+bias);
+						products += m_num_maps;
+					}
+				}
+
+				pool(m, j);
+			}
+		}
+	}
+}
+
+void CNeuralConvolutionalLayer::pool(int32_t map, index_t sample)
+{
+	const bool autoencoder = autoencoder_position!=NLAP_NONE;
+	const int32_t output_width =
+		autoencoder ? m_input_width : m_input_width/m_stride_x;
+	const int32_t output_height =
+		autoencoder ? m_input_height : m_input_height/m_stride_y;
+	const index_t row_offset = index_t(map)*output_width*output_height;
+	const index_t pooled_offset = index_t(map)*m_width*m_height;
+
+	const float64_t* image =
+		m_convolution_output.get_column_vector(sample)+row_offset;
+	float64_t* pooled = m_activations.get_column_vector(sample)+pooled_offset;
+	float64_t* indices = m_max_indices.get_column_vector(sample)+pooled_offset;
+
+	if (autoencoder)
+	{
+		for (index_t k=0; k<m_width*m_height; k++)
+		{
+			pooled[k] = 0;
+			indices[k] = -1.0;
+		}
+	}
+
+	// an autoencoder layer keeps the size of its inputs and stores the
+	// maximum of a region at its first element
+	const int32_t num_x = autoencoder ?
+		(output_width+m_pooling_width-1)/m_pooling_width : m_width;
+	const int32_t num_y = autoencoder ?
+		(output_height+m_pooling_height-1)/m_pooling_height : m_height;
 
+	for (int32_t px=0; px<num_x; px++)
+	{
+		const int32_t x = px*m_pooling_width;
+		const int32_t x_end = CMath::min(x+m_pooling_width, output_width);
+		for (int32_t py=0; py<num_y; py++)
+		{
+			const int32_t y = py*m_pooling_height;
+			const int32_t y_end = CMath::min(y+m_pooling_height, output_height);
+
+			index_t max_index = y+index_t(x)*output_height;
+			for (int32_t x1=x; x1<x_end; x1++)
+			{
+				for (int32_t y1=y; y1<y_end; y1++)
+				{
+					const index_t k = y1+index_t(x1)*output_height;
+					if (image[k] > image[max_index])
+						max_index = k;
+				}
+			}
+
+			const index_t result =
+				autoencoder ? y+index_t(x)*m_height : py+index_t(px)*m_height;
+			pooled[result] = image[max_index];
+			indices[result] = row_offset+max_index;
+		}
+	}
+}
+
+template <class T>
+void CNeuralConvolutionalLayer::convolve_gradients(
+		SGVector<float64_t> parameters,
+		CDynamicObjectArray* layers,
+		SGVector<float64_t> parameter_gradients)
+{
+	const ConvolutionShape shape = {m_input_width, m_input_height,
+		m_radius_x, m_radius_y, m_stride_x, m_stride_y,
+		autoencoder_position!=NLAP_NONE};
+
+	bool has_gradients = false;
+	std::vector<InputChannel> channels;
+	for (int32_t l=0; l<m_input_indices.vlen; l++)
+	{
+		CNeuralLayer* layer =
+			(CNeuralLayer*)layers->get_element(m_input_indices[l]);
+		SGMatrix<float64_t> activations = layer->get_activations();
+		float64_t* gradients = layer->is_input() ? NULL :
+			layer->get_activation_gradients().matrix;
+		has_gradients |= gradients!=NULL;
+
+		const index_t input_size = index_t(m_input_width)*m_input_height;
+		for (index_t c=0; c<layer->get_num_neurons()/input_size; c++)
+			channels.push_back({activations.matrix+c*input_size,
+				gradients ? gradients+c*input_size : NULL,
+				activations.num_rows});
+		SG_UNREF(layer);
+	}
+
+	// gradients of the convolution outputs before the activation function
+	const index_t length = m_convolution_output.size();
+	if (m_activation_function==CMAF_LOGISTIC)
+	{
+		for (index_t i=0; i<length; i++)
+			m_convolution_output_gradients[i] *=
+				m_convolution_output[i]*(1.0-m_convolution_output[i]);
+	}
+	else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
+	{
+		for (index_t i=0; i<length; i++)
+			if (m_convolution_output[i]==0)
+				m_convolution_output_gradients[i] = 0;
+	}
+
+	const int32_t num_parameters_per_map =
+		1 + m_input_num_channels*(2*m_radius_x+1)*(2*m_radius_y+1);
+	const index_t column_size = num_parameters_per_map-1;
+	const index_t num_positions = shape.num_positions();
+	const index_t map_size = shape.map_size();
+
+	// the bias sees every output of its map
 	for (int32_t m=0; m<m_num_maps; m++)
 	{
-		SGVector<float64_t> map_params(
-			parameters.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
+		float64_t bias_gradient = 0;
+		for (index_t j=0; j<m_batch_size; j++)
+		{
+			const float64_t* gradients =
+				m_convolution_output_gradients.get_column_vector(j)+m*map_size;
+			for (index_t k=0; k<map_size; k++)
+				bias_gradient += gradients[k];
+		}
+		parameter_gradients[m*num_parameters_per_map] = bias_gradient;
+	}
+
+	typedef Matrix<float64_t, Dynamic, Dynamic, RowMajor> RowMatrix;
+	const Matrix<T, Dynamic, Dynamic> weights =
+		Map<const RowMatrix, 0, OuterStride<> >(parameters.vector+1,
+			m_num_maps, column_size, OuterStride<>(num_parameters_per_map))
+		.template cast<T>();
+
+	const index_t block = block_size(m_batch_size, column_size*num_positions);
+	const index_t num_blocks = (m_batch_size+block-1)/block;
+	const int32_t num_threads = env()->get_num_threads();
+
+	/* every thread sums up the weight gradients of its blocks, the partial
+	 * sums are added up in the order of the threads such that the result does
+	 * not depend on the scheduling
+	 */
+	std::vector<MatrixXd> partial_gradients(
+		num_threads, MatrixXd::Zero(m_num_maps, column_size));
+
+	#pragma omp parallel num_threads(num_threads)
+	{
+#ifdef HAVE_OPENMP
+		const int32_t thread_num = omp_get_thread_num();
+#else
+		const int32_t thread_num = 0;
+#endif
+		MatrixXd& weight_gradients = partial_gradients[thread_num];
+
+		#pragma omp for schedule(static)
+		for (index_t b=0; b<num_blocks; b++)
+		{
+			const index_t first = b*block;
+			const index_t len = CMath::min(block, m_batch_size-first);
+
+			ScopedArena scope;
+			SGMatrix<T> col(column_size, num_positions*len, scope.arena());
+			SGMatrix<T> local_gradients(m_num_maps, num_positions*len,
+				scope.arena());
 
-		SGVector<float64_t> map_gradients(
-			parameter_gradients.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
+			for (index_t i=0; i<len; i++)
+			{
+				const index_t j = first+i;
+				im2col(shape, channels, j, col.get_column_vector(i*num_positions));
+
+				T* dst = local_gradients.get_column_vector(i*num_positions);
+				for (int32_t px=0; px<shape.num_x(); px++)
+				{
+					for (int32_t py=0; py<shape.num_y(); py++)
+					{
+						const index_t k = shape.output_index(px, py);
+						for (int32_t m=0; m<m_num_maps; m++)
+							*dst++ = T(m_convolution_output_gradients(
+								m*map_size+k, j));
+					}
+				}
+			}
 
-		CConvolutionalFeatureMap map(m_input_width, m_input_height,
-			m_radius_x, m_radius_y, m_stride_x, m_stride_y, m,
-			m_activation_function, autoencoder_position);
+			Map<Matrix<T, Dynamic, Dynamic> > C(
+				col.matrix, col.num_rows, col.num_cols);
+			Map<Matrix<T, Dynamic, Dynamic> > G(
+				local_gradients.matrix, local_gradients.num_rows,
+				local_gradients.num_cols);
 
-		map.compute_gradients(map_params, m_convolution_output,
-			m_convolution_output_gradients, layers,
-			m_input_indices, map_gradients);
+			weight_gradients += (G*C.transpose()).template cast<float64_t>();
+
+			if (has_gradients)
+			{
+				// the columns are not needed anymore and hold the gradients of
+				// the lowered inputs
+				C.noalias() = weights.transpose()*G;
+				for (index_t i=0; i<len; i++)
+					col2im(shape, channels, first+i,
+						col.get_column_vector(i*num_positions));
+			}
+		}
 	}
+
+	Map<RowMatrix, 0, OuterStride<> > weight_gradients(
+		parameter_gradients.vector+1, m_num_maps, column_size,
+		OuterStride<>(num_parameters_per_map));
+	weight_gradients.setZero();
+	for (int32_t t=0; t<num_threads; t++)
+		weight_gradients += partial_gradients[t];
 }
 
 float64_t CNeuralConvolutionalLayer::compute_error(SGMatrix<float64_t> targets)
@@ -285,6 +719,7 @@ void CNeuralConvolutionalLayer::init()
 	m_stride_y = 1;
 	m_initialization_mode = NORMAL;
 	m_activation_function = CMAF_IDENTITY;
+	m_single_precision = false;
 
 	SG_ADD(&m_num_maps, "num_maps", "Number of maps");
 	SG_ADD(&m_input_width, "input_width", "Input Width");
@@ -298,6 +733,9 @@ void CNeuralConvolutionalLayer::init()
 	SG_ADD(&m_pooling_height, "pooling_height", "Pooling Height");
 	SG_ADD(&m_stride_x, "stride_x", "X Stride");
 	SG_ADD(&m_stride_y, "stride_y", "Y Stride");
+	SG_ADD(
+	    &m_single_precision, "single_precision",
+	    "Whether the convolutions are computed in single precision");
 
 	SG_ADD(&m_convolution_output, "convolution_output", "Convolution Output");
 
@@ -71,6 +71,13 @@ enum EInitializationMode
  * sides
  *
  * The layer assumes that its input images are in column major format
+ *
+ * The convolutions are lowered to matrix products: the filter taps of every
+ * convolved position of a block of images are copied into the columns of a
+ * matrix (im2col), which is multiplied with the filters of all maps at once.
+ * The bias, the non-linearity and the pooling are applied in the same pass
+ * over the products. The products can be computed in single precision, see
+ * set_single_precision().
  */
 class CNeuralConvolutionalLayer : public CNeuralLayer
 {
@@ -207,11 +214,53 @@ public:
 	virtual void enforce_max_norm(SGVector<float64_t> parameters,
 			float64_t max_norm);
 
+	/** Sets whether the convolutions are computed in single precision
+	 *
+	 * The parameters and activations stay in double precision, the lowered
+	 * images and the matrix products are stored as float32, which halves
+	 * their memory traffic.
+	 *
+	 * default value is false
+	 *
+	 * @param single_precision whether to compute in single precision
+	 */
+	void set_single_precision(bool single_precision)
+	{
+		m_single_precision = single_precision;
+	}
+
+	/** Returns whether the convolutions are computed in single precision */
+	bool get_single_precision() const
+	{
+		return m_single_precision;
+	}
+
 	virtual const char* get_name() const { return "NeuralConvolutionalLayer"; }
 
 private:
 	void init();
 
+	/** Computes the convolution outputs and the pooled activations with
+	 * matrix products in precision T
+	 */
+	template <class T>
+	void convolve(SGVector<float64_t> parameters, CDynamicObjectArray* layers);
+
+	/** Max-pools the convolution outputs of a map for one sample into
+	 * m_activations and stores the row indices of the maxima in
+	 * m_max_indices
+	 */
+	void pool(int32_t map, index_t sample);
+
+	/** Computes the parameter gradients and the gradients of the input
+	 * layers from m_convolution_output_gradients with matrix products in
+	 * precision T
+	 */
+	template <class T>
+	void convolve_gradients(SGVector<float64_t> parameters,
+			CDynamicObjectArray* layers,
+			SGVector<float64_t> parameter_gradients);
+
 protected:
 	/** Number of feature maps */
 	int32_t m_num_maps;
@@ -255,6 +304,9 @@ protected:
 	/** Row indices of the max elements for each pooling region */
 	SGMatrix<float64_t> m_max_indices;
 
+	/** Whether the convolutions are computed in single precision */
+	bool m_single_precision;
+
 	/** Parameters initialization mode */
 	EInitializationMode m_initialization_mode;
 };
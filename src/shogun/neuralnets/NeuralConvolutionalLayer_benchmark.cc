@@ -0,0 +1,147 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "shogun/lib/DynamicObjectArray.h"
+#include "shogun/lib/SGMatrix.h"
+#include "shogun/lib/SGVector.h"
+#include "shogun/neuralnets/ConvolutionalFeatureMap.h"
+#include "shogun/neuralnets/NeuralConvolutionalLayer.h"
+#include "shogun/neuralnets/NeuralInputLayer.h"
+
+#include <algorithm>
+#include <random>
+
+namespace shogun
+{
+
+class NeuralConvolutionalLayerFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		std::mt19937_64 prng(17);
+		std::normal_distribution<float64_t> dist;
+
+		SGMatrix<float64_t> images(width * height, batch_size);
+		for (auto& x : images)
+			x = dist(prng);
+
+		// the gradients of the convolution are propagated to a hidden layer
+		// that holds the images
+		auto input = new CNeuralInputLayer(width, height);
+		auto hidden = new CNeuralConvolutionalLayer(CMAF_IDENTITY, 1, 0, 0);
+		layers = new CDynamicObjectArray();
+		layers->append_element(input);
+		layers->append_element(hidden);
+		SG_REF(layers);
+
+		input_indices = SGVector<int32_t>(1);
+		input_indices[0] = 0;
+		hidden->initialize_neural_layer(layers, input_indices);
+		hidden->set_batch_size(batch_size);
+		auto activations = hidden->get_activations();
+		std::copy(images.begin(), images.end(), activations.begin());
+
+		layer = new CNeuralConvolutionalLayer(
+		    CMAF_RECTIFIED_LINEAR, num_maps, radius, radius);
+		SG_REF(layer);
+		input_indices[0] = 1;
+		layer->initialize_neural_layer(layers, input_indices);
+		layer->set_batch_size(batch_size);
+		layer->set_single_precision(st.range(0));
+
+		params = SGVector<float64_t>(layer->get_num_parameters());
+		for (auto& x : params)
+			x = 0.1 * dist(prng);
+		gradients = SGVector<float64_t>(params.vlen);
+		targets = SGMatrix<float64_t>(layer->get_num_neurons(), batch_size);
+		for (auto& x : targets)
+			x = dist(prng);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(layer);
+		SG_UNREF(layers);
+	}
+
+	static constexpr int32_t width = 28;
+	static constexpr int32_t height = 28;
+	static constexpr int32_t batch_size = 64;
+	static constexpr int32_t num_maps = 16;
+	static constexpr int32_t radius = 1;
+	static constexpr int64_t num_products = int64_t(width) * height *
+	                                        batch_size * num_maps *
+	                                        (2 * radius + 1) * (2 * radius + 1);
+
+	CDynamicObjectArray* layers;
+	CNeuralConvolutionalLayer* layer;
+	SGVector<int32_t> input_indices;
+	SGVector<float64_t> params;
+	SGVector<float64_t> gradients;
+	SGMatrix<float64_t> targets;
+};
+
+BENCHMARK_DEFINE_F(NeuralConvolutionalLayerFixture, compute_activations)
+(benchmark::State& st)
+{
+	for (auto _ : st)
+	{
+		layer->compute_activations(params, layers);
+		benchmark::DoNotOptimize(layer->get_activations().matrix);
+	}
+	st.SetItemsProcessed(st.iterations() * num_products);
+}
+
+BENCHMARK_DEFINE_F(NeuralConvolutionalLayerFixture, compute_gradients)
+(benchmark::State& st)
+{
+	layer->compute_activations(params, layers);
+	for (auto _ : st)
+	{
+		layer->compute_gradients(params, targets, layers, gradients);
+		benchmark::DoNotOptimize(gradients.vector);
+	}
+	st.SetItemsProcessed(st.iterations() * num_products);
+}
+
+BENCHMARK_DEFINE_F(NeuralConvolutionalLayerFixture, direct_convolution)
+(benchmark::State& st)
+{
+	// the same activations with one direct convolution per map
+	const int32_t num_parameters_per_map = params.vlen / num_maps;
+	SGMatrix<float64_t> activations(layer->get_num_neurons(), batch_size);
+	for (auto _ : st)
+	{
+		for (int32_t m = 0; m < num_maps; m++)
+		{
+			SGVector<float64_t> map_params(
+			    params.vector + m * num_parameters_per_map,
+			    num_parameters_per_map, false);
+			CConvolutionalFeatureMap map(
+			    width, height, radius, radius, 1, 1, m,
+			    CMAF_RECTIFIED_LINEAR);
+			map.compute_activations(
+			    map_params, layers, input_indices, activations);
+		}
+		benchmark::DoNotOptimize(activations.matrix);
+	}
+	st.SetItemsProcessed(st.iterations() * num_products);
+}
+
+#define ADD_CONVOLUTION_ARGS(WHAT)                                             \
+	WHAT->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+ADD_CONVOLUTION_ARGS(
+    BENCHMARK_REGISTER_F(NeuralConvolutionalLayerFixture, compute_activations))
+ADD_CONVOLUTION_ARGS(
+    BENCHMARK_REGISTER_F(NeuralConvolutionalLayerFixture, compute_gradients))
+BENCHMARK_REGISTER_F(NeuralConvolutionalLayerFixture, direct_convolution)
+    ->Arg(0)
+    ->Unit(benchmark::kMillisecond);
+}
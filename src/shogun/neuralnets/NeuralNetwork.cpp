@@ -31,6 +31,7 @@
  * Written (W) 2014 Khaled Nasr
  */
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/base/progress.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/DynamicObjectArray.h>
@@ -38,6 +39,7 @@
 #include <shogun/mathematics/UniformRealDistribution.h>
 #include <shogun/neuralnets/NeuralLayer.h>
 #include <shogun/neuralnets/NeuralNetwork.h>
+#include <shogun/optimization/DescendUpdater.h>
 #include <shogun/optimization/lbfgs/lbfgs.h>
 
 using namespace shogun;
@@ -159,9 +161,18 @@ void CNeuralNetwork::initialize_neural_network(float64_t sigma)
 
 CNeuralNetwork::~CNeuralNetwork()
 {
+	free_gradient_shards();
+	SG_UNREF(m_gradient_updater);
 	SG_UNREF(m_layers);
 }
 
+void CNeuralNetwork::set_gradient_updater(DescendUpdater* gradient_updater)
+{
+	SG_REF(gradient_updater);
+	SG_UNREF(m_gradient_updater);
+	m_gradient_updater = gradient_updater;
+}
+
 CBinaryLabels* CNeuralNetwork::apply_binary(CFeatures* data)
 {
 	SGMatrix<float64_t> output_activations = forward_propagate(data);
@@ -259,12 +270,17 @@ bool CNeuralNetwork::train_machine(CFeatures* data)
 	for (int32_t i=0; i<m_num_layers; i++)
 		get_layer(i)->is_training = true;
 
+	if (m_data_parallel)
+		init_gradient_shards();
+
 	bool result = false;
 	if (m_optimization_method==NNOM_GRADIENT_DESCENT)
 		result = train_gradient_descent(inputs, targets);
 	else if (m_optimization_method==NNOM_LBFGS)
 		result = train_lbfgs(inputs, targets);
 
+	free_gradient_shards();
+
 	for (int32_t i=0; i<m_num_layers; i++)
 		get_layer(i)->is_training = false;
 	m_is_training = false;
@@ -300,6 +316,11 @@ bool CNeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 	bool continue_training = true;
 	float64_t alpha = m_gd_learning_rate;
 
+	// the configured updater is not modified, every training starts with
+	// the state it was given
+	DescendUpdater* updater = m_gradient_updater ?
+		m_gradient_updater->clone()->as<DescendUpdater>() : NULL;
+
 	for (auto i : SG_PROGRESS(
 	         range(0, m_max_num_epochs), [&] { return continue_training; }))
 	{
@@ -316,8 +337,11 @@ bool CNeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 			SGMatrix<float64_t> inputs_batch(inputs.matrix+j*m_num_inputs,
 				m_num_inputs, m_gd_mini_batch_size, false);
 
-			for (int32_t k=0; k<n_param; k++)
-				m_params[k] += m_gd_momentum*param_updates[k];
+			if (!updater)
+			{
+				for (int32_t k=0; k<n_param; k++)
+					m_params[k] += m_gd_momentum*param_updates[k];
+			}
 
 			float64_t e = compute_gradients(inputs_batch, targets_batch, gradients);
 
@@ -339,12 +363,17 @@ bool CNeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 			else
 				error = (1.0-c) * error + c*e;
 
-			for (int32_t k=0; k<n_param; k++)
+			if (updater)
+				updater->update_variable(m_params, gradients, alpha);
+			else
 			{
-				param_updates[k] = m_gd_momentum*param_updates[k]
-						-alpha*gradients[k];
+				for (int32_t k=0; k<n_param; k++)
+				{
+					param_updates[k] = m_gd_momentum*param_updates[k]
+							-alpha*gradients[k];
 
-				m_params[k] -= alpha*gradients[k];
+					m_params[k] -= alpha*gradients[k];
+				}
 			}
 
 			if (error_last_time!=-1.0)
@@ -363,6 +392,7 @@ bool CNeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 		}
 	}
 
+	SG_UNREF(updater);
 	return true;
 }
 
@@ -479,6 +509,13 @@ SGMatrix<float64_t> CNeuralNetwork::forward_propagate(
 float64_t CNeuralNetwork::compute_gradients(SGMatrix<float64_t> inputs,
 		SGMatrix<float64_t> targets, SGVector<float64_t> gradients)
 {
+	if (m_gradient_shards.size()>1 && inputs.num_cols>1)
+	{
+		float64_t error = compute_gradients_parallel(inputs, targets, gradients);
+		regularize_gradients(gradients);
+		return regularize_error(error);
+	}
+
 	forward_propagate(inputs);
 
 	for (int32_t i=0; i<m_num_layers; i++)
@@ -497,6 +534,111 @@ float64_t CNeuralNetwork::compute_gradients(SGMatrix<float64_t> inputs,
 				SGMatrix<float64_t>(), m_layers, get_section(gradients,i));
 	}
 
+	regularize_gradients(gradients);
+
+	return compute_error(targets);
+}
+
+float64_t CNeuralNetwork::compute_gradients_parallel(
+	SGMatrix<float64_t> inputs, SGMatrix<float64_t> targets,
+	SGVector<float64_t> gradients)
+{
+	const int32_t batch_size = inputs.num_cols;
+	const int32_t num_shards =
+		CMath::min<int32_t>(m_gradient_shards.size(), batch_size);
+
+	SGVector<int32_t> num_parameters(m_num_layers);
+	for (int32_t i=0; i<m_num_layers; i++)
+		num_parameters[i] = get_layer(i)->get_num_parameters();
+
+	SGVector<float64_t> errors(num_shards);
+
+	// every shard propagates its part of the batch through its own layers
+	#pragma omp parallel for num_threads(num_shards) schedule(static, 1)
+	for (int32_t s=0; s<num_shards; s++)
+	{
+		GradientShard& shard = m_gradient_shards[s];
+		const int32_t first = (int64_t)batch_size*s/num_shards;
+		const int32_t len = (int64_t)batch_size*(s+1)/num_shards - first;
+
+		std::vector<CNeuralLayer*> layers(m_num_layers);
+		for (int32_t i=0; i<m_num_layers; i++)
+		{
+			layers[i] = (CNeuralLayer*)shard.layers->get_element(i);
+			if (shard.batch_size!=len)
+				layers[i]->set_batch_size(len);
+		}
+		shard.batch_size = len;
+
+		SGMatrix<float64_t> inputs_shard(inputs.matrix+(int64_t)first*inputs.num_rows,
+			inputs.num_rows, len, false);
+		SGMatrix<float64_t> targets_shard(targets.matrix+(int64_t)first*targets.num_rows,
+			targets.num_rows, len, false);
+
+		auto params = [&](SGVector<float64_t> v, int32_t i)
+		{
+			return SGVector<float64_t>(v.vector+m_index_offsets[i],
+				num_parameters[i], false);
+		};
+
+		for (int32_t i=0; i<m_num_layers; i++)
+		{
+			if (layers[i]->is_input())
+				layers[i]->compute_activations(inputs_shard);
+			else
+				layers[i]->compute_activations(params(m_params, i),
+					shard.layers);
+
+			layers[i]->dropout_activations();
+		}
+
+		for (int32_t i=0; i<m_num_layers; i++)
+		{
+			if (!layers[i]->is_input())
+				layers[i]->get_activation_gradients().zero();
+		}
+
+		for (int32_t i=m_num_layers-1; i>=0; i--)
+		{
+			layers[i]->compute_gradients(params(m_params, i),
+				i==m_num_layers-1 ? targets_shard : SGMatrix<float64_t>(),
+				shard.layers, params(shard.gradients, i));
+		}
+
+		// the layers average over their part of the batch
+		const float64_t weight = (float64_t)len/batch_size;
+		errors[s] = weight*layers[m_num_layers-1]->compute_error(targets_shard);
+		for (int32_t k=0; k<m_total_num_parameters; k++)
+			shard.gradients[k] *= weight;
+
+		for (auto layer : layers)
+			SG_UNREF(layer);
+	}
+
+	// tree reduction of the gradients into the first shard
+	for (int32_t step=1; step<num_shards; step*=2)
+	{
+		#pragma omp parallel for num_threads(num_shards)
+		for (int32_t s=0; s<num_shards-step; s+=2*step)
+		{
+			SGVector<float64_t> dst = m_gradient_shards[s].gradients;
+			SGVector<float64_t> src = m_gradient_shards[s+step].gradients;
+			for (int32_t k=0; k<m_total_num_parameters; k++)
+				dst[k] += src[k];
+		}
+	}
+
+	sg_memcpy(gradients.vector, m_gradient_shards[0].gradients.vector,
+		m_total_num_parameters*sizeof(float64_t));
+
+	float64_t error = 0;
+	for (int32_t s=0; s<num_shards; s++)
+		error += errors[s];
+	return error;
+}
+
+void CNeuralNetwork::regularize_gradients(SGVector<float64_t> gradients)
+{
 	// L2 regularization
 	if (m_l2_coefficient != 0.0)
 	{
@@ -527,14 +669,15 @@ float64_t CNeuralNetwork::compute_gradients(SGMatrix<float64_t> inputs,
 			get_layer(i)->enforce_max_norm(layer_params, m_max_norm);
 		}
 	}
-
-	return compute_error(targets);
 }
 
 float64_t CNeuralNetwork::compute_error(SGMatrix<float64_t> targets)
 {
-	float64_t error = get_layer(m_num_layers-1)->compute_error(targets);
+	return regularize_error(get_layer(m_num_layers-1)->compute_error(targets));
+}
 
+float64_t CNeuralNetwork::regularize_error(float64_t error)
+{
 	// L2 regularization
 	if (m_l2_coefficient != 0.0)
 	{
@@ -558,6 +701,39 @@ float64_t CNeuralNetwork::compute_error(SGMatrix<float64_t> targets)
 	return error;
 }
 
+void CNeuralNetwork::init_gradient_shards()
+{
+	free_gradient_shards();
+
+	const int32_t num_threads = env()->get_num_threads();
+	if (num_threads<2)
+		return;
+
+	m_gradient_shards.resize(num_threads);
+	for (auto& shard : m_gradient_shards)
+	{
+		shard.layers = new CDynamicObjectArray();
+		SG_REF(shard.layers);
+		for (int32_t i=0; i<m_num_layers; i++)
+		{
+			auto layer = get_layer(i)->clone()->as<CNeuralLayer>();
+			// every copy drops out different neurons
+			seed(layer);
+			shard.layers->append_element(layer);
+			SG_UNREF(layer);
+		}
+		shard.batch_size = -1;
+		shard.gradients = SGVector<float64_t>(m_total_num_parameters);
+	}
+}
+
+void CNeuralNetwork::free_gradient_shards()
+{
+	for (auto& shard : m_gradient_shards)
+		SG_UNREF(shard.layers);
+	m_gradient_shards.clear();
+}
+
 float64_t CNeuralNetwork::compute_error(SGMatrix<float64_t> inputs,
 		SGMatrix<float64_t> targets)
 {
@@ -785,6 +961,8 @@ void CNeuralNetwork::init()
 	m_is_training = false;
 	m_auto_quick_initialize = false;
 	m_sigma = 0.01f;
+	m_data_parallel = false;
+	m_gradient_updater = NULL;
 	m_layers = new CDynamicObjectArray();
 	SG_REF(m_layers);
 
@@ -832,4 +1010,10 @@ void CNeuralNetwork::init()
 	    "auto_quick_initialize");
 	SG_ADD(&m_is_training, "is_training", "is_training");
 	SG_ADD(&m_sigma, "sigma", "sigma");
+	SG_ADD(
+	    &m_data_parallel, "data_parallel",
+	    "Whether the gradients are computed in parallel");
+	SG_ADD(
+	    (CSGObject**)&m_gradient_updater, "gradient_updater",
+	    "Updater of the parameters during gradient descent");
 }
@@ -40,11 +40,14 @@
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/mathematics/RandomMixin.h>
 
+#include <vector>
+
 namespace shogun
 {
 template<class T> class CDenseFeatures;
 class CDynamicObjectArray;
 class CNeuralLayer;
+class DescendUpdater;
 
 /** optimization method for neural networks */
 enum ENNOptimizationMethod
@@ -95,6 +98,14 @@ enum ENNOptimizationMethod
  * NOTE: LBFGS does not work properly when using dropout/max-norm regularization
  * due to their stochastic nature. Use gradient descent instead.
  *
+ * Gradient descent updates the parameters with momentum, or with a
+ * DescendUpdater such as AdamUpdater, RmsPropUpdater or AdaDeltaUpdater, see
+ * set_gradient_updater().
+ *
+ * With set_data_parallel(), the gradients of each batch are computed by
+ * several threads. Every thread propagates a part of the batch through its
+ * own copy of the layers, and the gradients of the parts are summed.
+ *
  * During training, the error at each iteration is logged as MSG_INFO. (to turn
  * on info messages call sg_io->set_loglevel(MSG_INFO)).
  *
@@ -250,6 +261,45 @@ public:
 	{
 		return m_optimization_method;
 	}
+
+	/** Sets whether the gradients of a batch are computed in parallel during
+	 * training, by as many threads as the environment allows
+	 *
+	 * Every thread copies the layers once per training, which costs memory
+	 * for the parameters and activations of one copy per thread. The
+	 * results only depend on the number of threads.
+	 *
+	 * default value is false
+	 *
+	 * @param data_parallel whether to compute the gradients in parallel
+	 */
+	void set_data_parallel(bool data_parallel)
+	{
+		m_data_parallel = data_parallel;
+	}
+
+	/** Returns whether the gradients are computed in parallel */
+	bool get_data_parallel() const
+	{
+		return m_data_parallel;
+	}
+
+	/** Sets the updater that gradient descent uses to update the
+	 * parameters, e.g. AdamUpdater, RmsPropUpdater or AdaDeltaUpdater
+	 *
+	 * The updater is given the gradients of every mini-batch and the
+	 * gradient descent learning rate, which updaters with a built-in
+	 * learning rate such as AdamUpdater ignore. Momentum is not applied.
+	 *
+	 * Every training starts with a copy of the given updater, such that
+	 * the state of the updater, e.g. the moments of AdamUpdater, is not
+	 * carried over from one training to the next.
+	 *
+	 * default value is NULL (gradient descent with momentum)
+	 *
+	 * @param gradient_updater updater of the parameters
+	 */
+	void set_gradient_updater(DescendUpdater* gradient_updater);
 	/** Sets L2 Regularization coeff
 	 * default value is 0.0
 	 * @param l2_coefficient l2_coefficient
@@ -585,6 +635,30 @@ private:
 	template<class T>
 	SGVector<T> get_section(SGVector<T> v, int32_t i);
 
+	/** Adds the gradients of the regularization terms to the given gradients
+	 * and enforces the max-norm constraint
+	 */
+	void regularize_gradients(SGVector<float64_t> gradients);
+
+	/** Returns the given error plus the regularization terms */
+	float64_t regularize_error(float64_t error);
+
+	/** Copies the layers for the threads that compute the gradients in
+	 * parallel
+	 */
+	void init_gradient_shards();
+
+	/** Releases the copies of the layers of init_gradient_shards() */
+	void free_gradient_shards();
+
+	/** Computes the gradients of a batch in parallel, without the
+	 * regularization terms
+	 *
+	 * @return error between the targets and the activations of the last layer
+	 */
+	float64_t compute_gradients_parallel(SGMatrix<float64_t> inputs,
+			SGMatrix<float64_t> targets, SGVector<float64_t> gradients);
+
 protected:
 	/** number of neurons in the input layer */
 	int32_t m_num_inputs;
@@ -725,7 +799,33 @@ protected:
 	 */
 	float64_t m_gd_error_damping_coeff;
 
+	/** whether the gradients are computed in parallel during training,
+	 * default value is false
+	 */
+	bool m_data_parallel;
+
+	/** updater of the parameters during gradient descent,
+	 * default value is NULL (gradient descent with momentum)
+	 */
+	DescendUpdater* m_gradient_updater;
+
 private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** a thread that computes the gradients of a part of each batch */
+	struct GradientShard
+	{
+		/** copies of the network's layers */
+		CDynamicObjectArray* layers;
+		/** size of the part of the batch the layers are set up for */
+		int32_t batch_size;
+		/** gradients of the part of the batch */
+		SGVector<float64_t> gradients;
+	};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+	/** threads that compute the gradients in parallel during training */
+	std::vector<GradientShard> m_gradient_shards;
+
 	/** temperary pointers to the training data, used to pass the data to L-BFGS
 	 * routines
 	 */
@@ -79,8 +79,19 @@ void CKernelPCA::fit(CFeatures* features)
 	m_init_features = features;
 
 	m_kernel->init(features, features);
-	SGMatrix<float64_t> kernel_matrix = m_kernel->get_kernel_matrix();
+	if (m_kernel->get_precision() == KPREC_DOUBLE)
+		fit_kernel_matrix(m_kernel->get_kernel_matrix<float64_t>());
+	else
+		fit_kernel_matrix(m_kernel->get_kernel_matrix<float32_t>());
 	m_kernel->cleanup();
+
+	m_fitted = true;
+	io::info("Done");
+}
+
+template <class T>
+void CKernelPCA::fit_kernel_matrix(SGMatrix<T> kernel_matrix)
+{
 	int32_t n = kernel_matrix.num_cols;
 	int32_t m = kernel_matrix.num_rows;
 	ASSERT(n == m)
@@ -94,15 +105,20 @@ void CKernelPCA::fit(CFeatures* features)
 		m_target_dim = n;
 	}
 
-	auto bias_tmp = linalg::rowwise_sum(kernel_matrix);
+	// row sums are accumulated in float64_t
+	SGVector<float64_t> bias_tmp(n);
+	bias_tmp.zero();
+	for (index_t j = 0; j < n; j++)
+		for (index_t i = 0; i < m; i++)
+			bias_tmp[i] += kernel_matrix(i, j);
 	linalg::scale(bias_tmp, bias_tmp, -1.0 / n);
 	auto s = linalg::sum(bias_tmp) / n;
 	linalg::add_scalar(bias_tmp, -s);
 
 	linalg::center_matrix(kernel_matrix);
 
-	SGVector<float64_t> eigenvalues(m_target_dim);
-	SGMatrix<float64_t> eigenvectors(kernel_matrix.num_rows, m_target_dim);
+	SGVector<T> eigenvalues(m_target_dim);
+	SGMatrix<T> eigenvectors(kernel_matrix.num_rows, m_target_dim);
 	linalg::eigen_solver_symmetric(
 	    kernel_matrix, eigenvalues, eigenvectors, m_target_dim);
 
@@ -113,17 +129,14 @@ void CKernelPCA::fit(CFeatures* features)
 	{
 		// normalize and trap divide by zero and negative eigenvalues
 		auto idx = m_target_dim - i - 1;
-		auto vec = eigenvectors.get_column(idx);
-		linalg::scale(
-		    vec, vec, 1.0 / std::sqrt(std::max(std::numeric_limits<float64_t>::epsilon(), eigenvalues[idx])));
-		m_transformation_matrix.set_column(i, vec);
+		float64_t scale = 1.0 / std::sqrt(std::max(
+		    std::numeric_limits<T>::epsilon(), eigenvalues[idx]));
+		for (index_t j = 0; j < kernel_matrix.num_rows; j++)
+			m_transformation_matrix(j, i) = eigenvectors(j, idx) * scale;
 	}
 
 	m_bias_vector = SGVector<float64_t>(m_target_dim);
 	linalg::matrix_prod(m_transformation_matrix, bias_tmp, m_bias_vector, true);
-
-	m_fitted = true;
-	io::info("Done");
 }
 
 CFeatures* CKernelPCA::transform(CFeatures* features, bool inplace)
@@ -148,20 +161,42 @@ CFeatures* CKernelPCA::transform(CFeatures* features, bool inplace)
 SGMatrix<float64_t> CKernelPCA::apply_to_feature_matrix(CFeatures* features)
 {
 	assert_fitted();
-	int32_t n = m_init_features->get_num_vectors();
 
 	m_kernel->init(features, m_init_features);
-	auto kernel_matrix = m_kernel->get_kernel_matrix();
+	SGMatrix<float64_t> new_feature_matrix;
+	if (m_kernel->get_precision() == KPREC_DOUBLE)
+		new_feature_matrix =
+		    apply_to_kernel_matrix(m_kernel->get_kernel_matrix<float64_t>());
+	else
+		new_feature_matrix =
+		    apply_to_kernel_matrix(m_kernel->get_kernel_matrix<float32_t>());
+
+	m_kernel->cleanup();
+	return new_feature_matrix;
+}
+
+template <class T>
+SGMatrix<float64_t> CKernelPCA::apply_to_kernel_matrix(SGMatrix<T> kernel_matrix)
+{
+	int32_t n = m_init_features->get_num_vectors();
 
 	auto rows_sum = linalg::rowwise_sum(kernel_matrix);
-	linalg::add_vector(kernel_matrix, rows_sum, kernel_matrix, 1.0, -1.0 / n);
+	linalg::add_vector(kernel_matrix, rows_sum, kernel_matrix, (T)1.0, (T)(-1.0 / n));
 
-	SGMatrix<float64_t> new_feature_matrix =
-	    linalg::matrix_prod(m_transformation_matrix, kernel_matrix, true, true);
+	// the transformation matrix is small, project in the kernel's precision
+	SGMatrix<T> transformation(
+	    m_transformation_matrix.num_rows, m_transformation_matrix.num_cols);
+	for (int64_t i = 0; i < int64_t(transformation.num_rows) * transformation.num_cols; i++)
+		transformation.matrix[i] = m_transformation_matrix.matrix[i];
 
-	linalg::add_vector(new_feature_matrix, m_bias_vector, new_feature_matrix);
+	SGMatrix<T> projection =
+	    linalg::matrix_prod(transformation, kernel_matrix, true, true);
 
-	m_kernel->cleanup();
+	SGMatrix<float64_t> new_feature_matrix(projection.num_rows, projection.num_cols);
+	for (int64_t i = 0; i < int64_t(projection.num_rows) * projection.num_cols; i++)
+		new_feature_matrix.matrix[i] = projection.matrix[i];
+
+	linalg::add_vector(new_feature_matrix, m_bias_vector, new_feature_matrix);
 	return new_feature_matrix;
 }
 
@@ -116,6 +116,24 @@ public:
 		/** default init */
 		void init();
 
+		/** compute transformation matrix and bias from the kernel matrix of
+		 * the training features
+		 *
+		 * @param kernel_matrix kernel matrix, float32_t unless the kernel's
+		 * precision is KPREC_DOUBLE
+		 */
+		template <class T>
+		void fit_kernel_matrix(SGMatrix<T> kernel_matrix);
+
+		/** project using the kernel matrix between features and training
+		 * features
+		 *
+		 * @param kernel_matrix kernel matrix
+		 * @return projected features
+		 */
+		template <class T>
+		SGMatrix<float64_t> apply_to_kernel_matrix(SGMatrix<T> kernel_matrix);
+
 	protected:
 
 		/** features used by init. needed for apply */
@@ -110,9 +110,16 @@ namespace shogun
 			string_features = new CStringFeatures<ST>(*string_features);
 		}
 
-		auto& string_list = string_features->get_string_list();
+		// packed strings can not be modified, they are preprocessed
+		// whenever a feature vector is requested
+		if (string_features->is_packed())
+			string_features->add_preprocessor(this);
+		else
+		{
+			auto& string_list = string_features->get_string_list();
 
-		apply_to_string_list(string_list);
+			apply_to_string_list(string_list);
+		}
 
 		SG_UNREF(features);
 		return string_features;
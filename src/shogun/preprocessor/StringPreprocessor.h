@@ -34,6 +34,9 @@ template <class ST> class CStringPreprocessor : public CPreprocessor
 		CStringPreprocessor() : CPreprocessor() {}
 
 		/** Apply transformation to string features.
+		 *
+		 * packed string features are not modified, the preprocessor is
+		 * attached to them instead
 		 *
 		 * @param features the string input features
 		 * @return the result feature object after applying the preprocessor
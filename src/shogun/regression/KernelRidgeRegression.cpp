@@ -40,25 +40,37 @@ void CKernelRidgeRegression::init()
 
 bool CKernelRidgeRegression::solve_krr_system()
 {
-	SGMatrix<float64_t> kernel_matrix(kernel->get_kernel_matrix());
+	if (kernel->get_precision() == KPREC_DOUBLE)
+		return solve_krr_system_cholesky<float64_t>();
+	return solve_krr_system_cholesky<float32_t>();
+}
+
+template <class T>
+bool CKernelRidgeRegression::solve_krr_system_cholesky()
+{
+	typedef Matrix<T, Dynamic, Dynamic> MatrixXt;
+	typedef Matrix<T, Dynamic, 1> VectorXt;
+
+	SGMatrix<T> kernel_matrix(kernel->get_kernel_matrix<T>());
 	int32_t n = kernel_matrix.num_rows;
 	SGVector<float64_t> y = regression_labels(m_labels)->get_labels();
 
 	for(index_t i=0; i<n; i++)
 		kernel_matrix(i,i) += m_tau;
 
-	Map<MatrixXd> eigen_kernel_matrix(kernel_matrix.matrix, n, n);
+	Map<MatrixXt> eigen_kernel_matrix(kernel_matrix.matrix, n, n);
 	Map<VectorXd> eigen_alphas(m_alpha.vector, n);
 	Map<VectorXd> eigen_y(y.vector, n);
 
-	LLT<MatrixXd> llt;
-	llt.compute(eigen_kernel_matrix);
+	// factorize in place to not hold a second n x n matrix
+	LLT<Ref<MatrixXt>> llt(eigen_kernel_matrix);
 	if (llt.info() != Eigen::Success)
 	{
 		io::warn("Features covariance matrix was not positive definite");
 		return false;
 	}
-	eigen_alphas = llt.solve(eigen_y);
+	VectorXt alphas = llt.solve(eigen_y.cast<T>());
+	eigen_alphas = alphas.template cast<float64_t>();
 	return true;
 }
 
@@ -126,6 +126,14 @@ class CKernelRidgeRegression : public CKernelMachine
 	private:
 		void init();
 
+		/** solve the system with a Cholesky decomposition of the kernel
+		 * matrix computed in the given type, see CKernel::set_precision()
+		 *
+		 * @return boolean to indicate success
+		 */
+		template <class T>
+		bool solve_krr_system_cholesky();
+
 	protected:
 		/** regularization parameter tau */
 		float64_t m_tau;
@@ -29,10 +29,7 @@ extern "C" {
 #endif
 
 #include <shogun/base/Parallel.h>
-
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-#endif
+#include <shogun/base/ThreadPool.h>
 
 using namespace shogun;
 
@@ -425,56 +422,31 @@ void CSVRLight::update_linear_component(
 
 			if (num_working>0)
 			{
-			// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-				int32_t num_threads=env()->get_num_threads();
-#else
-				int32_t num_threads=1;
-#endif
-				if (num_threads < 2)
+				auto pool=env()->get_thread_pool();
+				if (pool->get_num_threads() < 2)
 				{
 					for(jj=0;(j=active2dnum[jj])>=0;jj++) {
 						lin[j]+=kernel->compute_optimized(regression_fix_index(docs[j]));
 					}
 				}
-#ifdef HAVE_PTHREAD
 				else
 				{
 					int32_t num_elem = 0 ;
 					for(jj=0;(j=active2dnum[jj])>=0;jj++) num_elem++ ;
 
-					pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-					S_THREAD_PARAM_SVRLIGHT* params = SG_MALLOC(S_THREAD_PARAM_SVRLIGHT, num_threads-1);
-					int32_t start = 0 ;
-					int32_t step = num_elem/num_threads ;
-					int32_t end = step ;
-
-					for (int32_t t=0; t<num_threads-1; t++)
+					pool->parallel_for(0, num_elem, [&](index_t start, index_t end)
 					{
-						params[t].kernel = kernel ;
-						params[t].lin = lin ;
-						params[t].docs = docs ;
-						params[t].active2dnum=active2dnum ;
-						params[t].start = start ;
-						params[t].end = end ;
-						params[t].num_vectors=num_vectors ;
-
-						start=end ;
-						end+=step ;
-						pthread_create(&threads[t], NULL, update_linear_component_linadd_helper, (void*)&params[t]) ;
-					}
-
-					for(jj=params[num_threads-2].end;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(regression_fix_index(docs[j]));
-					}
-					void* ret;
-					for (int32_t t=0; t<num_threads-1; t++)
-						pthread_join(threads[t], &ret) ;
-
-					SG_FREE(params);
-					SG_FREE(threads);
+						S_THREAD_PARAM_SVRLIGHT params;
+						params.kernel = kernel ;
+						params.lin = lin ;
+						params.docs = docs ;
+						params.active2dnum=active2dnum ;
+						params.start = start ;
+						params.end = end ;
+						params.num_vectors=num_vectors ;
+						update_linear_component_linadd_helper((void*) &params);
+					});
 				}
-#endif
 			}
 		}
 	}
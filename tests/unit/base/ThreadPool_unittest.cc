@@ -0,0 +1,155 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/ThreadPool.h>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace shogun;
+
+TEST(ThreadPool, num_threads)
+{
+	ThreadPool serial(1);
+	EXPECT_EQ(1, serial.get_num_threads());
+
+	ThreadPool pool(4);
+	EXPECT_EQ(4, pool.get_num_threads());
+}
+
+TEST(ThreadPool, parallel_for_covers_range_once)
+{
+	for (auto num_threads : {1, 2, 4, 8})
+	{
+		ThreadPool pool(num_threads);
+		for (auto grain : {1, 3, 7, 1000})
+		{
+			std::vector<int32_t> hits(101, 0);
+			pool.parallel_for(5, 101, grain, [&](index_t begin, index_t end) {
+				if (num_threads > 1)
+					EXPECT_LE(end - begin, grain);
+				for (index_t i = begin; i < end; i++)
+					hits[i]++;
+			});
+
+			for (index_t i = 0; i < 5; i++)
+				EXPECT_EQ(0, hits[i]);
+			for (index_t i = 5; i < 101; i++)
+				EXPECT_EQ(1, hits[i]);
+		}
+	}
+}
+
+TEST(ThreadPool, parallel_for_empty_range)
+{
+	ThreadPool pool(4);
+	bool called = false;
+	pool.parallel_for(10, 10, [&](index_t, index_t) { called = true; });
+	EXPECT_FALSE(called);
+}
+
+TEST(ThreadPool, repeated_small_sections)
+{
+	ThreadPool pool(4);
+	std::atomic<int64_t> sum(0);
+
+	for (int32_t iter = 0; iter < 1000; iter++)
+	{
+		pool.parallel_for(0, 16, 1, [&](index_t begin, index_t end) {
+			for (index_t i = begin; i < end; i++)
+				sum += i;
+		});
+	}
+	EXPECT_EQ(1000 * 120, sum.load());
+}
+
+TEST(ThreadPool, nested_parallel_for)
+{
+	ThreadPool pool(3);
+	std::atomic<int64_t> count(0);
+
+	pool.parallel_for(0, 8, 1, [&](index_t begin, index_t end) {
+		for (index_t i = begin; i < end; i++)
+		{
+			pool.parallel_for(0, 10, 2, [&](index_t b, index_t e) {
+				count += e - b;
+			});
+		}
+	});
+	EXPECT_EQ(80, count.load());
+}
+
+TEST(ThreadPool, parallel_for_rethrows)
+{
+	ThreadPool pool(4);
+	EXPECT_THROW(
+	    pool.parallel_for(
+	        0, 100, 1,
+	        [](index_t begin, index_t) {
+		        if (begin == 42)
+			        throw std::runtime_error("failed");
+	        }),
+	    std::runtime_error);
+
+	// the pool is still usable afterwards
+	std::atomic<index_t> count(0);
+	pool.parallel_for(0, 100, 1, [&](index_t, index_t) { count++; });
+	EXPECT_EQ(100, count.load());
+}
+
+TEST(ThreadPool, submit)
+{
+	for (auto num_threads : {1, 4})
+	{
+		ThreadPool pool(num_threads);
+		std::vector<std::future<int32_t>> results;
+		for (int32_t i = 0; i < 20; i++)
+			results.push_back(pool.submit([i]() { return i * i; }));
+
+		for (int32_t i = 0; i < 20; i++)
+			EXPECT_EQ(i * i, results[i].get());
+	}
+}
+
+TEST(ThreadPool, set_num_threads_while_running)
+{
+	const int32_t num_threads = env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	std::atomic<bool> started(false);
+	std::atomic<bool> resized(false);
+	std::vector<int32_t> hits(64, 0);
+	std::thread section([&]() {
+		env()->get_thread_pool()->parallel_for(
+		    0, hits.size(), 1, [&](index_t begin, index_t end) {
+			    started = true;
+			    while (!resized)
+				    std::this_thread::yield();
+			    for (index_t i = begin; i < end; i++)
+				    hits[i]++;
+		    });
+	});
+
+	while (!started)
+		std::this_thread::yield();
+
+	// the running section keeps the old pool alive
+	env()->set_num_threads(2);
+	EXPECT_EQ(2, env()->get_thread_pool()->get_num_threads());
+	resized = true;
+	section.join();
+
+	for (auto h : hits)
+		EXPECT_EQ(1, h);
+
+	env()->set_num_threads(num_threads);
+}
@@ -5,6 +5,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/classifier/svm/LibLinear.h>
 #include <shogun/features/DataGenerator.h>
 #include <shogun/features/DenseFeatures.h>
@@ -446,3 +447,39 @@ TEST_F(LibLinear, simple_set_train_L2R_LR_DUAL_BIAS)
 	// bias, not l1
 	train_with_solver_simple(liblinear_solver_type, true, false, t_w);
 }
+
+TEST_F(LibLinear, parallel_coordinate_descent)
+{
+	generate_data_l2();
+	auto num_threads = env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	for (auto solver_type : {L2R_L1LOSS_SVC_DUAL, L2R_L2LOSS_SVC_DUAL})
+	{
+		auto ll = some<CLibLinear>(solver_type);
+		ll->set_epsilon(1e-8);
+		ll->set_features(train_feats);
+		ll->set_labels(ground_truth);
+		ll->train();
+
+		auto parallel_ll = some<CLibLinear>(solver_type);
+		parallel_ll->set_epsilon(1e-8);
+		parallel_ll->set_parallel_coordinate_descent(true);
+		parallel_ll->set_features(train_feats);
+		parallel_ll->set_labels(ground_truth);
+		parallel_ll->train();
+
+		// the parallel solver converges to the same optimum
+		auto w = ll->get_w();
+		auto parallel_w = parallel_ll->get_w();
+		for (auto i : range(w.vlen))
+			EXPECT_NEAR(parallel_w[i], w[i], 1e-4);
+		EXPECT_NEAR(parallel_ll->get_bias(), ll->get_bias(), 1e-4);
+
+		auto eval = some<CContingencyTableEvaluation>();
+		auto pred = wrap(parallel_ll->apply_binary(test_feats));
+		EXPECT_NEAR(eval->evaluate(pred, ground_truth), 1.0, 1e-6);
+	}
+
+	env()->set_num_threads(num_threads);
+}
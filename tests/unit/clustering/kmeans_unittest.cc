@@ -6,14 +6,18 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/clustering/KMeans.h>
 #include <shogun/clustering/KMeansMiniBatch.h>
 #include <shogun/distance/EuclideanDistance.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/lib/observers/ParameterObserver.h>
 #include <shogun/lib/observers/ParameterObserverLogger.h>
 
+#include <random>
+
 using namespace shogun;
 
 void check_consistency_observable(
@@ -285,3 +289,150 @@ TEST(KMeans, random_centers_assign)
 	SG_UNREF(features);
 }
 
+
+TEST(KMeans, bounded_algorithms)
+{
+	/* Elkan's and Hamerly's algorithms only skip distance computations and
+	 * converge to the same centers as Lloyd's algorithm */
+	const index_t num_vectors = 500;
+	const index_t dim = 5;
+	const int32_t k = 8;
+
+	std::mt19937_64 prng(13);
+	std::normal_distribution<float64_t> normal(0, 1);
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i = 0; i < num_vectors; ++i)
+		for (index_t j = 0; j < dim; ++j)
+			data(j, i) = normal(prng) + 4 * ((i + j) % k);
+
+	SGMatrix<float64_t> initial_centers(dim, k);
+	for (index_t c = 0; c < k; ++c)
+		for (index_t j = 0; j < dim; ++j)
+			initial_centers(j, c) = data(j, 3 * c);
+
+	auto features = some<CDenseFeatures<float64_t>>(data);
+	SGMatrix<float64_t> lloyd_centers;
+	SGVector<float64_t> lloyd_labels;
+	for (auto algorithm : {KMEANS_LLOYD, KMEANS_ELKAN, KMEANS_HAMERLY})
+	{
+		auto distance = new CEuclideanDistance(features, features);
+		auto clustering = some<CKMeans>(k, distance, initial_centers);
+		clustering->set_algorithm(algorithm);
+		clustering->train(features);
+
+		auto centers = clustering->get_cluster_centers();
+		auto result = clustering->apply()->as<CMulticlassLabels>();
+		auto labels = result->get_labels();
+		if (algorithm == KMEANS_LLOYD)
+		{
+			lloyd_centers = centers;
+			lloyd_labels = labels;
+		}
+		else
+		{
+			EXPECT_TRUE(centers.equals(lloyd_centers));
+			EXPECT_TRUE(labels.equals(lloyd_labels));
+		}
+		SG_UNREF(result);
+	}
+}
+
+TEST(KMeans, update_independent_of_threads)
+{
+	/* the centers are the means of their points summed up in order, like a
+	 * serial loop does, whatever the number of threads */
+	const index_t num_vectors = 1000;
+	const index_t dim = 7;
+	const int32_t k = 6;
+
+	std::mt19937_64 prng(29);
+	std::normal_distribution<float64_t> normal(0, 1);
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i = 0; i < num_vectors; ++i)
+		for (index_t j = 0; j < dim; ++j)
+			data(j, i) = normal(prng) + 3 * (i % k);
+
+	SGMatrix<float64_t> initial_centers(dim, k);
+	for (index_t c = 0; c < k; ++c)
+		for (index_t j = 0; j < dim; ++j)
+			initial_centers(j, c) = data(j, 5 * c);
+
+	auto features = some<CDenseFeatures<float64_t>>(data);
+	const int32_t num_threads = env()->get_num_threads();
+	SGMatrix<float64_t> serial_centers;
+	for (auto threads : {1, 4})
+	{
+		env()->set_num_threads(threads);
+		auto distance = new CEuclideanDistance(features, features);
+		auto clustering = some<CKMeans>(k, distance, initial_centers);
+		clustering->train(features);
+		auto centers = clustering->get_cluster_centers();
+
+		auto result = clustering->apply()->as<CMulticlassLabels>();
+		SGMatrix<float64_t> expected(dim, k);
+		SGVector<int64_t> counts(k);
+		expected.zero();
+		counts.zero();
+		for (index_t i = 0; i < num_vectors; ++i)
+		{
+			auto c = result->get_int_label(i);
+			for (index_t j = 0; j < dim; ++j)
+				expected(j, c) += data(j, i);
+			counts[c]++;
+		}
+		for (index_t c = 0; c < k; ++c)
+			for (index_t j = 0; j < dim; ++j)
+				expected(j, c) *= 1.0 / counts[c];
+		SG_UNREF(result);
+
+		for (index_t i = 0; i < expected.size(); ++i)
+			EXPECT_EQ(expected[i], centers[i]);
+		if (threads == 1)
+			serial_centers = centers;
+		else
+			EXPECT_TRUE(centers.equals(serial_centers));
+	}
+	env()->set_num_threads(num_threads);
+}
+
+TEST(KMeans, minibatch_streaming_training)
+{
+	/* three well separated clusters around (0,0) (10,0) (0,10) */
+	const index_t num_vectors = 3000;
+	std::mt19937_64 prng(5);
+	std::normal_distribution<float64_t> normal(0, 1);
+	SGMatrix<float64_t> data(2, num_vectors);
+	SGMatrix<float64_t> means(2, 3);
+	means.zero();
+	for (index_t i = 0; i < num_vectors; ++i)
+	{
+		data(0, i) = normal(prng) + (i % 3 == 1 ? 10 : 0);
+		data(1, i) = normal(prng) + (i % 3 == 2 ? 10 : 0);
+		means(0, i % 3) += data(0, i) / (num_vectors / 3);
+		means(1, i % 3) += data(1, i) / (num_vectors / 3);
+	}
+
+	SGMatrix<float64_t> initial_centers(2, 3);
+	initial_centers(0, 0) = 1;
+	initial_centers(1, 0) = 1;
+	initial_centers(0, 1) = 9;
+	initial_centers(1, 1) = 1;
+	initial_centers(0, 2) = 1;
+	initial_centers(1, 2) = 9;
+
+	auto features = some<CDenseFeatures<float64_t>>(data);
+	auto streaming_features =
+	    some<CStreamingDenseFeatures<float64_t>>(features);
+	auto distance = some<CEuclideanDistance>();
+	auto clustering =
+	    some<CKMeansMiniBatch>(3, distance, initial_centers);
+	clustering->put<int32_t>("max_iter", 1000);
+	clustering->put<int32_t>("batch_size", 128);
+	clustering->train(streaming_features);
+
+	/* every vector of the stream was used once, so the centers are the means
+	 * of the clusters */
+	SGMatrix<float64_t> centers = clustering->get_cluster_centers();
+	for (index_t i = 0; i < centers.size(); ++i)
+		EXPECT_NEAR(centers[i], means[i], 1e-10);
+}
@@ -14,6 +14,7 @@
 #include <shogun/mathematics/UniformIntDistribution.h>
 #include <shogun/mathematics/NormalDistribution.h>
 #include <shogun/lib/View.h>
+#include <shogun/preprocessor/NormOne.h>
 
 #include <random>
 
@@ -303,3 +304,120 @@ TEST(DenseFeaturesTest, view)
 			    feature_matrix_subset2(i, j), data(i, subset1[subset2[j]]));
 	}
 }
+
+TEST(DenseFeaturesTest, contiguous_subset_view)
+{
+	index_t dim=3;
+	index_t n=10;
+	SGMatrix<float64_t> data(dim, n);
+	std::iota(data.data(), data.data()+data.size(), 1);
+
+	auto features=some<CDenseFeatures<float64_t>>(data);
+	SGVector<index_t> block{4, 5, 6, 7};
+	features->add_subset(block);
+
+	auto subset_stack=features->get_subset_stack();
+	EXPECT_TRUE(subset_stack->is_contiguous());
+	SG_UNREF(subset_stack);
+
+	// the block is copied as the caller may modify it
+	auto matrix=features->get_feature_matrix();
+	ASSERT_EQ(matrix.num_rows, dim);
+	ASSERT_EQ(matrix.num_cols, block.vlen);
+	EXPECT_NE(matrix.matrix, data.matrix+block[0]*dim);
+	for (index_t j=0; j<block.vlen; ++j)
+	{
+		for (index_t i=0; i<dim; ++i)
+			EXPECT_EQ(matrix(i, j), data(i, block[j]));
+	}
+
+	// read only operations use the block
+	auto sum=features->sum();
+	for (index_t i=0; i<dim; ++i)
+	{
+		float64_t expected=0;
+		for (auto j : block)
+			expected+=data(i, j);
+		EXPECT_EQ(sum[i], expected);
+	}
+
+	// every other index is converted without a lookup
+	SGVector<index_t> strided{0, 2};
+	features->add_subset(strided);
+	subset_stack=features->get_subset_stack();
+	EXPECT_FALSE(subset_stack->is_contiguous());
+	EXPECT_EQ(subset_stack->get_last_subset()->get_stride(), 2);
+	SG_UNREF(subset_stack);
+	for (index_t j=0; j<strided.vlen; ++j)
+	{
+		auto vec=features->get_feature_vector(j);
+		for (index_t i=0; i<dim; ++i)
+			EXPECT_EQ(vec[i], data(i, block[strided[j]]));
+	}
+
+}
+
+TEST(DenseFeaturesTest, subset_caching)
+{
+	index_t dim=3;
+	index_t n=10;
+	SGMatrix<float64_t> data(dim, n);
+	std::iota(data.data(), data.data()+data.size(), 1);
+
+	auto features=some<CDenseFeatures<float64_t>>(data);
+	features->set_subset_caching(true);
+
+	SGVector<index_t> subset{7, 1, 3};
+	auto subset_features=view(features, subset);
+	EXPECT_TRUE(subset_features->get_subset_caching());
+
+	// the cached copy is copied again on every call
+	auto matrix=subset_features->get_feature_matrix();
+	EXPECT_NE(matrix.matrix, subset_features->get_feature_matrix().matrix);
+	for (index_t j=0; j<subset.vlen; ++j)
+	{
+		auto vec=subset_features->get_feature_vector(j);
+		for (index_t i=0; i<dim; ++i)
+		{
+			EXPECT_EQ(vec[i], data(i, subset[j]));
+			EXPECT_EQ(matrix(i, j), data(i, subset[j]));
+		}
+	}
+
+	subset_features->remove_subset();
+	EXPECT_EQ(subset_features->get_feature_matrix().matrix, data.matrix);
+}
+
+TEST(DenseFeaturesTest, preprocess_subset_in_place)
+{
+	index_t dim=3;
+	index_t n=10;
+	SGMatrix<float64_t> data(dim, n);
+	std::iota(data.data(), data.data()+data.size(), 1);
+	auto original=data.clone();
+
+	auto features=some<CDenseFeatures<float64_t>>(data);
+	auto preprocessor=some<CNormOne>();
+
+	// a block of consecutive indices and a cached subset
+	SGVector<index_t> block{4, 5, 6, 7};
+	SGVector<index_t> subset{7, 1, 3};
+	for (auto caching : {false, true})
+	{
+		features->set_subset_caching(caching);
+		for (const auto& idx : {block, subset})
+		{
+			features->add_subset(idx);
+			auto cached=features->get_feature_matrix();
+
+			auto transformed=wrap(preprocessor->transform(features));
+			features->remove_subset();
+			EXPECT_TRUE(original.equals(features->get_feature_matrix()));
+
+			// the subset still reads the untouched vectors
+			features->add_subset(idx);
+			EXPECT_TRUE(cached.equals(features->get_feature_matrix()));
+			features->remove_subset();
+		}
+	}
+}
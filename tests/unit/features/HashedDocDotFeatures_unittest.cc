@@ -16,6 +16,7 @@
 #include <shogun/mathematics/UniformIntDistribution.h>
 
 #include <random>
+#include <string.h>
 
 using namespace shogun;
 
@@ -312,3 +313,84 @@ TEST(HashedDocDotFeaturesTest, quadratic_add_to_dense)
 	SG_UNREF(hddf);
 	SG_FREE(hashes);
 }
+
+TEST(HashedDocDotFeaturesTest, batch_murmur_hash)
+{
+	std::mt19937_64 prng(17);
+	UniformIntDistribution<int32_t> uniform_int_dist;
+	SGVector<uint8_t> data(1000);
+	for (index_t i=0; i<data.vlen; i++)
+		data[i] = uniform_int_dist(prng, {0, 255});
+
+	const int32_t num_tokens = 37;
+	SGVector<int32_t> starts(num_tokens);
+	SGVector<int32_t> lengths(num_tokens);
+	for (index_t i=0; i<num_tokens; i++)
+	{
+		lengths[i] = uniform_int_dist(prng, {0, 30});
+		starts[i] = uniform_int_dist(prng, {0, data.vlen - lengths[i]});
+	}
+	// a token that ends at the end of the buffer
+	lengths[0] = 7;
+	starts[0] = data.vlen - 7;
+
+	const uint32_t seed = 0xdeadbeaf;
+	SGVector<uint32_t> hashes(num_tokens);
+	CHash::MurmurHash3(data.vector, starts.vector, lengths.vector, num_tokens,
+			seed, hashes.vector);
+
+	for (index_t i=0; i<num_tokens; i++)
+		EXPECT_EQ(hashes[i], CHash::MurmurHash3(data.vector + starts[i],
+				lengths[i], seed));
+}
+
+TEST(HashedDocDotFeaturesTest, materialize)
+{
+	const char* docs[] = {
+		"You're never too old to rock and roll, if you're too young to die",
+		"Give me some rope, tie me to dream, give me the hope to run out of steam",
+		"Thank you Jack Daniels, Old Number Seven, Tennessee Whiskey got me drinking in heaven"};
+
+	std::vector<SGVector<char>> list;
+	for (auto doc : docs)
+	{
+		SGVector<char> string(strlen(doc));
+		sg_memcpy(string.vector, doc, string.vlen);
+		list.push_back(string);
+	}
+
+	int32_t hash_bits = 6;
+	int32_t dimension = 64;
+
+	CNGramTokenizer* tokenizer = new CNGramTokenizer(3);
+	CStringFeatures<char>* doc_collection = new CStringFeatures<char>(list, RAWBYTE);
+	CHashedDocDotFeatures* hddf = new CHashedDocDotFeatures(hash_bits, doc_collection,
+			tokenizer, true, 3, 2);
+	CHashedDocDotFeatures* materialized = (CHashedDocDotFeatures*) hddf->duplicate();
+	materialized->materialize();
+	EXPECT_FALSE(hddf->is_materialized());
+	EXPECT_TRUE(materialized->is_materialized());
+
+	SGVector<float64_t> vec(dimension);
+	for (index_t i=0; i<dimension; i++)
+		vec[i] = i - dimension / 2;
+
+	for (index_t i=0; i<3; i++)
+	{
+		EXPECT_NEAR(hddf->dot(i, vec), materialized->dot(i, vec), 1e-12);
+
+		SGVector<float64_t> expected(dimension);
+		SGVector<float64_t> result(dimension);
+		expected.zero();
+		result.zero();
+		hddf->add_to_dense_vec(-0.5, i, expected.vector, dimension, true);
+		materialized->add_to_dense_vec(-0.5, i, result.vector, dimension, true);
+		for (index_t j=0; j<dimension; j++)
+			EXPECT_NEAR(expected[j], result[j], 1e-12);
+
+		EXPECT_LE(materialized->get_nnz_features_for_vector(i), dimension);
+	}
+
+	SG_UNREF(materialized);
+	SG_UNREF(hddf);
+}
@@ -13,6 +13,7 @@
 #include <shogun/io/stream/FileOutputStream.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/SparseFeatures.h>
+#include <random>
 #include <string>
 
 using namespace shogun;
@@ -413,3 +414,44 @@ TEST(SparseFeaturesTest,subset_get_full_feature_vector_smaller)
 
 	SG_UNREF(features);
 }
+
+TEST(SparseFeaturesTest, dense_dot_and_product)
+{
+	const index_t num_features = 50;
+	const index_t num_vectors = 40;
+	const index_t num_outputs = 19;
+	std::mt19937_64 prng(23);
+	std::uniform_real_distribution<float64_t> uniform(-1, 1);
+
+	SGMatrix<float64_t> data(num_features, num_vectors);
+	for (auto& x : data)
+		x = uniform(prng) < -0.4 ? uniform(prng) : 0;
+	auto features = some<CSparseFeatures<float64_t>>(data);
+
+	SGMatrix<float64_t> weights(num_outputs, num_features);
+	for (auto& x : weights)
+		x = uniform(prng);
+
+	auto product = features->dense_product(weights);
+	ASSERT_EQ(num_outputs, product.num_rows);
+	ASSERT_EQ(num_vectors, product.num_cols);
+
+	for (index_t i = 0; i < num_vectors; ++i)
+	{
+		for (index_t k = 0; k < num_outputs; ++k)
+		{
+			float64_t expected = 0;
+			for (index_t j = 0; j < num_features; ++j)
+				expected += weights(k, j) * data(j, i);
+			EXPECT_NEAR(expected, product(k, i), 1e-12);
+		}
+
+		SGVector<float64_t> w(num_features);
+		for (index_t j = 0; j < num_features; ++j)
+			w[j] = weights(0, j);
+		EXPECT_NEAR(product(0, i), features->dot(i, w), 1e-12);
+		EXPECT_NEAR(
+		    2 * product(0, i) + 1,
+		    features->dense_dot(2, i, w.vector, num_features, 1), 1e-12);
+	}
+}
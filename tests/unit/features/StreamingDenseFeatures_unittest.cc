@@ -138,3 +138,110 @@ TEST(StreamingDenseFeaturesTest, reset_stream)
 	feats->end_parser();
 	SG_UNREF(feats);
 }
+
+TEST(StreamingDenseFeaturesTest, batches_from_file)
+{
+	int32_t seed = 17;
+	index_t n=1000;
+	index_t dim=3;
+	char fname[] = "StreamingDenseFeatures_batches.XXXXXX";
+	generate_temp_filename(fname);
+
+	std::mt19937_64 prng(seed);
+	NormalDistribution<float64_t> normal_dist;
+
+	SGMatrix<float64_t> data(dim,n);
+	for (index_t i=0; i<dim*n; ++i)
+		data.matrix[i] = normal_dist(prng);
+
+	CDenseFeatures<float64_t>* orig_feats=new CDenseFeatures<float64_t>(data);
+	CCSVFile* saved_features = new CCSVFile(fname, 'w');
+	orig_feats->save(saved_features);
+	saved_features->close();
+	SG_UNREF(saved_features);
+
+	CStreamingAsciiFile* input = new CStreamingAsciiFile(fname);
+	input->set_delimiter(',');
+	CStreamingDenseFeatures<float64_t>* feats
+		= new CStreamingDenseFeatures<float64_t>(input, false, 5);
+	// the parser threads get several batches each
+	feats->set_batch_size(64, 3);
+
+	index_t i = 0;
+	feats->start_parser();
+	SGVector<float64_t> labels;
+	CDotFeatures* batch = feats->get_next_batch(labels);
+	ASSERT_TRUE(batch!=nullptr);
+	EXPECT_EQ(64, batch->get_num_vectors());
+	EXPECT_EQ(dim, batch->get_dim_feature_space());
+	SG_REF(batch);
+	for (; i < batch->get_num_vectors(); i++)
+	{
+		SGVector<float64_t> example
+			= batch->as<CDenseFeatures<float64_t>>()->get_feature_vector(i);
+		for (index_t j = 0; j < dim; j++)
+			EXPECT_NEAR(data(j, i), example[j], 1E-5);
+	}
+	SG_UNREF(batch);
+
+	while (feats->get_next_example())
+	{
+		SGVector<float64_t> example = feats->get_vector();
+		ASSERT_EQ(dim, example.vlen);
+
+		for (index_t j = 0; j < dim; j++)
+			EXPECT_NEAR(data(j, i), example.vector[j], 1E-5);
+
+		feats->release_example();
+		i++;
+	}
+	feats->end_parser();
+	EXPECT_EQ(n, i);
+
+	SG_UNREF(orig_feats);
+	SG_UNREF(feats);
+
+	std::remove(fname);
+}
+
+TEST(StreamingDenseFeaturesTest, batches_reset_stream)
+{
+	int32_t seed = 17;
+	index_t n=20;
+	index_t dim=2;
+
+	std::mt19937_64 prng(seed);
+	NormalDistribution<float64_t> normal_dist;
+
+	SGMatrix<float64_t> data(dim,n);
+	for (index_t i=0; i<dim*n; ++i)
+		data.matrix[i]=normal_dist(prng);
+
+	CDenseFeatures<float64_t>* orig_feats=new CDenseFeatures<float64_t>(data);
+	SGVector<float64_t> lab(n);
+	lab.range_fill();
+	CStreamingDenseFeatures<float64_t>* feats
+		= new CStreamingDenseFeatures<float64_t>(orig_feats, lab.vector);
+	feats->set_batch_size(8);
+
+	for (index_t pass=0; pass<2; pass++)
+	{
+		if (pass)
+			feats->reset_stream();
+		else
+			feats->start_parser();
+
+		index_t i = 0;
+		while (feats->get_next_example())
+		{
+			EXPECT_EQ(data.get_column(i), feats->get_vector());
+			EXPECT_EQ(lab[i], feats->get_label());
+			feats->release_example();
+			i++;
+		}
+		EXPECT_EQ(n, i);
+	}
+	feats->end_parser();
+
+	SG_UNREF(feats);
+}
@@ -11,6 +11,7 @@
 
 #include <shogun/io/streaming/StreamingAsciiFile.h>
 #include <shogun/features/streaming/StreamingSparseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/io/LibSVMFile.h>
 #include <shogun/mathematics/UniformIntDistribution.h>
 #include <shogun/mathematics/UniformRealDistribution.h>
@@ -83,3 +84,87 @@ TEST(StreamingSparseFeaturesTest, parse_file)
 
   std::remove(fname);
 }
+
+TEST(StreamingSparseFeaturesTest, parse_file_in_batches)
+{
+  char fname[] = "StreamingSparseFeatures_batches.XXXXXX";
+  generate_temp_filename(fname);
+
+  int32_t num_vec=100;
+  int32_t num_feat=0;
+
+  std::mt19937_64 prng(101);
+  UniformIntDistribution<int32_t> uniform_int_dist;
+  UniformRealDistribution<float64_t> uniform_real_dist;
+
+  SGSparseVector<float64_t>* data=SG_MALLOC(SGSparseVector<float64_t>, num_vec);
+  float64_t* labels=SG_MALLOC(float64_t, num_vec);
+  for (int32_t i=0; i<num_vec; i++)
+  {
+    data[i]=SGSparseVector<float64_t>(uniform_int_dist(prng, {1, 20}));
+    labels[i]=(float64_t) uniform_int_dist(prng, {-1, 1});
+    for (int32_t j=0; j<data[i].num_feat_entries; j++)
+    {
+      int32_t feat_index=(j+1)*3;
+      num_feat=CMath::max(num_feat, feat_index);
+
+      data[i].features[j].feat_index=feat_index-1;
+      data[i].features[j].entry=uniform_real_dist(prng, {0.0, 1.0});
+    }
+  }
+  CLibSVMFile* fout = new CLibSVMFile(fname, 'w', NULL);
+  fout->set_sparse_matrix(data, num_feat, num_vec, labels);
+  SG_UNREF(fout);
+
+  CStreamingAsciiFile *file = new CStreamingAsciiFile(fname);
+  CStreamingSparseFeatures<float64_t> *stream_features =
+    new CStreamingSparseFeatures<float64_t>(file, true, 8);
+  stream_features->set_batch_size(16, 2);
+
+  stream_features->start_parser();
+  index_t i = 0;
+  while (stream_features->get_next_example())
+  {
+      SGSparseVector<float64_t> v = stream_features->get_vector();
+      ASSERT_EQ(data[i].num_feat_entries, v.num_feat_entries);
+      EXPECT_EQ(labels[i], stream_features->get_label());
+
+      for (index_t j = 0; j < data[i].num_feat_entries; j++)
+      {
+        EXPECT_EQ(data[i].features[j].feat_index, v.features[j].feat_index);
+        EXPECT_DOUBLE_EQ(data[i].features[j].entry, v.features[j].entry);
+      }
+
+      stream_features->release_example();
+      i++;
+
+      // the rest of the stream is returned as a batch
+      if (i == 40)
+        break;
+  }
+
+  SGVector<float64_t> batch_labels;
+  CDotFeatures* batch = stream_features->get_next_batch(batch_labels);
+  ASSERT_TRUE(batch != nullptr);
+  SG_REF(batch);
+  // the batch after the current one of the 40th example
+  ASSERT_EQ(16, batch->get_num_vectors());
+  ASSERT_EQ(16, batch_labels.vlen);
+  auto sparse_batch = batch->as<CSparseFeatures<float64_t>>();
+  for (index_t k = 0; k < 16; k++)
+  {
+    auto v = sparse_batch->get_sparse_feature_vector(k);
+    EXPECT_EQ(labels[48 + k], batch_labels[k]);
+    ASSERT_EQ(data[48 + k].num_feat_entries, v.num_feat_entries);
+    for (index_t j = 0; j < v.num_feat_entries; j++)
+      EXPECT_DOUBLE_EQ(data[48 + k].features[j].entry, v.features[j].entry);
+  }
+  SG_UNREF(batch);
+  stream_features->end_parser();
+
+  SG_UNREF(stream_features);
+  SG_FREE(data);
+  SG_FREE(labels);
+
+  std::remove(fname);
+}
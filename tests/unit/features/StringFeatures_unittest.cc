@@ -7,7 +7,13 @@
 
 #include "utils/Utils.h"
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/features/StringFeatures.h>
+#include <shogun/io/fs/FileSystem.h>
+#include <shogun/io/serialization/JsonDeserializer.h>
+#include <shogun/io/serialization/JsonSerializer.h>
+#include <shogun/io/stream/FileInputStream.h>
+#include <shogun/io/stream/FileOutputStream.h>
 #include <shogun/lib/memory.h>
 #include <random>
 
@@ -91,3 +97,176 @@ TEST(StringFeaturesTest,equals)
 	SG_UNREF(f);
 	SG_UNREF(f_clone);
 }
+
+TEST(StringFeaturesTest,packed_strings)
+{
+	std::mt19937_64 prng(25);
+	std::uniform_int_distribution<index_t> length(0, 100);
+	std::uniform_int_distribution<index_t> base(0, 3);
+
+	std::vector<SGVector<char>> strings;
+	for (index_t i=0; i<20; ++i)
+	{
+		SGVector<char> str(length(prng));
+		for (auto& c : str)
+			c="ACGT"[base(prng)];
+		strings.push_back(str);
+	}
+
+	auto f=some<CStringFeatures<char>>(strings, DNA);
+	f->pack();
+	EXPECT_TRUE(f->is_packed());
+	EXPECT_EQ(f->get_num_vectors(), 20);
+
+	for (index_t i=0; i<f->get_num_vectors(); ++i)
+	{
+		SGVector<char> vec=f->get_feature_vector(i);
+		EXPECT_EQ(vec.vlen, strings[i].vlen);
+		for (index_t j=0; j<vec.vlen; ++j)
+			EXPECT_EQ(vec[j], strings[i][j]);
+	}
+
+	SGVector<index_t> indices(5);
+	indices.range_fill(3);
+	auto subset_copy=f->copy_subset(indices)->as<CStringFeatures<char>>();
+	EXPECT_TRUE(subset_copy->is_packed());
+	for (index_t i=0; i<indices.vlen; ++i)
+	{
+		SGVector<char> vec=subset_copy->get_feature_vector(i);
+		EXPECT_EQ(vec.vlen, strings[i+3].vlen);
+		for (index_t j=0; j<vec.vlen; ++j)
+			EXPECT_EQ(vec[j], strings[i+3][j]);
+	}
+	SG_UNREF(subset_copy);
+
+	f->unpack();
+	EXPECT_FALSE(f->is_packed());
+	for (index_t i=0; i<f->get_num_vectors(); ++i)
+	{
+		int32_t len;
+		bool free_vec;
+		char* vec=f->get_feature_vector(i, len, free_vec);
+		EXPECT_FALSE(free_vec);
+		EXPECT_EQ(len, strings[i].vlen);
+		for (index_t j=0; j<len; ++j)
+			EXPECT_EQ(vec[j], strings[i][j]);
+	}
+}
+
+TEST(StringFeaturesTest,obtain_from_packed_char)
+{
+	std::mt19937_64 prng(25);
+	std::uniform_int_distribution<index_t> length(0, 200);
+	std::uniform_int_distribution<index_t> base(0, 3);
+
+	std::vector<SGVector<char>> strings;
+	for (index_t i=0; i<20; ++i)
+	{
+		SGVector<char> str(length(prng));
+		for (auto& c : str)
+			c="ACGT"[base(prng)];
+		strings.push_back(str);
+	}
+
+	auto chars=some<CStringFeatures<char>>(strings, DNA);
+	auto packed_chars=some<CStringFeatures<char>>(strings, DNA);
+	packed_chars->pack();
+
+	// start, order, gap
+	const int32_t shapes[][3]={{0, 1, 0}, {2, 3, 0}, {7, 8, 0}, {3, 4, 2},
+			{0, 6, 1}, {11, 5, 3}};
+	for (const auto& shape : shapes)
+	{
+		for (auto rev : {false, true})
+		{
+			auto expected=some<CStringFeatures<uint16_t>>(DNA);
+			expected->obtain_from_char(chars, shape[0], shape[1], shape[2], rev);
+
+			for (auto sf : {chars.get(), packed_chars.get()})
+			{
+				auto kmers=some<CStringFeatures<uint16_t>>(DNA);
+				kmers->obtain_from_packed_char(sf, shape[0], shape[1], shape[2], rev);
+				EXPECT_TRUE(kmers->is_packed());
+				EXPECT_EQ(kmers->get_num_symbols(), expected->get_num_symbols());
+				EXPECT_EQ(kmers->get_max_vector_length(),
+						expected->get_max_vector_length());
+
+				for (index_t i=0; i<kmers->get_num_vectors(); ++i)
+				{
+					SGVector<uint16_t> vec=kmers->get_feature_vector(i);
+					SGVector<uint16_t> expected_vec=expected->get_feature_vector(i);
+					ASSERT_EQ(vec.vlen, expected_vec.vlen);
+					for (index_t j=0; j<vec.vlen; ++j)
+						EXPECT_EQ(vec[j], expected_vec[j]);
+				}
+			}
+		}
+	}
+}
+
+TEST(StringFeaturesTest,packed_strings_clone_serialization)
+{
+	std::mt19937_64 prng(25);
+	std::uniform_int_distribution<index_t> length(0, 100);
+	std::uniform_int_distribution<index_t> base(0, 3);
+
+	std::vector<SGVector<char>> strings;
+	for (index_t i=0; i<20; ++i)
+	{
+		SGVector<char> str(length(prng));
+		for (auto& c : str)
+			c="ACGT"[base(prng)];
+		strings.push_back(str);
+	}
+
+	auto f=some<CStringFeatures<char>>(strings, DNA);
+	f->pack();
+
+	auto kmers=some<CStringFeatures<uint16_t>>(DNA);
+	kmers->obtain_from_packed_char(f, 2, 3, 1, false);
+
+	auto expect_packed_equal=[](auto* expected, auto* actual)
+	{
+		EXPECT_TRUE(actual->is_packed());
+		EXPECT_TRUE(expected->equals(actual));
+		ASSERT_EQ(actual->get_num_vectors(), expected->get_num_vectors());
+		EXPECT_EQ(actual->get_max_vector_length(),
+				expected->get_max_vector_length());
+		for (index_t i=0; i<expected->get_num_vectors(); ++i)
+		{
+			auto vec=actual->get_feature_vector(i);
+			auto expected_vec=expected->get_feature_vector(i);
+			ASSERT_EQ(vec.vlen, expected_vec.vlen);
+			for (index_t j=0; j<vec.vlen; ++j)
+				EXPECT_EQ(vec[j], expected_vec[j]);
+		}
+	};
+
+	auto f_clone=wrap(f->clone()->as<CStringFeatures<char>>());
+	expect_packed_equal(f.get(), f_clone.get());
+	auto kmers_clone=wrap(kmers->clone()->as<CStringFeatures<uint16_t>>());
+	expect_packed_equal(kmers.get(), kmers_clone.get());
+
+	std::string filename="serialization-json-CStringFeatures.XXXXXX";
+	generate_temp_filename(const_cast<char*>(filename.c_str()));
+
+	auto fs=env();
+	ASSERT_TRUE(!fs->file_exists(filename));
+	std::unique_ptr<io::WritableFile> file;
+	ASSERT_TRUE(!fs->new_writable_file(filename, &file));
+	auto fos=some<io::CFileOutputStream>(file.get());
+	auto serializer=some<io::CJsonSerializer>();
+	serializer->attach(fos);
+	serializer->write(kmers);
+
+	std::unique_ptr<io::RandomAccessFile> raf;
+	ASSERT_TRUE(!fs->new_random_access_file(filename, &raf));
+	auto fis=some<io::CFileInputStream>(raf.get());
+	auto deserializer=some<io::CJsonDeserializer>();
+	deserializer->attach(fis);
+	auto deser_obj=deserializer->read_object();
+	ASSERT_TRUE(!fs->delete_file(filename));
+
+	expect_packed_equal(kmers.get(),
+			deser_obj->as<CStringFeatures<uint16_t>>());
+}
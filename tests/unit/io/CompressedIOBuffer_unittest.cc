@@ -0,0 +1,171 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
+#include <shogun/io/CompressedIOBuffer.h>
+#include <shogun/io/streaming/StreamingAsciiFile.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include "../utils/Utils.h"
+
+#ifdef USE_GZIP
+#include <zlib.h>
+#endif
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace shogun;
+
+namespace
+{
+void write_compressed(
+    const char* fname, const std::string& text,
+    E_COMPRESSION_TYPE compression)
+{
+	auto buffer = some<CCompressedIOBuffer>(compression, 100);
+	ASSERT_TRUE(buffer->open_file(fname, 'w'));
+	// pieces across the block boundaries
+	for (size_t i = 0; i < text.size(); i += 37)
+		buffer->write_file(
+		    text.data() + i, std::min<size_t>(37, text.size() - i));
+	buffer->close_file();
+}
+
+std::string random_text(SGMatrix<float64_t>& data)
+{
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist;
+	std::string text;
+	char value[32];
+	for (index_t i = 0; i < data.num_cols; i++)
+	{
+		for (index_t j = 0; j < data.num_rows; j++)
+		{
+			data(j, i) = dist(prng);
+			snprintf(value, sizeof(value), j ? " %.17g" : "%.17g", data(j, i));
+			text += value;
+		}
+		text += "\n";
+	}
+	return text;
+}
+
+void check_streamed(const char* fname, const SGMatrix<float64_t>& data)
+{
+	auto file = new CStreamingAsciiFile(fname);
+	auto feats = some<CStreamingDenseFeatures<float64_t>>(file, false, 8);
+
+	index_t i = 0;
+	feats->start_parser();
+	while (feats->get_next_example())
+	{
+		ASSERT_LT(i, data.num_cols);
+		EXPECT_TRUE(data.get_column(i).equals(feats->get_vector()));
+		feats->release_example();
+		i++;
+	}
+	feats->end_parser();
+	EXPECT_EQ(data.num_cols, i);
+}
+}
+
+TEST(CompressedIOBuffer, streaming_features_from_blocks)
+{
+	std::vector<E_COMPRESSION_TYPE> compressions = {UNCOMPRESSED};
+#ifdef USE_GZIP
+	compressions.push_back(GZIP);
+#endif
+#ifdef USE_SNAPPY
+	compressions.push_back(SNAPPY);
+#endif
+
+	SGMatrix<float64_t> data(3, 200);
+	auto text = random_text(data);
+
+	for (auto compression : compressions)
+	{
+		char fname[] = "CompressedIOBuffer_features.XXXXXX";
+		generate_temp_filename(fname);
+		write_compressed(fname, text, compression);
+		check_streamed(fname, data);
+		std::remove(fname);
+	}
+}
+
+#ifdef USE_GZIP
+TEST(CompressedIOBuffer, streaming_features_from_gzip)
+{
+	SGMatrix<float64_t> data(3, 5000);
+	auto text = random_text(data);
+
+	char fname[] = "CompressedIOBuffer_gzip.XXXXXX";
+	generate_temp_filename(fname);
+	// two concatenated members, as appending to a gzip log does
+	auto half = text.find('\n', text.size() / 2) + 1;
+	gzFile gz = gzopen(fname, "wb");
+	ASSERT_NE(nullptr, gz);
+	ASSERT_EQ(int(half), gzwrite(gz, text.data(), half));
+	gzclose(gz);
+	gz = gzopen(fname, "ab");
+	ASSERT_NE(nullptr, gz);
+	ASSERT_EQ(
+	    int(text.size() - half),
+	    gzwrite(gz, text.data() + half, text.size() - half));
+	gzclose(gz);
+
+	check_streamed(fname, data);
+
+	// and read again after a reset
+	auto buffer = some<CCompressedIOBuffer>();
+	ASSERT_TRUE(buffer->open_file(fname, 'r'));
+	std::string read(text.size(), 0);
+	for (auto pass = 0; pass < 2; pass++)
+	{
+		size_t total = 0;
+		for (ssize_t n;
+		     (n = buffer->read_file(&read[total], read.size() - total)) > 0;)
+			total += n;
+		EXPECT_EQ(text.size(), total);
+		EXPECT_EQ(text, read);
+		buffer->reset_file();
+	}
+	buffer->close_file();
+
+	std::remove(fname);
+}
+#endif
+
+TEST(CompressedIOBuffer, truncated_file)
+{
+	char fname[] = "CompressedIOBuffer_truncated.XXXXXX";
+	generate_temp_filename(fname);
+	std::string text(1000, 'x');
+	write_compressed(fname, text, UNCOMPRESSED);
+
+	// cut the last block short
+	FILE* f = fopen(fname, "r+");
+	fseek(f, 0, SEEK_END);
+	ASSERT_EQ(0, ftruncate(fileno(f), ftell(f) - 10));
+	fclose(f);
+
+	auto buffer = some<CCompressedIOBuffer>();
+	ASSERT_TRUE(buffer->open_file(fname, 'r'));
+	char chunk[64];
+	size_t total = 0;
+	EXPECT_THROW(
+	    {
+		    for (ssize_t n; (n = buffer->read_file(chunk, sizeof(chunk))) > 0;)
+			    total += n;
+	    },
+	    ShogunException);
+	EXPECT_EQ(900u, total);
+	buffer->close_file();
+
+	std::remove(fname);
+}
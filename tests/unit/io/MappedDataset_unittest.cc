@@ -0,0 +1,136 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/io/MappedDataset.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/preprocessor/NormOne.h>
+#include "../utils/Utils.h"
+
+#include <cstdio>
+#include <random>
+
+using namespace shogun;
+
+TEST(MappedDataset, dense_features_with_labels)
+{
+	char fname[] = "MappedDataset_dense.XXXXXX";
+	generate_temp_filename(fname);
+
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist;
+	SGMatrix<float64_t> data(5, 37);
+	SGVector<float64_t> labels(37);
+	for (index_t i = 0; i < data.num_rows * data.num_cols; i++)
+		data.matrix[i] = dist(prng);
+	for (index_t i = 0; i < labels.vlen; i++)
+		labels[i] = i % 3;
+
+	MappedDataset::save(fname, data, labels);
+	{
+		MappedDataset dataset(fname);
+		EXPECT_FALSE(dataset.is_sparse());
+		EXPECT_EQ(PT_FLOAT64, dataset.get_primitive_type());
+		EXPECT_EQ(5, dataset.get_num_features());
+		EXPECT_EQ(37, dataset.get_num_vectors());
+		ASSERT_TRUE(dataset.has_labels());
+		EXPECT_TRUE(labels.equals(dataset.get_labels()));
+		EXPECT_THROW(dataset.get_dense_matrix<float32_t>(), ShogunException);
+		EXPECT_THROW(dataset.get_sparse_matrix<float64_t>(), ShogunException);
+	}
+
+	auto feats = some<CDenseFeatures<float64_t>>();
+	feats->set_feature_matrix_from_file(fname);
+
+	// in-place preprocessing writes to private pages, not to the file
+	{
+		auto mapped = some<CDenseFeatures<float64_t>>();
+		mapped->set_feature_matrix_from_file(fname);
+		auto preprocessor = some<CNormOne>();
+		auto normalized = wrap(preprocessor->transform(mapped));
+		EXPECT_NEAR(
+		    1.0, linalg::norm(mapped->get_feature_vector(0)), 1e-12);
+	}
+	EXPECT_TRUE(data.equals(feats->get_feature_matrix()));
+	{
+		MappedDataset dataset(fname);
+		EXPECT_TRUE(data.equals(dataset.get_dense_matrix<float64_t>()));
+	}
+
+	// matrices and vectors keep the mapping alive
+	{
+		auto mapped = some<CDenseFeatures<float64_t>>();
+		mapped->set_feature_matrix_from_file(fname);
+		auto matrix = mapped->get_feature_matrix();
+		auto vector = mapped->get_feature_vector(3);
+		mapped->free_feature_matrix();
+		EXPECT_TRUE(data.equals(matrix));
+		EXPECT_TRUE(data.get_column(3).equals(vector));
+	}
+	std::remove(fname);
+
+	// the mapping outlives the removed file and is shared by copies
+	auto copy = feats->duplicate()->as<CDenseFeatures<float64_t>>();
+	SG_REF(copy);
+	feats->free_feature_matrix();
+	EXPECT_TRUE(data.equals(copy->get_feature_matrix()));
+	SG_UNREF(copy);
+}
+
+TEST(MappedDataset, sparse_features)
+{
+	char fname[] = "MappedDataset_sparse.XXXXXX";
+	generate_temp_filename(fname);
+
+	std::mt19937_64 prng(18);
+	std::uniform_real_distribution<float64_t> dist;
+	SGMatrix<float64_t> data(20, 43);
+	for (index_t i = 0; i < data.num_rows * data.num_cols; i++)
+		data.matrix[i] = dist(prng) < 0.2 ? dist(prng) : 0;
+	// empty vectors at both ends
+	for (index_t j = 0; j < data.num_rows; j++)
+	{
+		data(j, 0) = 0;
+		data(j, data.num_cols - 1) = 0;
+	}
+
+	auto sparse = some<CSparseFeatures<float64_t>>(data);
+	MappedDataset::save(fname, sparse->get_sparse_feature_matrix());
+	{
+		MappedDataset dataset(fname);
+		EXPECT_TRUE(dataset.is_sparse());
+		EXPECT_FALSE(dataset.has_labels());
+		EXPECT_THROW(dataset.get_labels(), ShogunException);
+	}
+
+	auto feats = some<CSparseFeatures<float64_t>>();
+	feats->set_sparse_feature_matrix_from_file(fname);
+	EXPECT_EQ(20, feats->get_num_features());
+	EXPECT_EQ(43, feats->get_num_vectors());
+	EXPECT_TRUE(data.equals(feats->get_full_feature_matrix()));
+	EXPECT_EQ(0, feats->get_sparse_feature_vector(0).num_feat_entries);
+
+	std::remove(fname);
+}
+
+TEST(MappedDataset, not_a_dataset)
+{
+	char fname[] = "MappedDataset_invalid.XXXXXX";
+	generate_temp_filename(fname);
+
+	FILE* f = fopen(fname, "w");
+	for (int32_t i = 0; i < 5000; i++)
+		fputc('x', f);
+	fclose(f);
+
+	EXPECT_THROW(MappedDataset dataset(fname), ShogunException);
+	std::remove(fname);
+}
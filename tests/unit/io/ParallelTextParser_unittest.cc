@@ -0,0 +1,174 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/io/ParallelTextParser.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/exception/ShogunException.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using namespace shogun;
+
+namespace
+{
+float64_t parse(const char* text)
+{
+	return ParallelTextParser::parse_value<float64_t>(
+	    text, text + strlen(text));
+}
+}
+
+TEST(ParallelTextParser, parse_value_matches_strtod)
+{
+	const char* texts[] = {
+	    "0",     "-0",    "+1",    "1.5",   ".25",    "3.",     "1e10",
+	    "-2.5E-3", "1e-30", "1e400", "0.1", "123456789012345678", "nan",
+	    "-inf",  "0x1p3", "1.5abc", "1e",   "007",    "4.9e-324"};
+	for (auto text : texts)
+	{
+		auto expected = strtod(text, NULL);
+		auto value = parse(text);
+		if (std::isnan(expected))
+			EXPECT_TRUE(std::isnan(value)) << text;
+		else
+			EXPECT_EQ(expected, value) << text;
+		EXPECT_EQ(std::signbit(expected), std::signbit(value)) << text;
+	}
+
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist(0, 1000);
+	char text[64];
+	for (int32_t i = 0; i < 10000; i++)
+	{
+		snprintf(text, sizeof(text), i % 2 ? "%.17g" : "%.6f", dist(prng));
+		EXPECT_EQ(strtod(text, NULL), parse(text)) << text;
+	}
+
+	EXPECT_EQ(
+	    -12, ParallelTextParser::parse_value<int32_t>("-12.7", "-12.7" + 5));
+	EXPECT_EQ(
+	    int64_t(9007199254740993),
+	    ParallelTextParser::parse_value<int64_t>(
+	        "9007199254740993", "9007199254740993" + 16));
+}
+
+TEST(ParallelTextParser, dense_matches_lines)
+{
+	const index_t num_lines = 50000;
+	const index_t num_values = 6;
+
+	// several ranges of data after a header, with an empty line
+	FILE* file = tmpfile();
+	ASSERT_TRUE(file);
+	fprintf(file, "a,b,c\n");
+	std::mt19937_64 prng(18);
+	std::normal_distribution<float64_t> dist;
+	SGMatrix<float64_t> expected(num_values, num_lines);
+	for (index_t i = 0; i < num_lines; i++)
+	{
+		for (index_t j = 0; j < num_values; j++)
+		{
+			expected(j, i) = dist(prng);
+			fprintf(file, j ? ",%.17g" : "%.17g", expected(j, i));
+		}
+		fprintf(file, i == num_lines / 2 ? "\n\n" : "\n");
+	}
+
+	rewind(file);
+	ParallelTextParser parser(file, 1);
+	EXPECT_EQ(num_lines, parser.get_num_lines());
+
+	float64_t* matrix = NULL;
+	int32_t num_feat = 0;
+	int32_t num_vec = 0;
+	parser.parse_dense(matrix, num_feat, num_vec, ',', false);
+	ASSERT_EQ(num_values, num_feat);
+	ASSERT_EQ(num_lines, num_vec);
+	EXPECT_EQ(expected, SGMatrix<float64_t>(matrix, num_feat, num_vec));
+
+	parser.parse_dense(matrix, num_feat, num_vec, ',', true);
+	ASSERT_EQ(num_lines, num_feat);
+	ASSERT_EQ(num_values, num_vec);
+	auto transposed = SGMatrix<float64_t>(matrix, num_feat, num_vec);
+	for (index_t i = 0; i < num_lines; i++)
+	{
+		for (index_t j = 0; j < num_values; j++)
+			ASSERT_EQ(expected(j, i), transposed(i, j));
+	}
+
+	fclose(file);
+}
+
+TEST(ParallelTextParser, dense_short_line)
+{
+	FILE* file = tmpfile();
+	ASSERT_TRUE(file);
+	fprintf(file, "1,2,3\n4,5\n");
+	rewind(file);
+
+	ParallelTextParser parser(file);
+	int32_t* matrix = NULL;
+	int32_t num_feat = 0;
+	int32_t num_vec = 0;
+	EXPECT_THROW(
+	    parser.parse_dense(matrix, num_feat, num_vec, ',', false),
+	    ShogunException);
+	EXPECT_TRUE(matrix == NULL);
+
+	fclose(file);
+}
+
+TEST(ParallelTextParser, libsvm_with_labels)
+{
+	FILE* file = tmpfile();
+	ASSERT_TRUE(file);
+	fprintf(file, "1,2 1:0.5 3:2\n\n3:1.5\n-1 7:4\r\n");
+	rewind(file);
+
+	ParallelTextParser parser(file);
+	SGSparseVector<float64_t>* vectors = NULL;
+	SGVector<float64_t>* labels = NULL;
+	int32_t num_feat = 0;
+	int32_t num_vec = 0;
+	int32_t num_classes = 0;
+	parser.parse_libsvm(
+	    vectors, num_feat, num_vec, labels, num_classes, true);
+
+	ASSERT_EQ(3, num_vec);
+	EXPECT_EQ(7, num_feat);
+	EXPECT_EQ(3, num_classes);
+
+	ASSERT_EQ(2, labels[0].vlen);
+	EXPECT_EQ(1, labels[0][0]);
+	EXPECT_EQ(2, labels[0][1]);
+	ASSERT_EQ(2, vectors[0].num_feat_entries);
+	EXPECT_EQ(0, vectors[0].features[0].feat_index);
+	EXPECT_EQ(0.5, vectors[0].features[0].entry);
+	EXPECT_EQ(2, vectors[0].features[1].feat_index);
+	EXPECT_EQ(2, vectors[0].features[1].entry);
+
+	// the first token of the second line is a feature
+	EXPECT_EQ(0, labels[1].vlen);
+	ASSERT_EQ(1, vectors[1].num_feat_entries);
+	EXPECT_EQ(2, vectors[1].features[0].feat_index);
+	EXPECT_EQ(1.5, vectors[1].features[0].entry);
+
+	ASSERT_EQ(1, labels[2].vlen);
+	EXPECT_EQ(-1, labels[2][0]);
+	ASSERT_EQ(1, vectors[2].num_feat_entries);
+	EXPECT_EQ(6, vectors[2].features[0].feat_index);
+	EXPECT_EQ(4, vectors[2].features[0].entry);
+
+	SG_FREE(vectors);
+	SG_FREE(labels);
+	fclose(file);
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstdio>
+#include <numeric>
 
 #include <shogun/io/ShogunErrc.h>
 #include <shogun/io/serialization/BitserySerializer.h>
@@ -12,6 +14,8 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/kernel/GaussianKernel.h>
 
+#include "utils/Utils.h"
+
 using namespace shogun;
 using namespace shogun::io;
 using namespace std;
@@ -145,3 +149,81 @@ TYPED_TEST(SerializationTest, serialize)
 
 	ASSERT_TRUE(obj->equals(deser_obj));
 }
+
+TEST(BitserySerializer, array_blocks)
+{
+	std::vector<E_COMPRESSION_TYPE> compressions = {UNCOMPRESSED};
+#ifdef USE_GZIP
+	compressions.push_back(GZIP);
+#endif
+
+	SGMatrix<float64_t> data(10, 100);
+	std::iota(data.begin(), data.end(), 0.5);
+	auto df = new CDenseFeatures<float64_t>(data);
+	auto obj = some<CGaussianKernel>(df, df, 2.0);
+
+	for (auto compression : compressions)
+	{
+		auto serializer = some<CBitserySerializer>();
+		serializer->set_array_blocks(true, compression);
+		auto stream = some<CDummyOutputStream>();
+		serializer->attach(stream);
+		serializer->write(obj);
+
+		auto deserializer = some<CBitseryDeserializer>();
+		auto istream = some<CDummyInputStream>(stream->buffer());
+		deserializer->attach(istream);
+		auto deser_obj = deserializer->read_object();
+
+		ASSERT_TRUE(obj->equals(deser_obj));
+	}
+}
+
+TEST(BitserySerializer, array_blocks_mapped)
+{
+	SGMatrix<float64_t> data(10, 100);
+	std::iota(data.begin(), data.end(), 0.5);
+	auto df = new CDenseFeatures<float64_t>(data);
+	auto obj = some<CGaussianKernel>(df, df, 2.0);
+
+	char fname[] = "Serialization_array_blocks.XXXXXX";
+	generate_temp_filename(fname);
+	auto serializer = some<CBitserySerializer>();
+	serializer->set_array_blocks(true);
+	serialize(fname, obj, serializer);
+
+	auto deserializer = some<CBitseryDeserializer>();
+	deserializer->attach_mapped(fname);
+	auto deser_obj = deserializer->read_object();
+	ASSERT_TRUE(obj->equals(deser_obj));
+
+	// the features point into the mapping, which outlives the deserializer
+	deserializer = some<CBitseryDeserializer>();
+	auto lhs = wrap(deser_obj->as<CGaussianKernel>()->get_lhs());
+	auto matrix = lhs->as<CDenseFeatures<float64_t>>()->get_feature_matrix();
+	EXPECT_NE(nullptr, matrix.memory_owner);
+	EXPECT_EQ(0, (uintptr_t)matrix.matrix % 64);
+	EXPECT_TRUE(data.equals(matrix));
+
+	// the mapping is copy on write, changes do not reach the file
+	for (auto& x : matrix)
+		x *= 2;
+	auto features = lhs->as<CDenseFeatures<float64_t>>();
+	EXPECT_EQ(2 * data[1], features->get_feature_vector(0)[1]);
+
+	deserializer->attach_mapped(fname);
+	auto reloaded = deserializer->read_object();
+	ASSERT_TRUE(obj->equals(reloaded));
+
+	// resizing copies the data out of the mapping
+	SGVector<float64_t> vec(matrix);
+	vec.resize_vector(data.size() + 10);
+	EXPECT_EQ(nullptr, vec.memory_owner);
+	EXPECT_NE(matrix.matrix, vec.vector);
+	for (index_t i = 0; i < data.size(); i++)
+		EXPECT_EQ(2 * data[i], vec[i]);
+	for (index_t i = data.size(); i < vec.vlen; i++)
+		EXPECT_EQ(0, vec[i]);
+
+	std::remove(fname);
+}
@@ -0,0 +1,57 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+#include <gtest/gtest.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/kernel/string/CommWordStringKernel.h>
+#include <shogun/preprocessor/SortWordString.h>
+
+#include <random>
+
+using namespace shogun;
+
+TEST(CommWordStringKernel, packed_kmers)
+{
+	std::mt19937_64 prng(7);
+	std::uniform_int_distribution<index_t> base(0, 3);
+
+	std::vector<SGVector<char>> strings;
+	for (index_t i = 0; i < 10; ++i)
+	{
+		SGVector<char> str(50 + 5 * i);
+		for (auto& c : str)
+			c = "ACGT"[base(prng)];
+		strings.push_back(str);
+	}
+
+	const int32_t order = 6;
+	auto chars = some<CStringFeatures<char>>(strings, DNA);
+
+	auto kmers = some<CStringFeatures<uint16_t>>(DNA);
+	kmers->obtain_from_char(chars, order - 1, order, 0, false);
+	auto preproc = some<CSortWordString>();
+	preproc->fit(kmers);
+	kmers =
+	    wrap(preproc->transform(kmers)->as<CStringFeatures<uint16_t>>());
+
+	chars->pack();
+	auto packed_kmers = some<CStringFeatures<uint16_t>>(DNA);
+	packed_kmers->obtain_from_packed_char(chars, order - 1, order, 0, false);
+	auto packed_preproc = some<CSortWordString>();
+	packed_preproc->fit(packed_kmers);
+	packed_kmers = wrap(
+	    packed_preproc->transform(packed_kmers)
+	        ->as<CStringFeatures<uint16_t>>());
+	EXPECT_TRUE(packed_kmers->is_packed());
+
+	auto kernel = some<CCommWordStringKernel>(kmers, kmers);
+	auto packed_kernel =
+	    some<CCommWordStringKernel>(packed_kmers, packed_kmers);
+
+	SGMatrix<float64_t> kernel_matrix = kernel->get_kernel_matrix();
+	SGMatrix<float64_t> packed_kernel_matrix =
+	    packed_kernel->get_kernel_matrix();
+	EXPECT_TRUE(kernel_matrix.equals(packed_kernel_matrix));
+}
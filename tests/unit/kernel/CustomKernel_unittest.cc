@@ -7,17 +7,83 @@
 
 #include <gtest/gtest.h>
 
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/io/fs/FileSystem.h>
+#include <shogun/io/serialization/JsonDeserializer.h>
+#include <shogun/io/serialization/JsonSerializer.h>
+#include <shogun/io/stream/FileInputStream.h>
+#include <shogun/io/stream/FileOutputStream.h>
 #include <shogun/kernel/GaussianKernel.h>
 #include <shogun/kernel/CustomKernel.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/labels/BinaryLabels.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/features/IndexFeatures.h>
 #include <shogun/features/streaming/generators/MeanShiftDataGenerator.h>
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/Math.h>
+#include "../utils/Utils.h"
+
+#include <cstdio>
+#include <map>
+#include <mutex>
 
 using namespace shogun;
 using namespace Eigen;
 
+namespace
+{
+/* counts the rows that are prefetched while another row is computed */
+class CPrefetchCountingKernel : public CCustomKernel
+{
+public:
+	CPrefetchCountingKernel(SGMatrix<float64_t> km) : CCustomKernel(km)
+	{
+	}
+
+	virtual void prefetch_rows(const int32_t* rows, int32_t num_rows)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (int32_t i=0; i<num_rows; i++)
+			m_pending.emplace(rows[i], false);
+		CCustomKernel::prefetch_rows(rows, num_rows);
+	}
+
+	/* prefetched rows computed after another row or right away */
+	int32_t num_ahead=0;
+	int32_t num_late=0;
+
+protected:
+	virtual float64_t compute(int32_t row, int32_t col)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (auto it=m_pending.begin(); it!=m_pending.end();)
+			{
+				if (it->first!=row)
+				{
+					it->second=true;
+					++it;
+					continue;
+				}
+
+				if (it->second)
+					num_ahead++;
+				else
+					num_late++;
+				it=m_pending.erase(it);
+			}
+		}
+		return CCustomKernel::compute(row, col);
+	}
+
+private:
+	std::mutex m_mutex;
+	/* prefetched rows and whether another row was computed since */
+	std::multimap<int32_t, bool> m_pending;
+};
+}
+
 TEST(CustomKernelTest,add_row_subset)
 {
 	index_t seed = 17;
@@ -647,3 +713,169 @@ TEST(CustomKernelTest, row_col_wise_sum_block_no_diag)
 	SG_UNREF(feats_p);
 	SG_UNREF(feats_q);
 }
+
+TEST(CustomKernelTest, tiled_kernel_matrix)
+{
+	index_t n=50;
+	char fname[]="CustomKernel_tiled.XXXXXX";
+	generate_temp_filename(fname);
+
+	SGMatrix<float64_t> data(2, n);
+	SGVector<float64_t> lab(n);
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i=0; i<n; ++i)
+	{
+		lab[i]=i%2 ? 1 : -1;
+		data(0, i)=dist(prng)+lab[i];
+		data(1, i)=dist(prng);
+	}
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CGaussianKernel* gaussian=new CGaussianKernel(feats, feats, 2, 10);
+	SG_REF(gaussian);
+	TiledKernelMatrix::save(gaussian, fname, 16);
+
+	CCustomKernel* tiled=new CCustomKernel();
+	tiled->set_tiled_kernel_matrix_from_file(fname);
+	SG_REF(tiled);
+
+	EXPECT_TRUE(tiled->is_tiled());
+	EXPECT_EQ(n, tiled->get_num_vec_lhs());
+	EXPECT_EQ(n, tiled->get_num_vec_rhs());
+
+	SGMatrix<float64_t> kmg=gaussian->get_kernel_matrix();
+	SGMatrix<float64_t> km=tiled->get_kernel_matrix();
+	for (index_t i=0; i<n; ++i)
+	{
+		for (index_t j=0; j<n; ++j)
+			EXPECT_NEAR(kmg(i, j), km(i, j), 1e-6);
+	}
+
+	/* the same values held in memory */
+	CCustomKernel* in_memory=new CCustomKernel(km);
+	SG_REF(in_memory);
+
+	/* subsets select rows of the mapped file */
+	SGVector<index_t> r_idx(n/2);
+	r_idx.range_fill();
+	random::shuffle(r_idx, prng);
+	tiled->add_row_subset(r_idx);
+	for (index_t i=0; i<r_idx.vlen; ++i)
+	{
+		for (index_t j=0; j<n; ++j)
+			EXPECT_EQ(km(r_idx[i], j), tiled->kernel(i, j));
+	}
+	tiled->remove_all_row_subsets();
+
+	/* SVMs train on the mapped file as on the in-memory matrix */
+	CBinaryLabels* labels=new CBinaryLabels(lab);
+	CLibSVM* svm=new CLibSVM(1, in_memory, labels);
+	CLibSVM* svm_tiled=new CLibSVM(1, tiled, labels);
+	SG_REF(svm);
+	SG_REF(svm_tiled);
+	svm->train();
+	svm_tiled->train();
+
+	EXPECT_EQ(svm->get_bias(), svm_tiled->get_bias());
+	EXPECT_TRUE(svm->get_alphas().equals(svm_tiled->get_alphas()));
+	EXPECT_TRUE(
+		svm->get_support_vectors().equals(svm_tiled->get_support_vectors()));
+
+	SG_UNREF(svm);
+	SG_UNREF(svm_tiled);
+	SG_UNREF(tiled);
+	SG_UNREF(in_memory);
+	SG_UNREF(gaussian);
+	std::remove(fname);
+}
+
+TEST(CustomKernelTest, tiled_kernel_matrix_clone_serialization)
+{
+	index_t n=20;
+	char fname[]="CustomKernel_tiled.XXXXXX";
+	generate_temp_filename(fname);
+
+	SGMatrix<float64_t> data(2, n);
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i=0; i<data.size(); ++i)
+		data[i]=dist(prng);
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CGaussianKernel* gaussian=new CGaussianKernel(feats, feats, 2, 10);
+	SG_REF(gaussian);
+	TiledKernelMatrix::save(gaussian, fname, 8);
+
+	auto tiled=some<CCustomKernel>();
+	tiled->set_tiled_kernel_matrix_from_file(fname);
+	SGMatrix<float64_t> km=tiled->get_kernel_matrix();
+
+	/* block sums read the mapped file */
+	float64_t km_sum=0;
+	for (index_t i=0; i<km.size(); ++i)
+		km_sum+=km[i];
+	EXPECT_NEAR(km_sum, tiled->sum_block(0, 0, n, n), 1e-4);
+	EXPECT_NEAR(km_sum, tiled->sum_symmetric_block(0, n), 1e-4);
+
+	/* a clone maps the same file */
+	CCustomKernel* cloned=(CCustomKernel*)tiled->clone();
+	EXPECT_TRUE(cloned->is_tiled());
+	EXPECT_TRUE(km.equals(cloned->get_kernel_matrix()));
+	SG_UNREF(cloned);
+
+	/* so does a deserialized kernel */
+	std::string filename="serialization-json-CCustomKernel.XXXXXX";
+	generate_temp_filename(const_cast<char*>(filename.c_str()));
+
+	auto fs=env();
+	std::unique_ptr<io::WritableFile> file;
+	ASSERT_TRUE(!fs->new_writable_file(filename, &file));
+	auto fos=some<io::CFileOutputStream>(file.get());
+	auto serializer=some<io::CJsonSerializer>();
+	serializer->attach(fos);
+	serializer->write(tiled);
+
+	std::unique_ptr<io::RandomAccessFile> raf;
+	ASSERT_TRUE(!fs->new_random_access_file(filename, &raf));
+	auto fis=some<io::CFileInputStream>(raf.get());
+	auto deserializer=some<io::CJsonDeserializer>();
+	deserializer->attach(fis);
+	auto deser_obj=deserializer->read_object();
+	ASSERT_TRUE(!fs->delete_file(filename));
+
+	auto loaded=deser_obj->as<CCustomKernel>();
+	EXPECT_TRUE(loaded->is_tiled());
+	EXPECT_TRUE(km.equals(loaded->get_kernel_matrix()));
+
+	SG_UNREF(gaussian);
+	std::remove(fname);
+}
+
+TEST(CustomKernelTest, prefetch_ahead_of_computation)
+{
+	index_t n=60;
+	SGMatrix<float64_t> data(2, n);
+	SGVector<float64_t> lab(n);
+	std::mt19937_64 prng(19);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i=0; i<n; ++i)
+	{
+		lab[i]=i%2 ? 1 : -1;
+		data(0, i)=dist(prng)+lab[i];
+		data(1, i)=dist(prng);
+	}
+
+	auto feats=some<CDenseFeatures<float64_t>>(data);
+	auto gaussian=some<CGaussianKernel>(feats, feats, 2, 10);
+	SGMatrix<float64_t> km=gaussian->get_kernel_matrix();
+
+	/* the second row of a working set is prefetched before the first one is
+	 * computed, hence its loading overlaps the computation */
+	auto kernel=some<CPrefetchCountingKernel>(km);
+	auto labels=some<CBinaryLabels>(lab);
+	auto svm=some<CLibSVM>(1, kernel, labels);
+	svm->train();
+
+	EXPECT_GT(kernel->num_ahead, 0);
+}
@@ -0,0 +1,164 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/kernel/KernelRowCache.h>
+
+using namespace shogun;
+
+namespace
+{
+float64_t value(int32_t i, int32_t j)
+{
+	return i * 1000.0 + j + 0.5;
+}
+}
+
+TEST(KernelRowCache, init)
+{
+	KernelRowCache cache;
+	EXPECT_FALSE(cache.is_initialized());
+
+	cache.init(100, 1, 4, true);
+	EXPECT_TRUE(cache.is_initialized());
+	EXPECT_EQ(4, cache.get_num_shards());
+	EXPECT_EQ(100, cache.get_activenum());
+	EXPECT_EQ(100, cache.get_max_elems());
+	EXPECT_EQ(0, cache.get_elems());
+	EXPECT_TRUE(cache.space_available());
+
+	for (int32_t i = 0; i < 100; i++)
+		EXPECT_FALSE(cache.check(i));
+
+	cache.cleanup();
+	EXPECT_FALSE(cache.is_initialized());
+}
+
+TEST(KernelRowCache, shortreal_fits_twice_as_many_rows)
+{
+	// 1MB holds 256 rows of 1024 float32_t or 128 rows of 1024 float64_t
+	KernelRowCache single, dbl;
+	single.init(1024, 1, 2, true);
+	dbl.init(1024, 1, 2, false);
+
+	EXPECT_EQ(256, single.get_max_elems());
+	EXPECT_EQ(128, dbl.get_max_elems());
+}
+
+TEST(KernelRowCache, fill_and_get)
+{
+	for (auto shortreal : {true, false})
+	{
+		KernelRowCache cache;
+		cache.init(10, 1, 3, shortreal);
+
+		for (int32_t i = 0; i < 10; i++)
+		{
+			ASSERT_TRUE(cache.allocate(i));
+			cache.fill(i, [i](int32_t j) { return value(i, j); });
+		}
+		EXPECT_EQ(10, cache.get_elems());
+		EXPECT_FALSE(cache.space_available());
+
+		for (int32_t i = 0; i < 10; i++)
+		{
+			EXPECT_TRUE(cache.check(i));
+			EXPECT_EQ(i % 3, cache.get_shard(i));
+			for (int32_t j = 0; j < 10; j++)
+				EXPECT_EQ(value(i, j), cache.get(i, j));
+		}
+	}
+}
+
+TEST(KernelRowCache, lru_eviction_within_shard)
+{
+	// a single float64_t row of 131072 columns fills one MB
+	const int32_t totdoc = 131072;
+	KernelRowCache cache;
+	cache.init(totdoc, 2, 2, false);
+	ASSERT_EQ(2, cache.get_num_shards());
+	ASSERT_EQ(2, cache.get_max_elems());
+
+	cache.set_time(1);
+	ASSERT_TRUE(cache.allocate(0));
+	ASSERT_TRUE(cache.allocate(1));
+
+	// row 2 shares the shard with row 0 and evicts it, row 1 stays
+	cache.set_time(2);
+	ASSERT_TRUE(cache.allocate(2));
+	EXPECT_FALSE(cache.check(0));
+	EXPECT_TRUE(cache.check(1));
+	EXPECT_TRUE(cache.check(2));
+
+	// touching keeps a row alive
+	cache.set_time(3);
+	EXPECT_TRUE(cache.touch(2));
+	EXPECT_FALSE(cache.touch(0));
+	cache.set_time(4);
+	ASSERT_TRUE(cache.allocate(3));
+	EXPECT_FALSE(cache.check(1));
+	EXPECT_TRUE(cache.check(2));
+	EXPECT_TRUE(cache.check(3));
+}
+
+TEST(KernelRowCache, shrink)
+{
+	const int32_t totdoc = 8;
+	KernelRowCache cache;
+	cache.init(totdoc, 1, 2, false);
+
+	for (int32_t i = 0; i < totdoc; i++)
+	{
+		ASSERT_TRUE(cache.allocate(i));
+		cache.fill(i, [i](int32_t j) { return value(i, j); });
+	}
+
+	// deactivate the odd examples
+	int32_t after[totdoc];
+	for (int32_t j = 0; j < totdoc; j++)
+		after[j] = (j % 2 == 0);
+
+	cache.shrink(totdoc, totdoc, after);
+	ASSERT_EQ(totdoc / 2, cache.get_activenum());
+
+	for (int32_t j = 0; j < totdoc; j++)
+	{
+		if (j % 2)
+			EXPECT_EQ(-1, cache.totdoc2active(j));
+		else
+			EXPECT_EQ(j, cache.active2totdoc(cache.totdoc2active(j)));
+	}
+
+	for (int32_t i = 0; i < totdoc; i++)
+	{
+		ASSERT_TRUE(cache.check(i));
+		for (int32_t l = 0; l < cache.get_activenum(); l++)
+			EXPECT_EQ(value(i, cache.active2totdoc(l)), cache.get(i, l));
+	}
+}
+
+TEST(KernelRowCache, reset_lru)
+{
+	// a single shard holding two rows
+	const int32_t totdoc = 131072;
+	KernelRowCache cache;
+	cache.init(totdoc, 2, 1, false);
+	ASSERT_EQ(2, cache.get_max_elems());
+
+	cache.set_time(10);
+	ASSERT_TRUE(cache.allocate(0));
+	cache.set_time(20);
+	ASSERT_TRUE(cache.allocate(1));
+
+	// without the reset, rows used after time 0 could not be evicted
+	cache.reset_lru();
+	cache.set_time(0);
+	ASSERT_TRUE(cache.allocate(2));
+	EXPECT_FALSE(cache.check(0));
+	EXPECT_TRUE(cache.check(1));
+	EXPECT_TRUE(cache.check(2));
+}
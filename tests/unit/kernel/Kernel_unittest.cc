@@ -34,6 +34,10 @@
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/PolyKernel.h>
+#include <shogun/kernel/SigmoidKernel.h>
+#include <shogun/kernel/normalizer/SqrtDiagKernelNormalizer.h>
 #include <shogun/mathematics/NormalDistribution.h>
 
 using namespace shogun;
@@ -421,9 +425,192 @@ TEST(Kernel, gaussian_get_kernel_matrix)
 	// initialize a Gaussian kernel of width 1
 	CGaussianKernel* kernel=new CGaussianKernel(feats_p, feats_q, 2);
 	SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+	// the matrix is computed from dot products and squared norms, which
+	// differs from the element-wise distance in the last bits
 	for (index_t i=0; i<km.num_rows; i++)
 		for (index_t j=0; j<km.num_cols; ++j)
-			EXPECT_NEAR(kernel->kernel(i,j), km(i, j), 1E-15);
+			EXPECT_NEAR(kernel->kernel(i,j), km(i, j), 1E-14);
 
 	SG_UNREF(kernel);
 }
+
+static void check_blocked_kernel_matrix(CKernel* kernel, float64_t eps)
+{
+	SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+	ASSERT_EQ(kernel->get_num_vec_lhs(), km.num_rows);
+	ASSERT_EQ(kernel->get_num_vec_rhs(), km.num_cols);
+	for (index_t i=0; i<km.num_rows; i++)
+		for (index_t j=0; j<km.num_cols; ++j)
+			EXPECT_NEAR(kernel->kernel(i, j), km(i, j), eps);
+
+	SGMatrix<float32_t> km32=kernel->get_kernel_matrix<float32_t>();
+	for (index_t i=0; i<km.num_rows; i++)
+		for (index_t j=0; j<km.num_cols; ++j)
+			EXPECT_EQ((float32_t)km(i, j), km32(i, j));
+}
+
+TEST(Kernel, blocked_kernel_matrix)
+{
+	const int32_t seed = 100;
+	// sizes that are not multiples of the tile size
+	const index_t num_feats_p=300;
+	const index_t num_feats_q=170;
+	const index_t dim=5;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data_p = generate_std_norm_matrix(num_feats_p, dim, prng);
+	SGMatrix<float64_t> data_q = generate_std_norm_matrix(num_feats_q, dim, prng);
+	CDenseFeatures<float64_t>* feats_p=new CDenseFeatures<float64_t>(data_p);
+	CDenseFeatures<float64_t>* feats_q=new CDenseFeatures<float64_t>(data_q);
+	SG_REF(feats_p);
+	SG_REF(feats_q);
+
+	CKernel* kernels[]={
+		new CGaussianKernel(10, 3.0),
+		new CLinearKernel(),
+		new CPolyKernel(10, 3, 1.0, 0.5),
+		new CSigmoidKernel(10, 0.1, 0.5)};
+
+	for (auto kernel : kernels)
+	{
+		// asymmetric and symmetric case
+		kernel->init(feats_p, feats_q);
+		check_blocked_kernel_matrix(kernel, 1E-12);
+		kernel->init(feats_p, feats_p);
+		check_blocked_kernel_matrix(kernel, 1E-12);
+
+		// subsets are respected
+		feats_p->add_subset(SGVector<index_t>({7, 3, 250, 128, 0}));
+		kernel->init(feats_p, feats_q);
+		check_blocked_kernel_matrix(kernel, 1E-12);
+		feats_p->remove_subset();
+
+		SG_UNREF(kernel);
+	}
+
+	SG_UNREF(feats_p);
+	SG_UNREF(feats_q);
+}
+
+TEST(Kernel, kernel_matrix_precision)
+{
+	const int32_t seed = 100;
+	const index_t num_feats=200;
+	const index_t dim=5;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data = generate_std_norm_matrix(num_feats, dim, prng);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	SG_REF(feats);
+
+	CKernel* kernels[]={
+		new CGaussianKernel(10, 3.0),
+		new CLinearKernel(),
+		new CPolyKernel(10, 3, 1.0, 0.5)};
+
+	for (auto kernel : kernels)
+	{
+		kernel->init(feats, feats);
+		EXPECT_EQ(KPREC_DOUBLE, kernel->get_precision());
+		SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+
+		// computed in double precision, only rounded when stored
+		kernel->set_precision(KPREC_MIXED);
+		SGMatrix<float32_t> km_mixed=kernel->get_kernel_matrix<float32_t>();
+		for (index_t i=0; i<km.num_rows*km.num_cols; i++)
+			EXPECT_EQ((float32_t)km[i], km_mixed[i]);
+
+		// relative error of single precision dot products
+		kernel->set_precision(KPREC_SINGLE);
+		SGMatrix<float32_t> km_single=kernel->get_kernel_matrix<float32_t>();
+		for (index_t i=0; i<km.num_rows*km.num_cols; i++)
+			EXPECT_NEAR(km[i], km_single[i], 1E-5*std::max(1.0, std::abs(km[i])));
+
+		SG_UNREF(kernel);
+	}
+
+	SG_UNREF(feats);
+
+	// more features than a float32_t GEMM sums up, the error of a dot
+	// product is bounded by (min(dim, 128)+2)*u*sum_i |a_i*b_i| and the
+	// rounding when stored
+	const index_t large_dim=300;
+	SGMatrix<float64_t> large_data=generate_std_norm_matrix(50, large_dim, prng);
+	auto large_feats=some<CDenseFeatures<float64_t>>(large_data);
+	auto linear=some<CLinearKernel>();
+	linear->init(large_feats, large_feats);
+	SGMatrix<float64_t> km=linear->get_kernel_matrix();
+	linear->set_precision(KPREC_SINGLE);
+	SGMatrix<float32_t> km_single=linear->get_kernel_matrix<float32_t>();
+
+	const float64_t u=std::ldexp(1.0, -24);
+	for (index_t i=0; i<km.num_rows; i++)
+	{
+		for (index_t j=0; j<km.num_cols; j++)
+		{
+			float64_t abs_sum=0;
+			for (index_t d=0; d<large_dim; d++)
+				abs_sum+=std::abs(large_data(d, i)*large_data(d, j));
+			EXPECT_NEAR(km(i, j), km_single(i, j),
+				130*u*abs_sum+u*std::abs(km(i, j)));
+		}
+	}
+}
+
+TEST(Kernel, weighted_sums_dense)
+{
+	const int32_t seed = 100;
+	// sizes that are not multiples of the tile size
+	const index_t num_feats_p=300;
+	const index_t num_feats_q=170;
+	const index_t dim=5;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data_p = generate_std_norm_matrix(num_feats_p, dim, prng);
+	SGMatrix<float64_t> data_q = generate_std_norm_matrix(num_feats_q, dim, prng);
+	CDenseFeatures<float64_t>* feats_p=new CDenseFeatures<float64_t>(data_p);
+	CDenseFeatures<float64_t>* feats_q=new CDenseFeatures<float64_t>(data_q);
+	SG_REF(feats_p);
+	SG_REF(feats_q);
+
+	// every second lhs example with a random weight
+	SGVector<int32_t> idx(num_feats_p/2);
+	SGVector<float64_t> weights(idx.vlen);
+	SGMatrix<float64_t> packed(dim, idx.vlen);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i=0; i<idx.vlen; i++)
+	{
+		idx[i]=2*i+1;
+		weights[i]=dist(prng);
+		for (index_t d=0; d<dim; d++)
+			packed(d, i)=data_p(d, idx[i]);
+	}
+
+	CKernel* kernels[]={
+		new CGaussianKernel(10, 3.0),
+		new CPolyKernel(10, 3, 1.0, 0.5),
+		new CPolyKernel(10, 2, 1.0, 0.5)};
+	kernels[2]->set_normalizer(new CSqrtDiagKernelNormalizer());
+
+	for (auto kernel : kernels)
+	{
+		kernel->init(feats_p, feats_q);
+		ASSERT_TRUE(kernel->has_dense_dot_transform());
+
+		SGVector<float64_t> sums=
+			kernel->compute_weighted_sums_dense(packed, idx, weights);
+		ASSERT_EQ(num_feats_q, sums.vlen);
+		for (index_t j=0; j<num_feats_q; j++)
+		{
+			float64_t expected=0;
+			for (index_t i=0; i<idx.vlen; i++)
+				expected+=weights[i]*kernel->kernel(idx[i], j);
+			EXPECT_NEAR(expected, sums[j], 1E-10*std::max(1.0, std::abs(expected)));
+		}
+
+		SG_UNREF(kernel);
+	}
+
+	SG_UNREF(feats_p);
+	SG_UNREF(feats_q);
+}
@@ -0,0 +1,103 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/TiledKernelMatrix.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include "../utils/Utils.h"
+
+#include <cstdio>
+
+using namespace shogun;
+
+namespace
+{
+CDenseFeatures<float64_t>* random_features(index_t num_vectors, int32_t seed)
+{
+	SGMatrix<float64_t> data(3, num_vectors);
+	std::mt19937_64 prng(seed);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i = 0; i < data.num_rows * data.num_cols; i++)
+		data.matrix[i] = dist(prng);
+
+	return new CDenseFeatures<float64_t>(data);
+}
+
+void check_tiled(CKernel* kernel, const TiledKernelMatrix& tiled)
+{
+	ASSERT_EQ(kernel->get_num_vec_lhs(), tiled.get_num_rows());
+	ASSERT_EQ(kernel->get_num_vec_rhs(), tiled.get_num_cols());
+
+	for (index_t i = 0; i < tiled.get_num_rows(); i++)
+	{
+		tiled.prefetch_row(i);
+		for (index_t j = 0; j < tiled.get_num_cols(); j++)
+			EXPECT_EQ((float32_t)kernel->kernel(i, j), tiled.get(i, j));
+	}
+}
+}
+
+TEST(TiledKernelMatrix, save_and_map_rectangular)
+{
+	char fname[] = "TiledKernelMatrix_rectangular.XXXXXX";
+	generate_temp_filename(fname);
+
+	auto lhs = random_features(37, 17);
+	auto rhs = random_features(23, 18);
+	auto kernel = new CGaussianKernel(lhs, rhs, 2.0);
+	SG_REF(kernel);
+
+	// tiles do not divide the matrix and are padded
+	TiledKernelMatrix::save(kernel, fname, 8);
+	{
+		TiledKernelMatrix tiled(fname);
+		EXPECT_EQ(8, tiled.get_tile_size());
+		EXPECT_FALSE(tiled.is_upper_triangle());
+		check_tiled(kernel, tiled);
+	}
+
+	SG_UNREF(kernel);
+	std::remove(fname);
+}
+
+TEST(TiledKernelMatrix, save_and_map_symmetric)
+{
+	char fname[] = "TiledKernelMatrix_symmetric.XXXXXX";
+	generate_temp_filename(fname);
+
+	auto feats = random_features(45, 17);
+	auto kernel = new CGaussianKernel(feats, feats, 2.0);
+	SG_REF(kernel);
+
+	for (auto tile_size : {1, 8, 45, 64})
+	{
+		TiledKernelMatrix::save(kernel, fname, tile_size);
+		TiledKernelMatrix tiled(fname);
+		EXPECT_EQ(tile_size, tiled.get_tile_size());
+		EXPECT_TRUE(tiled.is_upper_triangle());
+		check_tiled(kernel, tiled);
+	}
+
+	SG_UNREF(kernel);
+	std::remove(fname);
+}
+
+TEST(TiledKernelMatrix, invalid_file)
+{
+	char fname[] = "TiledKernelMatrix_invalid.XXXXXX";
+	generate_temp_filename(fname);
+
+	FILE* f = fopen(fname, "w");
+	ASSERT_TRUE(f != NULL);
+	fprintf(f, "not a kernel matrix\n");
+	fclose(f);
+
+	EXPECT_THROW(TiledKernelMatrix tiled(fname), ShogunException);
+	std::remove(fname);
+}
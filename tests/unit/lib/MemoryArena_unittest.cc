@@ -0,0 +1,75 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/lib/MemoryArena.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+
+using namespace shogun;
+
+TEST(MemoryArenaTest, allocate_and_release)
+{
+	MemoryArena arena(1024);
+	auto marker = arena.mark();
+
+	auto a = (char*)arena.allocate(10, 64);
+	auto b = (char*)arena.allocate(100, 64);
+	EXPECT_EQ((uintptr_t)a % 64, 0);
+	EXPECT_EQ((uintptr_t)b % 64, 0);
+	EXPECT_GE(b, a + 10);
+	EXPECT_EQ(arena.capacity(), 1024);
+
+	// larger than a chunk
+	auto c = (char*)arena.allocate(4000, 64);
+	EXPECT_EQ((uintptr_t)c % 64, 0);
+	auto capacity = arena.capacity();
+	EXPECT_GE(capacity, 1024 + 4000);
+
+	// the chunks are reused after releasing
+	arena.release(marker);
+	EXPECT_EQ(arena.allocate(10, 64), a);
+	arena.allocate(4000, 64);
+	EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(MemoryArenaTest, scoped_vectors)
+{
+	auto& counters = MemoryArena::counters();
+	auto heap_allocations = counters.heap_allocations;
+	auto heap_bytes = counters.heap_bytes;
+	auto arena_allocations = counters.arena_allocations;
+
+	float64_t* data = nullptr;
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		ScopedArena scope;
+		SGVector<float64_t> vec(100, scope.arena());
+		SGMatrix<int32_t> mat(10, 20, scope.arena());
+		EXPECT_EQ(vec.vlen, 100);
+		EXPECT_EQ(mat.num_rows, 10);
+		EXPECT_EQ(mat.num_cols, 20);
+		for (auto v : vec)
+			EXPECT_EQ(v, 0);
+		for (index_t j = 0; j < mat.size(); ++j)
+			EXPECT_EQ(mat[j], 0);
+
+		// the same memory is handed out in every iteration
+		if (!data)
+			data = vec.vector;
+		EXPECT_EQ(vec.vector, data);
+
+		vec[0] = 1;
+		mat[0] = 1;
+	}
+
+	EXPECT_EQ(counters.heap_allocations, heap_allocations);
+	EXPECT_EQ(counters.arena_allocations, arena_allocations + 6);
+
+	SGVector<float64_t> heap(10);
+	EXPECT_EQ(counters.heap_allocations, heap_allocations + 1);
+	EXPECT_EQ(counters.heap_bytes, heap_bytes + 10 * sizeof(float64_t));
+}
@@ -0,0 +1,108 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/machine/KernelMachine.h>
+
+#include <random>
+
+using namespace shogun;
+
+namespace
+{
+CDenseFeatures<float64_t>*
+random_features(index_t dim, index_t num_vectors, std::mt19937_64& prng)
+{
+	SGMatrix<float64_t> data(dim, num_vectors);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i = 0; i < dim * num_vectors; i++)
+		data[i] = dist(prng);
+
+	return new CDenseFeatures<float64_t>(data);
+}
+
+void check_outputs(
+    CKernelMachine* machine, CKernel* kernel, CDenseFeatures<float64_t>* test)
+{
+	auto outputs = machine->apply_regression(test);
+	SGVector<float64_t> scores = outputs->get_labels();
+	ASSERT_EQ(test->get_num_vectors(), scores.vlen);
+
+	// the machine initialised the kernel with the test features
+	for (index_t j = 0; j < scores.vlen; j++)
+	{
+		float64_t expected = machine->get_bias();
+		for (index_t i = 0; i < machine->get_num_support_vectors(); i++)
+			expected += machine->get_alpha(i) *
+			            kernel->kernel(machine->get_support_vector(i), j);
+		EXPECT_NEAR(expected, scores[j], 1e-10);
+	}
+
+	SG_UNREF(outputs);
+}
+}
+
+TEST(KernelMachine, apply_dense_features_tiled)
+{
+	const index_t dim = 4;
+	const index_t num_train = 300;
+	const index_t num_test = 257;
+	const index_t num_sv = 140;
+
+	std::mt19937_64 prng(17);
+	auto train = random_features(dim, num_train, prng);
+	auto test = random_features(dim, num_test, prng);
+	SG_REF(train);
+	SG_REF(test);
+
+	auto kernel = new CGaussianKernel(10, 2.0);
+	kernel->init(train, train);
+
+	SGVector<int32_t> svs(num_sv);
+	SGVector<float64_t> alphas(num_sv);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i = 0; i < num_sv; i++)
+	{
+		svs[i] = 2 * i + 3;
+		alphas[i] = dist(prng);
+	}
+
+	auto machine = new CKernelMachine();
+	SG_REF(machine);
+	machine->set_kernel(kernel);
+	machine->set_support_vectors(svs);
+	machine->set_alphas(alphas);
+	machine->set_bias(0.5);
+
+	check_outputs(machine, kernel, test);
+
+	// changed support vectors are packed again
+	machine->set_support_vector(0, 0);
+	machine->set_support_vector(num_sv - 1, 1);
+	check_outputs(machine, kernel, test);
+
+	// as are the support vectors of a subset of the same features
+	SGVector<index_t> reversed(num_train);
+	for (index_t i = 0; i < num_train; i++)
+		reversed[i] = num_train - 1 - i;
+	train->add_subset(reversed);
+	check_outputs(machine, kernel, test);
+	train->remove_subset();
+
+	// and features whose values changed in place
+	SGMatrix<float64_t> data = train->get_feature_matrix();
+	for (index_t i = 0; i < data.size(); i++)
+		data[i] *= 2;
+	check_outputs(machine, kernel, test);
+
+	SG_UNREF(machine);
+	SG_UNREF(train);
+	SG_UNREF(test);
+}
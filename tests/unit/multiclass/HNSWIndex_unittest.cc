@@ -0,0 +1,111 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/mathematics/Math.h>
+#include <shogun/multiclass/HNSWIndex.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+using namespace shogun;
+
+namespace
+{
+SGMatrix<float64_t> random_vectors(index_t dim, index_t num_vectors, std::mt19937_64& prng)
+{
+	SGMatrix<float64_t> data(dim, num_vectors);
+	std::normal_distribution<float64_t> dist;
+	for (index_t i = 0; i < dim * num_vectors; i++)
+		data[i] = dist(prng);
+
+	return data;
+}
+
+SGMatrix<index_t> exact_knn(
+    const SGMatrix<float64_t>& data, const SGMatrix<float64_t>& queries,
+    int32_t k)
+{
+	SGMatrix<index_t> NN(k, queries.num_cols);
+	std::vector<std::pair<float64_t, index_t>> dists(data.num_cols);
+	for (index_t i = 0; i < queries.num_cols; i++)
+	{
+		for (index_t j = 0; j < data.num_cols; j++)
+		{
+			float64_t d = 0;
+			for (index_t r = 0; r < data.num_rows; r++)
+				d += CMath::sq(data(r, j) - queries(r, i));
+			dists[j] = std::make_pair(d, j);
+		}
+		std::partial_sort(dists.begin(), dists.begin() + k, dists.end());
+		for (int32_t j = 0; j < k; j++)
+			NN(j, i) = dists[j].second;
+	}
+	return NN;
+}
+
+float64_t recall(const SGMatrix<index_t>& approx, const SGMatrix<index_t>& exact)
+{
+	index_t found = 0;
+	for (index_t i = 0; i < exact.num_cols; i++)
+	{
+		std::set<index_t> truth(
+		    exact.get_column_vector(i),
+		    exact.get_column_vector(i) + exact.num_rows);
+		for (index_t j = 0; j < approx.num_rows; j++)
+			found += truth.count(approx(j, i));
+	}
+	return float64_t(found) / (exact.num_rows * exact.num_cols);
+}
+}
+
+TEST(HNSWIndex, recall)
+{
+	std::mt19937_64 prng(17);
+	auto data = random_vectors(8, 2000, prng);
+	auto queries = random_vectors(8, 100, prng);
+	const int32_t k = 10;
+
+	auto index = some<CHNSWIndex>(12, 100, 64);
+	index->put("seed", 17);
+	index->build(data);
+	EXPECT_EQ(data.num_cols, index->get_num_vectors());
+
+	auto exact = exact_knn(data, queries, k);
+	auto approx = index->query_knn(data, queries, k);
+	ASSERT_EQ(k, approx.num_rows);
+	ASSERT_EQ(queries.num_cols, approx.num_cols);
+	EXPECT_GT(recall(approx, exact), 0.95);
+
+	// the indexed vectors themselves are their own nearest neighbour
+	SGVector<index_t> ids(data.num_cols);
+	ids.range_fill();
+	auto self = index->query_knn(data, data, 1);
+	EXPECT_GT(recall(self, SGMatrix<index_t>(ids, 1, data.num_cols)), 0.99);
+
+	// the graph survives cloning
+	auto clone = index->clone()->as<CHNSWIndex>();
+	SG_REF(clone);
+	auto cloned = clone->query_knn(data, queries, k);
+	EXPECT_TRUE(approx.equals(cloned));
+	SG_UNREF(clone);
+}
+
+TEST(HNSWIndex, more_neighbours_than_reachable)
+{
+	std::mt19937_64 prng(17);
+	auto data = random_vectors(3, 5, prng);
+	auto queries = random_vectors(3, 4, prng);
+
+	auto index = some<CHNSWIndex>(2, 4, 1);
+	index->build(data);
+
+	auto exact = exact_knn(data, queries, 5);
+	auto approx = index->query_knn(data, queries, 5);
+	EXPECT_EQ(1.0, recall(approx, exact));
+}
@@ -122,6 +122,60 @@ TEST_F(KNNTest, lsh_solver)
 	SG_UNREF(output);
 }
 
+TEST_F(KNNTest, hnsw_solver)
+{
+	auto knn = some<CKNN>(k, distance, labels, KNN_HNSW);
+	knn->set_hnsw_parameters(8, 50, 20);
+	knn->train(features);
+	auto output = knn->apply(features_test)->as<CMulticlassLabels>();
+	SG_REF(output);
+
+	for ( index_t i = 0; i < labels_test->get_num_labels(); ++i )
+		EXPECT_EQ(output->get_label(i), ((CMulticlassLabels*)labels_test)->get_label(i));
+
+	SG_UNREF(output);
+}
+
+TEST_F(KNNTest, hnsw_solver_retrain)
+{
+	auto knn = some<CKNN>(k, distance, labels, KNN_HNSW);
+	knn->set_hnsw_parameters(8, 50, 20);
+	knn->train(features);
+
+	// a training set of the same size with every class shifted by one
+	auto shifted_features =
+	    some<CDenseFeatures<float64_t>>(features->get_feature_matrix());
+	auto shifted = labels->get_labels();
+	for (auto& l : shifted)
+		l = std::fmod(l + 1, classes);
+	auto shifted_labels = some<CMulticlassLabels>(shifted);
+
+	knn->set_labels(shifted_labels);
+	knn->train(shifted_features);
+	auto output = knn->apply(features_test)->as<CMulticlassLabels>();
+	SG_REF(output);
+
+	for ( index_t i = 0; i < labels_test->get_num_labels(); ++i )
+		EXPECT_EQ(output->get_label(i), std::fmod(((CMulticlassLabels*)labels_test)->get_label(i) + 1, classes));
+
+	SG_UNREF(output);
+}
+
+TEST_F(KNNTest, hnsw_solver_seed)
+{
+	auto knn1 = some<CKNN>(k, distance, labels, KNN_HNSW);
+	auto knn2 = some<CKNN>(k, distance, labels, KNN_HNSW);
+	knn1->put("seed", 17);
+	knn2->put("seed", 17);
+	knn1->train(features);
+	knn2->train(features);
+
+	auto index1 = knn1->get<CSGObject*>("hnsw_index");
+	auto index2 = knn2->get<CSGObject*>("hnsw_index");
+	ASSERT_NE(index1, nullptr);
+	EXPECT_TRUE(index1->equals(index2));
+}
+
 TEST_F(KNNTest, lsh_solver_sparse)
 {
 	auto knn = some<CKNN>(k, distance, labels, KNN_LSH);
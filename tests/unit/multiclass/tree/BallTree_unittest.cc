@@ -33,6 +33,9 @@
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/multiclass/tree/BallTree.h>
 
+#include <algorithm>
+#include <random>
+
 using namespace shogun;
 
 TEST(BallTree,tree_structure)
@@ -115,3 +118,58 @@ TEST(BallTree, knn_query)
 	SG_UNREF(feats);
 	SG_UNREF(tree);
 }
+
+TEST(BallTree, knn_query_parallel)
+{
+	// large enough for subtrees to be built as separate tasks
+	const index_t num_vectors=10000;
+	const index_t num_queries=100;
+	const int32_t k=5;
+
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> normal;
+	SGMatrix<float64_t> data(3,num_vectors);
+	SGMatrix<float64_t> test_data(3,num_queries);
+	for (index_t i=0;i<data.num_rows*data.num_cols;i++)
+		data[i]=normal(prng);
+	for (index_t i=0;i<test_data.num_rows*test_data.num_cols;i++)
+		test_data[i]=normal(prng);
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CDenseFeatures<float64_t>* qfeats=new CDenseFeatures<float64_t>(test_data);
+	SG_REF(feats);
+	SG_REF(qfeats);
+
+	CBallTree* tree=new CBallTree(10);
+	SG_REF(tree);
+	tree->build_tree(feats);
+	tree->query_knn(qfeats,k);
+
+	SGMatrix<index_t> ind=tree->get_knn_indices();
+	SGMatrix<float64_t> dists=tree->get_knn_dists();
+	SGVector<float64_t> exact(num_vectors);
+	for (index_t i=0;i<num_queries;i++)
+	{
+		for (index_t j=0;j<num_vectors;j++)
+		{
+			exact[j]=0;
+			for (index_t d=0;d<data.num_rows;d++)
+				exact[j]+=CMath::sq(data(d,j)-test_data(d,i));
+			exact[j]=std::sqrt(exact[j]);
+		}
+		std::sort(exact.vector,exact.vector+num_vectors);
+
+		for (int32_t j=0;j<k;j++)
+		{
+			EXPECT_NEAR(exact[j],dists(j,i),1e-12);
+			float64_t d=0;
+			for (index_t r=0;r<data.num_rows;r++)
+				d+=CMath::sq(data(r,ind(j,i))-test_data(r,i));
+			EXPECT_NEAR(exact[j],std::sqrt(d),1e-12);
+		}
+	}
+
+	SG_UNREF(tree);
+	SG_UNREF(qfeats);
+	SG_UNREF(feats);
+}
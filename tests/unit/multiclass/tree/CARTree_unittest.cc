@@ -31,6 +31,7 @@
 #include <gtest/gtest.h>
 #include <shogun/base/some.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/RegressionLabels.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/multiclass/tree/CARTree.h>
 
@@ -641,3 +642,116 @@ TEST(CARTree,cv_prune_simple)
 	SG_UNREF(c);
 	SG_UNREF(root);
 }
+
+TEST(CARTree, binned_regression_matches_exact)
+{
+	const index_t dim=3;
+	const index_t num_train=200;
+	const index_t num_test=50;
+
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist;
+	SGMatrix<float64_t> data(dim,num_train);
+	SGMatrix<float64_t> test(dim,num_test);
+	for (index_t i=0;i<dim*num_train;i++)
+		data[i]=dist(prng);
+	for (index_t i=0;i<dim*num_test;i++)
+		test[i]=dist(prng);
+
+	SGVector<float64_t> lab(num_train);
+	for (index_t i=0;i<num_train;i++)
+		lab[i]=data(0,i)*data(1,i)+0.1*dist(prng);
+
+	auto feats=some<CDenseFeatures<float64_t>>(data);
+	auto test_feats=some<CDenseFeatures<float64_t>>(test);
+	auto labels=some<CRegressionLabels>(lab);
+
+	SGVector<bool> ft(dim);
+	ft.set_const(false);
+
+	auto exact=some<CCARTree>(ft,PT_REGRESSION);
+	exact->set_labels(labels);
+	exact->set_max_depth(6);
+	exact->train(feats);
+
+	// every distinct value has its own bin, the splits are the exact ones
+	auto binned=some<CCARTree>(ft,PT_REGRESSION);
+	binned->set_labels(labels);
+	binned->set_max_depth(6);
+	binned->set_num_bins(255);
+	binned->train(feats);
+
+	auto expected=exact->apply_regression(test_feats);
+	auto result=binned->apply_regression(test_feats);
+	for (index_t i=0;i<num_test;i++)
+		EXPECT_NEAR(expected->get_label(i),result->get_label(i),1e-10);
+
+	SG_UNREF(expected);
+	SG_UNREF(result);
+}
+
+TEST(CARTree, binned_classify_few_bins)
+{
+	const index_t num_train=400;
+	const int32_t num_bins=8;
+
+	// label is whether the first feature is positive, the second one is noise
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist;
+	SGMatrix<float64_t> data(2,num_train);
+	SGVector<float64_t> lab(num_train);
+	for (index_t i=0;i<num_train;i++)
+	{
+		data(0,i)=dist(prng);
+		data(1,i)=dist(prng);
+		lab[i]=data(0,i)>0 ? 1.0 : 0.0;
+	}
+
+	auto feats=some<CDenseFeatures<float64_t>>(data);
+	auto labels=some<CMulticlassLabels>(lab);
+
+	SGVector<bool> ft(2);
+	ft.set_const(false);
+
+	auto c=some<CCARTree>(ft,PT_MULTICLASS);
+	c->set_labels(labels);
+	c->set_num_bins(num_bins);
+
+	SGMatrix<uint8_t> bins;
+	SGMatrix<float64_t> bin_edges;
+	c->pre_bin_features(feats,bins,bin_edges);
+	ASSERT_EQ(2,bins.num_rows);
+	ASSERT_EQ(num_train,bins.num_cols);
+	for (index_t f=0;f<2;f++)
+	{
+		float64_t max_value=data(f,0);
+		for (index_t i=0;i<num_train;i++)
+		{
+			EXPECT_LT(bins(f,i),num_bins);
+			EXPECT_LE(data(f,i),bin_edges(bins(f,i),f));
+			if (bins(f,i)>0)
+			{
+				EXPECT_GT(data(f,i),bin_edges(bins(f,i)-1,f));
+			}
+			max_value=std::max(max_value,data(f,i));
+		}
+		EXPECT_EQ(max_value,bin_edges(num_bins-1,f));
+	}
+
+	c->set_binned_features(bins,bin_edges);
+	c->train(feats);
+
+	SGMatrix<float64_t> test(2,10);
+	for (index_t i=0;i<10;i++)
+	{
+		test(0,i)=(i<5) ? -1.0-0.2*i : 1.0+0.2*i;
+		test(1,i)=dist(prng);
+	}
+
+	auto test_feats=some<CDenseFeatures<float64_t>>(test);
+	auto result=c->apply_multiclass(test_feats);
+	for (index_t i=0;i<10;i++)
+		EXPECT_EQ((i<5) ? 0.0 : 1.0,result->get_label(i));
+
+	SG_UNREF(result);
+}
@@ -0,0 +1,102 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/multiclass/tree/CARTree.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+#include <random>
+
+using namespace shogun;
+
+namespace
+{
+SGMatrix<float64_t>
+random_categories(index_t dim, index_t num_vectors, std::mt19937_64& prng)
+{
+	SGMatrix<float64_t> data(dim, num_vectors);
+	std::uniform_int_distribution<int32_t> dist(0, 4);
+	for (index_t i = 0; i < dim * num_vectors; i++)
+		data[i] = dist(prng);
+
+	return data;
+}
+}
+
+TEST(FlatTreeEnsemble, apply_matches_trees)
+{
+	const index_t dim = 4;
+	const index_t num_train = 300;
+	const index_t num_test = 150;
+
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> dist;
+	auto train = random_categories(dim, num_train, prng);
+	auto test = random_categories(dim, num_test, prng);
+
+	// the first two features are nominal
+	SGVector<bool> ft(dim);
+	ft[0] = true;
+	ft[1] = true;
+	ft[2] = false;
+	ft[3] = false;
+
+	SGVector<float64_t> classes(num_train);
+	SGVector<float64_t> targets(num_train);
+	for (index_t i = 0; i < num_train; i++)
+	{
+		classes[i] = (index_t)(train(0, i) + train(2, i)) % 3;
+		targets[i] = train(1, i) * train(3, i) + 0.1 * dist(prng);
+	}
+
+	auto train_feats = some<CDenseFeatures<float64_t>>(train);
+	auto test_feats = some<CDenseFeatures<float64_t>>(test);
+
+	auto classifier = some<CCARTree>(ft, PT_MULTICLASS);
+	classifier->set_labels(new CMulticlassLabels(classes));
+	classifier->train(train_feats);
+
+	auto regressor = some<CCARTree>(ft, PT_REGRESSION);
+	regressor->set_labels(new CRegressionLabels(targets));
+	regressor->set_max_depth(5);
+	regressor->train(train_feats);
+
+	auto flat_trees = some<CFlatTreeEnsemble>();
+	flat_trees->add_tree(classifier);
+	flat_trees->add_tree(regressor);
+	EXPECT_EQ(2, flat_trees->get_num_trees());
+
+	auto classes_pred = classifier->apply_multiclass(test_feats);
+	auto targets_pred = regressor->apply_regression(test_feats);
+	auto outputs = flat_trees->apply(test_feats);
+	ASSERT_EQ(num_test, outputs.num_rows);
+	ASSERT_EQ(2, outputs.num_cols);
+	for (index_t i = 0; i < num_test; i++)
+	{
+		EXPECT_EQ(classes_pred->get_label(i), outputs(i, 0));
+		EXPECT_EQ(targets_pred->get_label(i), outputs(i, 1));
+	}
+
+	SGVector<float64_t> weights(2);
+	weights[0] = 0.5;
+	weights[1] = -2.0;
+	auto sums = flat_trees->apply_weighted_sum(test_feats, weights, 0.1);
+	for (index_t i = 0; i < num_test; i++)
+	{
+		float64_t expected = 0;
+		expected += classes_pred->get_label(i) * weights[0] * 0.1;
+		expected += targets_pred->get_label(i) * weights[1] * 0.1;
+		EXPECT_EQ(expected, sums[i]);
+	}
+
+	SG_UNREF(classes_pred);
+	SG_UNREF(targets_pred);
+}
@@ -55,3 +55,20 @@ TEST(KNNHeap, heap_formation)
 
 	delete(heap);
 }
+
+TEST(KNNHeap, clear)
+{
+	CKNNHeap heap(2);
+	heap.push(1,30);
+	heap.push(2,20);
+	heap.get_indices();
+
+	heap.clear();
+	heap.push(3,40);
+	heap.push(4,10);
+	heap.push(5,50);
+
+	SGVector<index_t> sorted=heap.get_indices();
+	EXPECT_EQ(4,sorted[0]);
+	EXPECT_EQ(3,sorted[1]);
+}
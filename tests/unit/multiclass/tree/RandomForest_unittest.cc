@@ -276,4 +276,56 @@ TEST_F(RandomForest, score_consistent_with_binary_trivial_data)
 	EXPECT_NEAR(1.0, values_vector[9], 1e-1);
 
 	SG_UNREF(result);
-}
\ No newline at end of file
+}
+TEST_F(RandomForest, classify_binned_test)
+{
+	int32_t seed = 1137;
+	int32_t num_train = 100;
+	int32_t num_test = 10;
+
+	// two classes separated at 5
+	std::mt19937_64 prng(seed);
+	std::uniform_real_distribution<float64_t> dist(0, 4);
+	SGMatrix<float64_t> data(2, num_train);
+	SGVector<float64_t> lab(num_train);
+	for (auto i = 0; i < num_train; ++i)
+	{
+		lab[i] = i % 2;
+		data(0, i) = lab[i] > 0 ? 6 + dist(prng) : dist(prng);
+		data(1, i) = dist(prng);
+	}
+
+	SGMatrix<float64_t> test_data(2, num_test);
+	for (auto i = 0; i < num_test; ++i)
+	{
+		test_data(0, i) = i < 5 ? 0.5 + 0.2 * i : 8 + 0.2 * i;
+		test_data(1, i) = dist(prng);
+	}
+
+	CDenseFeatures<float64_t>* features_train =
+	    new CDenseFeatures<float64_t>(data);
+	CDenseFeatures<float64_t>* features_test =
+	    new CDenseFeatures<float64_t>(test_data);
+	CMulticlassLabels* labels_train = new CMulticlassLabels(lab);
+
+	CRandomForest* c = new CRandomForest(features_train, labels_train, 10, 1);
+	SGVector<bool> ft = SGVector<bool>(2);
+	ft[0] = false;
+	ft[1] = false;
+	c->set_feature_types(ft);
+	c->set_num_bins(16);
+	EXPECT_EQ(16, c->get_num_bins());
+
+	CMajorityVote* mv = new CMajorityVote();
+	c->set_combination_rule(mv);
+	c->put("seed", seed);
+	c->train(features_train);
+
+	CMulticlassLabels* result = c->apply_multiclass(features_test);
+	for (auto i = 0; i < num_test; ++i)
+		EXPECT_EQ(i < 5 ? 0.0 : 1.0, result->get_label(i));
+
+	SG_UNREF(result);
+	SG_UNREF(c);
+	SG_UNREF(features_test);
+}
@@ -0,0 +1,163 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/lib/DynamicObjectArray.h>
+#include <shogun/neuralnets/ConvolutionalFeatureMap.h>
+#include <shogun/neuralnets/NeuralConvolutionalLayer.h>
+#include <shogun/neuralnets/NeuralInputLayer.h>
+#include <shogun/neuralnets/NeuralLinearLayer.h>
+#include <shogun/neuralnets/NeuralNetwork.h>
+
+#include <random>
+
+using namespace shogun;
+
+namespace
+{
+const int32_t w = 8;
+const int32_t h = 12;
+const int32_t batch_size = 5;
+
+CDynamicObjectArray* create_inputs(std::mt19937_64& prng)
+{
+	std::normal_distribution<float64_t> normal;
+	auto layers = new CDynamicObjectArray();
+
+	// one layer with a single channel and one with two channels
+	for (int32_t num_channels = 1; num_channels <= 2; ++num_channels)
+	{
+		SGMatrix<float64_t> x(num_channels * w * h, batch_size);
+		for (index_t i = 0; i < x.size(); ++i)
+			x[i] = normal(prng);
+
+		auto input = new CNeuralInputLayer(w, h, num_channels);
+		input->set_batch_size(batch_size);
+		input->compute_activations(x);
+		layers->append_element(input);
+	}
+	return layers;
+}
+}
+
+TEST(NeuralConvolutionalLayer, compute_activations)
+{
+	const int32_t num_maps = 3;
+	const int32_t rx = 1;
+	const int32_t ry = 2;
+	const int32_t stride = 2;
+	const int32_t pooling = 2;
+
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> normal;
+	auto layers = create_inputs(prng);
+
+	SGVector<int32_t> input_indices(2);
+	input_indices[0] = 0;
+	input_indices[1] = 1;
+
+	for (auto function : {CMAF_IDENTITY, CMAF_LOGISTIC, CMAF_RECTIFIED_LINEAR})
+	{
+		auto layer = some<CNeuralConvolutionalLayer>(
+		    function, num_maps, rx, ry, pooling, pooling, stride, stride);
+		layer->initialize_neural_layer(layers, input_indices);
+		layer->set_batch_size(batch_size);
+
+		SGVector<float64_t> params(layer->get_num_parameters());
+		for (auto& p : params)
+			p = normal(prng);
+		layer->compute_activations(params, layers);
+
+		// the feature maps convolve directly
+		const int32_t num_parameters_per_map = params.vlen / num_maps;
+		SGMatrix<float64_t> convolved(
+		    num_maps * (w / stride) * (h / stride), batch_size);
+		SGMatrix<float64_t> pooled(layer->get_num_neurons(), batch_size);
+		SGMatrix<float64_t> max_indices(layer->get_num_neurons(), batch_size);
+		for (int32_t m = 0; m < num_maps; ++m)
+		{
+			SGVector<float64_t> map_params(
+			    params.vector + m * num_parameters_per_map,
+			    num_parameters_per_map, false);
+			CConvolutionalFeatureMap map(
+			    w, h, rx, ry, stride, stride, m, function);
+			map.compute_activations(
+			    map_params, layers, input_indices, convolved);
+			map.pool_activations(
+			    convolved, pooling, pooling, pooled, max_indices);
+		}
+
+		SGMatrix<float64_t> activations = layer->get_activations();
+		ASSERT_EQ(activations.num_rows, pooled.num_rows);
+		for (index_t i = 0; i < pooled.size(); ++i)
+			EXPECT_NEAR(activations[i], pooled[i], 1e-12);
+	}
+
+	SG_UNREF(layers);
+}
+
+TEST(NeuralConvolutionalLayer, single_precision)
+{
+	const int32_t num_maps = 4;
+
+	std::mt19937_64 prng(23);
+	std::normal_distribution<float64_t> normal;
+	auto layers = create_inputs(prng);
+
+	SGVector<int32_t> input_indices(2);
+	input_indices[0] = 0;
+	input_indices[1] = 1;
+
+	auto layer = some<CNeuralConvolutionalLayer>(
+	    CMAF_LOGISTIC, num_maps, 1, 1, 1, 1, 2, 1);
+	layer->initialize_neural_layer(layers, input_indices);
+	layer->set_batch_size(batch_size);
+
+	SGVector<float64_t> params(layer->get_num_parameters());
+	for (auto& p : params)
+		p = 0.1 * normal(prng);
+	SGMatrix<float64_t> targets(layer->get_num_neurons(), batch_size);
+	for (index_t i = 0; i < targets.size(); ++i)
+		targets[i] = normal(prng);
+
+	SGVector<float64_t> gradients(params.vlen);
+	layer->compute_activations(params, layers);
+	SGMatrix<float64_t> activations = layer->get_activations().clone();
+	layer->compute_gradients(params, targets, layers, gradients);
+
+	layer->set_single_precision(true);
+	SGVector<float64_t> single_gradients(params.vlen);
+	layer->compute_activations(params, layers);
+	SGMatrix<float64_t> single_activations = layer->get_activations();
+	layer->compute_gradients(params, targets, layers, single_gradients);
+
+	for (index_t i = 0; i < activations.size(); ++i)
+		EXPECT_NEAR(activations[i], single_activations[i], 1e-5);
+	for (index_t i = 0; i < gradients.vlen; ++i)
+		EXPECT_NEAR(gradients[i], single_gradients[i], 1e-4);
+
+	SG_UNREF(layers);
+}
+
+TEST(NeuralConvolutionalLayer, backpropagation_with_stride)
+{
+	auto layers = new CDynamicObjectArray();
+	layers->append_element(new CNeuralInputLayer(w, h));
+	layers->append_element(new CNeuralConvolutionalLayer(
+	    CMAF_LOGISTIC, 2, 1, 1, 2, 2, 2, 1));
+	layers->append_element(new CNeuralConvolutionalLayer(
+	    CMAF_RECTIFIED_LINEAR, 2, 1, 1, 1, 1, 1, 2));
+	layers->append_element(new CNeuralLinearLayer(3));
+
+	auto network = some<CNeuralNetwork>(layers);
+	network->put("seed", 10);
+	network->connect(0, 1);
+	network->connect(1, 2);
+	network->connect(2, 3);
+	network->initialize_neural_network();
+
+	EXPECT_NEAR(network->check_gradients(), 0.0, 1e-9);
+}
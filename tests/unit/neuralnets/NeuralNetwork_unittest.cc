@@ -32,6 +32,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
@@ -46,6 +47,9 @@
 #include <shogun/neuralnets/NeuralRectifiedLinearLayer.h>
 #include <shogun/neuralnets/NeuralConvolutionalLayer.h>
 #include <shogun/neuralnets/NeuralLayers.h>
+#include <shogun/optimization/AdamUpdater.h>
+
+#include <random>
 
 using namespace shogun;
 
@@ -470,3 +474,153 @@ TEST(NeuralNetwork, gradient_descent)
 	SG_UNREF(features);
 	SG_UNREF(predictions);
 }
+
+/** tests a neural network trained using gradient descent with the Adam
+ * updater on the binary XOR problem
+ */
+TEST(NeuralNetwork, gradient_descent_adam)
+{
+	int32_t seed = 100;
+
+	SGMatrix<float64_t> inputs_matrix(2,4);
+	SGVector<float64_t> targets_vector(4);
+	for (int32_t i=0; i<4; i++)
+	{
+		inputs_matrix(0,i) = (i/2) ? 1.0 : -1.0;
+		inputs_matrix(1,i) = (i%2) ? 1.0 : -1.0;
+		targets_vector[i] = (i==1 || i==2) ? 1.0 : -1.0;
+	}
+
+	auto features = some<CDenseFeatures<float64_t>>(inputs_matrix);
+	auto labels = some<CBinaryLabels>(targets_vector);
+
+	CDynamicObjectArray* layers = new CDynamicObjectArray();
+	layers->append_element(new CNeuralInputLayer(2));
+	layers->append_element(new CNeuralLogisticLayer(8));
+	layers->append_element(new CNeuralLogisticLayer(1));
+
+	auto network = some<CNeuralNetwork>(layers);
+	network->put("seed", seed);
+	network->quick_connect();
+	network->initialize_neural_network(0.1);
+
+	network->set_optimization_method(NNOM_GRADIENT_DESCENT);
+	network->set_gradient_updater(new AdamUpdater(0.1, 1e-8, 0.9, 0.999));
+	network->set_epsilon(0.0);
+	network->set_max_num_epochs(1000);
+
+	network->set_labels(labels);
+	network->train(features);
+
+	auto predictions = wrap(network->apply_binary(features));
+
+	for (int32_t i=0; i<4; i++)
+		EXPECT_EQ(predictions->get_label(i), labels->get_label(i));
+}
+
+/** tests that the state of the updater is not carried over from one training
+ * to the next
+ */
+TEST(NeuralNetwork, gradient_updater_retrain)
+{
+	int32_t seed = 100;
+
+	SGMatrix<float64_t> inputs_matrix(2,4);
+	SGVector<float64_t> targets_vector(4);
+	for (int32_t i=0; i<4; i++)
+	{
+		inputs_matrix(0,i) = (i/2) ? 1.0 : -1.0;
+		inputs_matrix(1,i) = (i%2) ? 1.0 : -1.0;
+		targets_vector[i] = (i==1 || i==2) ? 1.0 : -1.0;
+	}
+
+	auto features = some<CDenseFeatures<float64_t>>(inputs_matrix);
+	auto labels = some<CBinaryLabels>(targets_vector);
+
+	CDynamicObjectArray* layers = new CDynamicObjectArray();
+	layers->append_element(new CNeuralInputLayer(2));
+	layers->append_element(new CNeuralLogisticLayer(8));
+	layers->append_element(new CNeuralLogisticLayer(1));
+
+	auto network = some<CNeuralNetwork>(layers);
+	network->put("seed", seed);
+	network->quick_connect();
+	network->initialize_neural_network(0.1);
+
+	network->set_optimization_method(NNOM_GRADIENT_DESCENT);
+	network->set_gradient_updater(new AdamUpdater(0.1, 1e-8, 0.9, 0.999));
+	network->set_epsilon(0.0);
+	network->set_max_num_epochs(50);
+	network->set_labels(labels);
+
+	SGVector<float64_t> params = network->get_parameters();
+	SGVector<float64_t> initial_params = params.clone();
+
+	network->train(features);
+	SGVector<float64_t> first_params = params.clone();
+
+	// the second training starts from the same parameters
+	sg_memcpy(params.vector, initial_params.vector,
+		sizeof(float64_t)*params.vlen);
+	network->train(features);
+
+	for (int32_t i=0; i<params.vlen; i++)
+		EXPECT_EQ(params[i], first_params[i]);
+}
+
+/** tests that computing the gradients of the mini-batches in parallel gives
+ * the same parameters as computing them on one thread
+ */
+TEST(NeuralNetwork, data_parallel_gradients)
+{
+	int32_t seed = 100;
+	int32_t N = 64;
+
+	std::mt19937_64 prng(seed);
+	std::normal_distribution<float64_t> normal(0, 1);
+	SGMatrix<float64_t> inputs_matrix(3,N);
+	SGVector<float64_t> targets_vector(N);
+	for (int32_t i=0; i<N; i++)
+	{
+		for (int32_t j=0; j<3; j++)
+			inputs_matrix(j,i) = normal(prng);
+		targets_vector[i] = inputs_matrix(0,i)*inputs_matrix(1,i);
+	}
+
+	auto features = some<CDenseFeatures<float64_t>>(inputs_matrix);
+	auto labels = some<CRegressionLabels>(targets_vector);
+
+	auto num_threads = env()->get_num_threads();
+	env()->set_num_threads(4);
+
+	SGVector<float64_t> params[2];
+	for (int32_t k=0; k<2; k++)
+	{
+		CDynamicObjectArray* layers = new CDynamicObjectArray();
+		layers->append_element(new CNeuralInputLayer(3));
+		layers->append_element(new CNeuralLogisticLayer(10));
+		layers->append_element(new CNeuralLinearLayer(1));
+
+		auto network = some<CNeuralNetwork>(layers);
+		network->put("seed", seed);
+		network->quick_connect();
+		network->initialize_neural_network(0.1);
+
+		network->set_optimization_method(NNOM_GRADIENT_DESCENT);
+		network->set_gd_mini_batch_size(16);
+		network->set_l2_coefficient(1e-3);
+		network->set_epsilon(0.0);
+		network->set_max_num_epochs(20);
+		network->set_data_parallel(k==1);
+
+		network->set_labels(labels);
+		network->train(features);
+		params[k] = network->get_parameters();
+	}
+
+	env()->set_num_threads(num_threads);
+
+	ASSERT_EQ(params[0].vlen, params[1].vlen);
+	for (int32_t i=0; i<params[0].vlen; i++)
+		EXPECT_NEAR(params[0][i], params[1][i], 1e-10);
+}
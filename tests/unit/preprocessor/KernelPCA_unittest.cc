@@ -101,3 +101,48 @@ TEST(KernelPCA, apply_to_feature_vector)
 	SG_UNREF(kpca);
 	SG_UNREF(kernel);
 }
+
+TEST(KernelPCA, transform_single_precision)
+{
+	index_t num_test_vectors = 2;
+
+	SGMatrix<float64_t> train_matrix(num_features, num_vectors);
+	SGMatrix<float64_t> test_matrix(num_features, num_test_vectors);
+	load_data(train_matrix, test_matrix);
+
+	CDenseFeatures<float64_t>* train_feats =
+	    new CDenseFeatures<float64_t>(train_matrix);
+
+	CDenseFeatures<float64_t>* test_feats =
+	    new CDenseFeatures<float64_t>(test_matrix);
+
+	SG_REF(train_feats)
+	SG_REF(test_feats)
+
+	for (auto precision : {KPREC_MIXED, KPREC_SINGLE})
+	{
+		CGaussianKernel* kernel = new CGaussianKernel();
+		SG_REF(kernel)
+		kernel->set_width(1);
+		kernel->set_precision(precision);
+
+		CKernelPCA* kpca = new CKernelPCA(kernel);
+		SG_REF(kpca)
+		kpca->set_target_dim(target_dim);
+		kpca->fit(train_feats);
+
+		SGMatrix<float64_t> embedding = kpca->transform(test_feats)
+		                                    ->as<CDenseFeatures<float64_t>>()
+		                                    ->get_feature_matrix();
+
+		// kernel matrix and eigenvectors are float32_t
+		for (index_t i = 0; i < num_test_vectors * target_dim; ++i)
+			EXPECT_NEAR(CMath::abs(embedding[i]), CMath::abs(resdata[i]), 1E-5);
+
+		SG_UNREF(kpca);
+		SG_UNREF(kernel);
+	}
+
+	SG_UNREF(train_feats)
+	SG_UNREF(test_feats)
+}
@@ -0,0 +1,56 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Authors: Viktor Gal
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/mathematics/NormalDistribution.h>
+#include <shogun/regression/KernelRidgeRegression.h>
+
+#include <random>
+
+using namespace shogun;
+
+TEST(KernelRidgeRegression, single_precision_kernel_matrix)
+{
+	const int32_t seed = 10;
+	const index_t num_vectors = 50;
+
+	SGVector<float64_t> lab(num_vectors);
+	SGMatrix<float64_t> train_dat(1, num_vectors);
+	std::mt19937_64 prng(seed);
+	NormalDistribution<float64_t> normal_dist(0.0, 0.1);
+	for (index_t i = 0; i < num_vectors; ++i)
+	{
+		train_dat.matrix[i] = i / 10.0;
+		lab.vector[i] = std::sin(train_dat.matrix[i]) + normal_dist(prng);
+	}
+
+	auto features = some<CDenseFeatures<float64_t>>(train_dat);
+	auto labels = some<CRegressionLabels>(lab);
+
+	auto kernel = some<CGaussianKernel>(10, 2.0);
+	auto krr = some<CKernelRidgeRegression>(0.1, kernel, labels);
+	krr->train(features);
+	auto expected_labels = krr->apply_regression(features);
+	auto expected = expected_labels->get_labels();
+
+	for (auto precision : {KPREC_MIXED, KPREC_SINGLE})
+	{
+		kernel->set_precision(precision);
+		krr->train(features);
+		auto result_labels = krr->apply_regression(features);
+		auto result = result_labels->get_labels();
+
+		// the regularised system is well conditioned in float32_t
+		for (index_t i = 0; i < num_vectors; ++i)
+			EXPECT_NEAR(expected[i], result[i], 1E-4);
+		SG_UNREF(result_labels);
+	}
+	SG_UNREF(expected_labels);
+}